@@ -0,0 +1,76 @@
+// Load test on an in-process simulated cluster.
+//
+// Usage: bench_cluster_sim [nodes] [requests] [departures_per_second]
+//
+// Runs a gossip flood, a Zipf content workload (without and with churn) and
+// a ledger event burst (unbatched and batched) over the simulated network, and prints latency
+// percentiles, completion and traffic for each. Times are virtual.
+
+#include "sim/cluster_simulator.hpp"
+#include "utils/logger.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace cashew;
+using namespace cashew::sim;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void print(const WorkloadReport& report, size_t node_count, Clock::time_point start) {
+    std::printf("%s\n    (%.0f ms wall)\n", report.to_string(node_count).c_str(), elapsed_ms(start));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t node_count = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 200;
+    const size_t requests = argc > 2 ? static_cast<size_t>(std::atoi(argv[2])) : 5000;
+    const double departures = argc > 3 ? std::atof(argv[3]) : 2.0;
+
+    utils::Logger::init("error");
+
+    ClusterConfig config;
+    config.node_count = node_count;
+    ClusterSimulator cluster(config);
+    std::printf("cluster: %zu nodes, %zu peers each, fanout %zu\n",
+                node_count, config.peers_per_node, config.gossip_fanout);
+
+    auto start = Clock::now();
+    print(cluster.run_gossip_flood(GossipFloodWorkload{}), node_count, start);
+
+    ContentWorkload content;
+    content.requests = requests;
+    start = Clock::now();
+    print(cluster.run_content_workload(content), node_count, start);
+
+    ChurnProfile churn;
+    churn.departures_per_second = departures;
+    cluster.set_churn(churn);
+    start = Clock::now();
+    auto churned = cluster.run_content_workload(content);
+    churned.name = "content+churn";
+    print(churned, node_count, start);
+    cluster.set_churn(ChurnProfile{});
+
+    // Followers that missed an event stay behind, so each burst gets a fresh cluster
+    for (auto window : {std::chrono::milliseconds(0), std::chrono::milliseconds(10)}) {
+        ClusterSimulator fresh(config);
+        LedgerBurstWorkload burst;
+        burst.batch_window = window;
+        start = Clock::now();
+        auto report = fresh.run_ledger_burst(burst);
+        if (window.count() > 0) {
+            report.name = "ledger (" + std::to_string(window.count()) + " ms batches)";
+        }
+        print(report, node_count, start);
+    }
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Gateway HTTP throughput and latency: httplib engine vs the native epoll engine.
+//
+// Usage: bench_gateway_http [connections] [seconds] [pipeline_depth]
+//
+// wrk-style closed loop: each connection keeps one socket alive and sends
+// pipeline_depth requests back to back, waiting for all responses before the
+// next batch. Reports requests/second and latency percentiles for a cheap
+// inline route (/api/health) and a handler route (/api/bench).
+
+#include "cashew/gateway/gateway_server.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace cashew;
+using namespace cashew::gateway;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int connect_local(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    return fd;
+}
+
+// Consume one Content-Length framed response from buffer, reading more as needed
+bool read_response(int fd, std::string& buffer) {
+    char chunk[16384];
+    while (true) {
+        const size_t head_end = buffer.find("\r\n\r\n");
+        if (head_end != std::string::npos) {
+            size_t length = 0;
+            const size_t pos = buffer.find("Content-Length: ");
+            if (pos != std::string::npos && pos < head_end) {
+                length = std::strtoul(buffer.c_str() + pos + 16, nullptr, 10);
+            }
+            if (buffer.size() >= head_end + 4 + length) {
+                buffer.erase(0, head_end + 4 + length);
+                return true;
+            }
+        }
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+}
+
+struct RunResult {
+    double requests_per_second;
+    double p50_us;
+    double p99_us;
+    size_t errors;
+    size_t reconnects;
+};
+
+RunResult run_load(uint16_t port, const std::string& path, size_t connections,
+                   double seconds, size_t depth) {
+    std::string batch;
+    for (size_t i = 0; i < depth; ++i) {
+        batch += "GET " + path + " HTTP/1.1\r\nHost: bench\r\n\r\n";
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> errors{0};
+    std::atomic<size_t> reconnects{0};
+    std::vector<std::vector<double>> latencies(connections);
+    std::vector<std::thread> clients;
+
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back([&, c]() {
+            int fd = connect_local(port);
+            std::string buffer;
+            while (!stop && fd >= 0) {
+                const auto sent_at = Clock::now();
+                bool ok = send(fd, batch.data(), batch.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(batch.size());
+                for (size_t i = 0; i < depth && ok; ++i) {
+                    ok = read_response(fd, buffer);
+                    if (ok) {
+                        latencies[c].push_back(
+                            std::chrono::duration<double, std::micro>(Clock::now() - sent_at).count());
+                    }
+                }
+                if (!ok) {
+                    // Server closed the connection (httplib caps requests per connection)
+                    reconnects++;
+                    close(fd);
+                    buffer.clear();
+                    fd = connect_local(port);
+                }
+            }
+            if (fd < 0) {
+                errors++;
+            } else {
+                close(fd);
+            }
+        });
+    }
+
+    const auto started = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& client : clients) {
+        client.join();
+    }
+    const double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+
+    std::vector<double> all;
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    RunResult result{};
+    result.requests_per_second = static_cast<double>(all.size()) / elapsed;
+    result.p50_us = all.empty() ? 0.0 : all[all.size() / 2];
+    result.p99_us = all.empty() ? 0.0 : all[std::min(all.size() - 1, all.size() * 99 / 100)];
+    result.errors = errors;
+    result.reconnects = reconnects;
+    return result;
+}
+
+void bench_engine(bool native, uint16_t port, size_t connections, double seconds, size_t depth) {
+    GatewayConfig config;
+    config.bind_address = "127.0.0.1";
+    config.http_port = port;
+    config.use_native_http_engine = native;
+    config.max_requests_per_minute = 1000000000;
+    config.max_requests_per_hour = 1000000000;
+    config.max_requests_per_subnet_per_minute = 1000000000;
+    config.max_concurrent_api = 0;
+
+    GatewayServer server(config);
+    server.register_handler(HttpMethod::GET, "/api/bench", [](const HttpRequest&, GatewaySession&) {
+        HttpResponse response;
+        response.set_json_body(R"({"ok": true})");
+        return response;
+    });
+    if (!server.start()) {
+        std::printf("%s: failed to start\n", native ? "native" : "httplib");
+        return;
+    }
+
+    for (const char* path : {"/api/health", "/api/bench"}) {
+        const auto result = run_load(server.bound_port(), path, connections, seconds, depth);
+        std::printf("%-8s %-12s %10.0f req/s   p50 %8.1f us   p99 %8.1f us   reconnects %zu   errors %zu\n",
+                    native ? "native" : "httplib", path, result.requests_per_second,
+                    result.p50_us, result.p99_us, result.reconnects, result.errors);
+    }
+    server.stop();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t connections = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32;
+    const double seconds = argc > 2 ? std::atof(argv[2]) : 3.0;
+    const size_t depth = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1;
+
+    std::printf("%zu connections, %.1f s per run, pipeline depth %zu\n", connections, seconds, depth);
+    bench_engine(false, 18181, connections, seconds, depth);
+    bench_engine(true, 18182, connections, seconds, depth);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace cashew {
+namespace gateway {
+
+/**
+ * Endpoint classes with separate concurrency limits
+ */
+enum class EndpointClass : uint8_t {
+    STATIC,   // Files under the web root
+    CONTENT,  // /api/thing/<hash>
+    API,      // Other /api/ endpoints
+    AUTH,     // /api/auth (signature verification)
+    PRIORITY  // Health checks, preflights, 304 revalidations (never queued)
+};
+
+constexpr size_t ENDPOINT_CLASS_COUNT = 5;
+
+const char* endpoint_class_to_string(EndpointClass endpoint_class);
+
+/**
+ * Admission control configuration
+ */
+struct AdmissionConfig {
+    // Requests allowed in flight per class, indexed by EndpointClass (0 = unlimited)
+    std::array<size_t, ENDPOINT_CLASS_COUNT> max_concurrent{16, 16, 16, 4, 64};
+
+    // Queue wait allowed once a class has had waiters for a whole interval
+    std::chrono::milliseconds target_queue_delay{5};
+    std::chrono::milliseconds interval{100};
+
+    // Queue wait allowed while the queue keeps draining
+    std::chrono::milliseconds max_queue_delay{500};
+};
+
+/**
+ * AdmissionController - Per-endpoint-class concurrency limits with
+ * queue-delay based load shedding
+ *
+ * A request beyond its class limit waits for a slot; freed slots are handed
+ * to waiters strictly in arrival order. While the queue keeps
+ * emptying, a waiter may queue for up to max_queue_delay to absorb bursts.
+ * Once the class has had waiters continuously for longer than interval the
+ * queue is standing, and new waiters only get target_queue_delay before they
+ * are shed (controlled delay, as in CoDel). Shed requests fail fast instead
+ * of piling up behind work that is already late.
+ *
+ * Complements the per-IP limits in security::IPAdmissionEngine, which cannot
+ * see load spread across many clients. Thread-safe.
+ */
+class AdmissionController {
+    struct Gate;
+
+public:
+    explicit AdmissionController(const AdmissionConfig& config = AdmissionConfig());
+    ~AdmissionController();
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /**
+     * Held while a request runs; releases its slot when destroyed.
+     * Converts to false if the request was shed.
+     */
+    class Permit {
+    public:
+        Permit() = default;
+        ~Permit();
+
+        Permit(Permit&& other) noexcept;
+        Permit& operator=(Permit&& other) noexcept;
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+
+        explicit operator bool() const { return admitted_; }
+        std::chrono::microseconds queued_for() const { return queued_for_; }
+
+    private:
+        friend class AdmissionController;
+
+        void release();
+
+        Gate* gate_{nullptr};
+        bool admitted_{false};
+        std::chrono::microseconds queued_for_{0};
+    };
+
+    /**
+     * Wait for a slot in endpoint_class; blocks at most max_queue_delay
+     */
+    Permit acquire(EndpointClass endpoint_class);
+
+    /**
+     * Take a slot only if one is free right now; never blocks, so it is safe
+     * on event loop threads. A full class sheds the request.
+     */
+    Permit try_acquire(EndpointClass endpoint_class);
+
+    struct ClassStatistics {
+        size_t limit{0};
+        size_t in_flight{0};
+        size_t waiting{0};
+        size_t peak_in_flight{0};
+        uint64_t admitted{0};
+        uint64_t queued{0};          // Admitted after waiting for a slot
+        uint64_t shed{0};
+        uint64_t total_queue_us{0};  // Summed wait of queued requests
+        bool standing_queue{false};  // Waiters present for longer than interval
+    };
+
+    struct Statistics {
+        std::array<ClassStatistics, ENDPOINT_CLASS_COUNT> classes{};
+        uint64_t admitted{0};
+        uint64_t shed{0};
+    };
+
+    Statistics get_statistics() const;
+
+    const AdmissionConfig& config() const { return config_; }
+
+private:
+    // One per blocked acquire(), woken only when a slot is handed to it
+    struct Waiter {
+        std::condition_variable granted_cv;
+        bool granted{false};
+    };
+
+    struct Gate {
+        mutable std::mutex mutex;
+        size_t limit{0};
+        size_t in_flight{0};
+        std::deque<Waiter*> waiters;  // Arrival order
+        std::chrono::steady_clock::time_point last_empty;
+        ClassStatistics stats;
+    };
+
+    AdmissionConfig config_;
+    std::array<std::unique_ptr<Gate>, ENDPOINT_CLASS_COUNT> gates_;
+};
+
+} // namespace gateway
+} // namespace cashew
@@ -8,9 +8,15 @@
 #include <optional>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
+#include <unordered_set>
 #include <functional>
 
 namespace cashew {
+
+namespace storage { class KVStore; }
+namespace runtime { class Executor; }
+
 namespace gateway {
 
 /**
@@ -87,8 +93,14 @@ struct ContentRendererConfig {
     std::vector<std::string> allowed_origins;
     
     // Performance
-    size_t max_concurrent_fetches{10};
+    size_t max_concurrent_fetches{10};    // Distinct hashes fetched at once
     std::chrono::seconds fetch_timeout{30};
+    
+    // Prefetch and cache warming
+    bool prefetch_html_references{true};  // Warm /api/thing/<hash> assets of served pages
+    size_t max_prefetch_references{32};   // Per page
+    size_t popularity_capacity{1024};     // Things tracked by the access log
+    double warm_cache_fraction{0.5};      // Share of max_cache_size_bytes warmed at startup
 };
 
 /**
@@ -158,6 +170,45 @@ public:
      */
     bool prefetch(const Hash256& content_hash);
     
+    /**
+     * Run HTML reference prefetches on executor (without one, pages are not scanned)
+     */
+    void set_prefetch_executor(std::shared_ptr<runtime::Executor> executor);
+    
+    /**
+     * Content hashes referenced by an HTML page (gateway URLs and bare hashes
+     * in src/href attributes), in document order without duplicates
+     */
+    static std::vector<Hash256> extract_content_references(
+        const std::vector<uint8_t>& html,
+        size_t max_references = 32
+    );
+    
+    /**
+     * Most accessed Things (space-saving counts) with their last seen size
+     */
+    struct PopularityEntry {
+        Hash256 content_hash;
+        uint64_t access_count{0};
+        uint64_t size_bytes{0};
+    };
+    
+    std::vector<PopularityEntry> get_popular_content(size_t max_count) const;
+    
+    /**
+     * Persist / restore the access log ("popularity/<hash>" records)
+     * Restored counts are halved so old popularity fades across restarts.
+     */
+    bool save_popularity(storage::KVStore& store) const;
+    bool load_popularity(const storage::KVStore& store);
+    
+    /**
+     * Prefetch the hottest Things until byte_budget is used
+     * @param byte_budget Bytes to warm (0 = warm_cache_fraction of the cache)
+     * @return Number of Things fetched into the cache
+     */
+    size_t warm_cache(size_t byte_budget = 0);
+    
     /**
      * Check if content is cached
      * @param content_hash Hash to check
@@ -181,6 +232,8 @@ public:
         size_t miss_count{0};
         double hit_ratio{0.0};
         size_t eviction_count{0};
+        size_t prefetch_count{0};   // Things fetched ahead of a request
+        size_t coalesced_count{0};  // Misses served by another caller's fetch
     };
     
     CacheStatistics get_cache_stats() const;
@@ -216,6 +269,17 @@ private:
      */
     std::optional<std::vector<uint8_t>> fetch_from_network(const Hash256& content_hash);
     
+    /**
+     * Fetch, verify and cache content once for all concurrent callers
+     * At most max_concurrent_fetches distinct hashes are fetched at a time.
+     * @param fetched_here Set when this call did the fetch (not a waiter)
+     * @return Verified content shared with the other waiters, or nullptr
+     */
+    std::shared_ptr<const std::vector<uint8_t>> fetch_coalesced(
+        const Hash256& content_hash,
+        bool& fetched_here
+    );
+    
     /**
      * Add to cache
      */
@@ -244,9 +308,51 @@ private:
         const std::vector<uint8_t>& data
     );
     
+    /**
+     * Count an access in the popularity log
+     */
+    void record_access(const Hash256& content_hash, size_t size_bytes);
+    
+    /**
+     * Queue prefetches for the uncached references of an HTML page
+     */
+    void schedule_reference_prefetch(const std::vector<uint8_t>& html);
+    
+    static bool looks_like_html(const std::vector<uint8_t>& data);
+    
     ContentRendererConfig config_;
     ContentFetchCallback fetch_callback_;
     
+    // Background prefetch; jobs check in with the guard so the destructor can
+    // wait for running ones and disarm queued ones
+    struct PrefetchGuard {
+        std::mutex mutex;
+        std::condition_variable idle_cv;
+        ContentRenderer* owner{nullptr};
+        size_t running{0};
+        std::unordered_set<Hash256> in_flight;
+    };
+    std::shared_ptr<runtime::Executor> prefetch_executor_;
+    std::shared_ptr<PrefetchGuard> prefetch_guard_;
+    
+    // In-flight fetches; waiters share the leader's result
+    struct InFlightFetch {
+        bool done{false};
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+    std::mutex fetch_mutex_;
+    std::condition_variable fetch_cv_;
+    std::unordered_map<Hash256, std::shared_ptr<InFlightFetch>> in_flight_fetches_;
+    size_t active_fetches_{0};
+    
+    // Popularity log (space-saving top-k)
+    struct PopularityCounter {
+        uint64_t count{0};
+        uint64_t size_bytes{0};
+    };
+    mutable std::mutex popularity_mutex_;
+    std::unordered_map<Hash256, PopularityCounter> popularity_;
+    
     // Cache management
     mutable std::mutex cache_mutex_;
     std::unordered_map<Hash256, CacheEntry> cache_;
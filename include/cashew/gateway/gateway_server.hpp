@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cashew/common.hpp"
+#include "cashew/gateway/admission_controller.hpp"
 #include <string>
 #include <memory>
 #include <unordered_map>
@@ -16,7 +17,10 @@ namespace cashew {
 // Forward declarations
 namespace storage { class Storage; }
 namespace network { class NetworkRegistry; }
-namespace gateway { class ContentRenderer; }
+namespace security { class IPAdmissionEngine; }
+namespace utils { class MaintenanceScheduler; }
+namespace gateway { class ContentRenderer; class NativeHttpServer; }
+namespace runtime { class Executor; }
 
 namespace gateway {
 
@@ -39,12 +43,14 @@ enum class HttpStatus {
     OK = 200,
     CREATED = 201,
     NO_CONTENT = 204,
+    NOT_MODIFIED = 304,
     BAD_REQUEST = 400,
     UNAUTHORIZED = 401,
     FORBIDDEN = 403,
     NOT_FOUND = 404,
     METHOD_NOT_ALLOWED = 405,
     CONFLICT = 409,
+    PAYLOAD_TOO_LARGE = 413,
     INTERNAL_ERROR = 500,
     NOT_IMPLEMENTED = 501,
     SERVICE_UNAVAILABLE = 503
@@ -128,9 +134,32 @@ struct GatewayConfig {
     std::chrono::seconds session_timeout{3600};  // 1 hour
     size_t max_sessions{10000};
     
-    // Rate limiting
+    // Rate limiting (per client IP, plus per /24 or /64 subnet)
     size_t max_requests_per_minute{60};
     size_t max_requests_per_hour{1000};
+    size_t max_requests_per_subnet_per_minute{1200};
+    
+    // Admission control (requests in flight per endpoint class, 0 = unlimited).
+    // Health checks, CORS preflights and revalidations answerable with 304
+    // have their own class: they never queue behind other work, but a flood
+    // of them is still shed once max_concurrent_priority are in flight.
+    size_t max_concurrent_static{16};
+    size_t max_concurrent_content{16};
+    size_t max_concurrent_api{16};
+    size_t max_concurrent_auth{4};
+    size_t max_concurrent_priority{64};
+    std::chrono::milliseconds admission_target_delay{5};
+    std::chrono::milliseconds admission_interval{100};
+    std::chrono::milliseconds admission_max_queue_delay{500};
+    std::chrono::seconds shed_retry_after{1};
+    size_t http_worker_threads{64};  // 0 = library default
+    
+    // In-tree epoll HTTP/1.1 engine instead of httplib (Linux only; handlers
+    // run on http_worker_threads executor workers). Off by default: it wins on
+    // inline routes and pipelined clients, but handler routes such as
+    // /api/bench measure no faster than httplib (bench_gateway_http).
+    bool use_native_http_engine{false};
+    size_t http_event_loops{2};
     
     // Content settings
     size_t max_request_body_size{10 * 1024 * 1024};  // 10 MB
@@ -179,6 +208,20 @@ public:
      */
     void set_network_registry(std::shared_ptr<network::NetworkRegistry> registry);
     
+    /**
+     * Share blocks with another IP admission engine (e.g. the P2P layer's);
+     * the gateway keeps its own request windows and limits
+     * @param engine Admission engine whose block list to use
+     */
+    void set_admission_engine(std::shared_ptr<security::IPAdmissionEngine> engine);
+    
+    /**
+     * Run periodic upkeep (session expiry, admission cleanup) on a shared
+     * maintenance scheduler (takes effect on the next start())
+     * @param scheduler Maintenance scheduler
+     */
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler);
+    
     /**
      * Start the gateway server
      * @return true on success
@@ -195,6 +238,11 @@ public:
      */
     bool is_running() const { return running_; }
     
+    /**
+     * Port the server is listening on (resolved if http_port was 0; native engine only)
+     */
+    uint16_t bound_port() const;
+    
     /**
      * Register a request handler for a specific path pattern
      * @param method HTTP method
@@ -217,6 +265,9 @@ public:
         size_t authenticated_sessions{0};
         size_t bytes_sent{0};
         size_t bytes_received{0};
+        size_t requests_shed{0};        // 503s from admission control
+        size_t priority_requests{0};    // Cheap requests admitted to the priority class
+        AdmissionController::Statistics admission;
         std::chrono::system_clock::time_point started_at;
     };
     
@@ -224,15 +275,20 @@ public:
 
 private:
     /**
-     * Main request processing loop
+     * Periodic upkeep pass (session expiry, admission cleanup)
      */
-    void process_requests();
+    void run_maintenance();
     
     /**
      * Setup HTTP server routes
      */
     void setup_http_routes();
     
+    /**
+     * Run httplib on server_thread_
+     */
+    void start_httplib();
+    
     /**
      * Handle incoming HTTP request
      */
@@ -244,9 +300,25 @@ private:
     std::optional<RequestHandler> find_handler(HttpMethod method, const std::string& path) const;
     
     /**
-     * Create or retrieve session
+     * Cheap requests (health, preflight, 304 revalidation) use the
+     * non-queueing priority class
+     */
+    static bool is_priority_request(const HttpRequest& request);
+    
+    static EndpointClass classify_endpoint(const HttpRequest& request);
+    
+    /**
+     * Create or retrieve session (returns a snapshot; see update_session)
+     */
+    GatewaySession get_or_create_session(const HttpRequest& request);
+    
+    /**
+     * Apply a change to the stored session in place, under the sessions lock,
+     * and refresh the caller's snapshot. Concurrent requests on one session
+     * never overwrite each other's changes.
+     * @return false if the session expired meanwhile
      */
-    GatewaySession& get_or_create_session(const HttpRequest& request);
+    bool update_session(GatewaySession& snapshot, const std::function<void(GatewaySession&)>& change);
     
     /**
      * Validate session
@@ -257,6 +329,7 @@ private:
      * Clean up expired sessions
      */
     void cleanup_sessions();
+    void cleanup_sessions_locked();
     
     /**
      * Apply rate limiting
@@ -288,10 +361,18 @@ private:
     std::atomic<bool> running_{false};
     std::thread server_thread_;
     
+    // Periodic upkeep
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    uint64_t maintenance_task_{0};
+    
     // HTTP server (forward declared, defined in cpp)
     class HttpServerImpl;
     std::unique_ptr<HttpServerImpl> http_server_;
     
+    // Native engine (use_native_http_engine)
+    std::shared_ptr<runtime::Executor> http_executor_;
+    std::unique_ptr<NativeHttpServer> native_server_;
+    
     // Session management
     mutable std::mutex sessions_mutex_;
     std::unordered_map<std::string, GatewaySession> sessions_;
@@ -316,13 +397,10 @@ private:
     std::unordered_map<RouteKey, RequestHandler, RouteKeyHash> handlers_;
     
     // Rate limiting
-    struct ClientRateInfo {
-        std::chrono::system_clock::time_point last_request;
-        size_t requests_this_minute{0};
-        size_t requests_this_hour{0};
-    };
-    mutable std::mutex rate_limit_mutex_;
-    std::unordered_map<std::string, ClientRateInfo> client_rates_;
+    std::shared_ptr<security::IPAdmissionEngine> admission_;
+    
+    // Load shedding
+    std::unique_ptr<AdmissionController> admission_control_;
     
     // Statistics
     std::shared_ptr<network::NetworkRegistry> network_registry_;
@@ -12,6 +12,9 @@
 #include <thread>
 
 namespace cashew {
+
+namespace utils { class MaintenanceScheduler; }
+
 namespace gateway {
 
 /**
@@ -156,6 +159,13 @@ public:
     
     ~WebSocketHandler();
     
+    /**
+     * Run keepalive on a shared maintenance scheduler instead of a
+     * dedicated thread (takes effect on the next start())
+     * @param scheduler Maintenance scheduler
+     */
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler);
+    
     /**
      * Start the handler (background thread for keepalive)
      */
@@ -233,6 +243,11 @@ private:
      */
     void keepalive_loop();
     
+    /**
+     * One keepalive pass over all connections
+     */
+    void run_keepalive();
+    
     /**
      * Clean up dead connections
      */
@@ -251,6 +266,10 @@ private:
     std::atomic<bool> running_{false};
     std::thread keepalive_thread_;
     
+    // Shared scheduler (replaces keepalive_thread_ when set)
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    uint64_t keepalive_task_{0};
+    
     // Connection management
     mutable std::mutex connections_mutex_;
     std::unordered_map<std::string, std::shared_ptr<WsConnection>> connections_;
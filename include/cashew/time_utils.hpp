@@ -4,6 +4,7 @@
 #include <chrono>
 #include <string>
 #include <thread>
+#include <atomic>
 
 namespace cashew {
 namespace time {
@@ -51,6 +52,29 @@ inline uint64_t duration_to_milliseconds(const std::chrono::duration<Rep, Period
     return std::chrono::duration_cast<Milliseconds>(duration).count();
 }
 
+// Cached wall clock for hot loops (staleness/timeout checks)
+//
+// Reads are a single atomic load. A driver (the maintenance scheduler)
+// refreshes the cached value every tick; with no driver attached, reads
+// fall through to the system clock so the value is never stale.
+class CoarseClock {
+public:
+    // Unix timestamp (seconds / milliseconds)
+    static uint64_t now_seconds() { return now_milliseconds() / 1000; }
+    static uint64_t now_milliseconds();
+    
+    // Sample the system clock into the cache
+    static void refresh();
+    
+    // Drivers keep the cache fresh while attached
+    static void attach();
+    static void detach();
+    
+private:
+    static std::atomic<uint64_t> cached_ms_;
+    static std::atomic<uint32_t> drivers_;
+};
+
 // Epoch management (for Cashew's 10-minute epochs)
 class EpochManager {
 public:
@@ -1,5 +1,6 @@
 #include "core/decay/decay_runner.hpp"
 #include "utils/logger.hpp"
+#include "utils/maintenance_scheduler.hpp"
 
 namespace cashew::decay {
 
@@ -22,6 +23,15 @@ void DecayRunner::start(std::chrono::seconds interval) {
     running_ = true;
     start_time_ = std::chrono::system_clock::now();
     
+    if (maintenance_) {
+        maintenance_task_ = maintenance_->schedule_periodic(
+            "decay.check",
+            std::chrono::duration_cast<std::chrono::milliseconds>(interval),
+            [this]() { perform_decay_check(); });
+        CASHEW_LOG_INFO("DecayRunner scheduled with {}-second interval", interval.count());
+        return;
+    }
+    
     worker_thread_ = std::thread([this, interval]() {
         CASHEW_LOG_INFO("DecayRunner started with {}-second interval", interval.count());
         
@@ -64,11 +74,23 @@ void DecayRunner::stop() {
     CASHEW_LOG_INFO("Stopping DecayRunner...");
     running_ = false;
     
+    if (maintenance_ && maintenance_task_ != 0) {
+        maintenance_->cancel(maintenance_task_);
+        maintenance_task_ = 0;
+    }
+    
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
 }
 
+void DecayRunner::set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+    if (running_) {
+        CASHEW_LOG_WARN("DecayRunner running; scheduler applies after restart");
+    }
+    maintenance_ = std::move(scheduler);
+}
+
 void DecayRunner::set_decay_callback(DecayCallback callback) {
     decay_callback_ = std::move(callback);
 }
@@ -79,6 +101,11 @@ void DecayRunner::trigger_check() {
         return;
     }
     
+    if (maintenance_ && maintenance_task_ != 0) {
+        maintenance_->trigger(maintenance_task_);
+        return;
+    }
+    
     trigger_ = true;
 }
 
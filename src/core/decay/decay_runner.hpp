@@ -5,6 +5,9 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <memory>
+
+namespace cashew::utils { class MaintenanceScheduler; }
 
 namespace cashew::decay {
 
@@ -23,6 +26,10 @@ public:
     void stop();
     bool is_running() const { return running_; }
     
+    // Run checks on a shared maintenance scheduler instead of a worker thread
+    // (takes effect on the next start())
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler);
+    
     // Set callback for decay events
     void set_decay_callback(DecayCallback callback);
     
@@ -50,6 +57,10 @@ private:
     std::atomic<bool> trigger_{false};
     DecayCallback decay_callback_;
     
+    // Shared scheduler (replaces worker_thread_ when set)
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    uint64_t maintenance_task_{0};
+    
     // Stats
     mutable std::mutex stats_mutex_;
     Stats stats_;
@@ -14,6 +14,7 @@ namespace cashew::ledger {
 
 std::vector<uint8_t> LedgerEvent::to_bytes() const {
     std::vector<uint8_t> data_out;
+    data_out.reserve(serialized_size());
     
     // Event ID (32 bytes)
     data_out.insert(data_out.end(), event_id.begin(), event_id.end());
@@ -301,16 +302,49 @@ std::optional<ReputationUpdateData> ReputationUpdateData::from_bytes(const std::
     return data;
 }
 
+// EventRange methods
+
+EventRange EventRange::subrange(size_t offset, size_t count) const {
+    const size_t first = first_ + std::min(offset, size());
+    const size_t last = first + std::min(count, last_ - first);
+    EventRange range = *this;
+    range.first_ = first;
+    range.last_ = last;
+    return range;
+}
+
+std::vector<LedgerEvent> EventRange::to_vector() const {
+    return std::vector<LedgerEvent>(begin(), end());
+}
+
 // LedgerIndex methods
 
-void LedgerIndex::add_event(const LedgerEvent& event) {
-    Hash256 event_id = event.event_id;
-    
+namespace {
+
+const EventPositions& empty_positions() {
+    static const EventPositions empty;
+    return empty;
+}
+
+} // namespace
+
+void LedgerIndex::add_event(const LedgerEvent& event, uint32_t position) {
     // Index by node
-    events_by_node_[event.source_node].push_back(event_id);
+    events_by_node_[event.source_node].push_back(position);
     
     // Index by type
-    events_by_type_[event.event_type].push_back(event_id);
+    events_by_type_[event.event_type].push_back(position);
+    
+    // Index by epoch (events almost always arrive in epoch order)
+    if (epoch_keys_.empty() || epoch_keys_.back() <= event.epoch) {
+        epoch_keys_.push_back(event.epoch);
+        epoch_positions_.push_back(position);
+    } else {
+        auto it = std::upper_bound(epoch_keys_.begin(), epoch_keys_.end(), event.epoch);
+        const auto offset = it - epoch_keys_.begin();
+        epoch_keys_.insert(it, event.epoch);
+        epoch_positions_.insert(epoch_positions_.begin() + offset, position);
+    }
     
     // Type-specific indexing
     switch (event.event_type) {
@@ -327,24 +361,51 @@ void LedgerIndex::add_event(const LedgerEvent& event) {
             break;
         }
         
+        case EventType::NETWORK_CREATED: {
+            if (event.data.size() >= 32) {
+                Hash256 network_id;
+                std::copy(event.data.begin(), event.data.begin() + 32, network_id.begin());
+                events_by_network_[network_id].push_back(position);
+            }
+            break;
+        }
+        
         case EventType::NETWORK_MEMBER_ADDED: {
             auto net_data_opt = NetworkMembershipData::from_bytes(event.data);
             if (net_data_opt) {
-                events_by_network_[net_data_opt->network_id].push_back(event_id);
+                events_by_network_[net_data_opt->network_id].push_back(position);
                 network_members_[net_data_opt->network_id].insert(net_data_opt->member_node);
             }
             break;
         }
         
+        case EventType::NETWORK_MEMBER_REMOVED: {
+            auto net_data_opt = NetworkMembershipData::from_bytes(event.data);
+            if (net_data_opt) {
+                events_by_network_[net_data_opt->network_id].push_back(position);
+                network_members_[net_data_opt->network_id].erase(net_data_opt->member_node);
+            }
+            break;
+        }
+        
         case EventType::THING_REPLICATED: {
             auto thing_data_opt = ThingReplicationData::from_bytes(event.data);
             if (thing_data_opt) {
-                events_by_thing_[thing_data_opt->content_hash].push_back(event_id);
+                events_by_thing_[thing_data_opt->content_hash].push_back(position);
                 thing_hosts_[thing_data_opt->content_hash].insert(thing_data_opt->hosting_node);
             }
             break;
         }
         
+        case EventType::THING_REMOVED: {
+            auto thing_data_opt = ThingReplicationData::from_bytes(event.data);
+            if (thing_data_opt) {
+                events_by_thing_[thing_data_opt->content_hash].push_back(position);
+                thing_hosts_[thing_data_opt->content_hash].erase(thing_data_opt->hosting_node);
+            }
+            break;
+        }
+        
         default:
             break;
     }
@@ -352,17 +413,39 @@ void LedgerIndex::add_event(const LedgerEvent& event) {
 
 void LedgerIndex::rebuild_from_events(const std::vector<LedgerEvent>& events) {
     clear();
-    for (const auto& event : events) {
-        add_event(event);
+    for (size_t i = 0; i < events.size(); ++i) {
+        add_event(events[i], static_cast<uint32_t>(i));
     }
 }
 
-std::vector<Hash256> LedgerIndex::get_events_by_node(const NodeID& node_id) const {
+const EventPositions& LedgerIndex::positions_by_node(const NodeID& node_id) const {
     auto it = events_by_node_.find(node_id);
-    if (it == events_by_node_.end()) {
-        return {};
+    return it == events_by_node_.end() ? empty_positions() : it->second;
+}
+
+const EventPositions& LedgerIndex::positions_by_type(EventType type) const {
+    auto it = events_by_type_.find(type);
+    return it == events_by_type_.end() ? empty_positions() : it->second;
+}
+
+const EventPositions& LedgerIndex::positions_by_network(const Hash256& network_id) const {
+    auto it = events_by_network_.find(network_id);
+    return it == events_by_network_.end() ? empty_positions() : it->second;
+}
+
+const EventPositions& LedgerIndex::positions_by_thing(const ContentHash& content_hash) const {
+    auto it = events_by_thing_.find(content_hash);
+    return it == events_by_thing_.end() ? empty_positions() : it->second;
+}
+
+std::pair<size_t, size_t> LedgerIndex::epoch_span(uint64_t start_epoch, uint64_t end_epoch) const {
+    if (start_epoch > end_epoch) {
+        return {0, 0};
     }
-    return it->second;
+    auto first = std::lower_bound(epoch_keys_.begin(), epoch_keys_.end(), start_epoch);
+    auto last = std::upper_bound(first, epoch_keys_.end(), end_epoch);
+    return {static_cast<size_t>(first - epoch_keys_.begin()),
+            static_cast<size_t>(last - epoch_keys_.begin())};
 }
 
 std::optional<uint64_t> LedgerIndex::get_node_join_time(const NodeID& node_id) const {
@@ -373,15 +456,6 @@ std::optional<uint64_t> LedgerIndex::get_node_join_time(const NodeID& node_id) c
     return it->second;
 }
 
-std::vector<Hash256> LedgerIndex::get_key_events_by_node(const NodeID& node_id) const {
-    std::vector<Hash256> result;
-    auto node_events = get_events_by_node(node_id);
-    
-    // Filter for key events
-    // (Would need event lookup to check type - simplified here)
-    return result;
-}
-
 uint32_t LedgerIndex::get_total_keys_issued(const NodeID& node_id, core::KeyType type) const {
     auto key = std::make_pair(node_id, type);
     auto it = key_balances_.find(key);
@@ -391,14 +465,6 @@ uint32_t LedgerIndex::get_total_keys_issued(const NodeID& node_id, core::KeyType
     return it->second;
 }
 
-std::vector<Hash256> LedgerIndex::get_network_events(const Hash256& network_id) const {
-    auto it = events_by_network_.find(network_id);
-    if (it == events_by_network_.end()) {
-        return {};
-    }
-    return it->second;
-}
-
 std::vector<NodeID> LedgerIndex::get_network_members(const Hash256& network_id) const {
     auto it = network_members_.find(network_id);
     if (it == network_members_.end()) {
@@ -407,14 +473,6 @@ std::vector<NodeID> LedgerIndex::get_network_members(const Hash256& network_id)
     return std::vector<NodeID>(it->second.begin(), it->second.end());
 }
 
-std::vector<Hash256> LedgerIndex::get_thing_events(const ContentHash& content_hash) const {
-    auto it = events_by_thing_.find(content_hash);
-    if (it == events_by_thing_.end()) {
-        return {};
-    }
-    return it->second;
-}
-
 std::vector<NodeID> LedgerIndex::get_thing_hosts(const ContentHash& content_hash) const {
     auto it = thing_hosts_.find(content_hash);
     if (it == thing_hosts_.end()) {
@@ -423,16 +481,13 @@ std::vector<NodeID> LedgerIndex::get_thing_hosts(const ContentHash& content_hash
     return std::vector<NodeID>(it->second.begin(), it->second.end());
 }
 
-std::vector<Hash256> LedgerIndex::get_reputation_events(const NodeID& node_id) const {
-    // Simplified - would filter by event type
-    return get_events_by_node(node_id);
-}
-
 void LedgerIndex::clear() {
     events_by_node_.clear();
     events_by_type_.clear();
     events_by_network_.clear();
     events_by_thing_.clear();
+    epoch_positions_.clear();
+    epoch_keys_.clear();
     node_join_times_.clear();
     network_members_.clear();
     thing_hosts_.clear();
@@ -506,7 +561,7 @@ Hash256 Ledger::add_event(const LedgerEvent& event) {
     event_lookup_[event.event_id] = index;
     
     // Update index
-    index_.add_event(event);
+    index_.add_event(events_.back(), static_cast<uint32_t>(index));
     
     // Update chain
     latest_hash_ = event.compute_hash();
@@ -649,48 +704,75 @@ Hash256 Ledger::record_reputation_update(
 }
 
 std::optional<LedgerEvent> Ledger::get_event(const Hash256& event_id) const {
-    auto it = event_lookup_.find(event_id);
-    if (it == event_lookup_.end()) {
+    const LedgerEvent* event = find_event(event_id);
+    if (!event) {
         return std::nullopt;
     }
-    return events_[it->second];
+    return *event;
 }
 
 std::vector<LedgerEvent> Ledger::get_events_by_node(const NodeID& node_id) const {
-    std::vector<LedgerEvent> result;
-    auto event_ids = index_.get_events_by_node(node_id);
-    
-    for (const auto& event_id : event_ids) {
-        auto event_opt = get_event(event_id);
-        if (event_opt) {
-            result.push_back(*event_opt);
-        }
-    }
-    
-    return result;
+    return events_from_node(node_id).to_vector();
 }
 
 std::vector<LedgerEvent> Ledger::get_events_by_type(EventType type) const {
-    std::vector<LedgerEvent> result;
-    
-    for (const auto& event : events_) {
-        if (event.event_type == type) {
-            result.push_back(event);
-        }
-    }
-    
-    return result;
+    return events_of_type(type).to_vector();
 }
 
 std::vector<LedgerEvent> Ledger::get_recent_events(size_t count) const {
-    size_t start = events_.size() > count ? events_.size() - count : 0;
-    return std::vector<LedgerEvent>(events_.begin() + start, events_.end());
+    return recent_events(count).to_vector();
 }
 
 std::vector<LedgerEvent> Ledger::get_all_events() const {
     return events_;
 }
 
+EventRange Ledger::events() const {
+    return EventRange(events_, 0, events_.size());
+}
+
+EventRange Ledger::events_in_epochs(uint64_t start_epoch, uint64_t end_epoch) const {
+    const auto [first, last] = index_.epoch_span(start_epoch, end_epoch);
+    return EventRange(events_, index_.positions_by_epoch(), first, last);
+}
+
+EventRange Ledger::events_of_type(EventType type) const {
+    const auto& positions = index_.positions_by_type(type);
+    return EventRange(events_, positions, 0, positions.size());
+}
+
+EventRange Ledger::events_from_node(const NodeID& node_id) const {
+    const auto& positions = index_.positions_by_node(node_id);
+    return EventRange(events_, positions, 0, positions.size());
+}
+
+EventRange Ledger::events_for_network(const Hash256& network_id) const {
+    const auto& positions = index_.positions_by_network(network_id);
+    return EventRange(events_, positions, 0, positions.size());
+}
+
+EventRange Ledger::events_for_thing(const ContentHash& content_hash) const {
+    const auto& positions = index_.positions_by_thing(content_hash);
+    return EventRange(events_, positions, 0, positions.size());
+}
+
+EventRange Ledger::recent_events(size_t count) const {
+    size_t start = events_.size() > count ? events_.size() - count : 0;
+    return EventRange(events_, start, events_.size());
+}
+
+const LedgerEvent* Ledger::find_event(const Hash256& event_id) const {
+    auto it = event_lookup_.find(event_id);
+    if (it == event_lookup_.end()) {
+        return nullptr;
+    }
+    return &events_[it->second];
+}
+
+bool Ledger::contains_event(const Hash256& event_id) const {
+    return event_lookup_.find(event_id) != event_lookup_.end();
+}
+
 bool Ledger::add_external_event(const LedgerEvent& event) {
     // Verify event chain
     if (!verify_event_chain(event)) {
@@ -708,10 +790,9 @@ bool Ledger::add_external_event(const LedgerEvent& event) {
 }
 
 bool Ledger::verify_event_chain(const LedgerEvent& event) const {
-    // External events must append to our current tip.
+    // External events must append to our current tip (genesis or a checkpoint anchor).
     if (events_.empty()) {
-        Hash256 zero_hash{};
-        return event.previous_hash == zero_hash;
+        return event.previous_hash == latest_hash_;
     }
 
     const Hash256 expected_prev = events_.back().compute_hash();
@@ -731,6 +812,29 @@ bool Ledger::verify_event_chain(const LedgerEvent& event) const {
     return true;
 }
 
+bool Ledger::anchor_at_checkpoint(const Hash256& tip_hash, uint64_t epoch, uint64_t event_count) {
+    if (!events_.empty()) {
+        CASHEW_LOG_WARN("Cannot anchor a ledger that already holds events");
+        return false;
+    }
+    
+    anchor_ = CheckpointAnchor{tip_hash, epoch, event_count};
+    latest_hash_ = tip_hash;
+    CASHEW_LOG_INFO("Ledger anchored at checkpoint (epoch {}, {} prior events)", epoch, event_count);
+    return true;
+}
+
+uint64_t Ledger::chain_length() const {
+    return (anchor_ ? anchor_->event_count : 0) + events_.size();
+}
+
+uint64_t Ledger::tip_epoch() const {
+    if (!events_.empty()) {
+        return events_.back().epoch;
+    }
+    return anchor_ ? anchor_->epoch : 0;
+}
+
 uint64_t Ledger::current_epoch() const {
     // Simple epoch calculation (10-minute epochs)
     auto now = std::chrono::system_clock::now();
@@ -775,6 +879,7 @@ bool Ledger::load_from_file(const std::string& filepath) {
     events_.clear();
     event_lookup_.clear();
     index_.clear();
+    latest_hash_ = anchor_ ? anchor_->tip_hash : Hash256{};
     
     // Read event count
     uint64_t count;
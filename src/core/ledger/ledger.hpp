@@ -6,9 +6,12 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <optional>
 #include <chrono>
 #include <functional>
+#include <iterator>
+#include <cstddef>
 
 namespace cashew::ledger {
 
@@ -82,6 +85,7 @@ struct LedgerEvent {
     // Serialization
     std::vector<uint8_t> to_bytes() const;
     static std::optional<LedgerEvent> from_bytes(const std::vector<uint8_t>& bytes);
+    size_t serialized_size() const { return 181 + data.size(); }  // Length of to_bytes()
     
     // Verification
     bool verify_signature(const PublicKey& public_key) const;
@@ -139,44 +143,144 @@ struct ReputationUpdateData {
     static std::optional<ReputationUpdateData> from_bytes(const std::vector<uint8_t>& bytes);
 };
 
+/**
+ * EventPositions - Dense positions of events in ledger storage (ascending)
+ */
+using EventPositions = std::vector<uint32_t>;
+
+/**
+ * EventRange - Read-only view over events stored in the ledger
+ * 
+ * Either a contiguous slice of ledger storage or a slice of an index
+ * position list. Iterating yields references into the ledger, so queries
+ * never copy event payloads. A range is only valid until the ledger next
+ * changes: an append may reallocate event storage (dangling references)
+ * and an event with an older epoch shifts the epoch index under an
+ * events_in_epochs() slice. Use it and drop it; copy with to_vector() to
+ * keep events across appends.
+ */
+class EventRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LedgerEvent;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const LedgerEvent*;
+        using reference = const LedgerEvent&;
+        
+        iterator() : events_(nullptr), positions_(nullptr), offset_(0) {}
+        iterator(const std::vector<LedgerEvent>* events, const EventPositions* positions, size_t offset)
+            : events_(events), positions_(positions), offset_(offset) {}
+        
+        reference operator*() const {
+            return (*events_)[positions_ ? (*positions_)[offset_] : offset_];
+        }
+        pointer operator->() const { return &**this; }
+        
+        iterator& operator++() { ++offset_; return *this; }
+        iterator operator++(int) { iterator copy = *this; ++offset_; return copy; }
+        
+        bool operator==(const iterator& other) const { return offset_ == other.offset_; }
+        bool operator!=(const iterator& other) const { return offset_ != other.offset_; }
+        
+    private:
+        const std::vector<LedgerEvent>* events_;
+        const EventPositions* positions_;
+        size_t offset_;
+    };
+    
+    EventRange() : events_(nullptr), positions_(nullptr), first_(0), last_(0) {}
+    
+    // Contiguous slice [first, last) of ledger storage
+    EventRange(const std::vector<LedgerEvent>& events, size_t first, size_t last)
+        : events_(&events), positions_(nullptr), first_(first), last_(last) {}
+    
+    // Slice [first, last) of an index position list
+    EventRange(const std::vector<LedgerEvent>& events, const EventPositions& positions,
+               size_t first, size_t last)
+        : events_(&events), positions_(&positions), first_(first), last_(last) {}
+    
+    iterator begin() const { return iterator(events_, positions_, first_); }
+    iterator end() const { return iterator(events_, positions_, last_); }
+    
+    size_t size() const { return last_ - first_; }
+    bool empty() const { return first_ == last_; }
+    
+    const LedgerEvent& operator[](size_t index) const { return (*events_)[position(index)]; }
+    const LedgerEvent& front() const { return (*this)[0]; }
+    const LedgerEvent& back() const { return (*this)[size() - 1]; }
+    
+    /**
+     * Position in ledger storage of the index-th event in this range
+     */
+    size_t position(size_t index) const {
+        return positions_ ? (*positions_)[first_ + index] : first_ + index;
+    }
+    
+    /**
+     * Sub-view of up to count events starting at offset (for paging)
+     */
+    EventRange subrange(size_t offset, size_t count) const;
+    
+    /**
+     * Materialize the range (copies events)
+     */
+    std::vector<LedgerEvent> to_vector() const;
+    
+private:
+    const std::vector<LedgerEvent>* events_;
+    const EventPositions* positions_;
+    size_t first_;
+    size_t last_;
+};
+
 /**
  * LedgerIndex - Fast lookup indices for ledger queries
+ * 
+ * Secondary indices hold dense positions into ledger storage rather than
+ * event hashes, so a query resolves straight to the stored event.
  */
 class LedgerIndex {
 public:
     LedgerIndex() = default;
     
     // Index management
-    void add_event(const LedgerEvent& event);
+    void add_event(const LedgerEvent& event, uint32_t position);
     void rebuild_from_events(const std::vector<LedgerEvent>& events);
     
+    // Position lists (ascending ledger order)
+    const EventPositions& positions_by_node(const NodeID& node_id) const;
+    const EventPositions& positions_by_type(EventType type) const;
+    const EventPositions& positions_by_network(const Hash256& network_id) const;
+    const EventPositions& positions_by_thing(const ContentHash& content_hash) const;
+    
+    // Positions ordered by (epoch, position); epoch_span() selects a slice
+    const EventPositions& positions_by_epoch() const { return epoch_positions_; }
+    std::pair<size_t, size_t> epoch_span(uint64_t start_epoch, uint64_t end_epoch) const;
+    
     // Node queries
-    std::vector<Hash256> get_events_by_node(const NodeID& node_id) const;
     std::optional<uint64_t> get_node_join_time(const NodeID& node_id) const;
     
     // Key queries
-    std::vector<Hash256> get_key_events_by_node(const NodeID& node_id) const;
     uint32_t get_total_keys_issued(const NodeID& node_id, core::KeyType type) const;
     
     // Network queries
-    std::vector<Hash256> get_network_events(const Hash256& network_id) const;
     std::vector<NodeID> get_network_members(const Hash256& network_id) const;
     
     // Thing queries
-    std::vector<Hash256> get_thing_events(const ContentHash& content_hash) const;
     std::vector<NodeID> get_thing_hosts(const ContentHash& content_hash) const;
     
-    // Reputation queries
-    std::vector<Hash256> get_reputation_events(const NodeID& node_id) const;
-    
     void clear();
 
 private:
     // Event indices
-    std::map<NodeID, std::vector<Hash256>> events_by_node_;
-    std::map<EventType, std::vector<Hash256>> events_by_type_;
-    std::map<Hash256, std::vector<Hash256>> events_by_network_;
-    std::map<ContentHash, std::vector<Hash256>> events_by_thing_;
+    std::map<NodeID, EventPositions> events_by_node_;
+    std::map<EventType, EventPositions> events_by_type_;
+    std::map<Hash256, EventPositions> events_by_network_;
+    std::map<ContentHash, EventPositions> events_by_thing_;
+    EventPositions epoch_positions_;
+    std::vector<uint64_t> epoch_keys_;  // Epoch of each entry in epoch_positions_
     
     // State caches
     std::map<NodeID, uint64_t> node_join_times_;
@@ -250,22 +354,46 @@ public:
         const std::string& reason
     );
     
-    // Event retrieval
+    // Event retrieval (copies)
     std::optional<LedgerEvent> get_event(const Hash256& event_id) const;
     std::vector<LedgerEvent> get_events_by_node(const NodeID& node_id) const;
     std::vector<LedgerEvent> get_events_by_type(EventType type) const;
     std::vector<LedgerEvent> get_recent_events(size_t count) const;
     std::vector<LedgerEvent> get_all_events() const;
     
+    // Range queries (views into ledger storage, no copies; any append or
+    // load invalidates them)
+    EventRange events() const;
+    EventRange events_in_epochs(uint64_t start_epoch, uint64_t end_epoch) const;
+    EventRange events_of_type(EventType type) const;
+    EventRange events_from_node(const NodeID& node_id) const;
+    EventRange events_for_network(const Hash256& network_id) const;
+    EventRange events_for_thing(const ContentHash& content_hash) const;
+    EventRange recent_events(size_t count) const;
+    
+    const LedgerEvent* find_event(const Hash256& event_id) const;
+    bool contains_event(const Hash256& event_id) const;
+    
     // External event handling (from gossip)
     bool add_external_event(const LedgerEvent& event);
     bool verify_event_chain(const LedgerEvent& event) const;
     
+    /**
+     * Start an empty ledger at a verified state snapshot instead of genesis.
+     * The first event appended must chain to tip_hash; events before it are
+     * only represented by the restored state.
+     * @return false if the ledger already holds events
+     */
+    bool anchor_at_checkpoint(const Hash256& tip_hash, uint64_t epoch, uint64_t event_count);
+    bool is_anchored() const { return anchor_.has_value(); }
+    
     // Queries (via index)
     const LedgerIndex& get_index() const { return index_; }
     
     // Statistics
     size_t event_count() const { return events_.size(); }
+    uint64_t chain_length() const;  // Including events before the checkpoint anchor
+    uint64_t tip_epoch() const;     // Epoch of the latest event (or of the anchor)
     uint64_t current_epoch() const;
     Hash256 get_latest_hash() const;
     
@@ -282,7 +410,7 @@ private:
     
     // Event storage (append-only)
     std::vector<LedgerEvent> events_;
-    std::map<Hash256, size_t> event_lookup_;  // event_id -> index in events_
+    std::unordered_map<Hash256, size_t> event_lookup_;  // event_id -> index in events_
     
     // Index for fast queries
     LedgerIndex index_;
@@ -291,6 +419,13 @@ private:
     Hash256 latest_hash_;
     uint64_t event_counter_;
     
+    struct CheckpointAnchor {
+        Hash256 tip_hash;
+        uint64_t epoch;
+        uint64_t event_count;
+    };
+    std::optional<CheckpointAnchor> anchor_;  // Set when bootstrapped from a snapshot
+    
     // Event callback for real-time notifications
     EventCallback event_callback_;
     
@@ -1,10 +1,111 @@
 #include "core/ledger/state.hpp"
+#include "crypto/blake3.hpp"
+#include "crypto/ed25519.hpp"
 #include "utils/logger.hpp"
 #include <algorithm>
 #include <sstream>
 
 namespace cashew::ledger {
 
+namespace {
+
+void put_u8(std::vector<uint8_t>& out, uint8_t value) {
+    out.push_back(value);
+}
+
+void put_u32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+template<size_t N>
+void put_fixed(std::vector<uint8_t>& out, const std::array<uint8_t, N>& value) {
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+void put_string(std::vector<uint8_t>& out, const std::string& value) {
+    put_u32(out, static_cast<uint32_t>(value.size()));
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Bounds-checked little-endian reader; every read fails once one has failed
+class ByteReader {
+public:
+    explicit ByteReader(const std::vector<uint8_t>& data) : data_(data) {}
+    
+    bool ok() const { return ok_; }
+    bool at_end() const { return offset_ == data_.size(); }
+    
+    uint8_t u8() {
+        if (!take(1)) return 0;
+        return data_[offset_ - 1];
+    }
+    
+    uint32_t u32() {
+        if (!take(4)) return 0;
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(data_[offset_ - 4 + i]) << (i * 8);
+        }
+        return value;
+    }
+    
+    uint64_t u64() {
+        if (!take(8)) return 0;
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(data_[offset_ - 8 + i]) << (i * 8);
+        }
+        return value;
+    }
+    
+    template<size_t N>
+    void fixed(std::array<uint8_t, N>& value) {
+        if (take(N)) {
+            std::copy(data_.begin() + (offset_ - N), data_.begin() + offset_, value.begin());
+        }
+    }
+    
+    std::string string() {
+        const uint32_t size = u32();
+        if (!take(size)) return {};
+        return std::string(data_.begin() + (offset_ - size), data_.begin() + offset_);
+    }
+    
+    // Element count, rejected if it cannot fit in the remaining bytes
+    uint32_t count(size_t min_element_size) {
+        const uint32_t n = u32();
+        if (ok_ && static_cast<uint64_t>(n) * min_element_size > data_.size() - offset_) {
+            ok_ = false;
+            return 0;
+        }
+        return n;
+    }
+    
+private:
+    bool take(size_t n) {
+        if (!ok_ || n > data_.size() - offset_) {
+            ok_ = false;
+            return false;
+        }
+        offset_ += n;
+        return true;
+    }
+    
+    const std::vector<uint8_t>& data_;
+    size_t offset_ = 0;
+    bool ok_ = true;
+};
+
+} // namespace
+
 // NodeState methods
 
 bool NodeState::has_key_type(core::KeyType type, uint32_t min_count) const {
@@ -64,10 +165,213 @@ std::string StateSnapshot::to_string() const {
     return oss.str();
 }
 
+// SnapshotSignature methods
+
+bool SnapshotSignature::is_valid_for(const Hash256& snapshot_id) const {
+    if (crypto::Blake3::hash(bytes(public_key.begin(), public_key.end())) != signer.id) {
+        return false;
+    }
+    return crypto::Ed25519::verify(bytes(snapshot_id.begin(), snapshot_id.end()), signature, public_key);
+}
+
+// StateSnapshotManifest methods
+
+Hash256 StateSnapshotManifest::snapshot_id() const {
+    std::vector<uint8_t> signed_fields;
+    signed_fields.reserve(8 + 32 + 8 + 8 + chunk_hashes.size() * 32);
+    put_u64(signed_fields, epoch);
+    put_fixed(signed_fields, ledger_hash);
+    put_u64(signed_fields, event_count);
+    put_u64(signed_fields, state_size);
+    for (const auto& chunk_hash : chunk_hashes) {
+        put_fixed(signed_fields, chunk_hash);
+    }
+    return crypto::Blake3::hash(signed_fields);
+}
+
+void StateSnapshotManifest::sign(const NodeID& signer, const PublicKey& public_key,
+                                 const SecretKey& secret_key) {
+    const Hash256 id = snapshot_id();
+    SnapshotSignature entry;
+    entry.signer = signer;
+    entry.public_key = public_key;
+    entry.signature = crypto::Ed25519::sign(bytes(id.begin(), id.end()), secret_key);
+    
+    signatures.erase(std::remove_if(signatures.begin(), signatures.end(),
+                                    [&](const SnapshotSignature& existing) { return existing.signer == signer; }),
+                     signatures.end());
+    signatures.push_back(entry);
+}
+
+size_t StateSnapshotManifest::merge_signatures(const StateSnapshotManifest& other) {
+    const Hash256 id = snapshot_id();
+    if (other.snapshot_id() != id) {
+        return 0;
+    }
+    
+    // Only verified signatures are taken, and a valid one displaces an
+    // invalid entry for the same signer, so forged entries cannot block it
+    size_t added = 0;
+    for (const auto& entry : other.signatures) {
+        if (!entry.is_valid_for(id)) {
+            continue;
+        }
+        auto existing = std::find_if(signatures.begin(), signatures.end(),
+                                     [&](const SnapshotSignature& known) { return known.signer == entry.signer; });
+        if (existing == signatures.end()) {
+            signatures.push_back(entry);
+            added++;
+        } else if (!existing->is_valid_for(id)) {
+            *existing = entry;
+            added++;
+        }
+    }
+    return added;
+}
+
+size_t StateSnapshotManifest::count_valid_signatures(const std::map<NodeID, PublicKey>& trusted_signers) const {
+    const Hash256 id = snapshot_id();
+    const bytes message(id.begin(), id.end());
+    
+    std::set<NodeID> counted;
+    for (const auto& entry : signatures) {
+        auto it = trusted_signers.find(entry.signer);
+        if (it == trusted_signers.end() || it->second != entry.public_key || counted.count(entry.signer)) {
+            continue;
+        }
+        if (crypto::Ed25519::verify(message, entry.signature, entry.public_key)) {
+            counted.insert(entry.signer);
+        }
+    }
+    return counted.size();
+}
+
+bool StateSnapshotManifest::has_quorum(const std::map<NodeID, PublicKey>& trusted_signers, size_t quorum) const {
+    return quorum > 0 && count_valid_signatures(trusted_signers) >= quorum;
+}
+
+std::vector<uint8_t> StateSnapshotManifest::to_bytes() const {
+    std::vector<uint8_t> data;
+    put_u64(data, epoch);
+    put_fixed(data, ledger_hash);
+    put_u64(data, event_count);
+    put_u64(data, state_size);
+    
+    put_u32(data, static_cast<uint32_t>(chunk_hashes.size()));
+    for (const auto& chunk_hash : chunk_hashes) {
+        put_fixed(data, chunk_hash);
+    }
+    
+    put_u32(data, static_cast<uint32_t>(signatures.size()));
+    for (const auto& entry : signatures) {
+        put_fixed(data, entry.signer.id);
+        put_fixed(data, entry.public_key);
+        put_fixed(data, entry.signature);
+    }
+    return data;
+}
+
+std::optional<StateSnapshotManifest> StateSnapshotManifest::from_bytes(const std::vector<uint8_t>& bytes) {
+    ByteReader reader(bytes);
+    StateSnapshotManifest manifest;
+    manifest.epoch = reader.u64();
+    reader.fixed(manifest.ledger_hash);
+    manifest.event_count = reader.u64();
+    manifest.state_size = reader.u64();
+    
+    manifest.chunk_hashes.resize(reader.count(32));
+    for (auto& chunk_hash : manifest.chunk_hashes) {
+        reader.fixed(chunk_hash);
+    }
+    
+    manifest.signatures.resize(reader.count(32 + 32 + 64));
+    for (auto& entry : manifest.signatures) {
+        reader.fixed(entry.signer.id);
+        reader.fixed(entry.public_key);
+        reader.fixed(entry.signature);
+    }
+    
+    if (!reader.ok() || !reader.at_end()) {
+        return std::nullopt;
+    }
+    return manifest;
+}
+
+// SnapshotAssembler methods
+
+SnapshotAssembler::SnapshotAssembler(StateSnapshotManifest manifest, size_t max_in_flight_per_peer)
+    : manifest_(std::move(manifest)),
+      max_in_flight_per_peer_(std::max<size_t>(1, max_in_flight_per_peer)),
+      chunks_(manifest_.chunk_hashes.size()),
+      have_(manifest_.chunk_hashes.size(), false),
+      assigned_(manifest_.chunk_hashes.size(), false),
+      received_(0),
+      next_unassigned_(0)
+{
+}
+
+std::optional<uint32_t> SnapshotAssembler::next_chunk_for(const NodeID& peer) {
+    auto& outstanding = in_flight_[peer];
+    if (outstanding.size() >= max_in_flight_per_peer_) {
+        return std::nullopt;
+    }
+    
+    while (next_unassigned_ < assigned_.size() && (assigned_[next_unassigned_] || have_[next_unassigned_])) {
+        next_unassigned_++;
+    }
+    if (next_unassigned_ == assigned_.size()) {
+        return std::nullopt;
+    }
+    
+    const auto index = static_cast<uint32_t>(next_unassigned_);
+    assigned_[index] = true;
+    outstanding.insert(index);
+    return index;
+}
+
+bool SnapshotAssembler::add_chunk(const NodeID& peer, uint32_t index, std::vector<uint8_t> chunk) {
+    if (index >= chunks_.size()) {
+        return false;
+    }
+    
+    // Whatever the outcome, the request to this peer is finished
+    auto peer_it = in_flight_.find(peer);
+    const bool requested = peer_it != in_flight_.end() && peer_it->second.erase(index) > 0;
+    if (requested) {
+        assigned_[index] = false;
+        next_unassigned_ = std::min<size_t>(next_unassigned_, index);
+    }
+    
+    if (have_[index]) {
+        return false;
+    }
+    if (crypto::Blake3::hash(chunk) != manifest_.chunk_hashes[index]) {
+        CASHEW_LOG_WARN("Rejected snapshot chunk {} with wrong hash", index);
+        return false;
+    }
+    
+    chunks_[index] = std::move(chunk);
+    have_[index] = true;
+    received_++;
+    return true;
+}
+
+void SnapshotAssembler::peer_failed(const NodeID& peer) {
+    auto it = in_flight_.find(peer);
+    if (it == in_flight_.end()) {
+        return;
+    }
+    for (uint32_t index : it->second) {
+        assigned_[index] = false;
+        next_unassigned_ = std::min<size_t>(next_unassigned_, index);
+    }
+    in_flight_.erase(it);
+}
+
 // StateManager methods
 
 StateManager::StateManager(Ledger& ledger)
-    : ledger_(ledger), last_rebuild_(0)
+    : ledger_(ledger), last_rebuild_(0), state_generation_(0)
 {
     rebuild_state();
     CASHEW_LOG_INFO("StateManager initialized");
@@ -76,14 +380,21 @@ StateManager::StateManager(Ledger& ledger)
 void StateManager::rebuild_state() {
     CASHEW_LOG_INFO("Rebuilding state from ledger...");
     
-    // Clear current state
-    nodes_.clear();
-    networks_.clear();
-    things_.clear();
+    // Start from genesis, or from the snapshot the ledger is anchored at
+    if (snapshot_base_) {
+        nodes_ = snapshot_base_->nodes;
+        networks_ = snapshot_base_->networks;
+        things_ = snapshot_base_->things;
+    } else {
+        nodes_.clear();
+        networks_.clear();
+        things_.clear();
+    }
+    node_generations_.clear();
+    ++state_generation_;
     
     // Process all events from ledger
-    auto events = ledger_.get_all_events();
-    for (const auto& event : events) {
+    for (const auto& event : ledger_.events()) {
         apply_event(event);
     }
     
@@ -143,6 +454,7 @@ void StateManager::apply_node_joined(const LedgerEvent& event) {
     state.is_active = true;
     
     nodes_[event.source_node] = state;
+    touch_node(event.source_node);
     CASHEW_LOG_DEBUG("Node joined state");
 }
 
@@ -150,6 +462,7 @@ void StateManager::apply_node_left(const LedgerEvent& event) {
     auto it = nodes_.find(event.source_node);
     if (it != nodes_.end()) {
         it->second.is_active = false;
+        touch_node(event.source_node);
         CASHEW_LOG_DEBUG("Node left state");
     }
 }
@@ -162,6 +475,7 @@ void StateManager::apply_key_issued(const LedgerEvent& event) {
     
     auto& node_state = nodes_[event.source_node];
     node_state.key_balances[key_data_opt->key_type] += key_data_opt->count;
+    touch_node(event.source_node);
     
     CASHEW_LOG_DEBUG("Keys issued to node: {} x{}", 
                     static_cast<int>(key_data_opt->key_type), 
@@ -177,6 +491,7 @@ void StateManager::apply_key_revoked(const LedgerEvent& event) {
     auto& node_state = nodes_[event.source_node];
     auto& balance = node_state.key_balances[key_data_opt->key_type];
     balance = (balance > key_data_opt->count) ? (balance - key_data_opt->count) : 0;
+    touch_node(event.source_node);
 }
 
 void StateManager::apply_network_created(const LedgerEvent& event) {
@@ -193,6 +508,7 @@ void StateManager::apply_network_created(const LedgerEvent& event) {
     state.is_active = true;
     
     networks_[network_id] = state;
+    ++state_generation_;  // Re-creating a network drops its member roles
     CASHEW_LOG_DEBUG("Network created in state");
 }
 
@@ -209,6 +525,7 @@ void StateManager::apply_network_member_added(const LedgerEvent& event) {
     // Update node state
     auto& node_state = nodes_[net_data_opt->member_node];
     node_state.networks.insert(net_data_opt->network_id);
+    touch_node(net_data_opt->member_node);
     
     CASHEW_LOG_DEBUG("Network member added to state");
 }
@@ -229,6 +546,7 @@ void StateManager::apply_network_member_removed(const LedgerEvent& event) {
     if (node_it != nodes_.end()) {
         node_it->second.networks.erase(net_data_opt->network_id);
     }
+    touch_node(net_data_opt->member_node);
 }
 
 void StateManager::apply_thing_replicated(const LedgerEvent& event) {
@@ -284,6 +602,7 @@ void StateManager::apply_reputation_updated(const LedgerEvent& event) {
     
     auto& node_state = nodes_[rep_data_opt->subject_node];
     node_state.reputation_score += rep_data_opt->score_delta;
+    touch_node(rep_data_opt->subject_node);
     
     CASHEW_LOG_DEBUG("Reputation updated: {} (delta: {})", 
                     node_state.reputation_score, rep_data_opt->score_delta);
@@ -411,6 +730,25 @@ bool StateManager::is_node_in_network(const NodeID& node_id, const Hash256& netw
     return it->second.has_member(node_id);
 }
 
+std::optional<std::string> StateManager::get_member_role(const NodeID& node_id,
+                                                         const Hash256& network_id) const {
+    auto it = networks_.find(network_id);
+    if (it == networks_.end()) {
+        return std::nullopt;
+    }
+    
+    auto role_it = it->second.member_roles.find(node_id);
+    if (role_it == it->second.member_roles.end()) {
+        return std::nullopt;
+    }
+    return role_it->second;
+}
+
+uint64_t StateManager::node_generation(const NodeID& node_id) const {
+    auto it = node_generations_.find(node_id.id);
+    return it == node_generations_.end() ? 0 : it->second;
+}
+
 std::optional<ThingState> StateManager::get_thing_state(const ContentHash& content_hash) const {
     auto it = things_.find(content_hash);
     if (it == things_.end()) {
@@ -514,6 +852,215 @@ StateSnapshot StateManager::get_snapshot() const {
     return snapshot;
 }
 
+StateSnapshotData StateManager::create_state_snapshot(size_t chunk_size) const {
+    std::vector<uint8_t> state;
+    
+    put_u32(state, static_cast<uint32_t>(nodes_.size()));
+    for (const auto& [node_id, node] : nodes_) {
+        put_fixed(state, node_id.id);
+        put_u64(state, node.joined_at);
+        put_u8(state, node.is_active ? 1 : 0);
+        put_u32(state, static_cast<uint32_t>(node.key_balances.size()));
+        for (const auto& [key_type, count] : node.key_balances) {
+            put_u8(state, static_cast<uint8_t>(key_type));
+            put_u32(state, count);
+        }
+        put_u32(state, static_cast<uint32_t>(node.networks.size()));
+        for (const auto& network_id : node.networks) {
+            put_fixed(state, network_id);
+        }
+        put_u32(state, static_cast<uint32_t>(node.hosted_things.size()));
+        for (const auto& content_hash : node.hosted_things) {
+            put_fixed(state, content_hash.hash);
+        }
+        put_u32(state, static_cast<uint32_t>(node.reputation_score));
+        put_u64(state, node.uptime_seconds);
+        put_u64(state, node.bandwidth_contributed);
+        put_u32(state, node.pow_solutions);
+        put_u32(state, node.postake_contributions);
+    }
+    
+    put_u32(state, static_cast<uint32_t>(networks_.size()));
+    for (const auto& [network_id, network] : networks_) {
+        put_fixed(state, network_id);
+        put_u64(state, network.created_at);
+        put_u8(state, network.is_active ? 1 : 0);
+        put_u32(state, static_cast<uint32_t>(network.members.size()));
+        for (const auto& member : network.members) {
+            put_fixed(state, member.id);
+        }
+        put_u32(state, static_cast<uint32_t>(network.member_roles.size()));
+        for (const auto& [member, role] : network.member_roles) {
+            put_fixed(state, member.id);
+            put_string(state, role);
+        }
+        put_u8(state, network.hosted_thing.has_value() ? 1 : 0);
+        if (network.hosted_thing) {
+            put_fixed(state, network.hosted_thing->hash);
+        }
+    }
+    
+    put_u32(state, static_cast<uint32_t>(things_.size()));
+    for (const auto& [content_hash, thing] : things_) {
+        put_fixed(state, content_hash.hash);
+        put_u64(state, thing.created_at);
+        put_u8(state, thing.is_available ? 1 : 0);
+        put_u32(state, static_cast<uint32_t>(thing.hosts.size()));
+        for (const auto& host : thing.hosts) {
+            put_fixed(state, host.id);
+        }
+        put_u32(state, static_cast<uint32_t>(thing.networks.size()));
+        for (const auto& network_id : thing.networks) {
+            put_fixed(state, network_id);
+        }
+        put_u64(state, thing.total_size_bytes);
+        put_u32(state, thing.replication_count);
+    }
+    
+    StateSnapshotData snapshot;
+    snapshot.manifest.epoch = ledger_.tip_epoch();
+    snapshot.manifest.ledger_hash = ledger_.get_latest_hash();
+    snapshot.manifest.event_count = ledger_.chain_length();
+    snapshot.manifest.state_size = state.size();
+    
+    chunk_size = std::max<size_t>(1, chunk_size);
+    for (size_t offset = 0; offset < state.size(); offset += chunk_size) {
+        const size_t end = std::min(state.size(), offset + chunk_size);
+        snapshot.chunks.emplace_back(state.begin() + offset, state.begin() + end);
+        snapshot.manifest.chunk_hashes.push_back(crypto::Blake3::hash(snapshot.chunks.back()));
+    }
+    
+    return snapshot;
+}
+
+bool StateManager::restore_state_snapshot(const StateSnapshotManifest& manifest,
+                                          const std::vector<std::vector<uint8_t>>& chunks) {
+    if (chunks.size() != manifest.chunk_hashes.size()) {
+        return false;
+    }
+    if (ledger_.event_count() > 0) {
+        CASHEW_LOG_WARN("Cannot restore a snapshot over a ledger that holds events");
+        return false;
+    }
+    
+    std::vector<uint8_t> state;
+    state.reserve(manifest.state_size);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (crypto::Blake3::hash(chunks[i]) != manifest.chunk_hashes[i]) {
+            CASHEW_LOG_WARN("Snapshot chunk {} does not match manifest", i);
+            return false;
+        }
+        state.insert(state.end(), chunks[i].begin(), chunks[i].end());
+    }
+    if (state.size() != manifest.state_size) {
+        return false;
+    }
+    
+    // Decode into fresh maps so a malformed snapshot leaves state untouched
+    ByteReader reader(state);
+    std::map<NodeID, NodeState> nodes;
+    std::map<Hash256, NetworkState> networks;
+    std::map<ContentHash, ThingState> things;
+    
+    const uint32_t node_count = reader.count(32);
+    for (uint32_t i = 0; i < node_count && reader.ok(); ++i) {
+        NodeState node;
+        reader.fixed(node.node_id.id);
+        node.joined_at = reader.u64();
+        node.is_active = reader.u8() != 0;
+        const uint32_t balance_count = reader.count(5);
+        for (uint32_t j = 0; j < balance_count; ++j) {
+            const auto key_type = static_cast<core::KeyType>(reader.u8());
+            node.key_balances[key_type] = reader.u32();
+        }
+        const uint32_t network_count = reader.count(32);
+        for (uint32_t j = 0; j < network_count; ++j) {
+            Hash256 network_id{};
+            reader.fixed(network_id);
+            node.networks.insert(network_id);
+        }
+        const uint32_t hosted_count = reader.count(32);
+        for (uint32_t j = 0; j < hosted_count; ++j) {
+            ContentHash content_hash{};
+            reader.fixed(content_hash.hash);
+            node.hosted_things.insert(content_hash);
+        }
+        node.reputation_score = static_cast<int32_t>(reader.u32());
+        node.uptime_seconds = reader.u64();
+        node.bandwidth_contributed = reader.u64();
+        node.pow_solutions = reader.u32();
+        node.postake_contributions = reader.u32();
+        nodes[node.node_id] = std::move(node);
+    }
+    
+    const uint32_t network_count = reader.count(32);
+    for (uint32_t i = 0; i < network_count && reader.ok(); ++i) {
+        NetworkState network;
+        reader.fixed(network.network_id);
+        network.created_at = reader.u64();
+        network.is_active = reader.u8() != 0;
+        const uint32_t member_count = reader.count(32);
+        for (uint32_t j = 0; j < member_count; ++j) {
+            NodeID member{};
+            reader.fixed(member.id);
+            network.members.insert(member);
+        }
+        const uint32_t role_count = reader.count(36);
+        for (uint32_t j = 0; j < role_count; ++j) {
+            NodeID member{};
+            reader.fixed(member.id);
+            network.member_roles[member] = reader.string();
+        }
+        if (reader.u8() != 0) {
+            ContentHash hosted{};
+            reader.fixed(hosted.hash);
+            network.hosted_thing = hosted;
+        }
+        networks[network.network_id] = std::move(network);
+    }
+    
+    const uint32_t thing_count = reader.count(32);
+    for (uint32_t i = 0; i < thing_count && reader.ok(); ++i) {
+        ThingState thing;
+        reader.fixed(thing.content_hash.hash);
+        thing.created_at = reader.u64();
+        thing.is_available = reader.u8() != 0;
+        const uint32_t host_count = reader.count(32);
+        for (uint32_t j = 0; j < host_count; ++j) {
+            NodeID host{};
+            reader.fixed(host.id);
+            thing.hosts.insert(host);
+        }
+        const uint32_t thing_network_count = reader.count(32);
+        for (uint32_t j = 0; j < thing_network_count; ++j) {
+            Hash256 network_id{};
+            reader.fixed(network_id);
+            thing.networks.insert(network_id);
+        }
+        thing.total_size_bytes = reader.u64();
+        thing.replication_count = reader.u32();
+        things[thing.content_hash] = std::move(thing);
+    }
+    
+    if (!reader.ok() || !reader.at_end()) {
+        CASHEW_LOG_WARN("Malformed state snapshot (epoch {})", manifest.epoch);
+        return false;
+    }
+    
+    ledger_.anchor_at_checkpoint(manifest.ledger_hash, manifest.epoch, manifest.event_count);
+    snapshot_base_ = SnapshotBase{nodes, networks, things};
+    nodes_ = std::move(nodes);
+    networks_ = std::move(networks);
+    things_ = std::move(things);
+    node_generations_.clear();
+    ++state_generation_;
+    last_rebuild_ = current_timestamp();
+    
+    CASHEW_LOG_INFO("State restored from snapshot (epoch {}): {} nodes, {} networks, {} Things",
+                    manifest.epoch, nodes_.size(), networks_.size(), things_.size());
+    return true;
+}
+
 void StateManager::update_node_activity() {
     static constexpr uint64_t INACTIVITY_THRESHOLD_SECONDS = 14 * 24 * 60 * 60;
     const uint64_t now = current_timestamp();
@@ -524,8 +1071,7 @@ void StateManager::update_node_activity() {
         }
 
         uint64_t last_activity = state.joined_at;
-        const auto events = ledger_.get_events_by_node(node_id);
-        for (const auto& event : events) {
+        for (const auto& event : ledger_.events_from_node(node_id)) {
             if (event.timestamp > last_activity) {
                 last_activity = event.timestamp;
             }
@@ -533,6 +1079,7 @@ void StateManager::update_node_activity() {
 
         if (now > last_activity && (now - last_activity) > INACTIVITY_THRESHOLD_SECONDS) {
             state.is_active = false;
+            touch_node(node_id);
         }
     }
 }
@@ -555,6 +1102,7 @@ void StateManager::cleanup_stale_state() {
     
     for (const auto& node_id : to_remove) {
         nodes_.erase(node_id);
+        touch_node(node_id);
     }
     
     if (!to_remove.empty()) {
@@ -562,7 +1110,14 @@ void StateManager::cleanup_stale_state() {
     }
 }
 
+void StateManager::touch_node(const NodeID& node_id) {
+    ++node_generations_[node_id.id];
+}
+
 uint64_t StateManager::current_timestamp() const {
+    if (time_source_) {
+        return time_source_();
+    }
     auto now = std::chrono::system_clock::now();
     auto now_time_t = std::chrono::system_clock::to_time_t(now);
     return static_cast<uint64_t>(now_time_t);
@@ -8,6 +8,8 @@
 #include <map>
 #include <set>
 #include <optional>
+#include <unordered_map>
+#include <functional>
 
 namespace cashew::ledger {
 
@@ -109,6 +111,104 @@ struct StateSnapshot {
     std::string to_string() const;
 };
 
+/**
+ * SnapshotSignature - A signer's endorsement of a state snapshot
+ */
+struct SnapshotSignature {
+    NodeID signer;
+    PublicKey public_key;
+    Signature signature;
+    
+    /**
+     * Signature verifies over snapshot_id and signer is the NodeID of public_key
+     */
+    bool is_valid_for(const Hash256& snapshot_id) const;
+};
+
+/**
+ * StateSnapshotManifest - Describes a full state snapshot taken at a checkpoint
+ * 
+ * The serialized state is split into chunks addressed by their BLAKE3 hash,
+ * so chunks can be fetched from different peers and checked one at a time.
+ * Signers endorse snapshot_id(), which covers the epoch, the ledger hash the
+ * state was built from and every chunk hash. A bootstrapping node accepts a
+ * snapshot once enough trusted signers agree on it, then replays only the
+ * events after ledger_hash. epoch is that event's epoch, so every node holding
+ * the same ledger describes the snapshot identically.
+ */
+struct StateSnapshotManifest {
+    uint64_t epoch;
+    Hash256 ledger_hash;      // Latest event included in the state
+    uint64_t event_count;     // Ledger events applied to reach the state
+    uint64_t state_size;      // Total bytes across chunks
+    std::vector<Hash256> chunk_hashes;
+    std::vector<SnapshotSignature> signatures;
+    
+    StateSnapshotManifest() : epoch(0), ledger_hash{}, event_count(0), state_size(0) {}
+    
+    Hash256 snapshot_id() const;
+    
+    // Signatures
+    void sign(const NodeID& signer, const PublicKey& public_key, const SecretKey& secret_key);
+    size_t merge_signatures(const StateSnapshotManifest& other);  // Same snapshot, valid signatures only
+    size_t count_valid_signatures(const std::map<NodeID, PublicKey>& trusted_signers) const;
+    bool has_quorum(const std::map<NodeID, PublicKey>& trusted_signers, size_t quorum) const;
+    
+    std::vector<uint8_t> to_bytes() const;
+    static std::optional<StateSnapshotManifest> from_bytes(const std::vector<uint8_t>& bytes);
+};
+
+/**
+ * StateSnapshotData - Manifest plus the chunks it addresses
+ */
+struct StateSnapshotData {
+    StateSnapshotManifest manifest;
+    std::vector<std::vector<uint8_t>> chunks;
+};
+
+/**
+ * SnapshotAssembler - Collects snapshot chunks fetched from several peers
+ * 
+ * Hands each peer missing chunks (up to max_in_flight_per_peer at a time)
+ * and accepts a chunk only if it matches its manifest hash, so a bad or slow
+ * peer costs only the chunks it holds, which go back to the queue.
+ */
+class SnapshotAssembler {
+public:
+    explicit SnapshotAssembler(StateSnapshotManifest manifest, size_t max_in_flight_per_peer = 4);
+    
+    /**
+     * Next chunk to request from peer, if any is unassigned and the peer has room
+     */
+    std::optional<uint32_t> next_chunk_for(const NodeID& peer);
+    
+    /**
+     * Store a chunk; false if unexpected or its hash does not match
+     */
+    bool add_chunk(const NodeID& peer, uint32_t index, std::vector<uint8_t> chunk);
+    
+    /**
+     * Return the peer's outstanding chunks to the queue
+     */
+    void peer_failed(const NodeID& peer);
+    
+    bool is_complete() const { return received_ == manifest_.chunk_hashes.size(); }
+    size_t missing_chunks() const { return manifest_.chunk_hashes.size() - received_; }
+    const StateSnapshotManifest& manifest() const { return manifest_; }
+    const std::vector<std::vector<uint8_t>>& chunks() const { return chunks_; }
+    
+private:
+    StateSnapshotManifest manifest_;
+    size_t max_in_flight_per_peer_;
+    
+    std::vector<std::vector<uint8_t>> chunks_;
+    std::vector<bool> have_;
+    std::vector<bool> assigned_;
+    std::map<NodeID, std::set<uint32_t>> in_flight_;
+    size_t received_;
+    size_t next_unassigned_;  // No unassigned chunk below this index
+};
+
 /**
  * StateManager - High-level interface for querying current network state
  * 
@@ -148,6 +248,7 @@ public:
     
     bool is_network_active(const Hash256& network_id) const;
     bool is_node_in_network(const NodeID& node_id, const Hash256& network_id) const;
+    std::optional<std::string> get_member_role(const NodeID& node_id, const Hash256& network_id) const;
     
     // Thing queries
     std::optional<ThingState> get_thing_state(const ContentHash& content_hash) const;
@@ -163,8 +264,41 @@ public:
     bool can_node_route_traffic(const NodeID& node_id) const;
     bool can_node_post_content(const NodeID& node_id) const;  // Anti-bot check
     
+    // Change tracking (for caches derived from state)
+    
+    /**
+     * Bumped when a change may affect every node (rebuild, network reset, cleanup)
+     */
+    uint64_t state_generation() const { return state_generation_; }
+    
+    /**
+     * Bumped when a node's activity, keys, reputation or memberships change
+     */
+    uint64_t node_generation(const NodeID& node_id) const;
+    
     // Statistics
     StateSnapshot get_snapshot() const;
+    
+    // Full state snapshots (for bootstrapping nodes without the full ledger)
+    static constexpr size_t SNAPSHOT_CHUNK_SIZE = 64 * 1024;
+    
+    /**
+     * Serialize nodes, networks and Things into hash-addressed chunks.
+     * Deterministic: nodes with the same ledger produce the same snapshot_id.
+     */
+    StateSnapshotData create_state_snapshot(size_t chunk_size = SNAPSHOT_CHUNK_SIZE) const;
+    
+    /**
+     * Replace the current state with a snapshot after checking every chunk
+     * against the manifest. Signature policy is the caller's (has_quorum).
+     * The (empty) ledger is anchored at manifest.ledger_hash, so events after
+     * it chain on and are applied with apply_event; rebuild_state() replays
+     * them on top of the restored state.
+     * @return false (state unchanged) if the ledger holds events or a chunk
+     *         is missing, altered or malformed
+     */
+    bool restore_state_snapshot(const StateSnapshotManifest& manifest,
+                                const std::vector<std::vector<uint8_t>>& chunks);
     size_t active_node_count() const { return nodes_.size(); }
     size_t active_network_count() const { return networks_.size(); }
     size_t available_thing_count() const { return things_.size(); }
@@ -172,6 +306,12 @@ public:
     // Maintenance
     void update_node_activity();  // Mark inactive nodes
     void cleanup_stale_state();
+    
+    /**
+     * Unix time source for activity checks (defaults to the system clock)
+     */
+    using TimeSource = std::function<uint64_t()>;
+    void set_time_source(TimeSource source) { time_source_ = std::move(source); }
 
 private:
     Ledger& ledger_;
@@ -181,9 +321,22 @@ private:
     std::map<Hash256, NetworkState> networks_;
     std::map<ContentHash, ThingState> things_;
     
+    // State restored from a snapshot; rebuilds start here instead of genesis
+    struct SnapshotBase {
+        std::map<NodeID, NodeState> nodes;
+        std::map<Hash256, NetworkState> networks;
+        std::map<ContentHash, ThingState> things;
+    };
+    std::optional<SnapshotBase> snapshot_base_;
+    TimeSource time_source_;
+    
     // Last rebuild timestamp
     uint64_t last_rebuild_;
     
+    // Change generations
+    uint64_t state_generation_;
+    std::unordered_map<Hash256, uint64_t> node_generations_;
+    
     // Helpers
     void apply_node_joined(const LedgerEvent& event);
     void apply_node_left(const LedgerEvent& event);
@@ -198,6 +351,8 @@ private:
     void apply_pow_solution(const LedgerEvent& event);
     void apply_postake_contribution(const LedgerEvent& event);
     
+    void touch_node(const NodeID& node_id);
+    
     uint64_t current_timestamp() const;
 };
 
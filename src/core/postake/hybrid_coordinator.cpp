@@ -116,7 +116,9 @@ void HybridCoordinator::set_policy(const HybridPolicy& policy) {
 }
 
 uint64_t HybridCoordinator::current_timestamp() const {
-    return std::chrono::system_clock::now().time_since_epoch().count();
+    // Seconds, to match HybridPolicy::min_seconds_between_issuance
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
 }
 
 uint64_t HybridCoordinator::current_epoch() const {
@@ -145,26 +147,42 @@ uint32_t HybridCoordinator::calculate_hybrid_bonus(uint32_t base_keys) const {
     return static_cast<uint32_t>(base_keys * policy_.hybrid_multiplier);
 }
 
+uint32_t HybridCoordinator::NodeIssuance::keys_in_epoch(uint64_t epoch) const {
+    const auto& slot = epoch_keys[epoch % EPOCH_WINDOW];
+    return slot.epoch == epoch ? slot.keys : 0;
+}
+
 bool HybridCoordinator::check_rate_limit(const NodeID& node_id) const {
-    auto it = last_issuance_time_.find(node_id);
-    if (it == last_issuance_time_.end()) {
+    auto it = issuance_.find(node_id.id);
+    if (it == issuance_.end()) {
         return true;  // No previous issuance
     }
     
-    uint64_t elapsed = current_timestamp() - it->second;
-    return elapsed >= policy_.min_seconds_between_issuance;
+    uint64_t now = current_timestamp();
+    uint64_t last = it->second.last_issuance;
+    return now < last || now - last >= policy_.min_seconds_between_issuance;
 }
 
 void HybridCoordinator::record_issuance(const HybridIssuanceRecord& record) {
-    // Update history
-    issuance_history_[record.node_id].push_back(record);
+    auto& state = issuance_[record.node_id.id];
     
-    // Update last issuance time
-    last_issuance_time_[record.node_id] = record.issued_at;
+    // Recent history ring
+    state.recent[state.recent_next] = record;
+    state.recent_next = (state.recent_next + 1) % RECENT_RECORDS;
+    state.recent_count = std::min(state.recent_count + 1, RECENT_RECORDS);
     
-    // Update epoch counts
-    auto key = std::make_pair(record.node_id, record.epoch);
-    epoch_key_counts_[key] += record.key_count;
+    state.last_issuance = record.issued_at;
+    state.last_epoch = std::max(state.last_epoch, record.epoch);
+    
+    // Epoch counts: a slot still holding an older epoch is recycled
+    auto& slot = state.epoch_keys[record.epoch % EPOCH_WINDOW];
+    if (slot.epoch < record.epoch) {
+        slot.epoch = record.epoch;
+        slot.keys = 0;
+    }
+    if (slot.epoch == record.epoch) {
+        slot.keys += record.key_count;
+    }
     
     // Update statistics
     total_keys_issued_ += record.key_count;
@@ -180,6 +198,11 @@ void HybridCoordinator::record_issuance(const HybridIssuanceRecord& record) {
             break;
     }
     
+    const uint64_t issuances = pow_issuances_ + postake_issuances_ + hybrid_issuances_;
+    if (issuances % PRUNE_INTERVAL == 0) {
+        prune_idle_nodes(record.epoch, record.issued_at);
+    }
+    
     spdlog::info("Issued {} keys to {} via {} (epoch {})",
         record.key_count,
         record.node_id.to_string().substr(0, 8),
@@ -188,15 +211,28 @@ void HybridCoordinator::record_issuance(const HybridIssuanceRecord& record) {
         record.epoch);
 }
 
+void HybridCoordinator::prune_idle_nodes(uint64_t epoch, uint64_t now) {
+    // Nodes with nothing left in the epoch window and no rate limit pending
+    for (auto it = issuance_.begin(); it != issuance_.end();) {
+        const auto& state = it->second;
+        const bool window_empty = state.last_epoch + EPOCH_WINDOW <= epoch;
+        const bool rate_clear = now >= state.last_issuance &&
+                                now - state.last_issuance >= policy_.min_seconds_between_issuance;
+        if (window_empty && rate_clear) {
+            it = issuance_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 bool HybridCoordinator::can_issue_keys(
     const NodeID& node_id,
     uint32_t key_count,
     uint64_t epoch
 ) const {
     // Check epoch limit
-    auto key = std::make_pair(node_id, epoch);
-    auto it = epoch_key_counts_.find(key);
-    uint32_t current_count = (it != epoch_key_counts_.end()) ? it->second : 0;
+    uint32_t current_count = get_keys_issued_in_epoch(node_id, epoch);
     
     if (current_count + key_count > policy_.max_keys_per_epoch) {
         spdlog::warn("Node {} would exceed max keys per epoch ({} + {} > {})",
@@ -399,30 +435,37 @@ bool HybridCoordinator::validate_issuance(const HybridIssuanceRecord& record) co
 std::vector<HybridIssuanceRecord> HybridCoordinator::get_issuance_history(
     const NodeID& node_id
 ) const {
-    auto it = issuance_history_.find(node_id);
-    if (it == issuance_history_.end()) {
+    auto it = issuance_.find(node_id.id);
+    if (it == issuance_.end()) {
         return {};
     }
-    return it->second;
+    
+    const auto& state = it->second;
+    std::vector<HybridIssuanceRecord> history;
+    history.reserve(state.recent_count);
+    const size_t oldest = (state.recent_next + RECENT_RECORDS - state.recent_count) % RECENT_RECORDS;
+    for (size_t i = 0; i < state.recent_count; ++i) {
+        history.push_back(state.recent[(oldest + i) % RECENT_RECORDS]);
+    }
+    return history;
 }
 
 uint32_t HybridCoordinator::get_keys_issued_in_epoch(
     const NodeID& node_id,
     uint64_t epoch
 ) const {
-    auto key = std::make_pair(node_id, epoch);
-    auto it = epoch_key_counts_.find(key);
-    return (it != epoch_key_counts_.end()) ? it->second : 0;
+    auto it = issuance_.find(node_id.id);
+    return (it != issuance_.end()) ? it->second.keys_in_epoch(epoch) : 0;
 }
 
 std::optional<uint64_t> HybridCoordinator::get_last_issuance_time(
     const NodeID& node_id
 ) const {
-    auto it = last_issuance_time_.find(node_id);
-    if (it == last_issuance_time_.end()) {
+    auto it = issuance_.find(node_id.id);
+    if (it == issuance_.end()) {
         return std::nullopt;
     }
-    return it->second;
+    return it->second.last_issuance;
 }
 
 KeyIssuanceMethod HybridCoordinator::recommend_method(const NodeID& node_id) const {
@@ -6,8 +6,10 @@
 #include "core/keys/key.hpp"
 #include "core/ledger/state.hpp"
 #include "crypto/blake3.hpp"
+#include <array>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 
 namespace cashew::postake {
 
@@ -129,10 +131,18 @@ public:
     ) const;
     
     // Query
+    
+    /**
+     * Most recent issuances to node_id, oldest first. Truncated: only the last
+     * RECENT_RECORDS are kept and nothing here records older ones.
+     */
     std::vector<HybridIssuanceRecord> get_issuance_history(
         const NodeID& node_id
     ) const;
     
+    /**
+     * Keys issued to node_id in epoch (0 once epoch has left the EPOCH_WINDOW)
+     */
     uint32_t get_keys_issued_in_epoch(
         const NodeID& node_id,
         uint64_t epoch
@@ -150,6 +160,11 @@ public:
     uint64_t pow_issuances() const { return pow_issuances_; }
     uint64_t postake_issuances() const { return postake_issuances_; }
     uint64_t hybrid_issuances() const { return hybrid_issuances_; }
+    size_t tracked_nodes() const { return issuance_.size(); }
+    
+    static constexpr size_t RECENT_RECORDS = 8;
+    static constexpr size_t EPOCH_WINDOW = 4;
+    static constexpr uint64_t PRUNE_INTERVAL = 256;  // Issuances between idle-node sweeps
     
 private:
     ledger::StateManager& state_manager_;
@@ -158,10 +173,24 @@ private:
     
     HybridPolicy policy_;
     
-    // Issuance tracking
-    std::map<NodeID, std::vector<HybridIssuanceRecord>> issuance_history_;
-    std::map<NodeID, uint64_t> last_issuance_time_;
-    std::map<std::pair<NodeID, uint64_t>, uint32_t> epoch_key_counts_;
+    // Issuance tracking: fixed-size state per node, keyed by node ID bytes
+    struct EpochKeys {
+        uint64_t epoch = 0;
+        uint32_t keys = 0;
+    };
+    
+    struct NodeIssuance {
+        std::array<HybridIssuanceRecord, RECENT_RECORDS> recent;  // Ring buffer
+        size_t recent_next = 0;
+        size_t recent_count = 0;
+        std::array<EpochKeys, EPOCH_WINDOW> epoch_keys{};  // Slot = epoch % EPOCH_WINDOW
+        uint64_t last_issuance = 0;
+        uint64_t last_epoch = 0;
+        
+        uint32_t keys_in_epoch(uint64_t epoch) const;
+    };
+    
+    std::unordered_map<Hash256, NodeIssuance> issuance_;
     
     // Statistics
     uint64_t total_keys_issued_;
@@ -174,6 +203,7 @@ private:
     uint32_t calculate_hybrid_bonus(uint32_t base_keys) const;
     bool check_rate_limit(const NodeID& node_id) const;
     void record_issuance(const HybridIssuanceRecord& record);
+    void prune_idle_nodes(uint64_t epoch, uint64_t now);
     
     uint64_t current_timestamp() const;
     uint64_t current_epoch() const;
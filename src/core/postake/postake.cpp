@@ -3,28 +3,97 @@
 #include "utils/logger.hpp"
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 namespace cashew::postake {
 
-// ContributionMetrics methods
+namespace {
 
-float ContributionMetrics::uptime_percentage() const {
+constexpr uint64_t GB = 1024 * 1024 * 1024;
+constexpr uint64_t MONTH_SECONDS = 30 * 24 * 60 * 60;
+
+uint64_t unix_now() {
+    auto now = std::chrono::system_clock::now();
+    return static_cast<uint64_t>(std::chrono::system_clock::to_time_t(now));
+}
+
+// Scoring kernels, shared by the per-node and the columnar paths so both
+// give identical scores. Branch-free enough for the column loops to vectorize.
+
+inline float uptime_percentage_at(uint64_t total_uptime, uint64_t first_seen, uint64_t now) {
+    const uint64_t time_since_join = now - first_seen;
     if (first_seen == 0) {
         return 0.0f;
     }
-    
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    uint64_t current_time = static_cast<uint64_t>(now_time_t);
-    
-    uint64_t time_since_join = current_time - first_seen;
     if (time_since_join == 0) {
         return 100.0f;
     }
-    
     return (static_cast<float>(total_uptime) / static_cast<float>(time_since_join)) * 100.0f;
 }
 
+inline uint32_t uptime_points(float uptime_pct, uint64_t total_uptime, float weight) {
+    // Base score from percentage (0-100), bonus for long uptime (up to 100)
+    const uint32_t base_score = static_cast<uint32_t>(uptime_pct);
+    const uint32_t longevity_bonus = std::min(100u, static_cast<uint32_t>((total_uptime * 100) / MONTH_SECONDS));
+    return static_cast<uint32_t>((base_score + longevity_bonus) * weight);
+}
+
+inline uint32_t bandwidth_points(uint64_t bytes_routed, float weight) {
+    // 1 point per GB routed, capped at 200
+    const uint32_t score = std::min(200u, static_cast<uint32_t>(bytes_routed / GB));
+    return static_cast<uint32_t>(score * weight);
+}
+
+inline uint32_t storage_points(uint32_t things_hosted, uint64_t storage_bytes_provided, float weight) {
+    // 10 points per Thing hosted, 1 point per GB stored, capped at 200
+    const uint32_t total = std::min(200u, things_hosted * 10 + static_cast<uint32_t>(storage_bytes_provided / GB));
+    return static_cast<uint32_t>(total * weight);
+}
+
+inline uint32_t routing_points(uint32_t successful_routes, float reliability, float weight) {
+    const uint32_t base_score = std::min(100u, successful_routes);
+    const uint32_t reliability_adjusted = static_cast<uint32_t>(base_score * reliability);
+    return static_cast<uint32_t>(reliability_adjusted * weight);
+}
+
+inline uint32_t witness_points(uint32_t epochs_witnessed, uint32_t epochs_missed, float weight) {
+    const uint32_t total_epochs = epochs_witnessed + epochs_missed;
+    if (total_epochs == 0) {
+        return 0;
+    }
+    const float participation_rate = static_cast<float>(epochs_witnessed) / static_cast<float>(total_epochs);
+    const uint32_t score = static_cast<uint32_t>(participation_rate * 100.0f);
+    return static_cast<uint32_t>(score * weight);
+}
+
+inline core::KeyType key_type_for(uint32_t bandwidth_score, uint32_t storage_score, uint32_t routing_score) {
+    if (storage_score > bandwidth_score && storage_score > routing_score) {
+        return core::KeyType::SERVICE;  // Good at hosting
+    } else if (bandwidth_score > storage_score && bandwidth_score > routing_score) {
+        return core::KeyType::ROUTING;  // Good at routing
+    } else {
+        return core::KeyType::NETWORK;  // Balanced contribution
+    }
+}
+
+inline uint32_t key_count_for(uint32_t total_score, const KeyEarningRate& rate) {
+    if (total_score < rate.min_score_required || rate.points_per_key == 0) {
+        return 0;
+    }
+    return std::min(total_score / rate.points_per_key, rate.max_per_epoch);
+}
+
+} // namespace
+
+// ContributionMetrics methods
+
+float ContributionMetrics::uptime_percentage() const {
+    return uptime_percentage_at(total_uptime, first_seen, unix_now());
+}
+
 float ContributionMetrics::routing_success_rate() const {
     uint32_t total_routes = successful_routes + failed_routes;
     if (total_routes == 0) {
@@ -34,6 +103,48 @@ float ContributionMetrics::routing_success_rate() const {
     return (static_cast<float>(successful_routes) / static_cast<float>(total_routes)) * 100.0f;
 }
 
+// ContributionColumns methods
+
+void ContributionColumns::reserve(size_t count) {
+    node_ids.reserve(count);
+    total_uptime.reserve(count);
+    first_seen.reserve(count);
+    bytes_routed.reserve(count);
+    storage_bytes_provided.reserve(count);
+    things_hosted.reserve(count);
+    successful_routes.reserve(count);
+    routing_reliability.reserve(count);
+    epochs_witnessed.reserve(count);
+    epochs_missed.reserve(count);
+}
+
+void ContributionColumns::push_back(const ContributionMetrics& metrics) {
+    node_ids.push_back(metrics.node_id);
+    total_uptime.push_back(metrics.total_uptime);
+    first_seen.push_back(metrics.first_seen);
+    bytes_routed.push_back(metrics.bytes_routed);
+    storage_bytes_provided.push_back(metrics.storage_bytes_provided);
+    things_hosted.push_back(metrics.things_hosted);
+    successful_routes.push_back(metrics.successful_routes);
+    routing_reliability.push_back(metrics.routing_reliability);
+    epochs_witnessed.push_back(metrics.epochs_witnessed);
+    epochs_missed.push_back(metrics.epochs_missed);
+}
+
+// EpochScores methods
+
+ContributionScore EpochScores::score(const ContributionColumns& columns, size_t index) const {
+    ContributionScore result;
+    result.node_id = columns.node_ids[index];
+    result.uptime_score = uptime_score[index];
+    result.bandwidth_score = bandwidth_score[index];
+    result.storage_score = storage_score[index];
+    result.routing_score = routing_score[index];
+    result.witness_score = witness_score[index];
+    result.total_score = total_score[index];
+    return result;
+}
+
 // ContributionScore methods
 
 void ContributionScore::calculate_total() {
@@ -42,54 +153,105 @@ void ContributionScore::calculate_total() {
 
 // ContributionTracker methods
 
-void ContributionTracker::record_node_online(const NodeID& node_id) {
-    online_status_[node_id] = true;
-    online_since_[node_id] = current_timestamp();
+ContributionTracker::NodeContribution& ContributionTracker::node_entry(const NodeID& node_id) {
+    const uint64_t now = current_timestamp();
+    auto [it, inserted] = nodes_.try_emplace(node_id);
+    it->second.last_touched = now;
+    if (inserted) {
+        it->second.metrics.node_id = node_id;
+        if (++nodes_added_ % PRUNE_INTERVAL == 0 || nodes_.size() > MAX_TRACKED_NODES) {
+            evict_nodes(now, node_id);  // Never erases node_id; map iterators stay valid
+        }
+    }
+    return it->second;
+}
+
+void ContributionTracker::evict_nodes(uint64_t now, const NodeID& keep) {
+    for (auto it = nodes_.begin(); it != nodes_.end();) {
+        const auto& entry = it->second;
+        const bool idle = entry.online_since == 0 && now >= entry.last_touched &&
+                          now - entry.last_touched > IDLE_EXPIRY;
+        if (idle && it->first != keep) {
+            it = nodes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (nodes_.size() <= MAX_TRACKED_NODES) {
+        return;
+    }
     
-    auto& metrics = metrics_[node_id];
-    if (metrics.first_seen == 0) {
-        metrics.first_seen = current_timestamp();
+    // Still over the cap: drop the least recently touched down to 7/8 of it,
+    // so the scan is not repeated on every new node
+    std::vector<std::pair<uint64_t, NodeID>> by_age;
+    by_age.reserve(nodes_.size());
+    for (const auto& [node_id, entry] : nodes_) {
+        if (node_id != keep) {
+            by_age.emplace_back(entry.last_touched, node_id);
+        }
     }
-    metrics.last_seen = current_timestamp();
+    const size_t excess = nodes_.size() - MAX_TRACKED_NODES / 8 * 7;
+    std::nth_element(by_age.begin(), by_age.begin() + static_cast<std::ptrdiff_t>(excess - 1), by_age.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < excess; ++i) {
+        nodes_.erase(by_age[i].second);
+    }
+}
+
+void ContributionTracker::record_node_online(const NodeID& node_id) {
+    auto& entry = node_entry(node_id);
+    const uint64_t now = current_timestamp();
+    entry.online_since = now;
+    if (entry.metrics.first_seen == 0) {
+        entry.metrics.first_seen = now;
+    }
+    entry.metrics.last_seen = now;
 }
 
 void ContributionTracker::record_node_offline(const NodeID& node_id) {
-    online_status_[node_id] = false;
+    auto& entry = node_entry(node_id);
+    const uint64_t now = current_timestamp();
     
     // Update uptime if was online
-    auto online_it = online_since_.find(node_id);
-    if (online_it != online_since_.end()) {
-        uint64_t current = current_timestamp();
-        uint64_t uptime = current - online_it->second;
-        update_uptime(node_id, uptime);
-        online_since_.erase(online_it);
+    if (entry.online_since != 0) {
+        entry.metrics.total_uptime += now - entry.online_since;
+        entry.online_since = 0;
     }
     
-    metrics_[node_id].last_seen = current_timestamp();
+    entry.metrics.last_seen = now;
 }
 
 void ContributionTracker::update_uptime(const NodeID& node_id, uint64_t seconds) {
-    metrics_[node_id].total_uptime += seconds;
+    node_entry(node_id).metrics.total_uptime += seconds;
 }
 
 void ContributionTracker::record_bytes_routed(const NodeID& node_id, uint64_t bytes) {
-    metrics_[node_id].bytes_routed += bytes;
+    node_entry(node_id).metrics.bytes_routed += bytes;
 }
 
 void ContributionTracker::record_traffic(const NodeID& node_id, uint64_t sent, uint64_t received) {
-    auto& metrics = metrics_[node_id];
+    auto& metrics = node_entry(node_id).metrics;
     metrics.bytes_sent += sent;
     metrics.bytes_received += received;
 }
 
+void ContributionTracker::apply_traffic(const std::vector<TrafficDelta>& deltas) {
+    for (const auto& delta : deltas) {
+        auto& metrics = node_entry(delta.node_id).metrics;
+        metrics.bytes_sent += delta.bytes_sent;
+        metrics.bytes_received += delta.bytes_received;
+        metrics.bytes_routed += delta.bytes_routed;
+    }
+}
+
 void ContributionTracker::record_thing_hosted(const NodeID& node_id, uint64_t size_bytes) {
-    auto& metrics = metrics_[node_id];
+    auto& metrics = node_entry(node_id).metrics;
     metrics.things_hosted++;
     metrics.storage_bytes_provided += size_bytes;
 }
 
 void ContributionTracker::record_thing_removed(const NodeID& node_id, uint64_t size_bytes) {
-    auto& metrics = metrics_[node_id];
+    auto& metrics = node_entry(node_id).metrics;
     if (metrics.things_hosted > 0) {
         metrics.things_hosted--;
     }
@@ -99,40 +261,37 @@ void ContributionTracker::record_thing_removed(const NodeID& node_id, uint64_t s
 }
 
 void ContributionTracker::record_successful_route(const NodeID& node_id) {
-    auto& metrics = metrics_[node_id];
+    auto& metrics = node_entry(node_id).metrics;
     metrics.successful_routes++;
     update_routing_reliability(metrics);
 }
 
 void ContributionTracker::record_failed_route(const NodeID& node_id) {
-    auto& metrics = metrics_[node_id];
+    auto& metrics = node_entry(node_id).metrics;
     metrics.failed_routes++;
     update_routing_reliability(metrics);
 }
 
 void ContributionTracker::record_epoch_witness(const NodeID& node_id, uint64_t epoch) {
     (void)epoch;
-    metrics_[node_id].epochs_witnessed++;
+    node_entry(node_id).metrics.epochs_witnessed++;
 }
 
 void ContributionTracker::record_epoch_missed(const NodeID& node_id, uint64_t epoch) {
     (void)epoch;
-    metrics_[node_id].epochs_missed++;
+    node_entry(node_id).metrics.epochs_missed++;
 }
 
 ContributionMetrics ContributionTracker::get_metrics(const NodeID& node_id) const {
-    auto it = metrics_.find(node_id);
-    if (it == metrics_.end()) {
+    auto it = nodes_.find(node_id);
+    if (it == nodes_.end()) {
         return ContributionMetrics{};
     }
     
     // If node is currently online, add current session uptime
-    auto metrics = it->second;
-    auto online_it = online_since_.find(node_id);
-    if (online_it != online_since_.end()) {
-        uint64_t current = current_timestamp();
-        uint64_t session_uptime = current - online_it->second;
-        metrics.total_uptime += session_uptime;
+    auto metrics = it->second.metrics;
+    if (it->second.online_since != 0) {
+        metrics.total_uptime += current_timestamp() - it->second.online_since;
     }
     
     return metrics;
@@ -144,8 +303,8 @@ std::vector<NodeID> ContributionTracker::get_active_contributors() const {
     uint64_t current = current_timestamp();
     static constexpr uint64_t ACTIVE_THRESHOLD = 300;  // 5 minutes
     
-    for (const auto& [node_id, metrics] : metrics_) {
-        if (current - metrics.last_seen <= ACTIVE_THRESHOLD) {
+    for (const auto& [node_id, entry] : nodes_) {
+        if (current - entry.metrics.last_seen <= ACTIVE_THRESHOLD) {
             result.push_back(node_id);
         }
     }
@@ -153,18 +312,36 @@ std::vector<NodeID> ContributionTracker::get_active_contributors() const {
     return result;
 }
 
+ContributionColumns ContributionTracker::snapshot_active() const {
+    ContributionColumns columns;
+    columns.taken_at = current_timestamp();
+    columns.reserve(nodes_.size());
+    
+    static constexpr uint64_t ACTIVE_THRESHOLD = 300;  // 5 minutes, as get_active_contributors
+    
+    for (const auto& [node_id, entry] : nodes_) {
+        if (columns.taken_at - entry.metrics.last_seen > ACTIVE_THRESHOLD) {
+            continue;
+        }
+        columns.push_back(entry.metrics);
+        if (entry.online_since != 0) {
+            columns.total_uptime.back() += columns.taken_at - entry.online_since;
+        }
+    }
+    
+    return columns;
+}
+
 void ContributionTracker::reset_metrics(const NodeID& node_id) {
-    metrics_.erase(node_id);
-    online_status_.erase(node_id);
-    online_since_.erase(node_id);
+    nodes_.erase(node_id);
 }
 
 void ContributionTracker::cleanup_inactive_nodes(uint64_t inactive_threshold) {
     std::vector<NodeID> to_remove;
     uint64_t current = current_timestamp();
     
-    for (const auto& [node_id, metrics] : metrics_) {
-        if (current - metrics.last_seen > inactive_threshold) {
+    for (const auto& [node_id, entry] : nodes_) {
+        if (current - entry.metrics.last_seen > inactive_threshold) {
             to_remove.push_back(node_id);
         }
     }
@@ -246,42 +423,155 @@ void PoStakeEngine::process_epoch(uint64_t epoch) {
     }
     
     epoch_rewards_[epoch] = rewards;
+    while (epoch_rewards_.size() > EPOCHS_RETAINED) {
+        epoch_rewards_.erase(epoch_rewards_.begin());
+    }
+    while (epoch_contributions_.size() > EPOCHS_RETAINED) {
+        epoch_contributions_.erase(epoch_contributions_.begin());
+    }
     
     CASHEW_LOG_INFO("PoStake epoch {} complete: {} rewards issued", epoch, rewards.size());
 }
 
 std::vector<PoStakeReward> PoStakeEngine::calculate_epoch_rewards(uint64_t epoch) const {
-    std::vector<PoStakeReward> rewards;
-    std::vector<EpochContribution> contributions;
-    
-    auto active_nodes = tracker_.get_active_contributors();
-    
-    for (const auto& node_id : active_nodes) {
-        auto metrics = tracker_.get_metrics(node_id);
-        auto score = calculate_score(metrics);
+    return score_epoch(tracker_.snapshot_active(), epoch).rewards;
+}
+
+EpochScores PoStakeEngine::score_epoch(const ContributionColumns& columns, uint64_t epoch) const {
+    const size_t n = columns.size();
+    EpochScores scores;
+    scores.uptime_score.resize(n);
+    scores.bandwidth_score.resize(n);
+    scores.storage_score.resize(n);
+    scores.routing_score.resize(n);
+    scores.witness_score.resize(n);
+    scores.total_score.resize(n);
+    std::vector<uint32_t> key_counts(n);
+    std::vector<core::KeyType> key_types(n);
+    
+    // Scores and key counts, split across the executor for large snapshots.
+    // Chunks are claimed, so a job that starts after every chunk is taken
+    // returns without touching this frame.
+    const size_t chunks = executor_
+        ? std::min(executor_->worker_count(), std::max<size_t>(1, n / MIN_NODES_PER_CHUNK)) : 1;
+    if (chunks <= 1) {
+        score_range(columns, scores, key_counts, key_types, 0, n);
+    } else {
+        struct Pass {
+            std::atomic<size_t> next{0};
+            size_t finished = 0;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+        auto pass = std::make_shared<Pass>();
+        const size_t chunk = (n + chunks - 1) / chunks;
+        const auto claim_chunks = [this, pass, chunks, chunk, n, &columns, &scores, &key_counts, &key_types]() {
+            for (size_t c = pass->next++; c < chunks; c = pass->next++) {
+                const size_t begin = std::min(n, c * chunk);
+                score_range(columns, scores, key_counts, key_types, begin, std::min(n, begin + chunk));
+                std::lock_guard<std::mutex> lock(pass->mutex);
+                if (++pass->finished == chunks) {
+                    pass->done.notify_all();
+                }
+            }
+        };
+        for (size_t t = 1; t < chunks; ++t) {
+            executor_->submit(claim_chunks, runtime::Priority::BULK);
+        }
+        claim_chunks();
+        std::unique_lock<std::mutex> lock(pass->mutex);
+        pass->done.wait(lock, [&pass, chunks]() { return pass->finished == chunks; });
+    }
+    
+    // Ranks by total score
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&scores](uint32_t a, uint32_t b) {
+        return scores.total_score[a] != scores.total_score[b]
+            ? scores.total_score[a] > scores.total_score[b] : a < b;
+    });
+    scores.rank.resize(n);
+    for (size_t position = 0; position < n; ++position) {
+        scores.rank[order[position]] = static_cast<uint32_t>(position);
+    }
+    
+    // Rewards
+    for (size_t i = 0; i < n; ++i) {
+        if (key_counts[i] == 0) {
+            continue;
+        }
         
-        // Determine key type and count
-        auto key_type = determine_key_type(score);
-        auto key_count = calculate_key_count(score, key_type);
+        PoStakeReward reward;
+        reward.node_id = columns.node_ids[i];
+        reward.epoch = epoch;
+        reward.key_type = key_types[i];
+        reward.key_count = key_counts[i];
+        reward.awarded_at = columns.taken_at;
         
-        if (key_count > 0) {
-            PoStakeReward reward;
-            reward.node_id = node_id;
-            reward.epoch = epoch;
-            reward.key_type = key_type;
-            reward.key_count = key_count;
-            
-            auto now = std::chrono::system_clock::now();
-            auto now_time_t = std::chrono::system_clock::to_time_t(now);
-            reward.awarded_at = static_cast<uint64_t>(now_time_t);
-            
-            reward.proof_hash = hash_contribution(metrics);
-            
-            rewards.push_back(reward);
-        }
+        ContributionMetrics metrics;
+        metrics.total_uptime = columns.total_uptime[i];
+        metrics.bytes_routed = columns.bytes_routed[i];
+        metrics.storage_bytes_provided = columns.storage_bytes_provided[i];
+        metrics.successful_routes = columns.successful_routes[i];
+        metrics.epochs_witnessed = columns.epochs_witnessed[i];
+        reward.proof_hash = hash_contribution(metrics);
+        
+        scores.rewards.push_back(reward);
+    }
+    
+    return scores;
+}
+
+void PoStakeEngine::score_range(const ContributionColumns& columns, EpochScores& scores,
+                                std::vector<uint32_t>& key_counts, std::vector<core::KeyType>& key_types,
+                                size_t begin, size_t end) const {
+    const uint64_t now = columns.taken_at;
+    const uint64_t* total_uptime = columns.total_uptime.data();
+    const uint64_t* first_seen = columns.first_seen.data();
+    const uint64_t* bytes_routed = columns.bytes_routed.data();
+    const uint64_t* storage_bytes = columns.storage_bytes_provided.data();
+    const uint32_t* things_hosted = columns.things_hosted.data();
+    const uint32_t* successful_routes = columns.successful_routes.data();
+    const float* reliability = columns.routing_reliability.data();
+    const uint32_t* witnessed = columns.epochs_witnessed.data();
+    const uint32_t* missed = columns.epochs_missed.data();
+    
+    uint32_t* uptime = scores.uptime_score.data();
+    uint32_t* bandwidth = scores.bandwidth_score.data();
+    uint32_t* storage = scores.storage_score.data();
+    uint32_t* routing = scores.routing_score.data();
+    uint32_t* witness = scores.witness_score.data();
+    uint32_t* total = scores.total_score.data();
+    
+    // One loop per field keeps each loop narrow enough to vectorize
+    for (size_t i = begin; i < end; ++i) {
+        uptime[i] = uptime_points(uptime_percentage_at(total_uptime[i], first_seen[i], now),
+                                  total_uptime[i], UPTIME_WEIGHT);
+    }
+    for (size_t i = begin; i < end; ++i) {
+        bandwidth[i] = bandwidth_points(bytes_routed[i], BANDWIDTH_WEIGHT);
+        storage[i] = storage_points(things_hosted[i], storage_bytes[i], STORAGE_WEIGHT);
+    }
+    for (size_t i = begin; i < end; ++i) {
+        routing[i] = routing_points(successful_routes[i], reliability[i], ROUTING_WEIGHT);
+        witness[i] = witness_points(witnessed[i], missed[i], WITNESS_WEIGHT);
+    }
+    for (size_t i = begin; i < end; ++i) {
+        total[i] = uptime[i] + bandwidth[i] + storage[i] + routing[i] + witness[i];
     }
     
-    return rewards;
+    // Key type and count, with the rates looked up once
+    const KeyEarningRate service_rate = get_earning_rate(core::KeyType::SERVICE);
+    const KeyEarningRate routing_rate = get_earning_rate(core::KeyType::ROUTING);
+    const KeyEarningRate network_rate = get_earning_rate(core::KeyType::NETWORK);
+    for (size_t i = begin; i < end; ++i) {
+        const auto key_type = key_type_for(bandwidth[i], storage[i], routing[i]);
+        const KeyEarningRate& rate = key_type == core::KeyType::SERVICE ? service_rate
+                                   : key_type == core::KeyType::ROUTING ? routing_rate
+                                   : network_rate;
+        key_types[i] = key_type;
+        key_counts[i] = key_count_for(total[i], rate);
+    }
 }
 
 bool PoStakeEngine::award_keys(const PoStakeReward& reward) {
@@ -321,41 +611,42 @@ std::vector<EpochContribution> PoStakeEngine::get_node_history(const NodeID& nod
 }
 
 std::vector<NodeID> PoStakeEngine::get_top_contributors(ContributionType type, uint32_t count) const {
-    auto active_nodes = tracker_.get_active_contributors();
+    const auto columns = tracker_.snapshot_active();
+    const size_t n = columns.size();
     
-    std::vector<std::pair<NodeID, uint64_t>> scored_nodes;
-    
-    for (const auto& node_id : active_nodes) {
-        auto metrics = tracker_.get_metrics(node_id);
-        uint64_t type_score = 0;
-        
+    std::vector<uint64_t> type_score(n);
+    for (size_t i = 0; i < n; ++i) {
         switch (type) {
             case ContributionType::UPTIME:
-                type_score = metrics.total_uptime;
+                type_score[i] = columns.total_uptime[i];
                 break;
             case ContributionType::BANDWIDTH:
-                type_score = metrics.bytes_routed;
+                type_score[i] = columns.bytes_routed[i];
                 break;
             case ContributionType::STORAGE:
-                type_score = metrics.storage_bytes_provided;
+                type_score[i] = columns.storage_bytes_provided[i];
                 break;
             case ContributionType::ROUTING_QUALITY:
-                type_score = metrics.successful_routes;
+                type_score[i] = columns.successful_routes[i];
                 break;
             case ContributionType::EPOCH_WITNESS:
-                type_score = metrics.epochs_witnessed;
+                type_score[i] = columns.epochs_witnessed[i];
                 break;
         }
-        
-        scored_nodes.push_back({node_id, type_score});
     }
     
-    std::sort(scored_nodes.begin(), scored_nodes.end(),
-             [](const auto& a, const auto& b) { return a.second > b.second; });
+    // Only the top `count` need ordering
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0u);
+    const size_t top = std::min(static_cast<size_t>(count), n);
+    std::partial_sort(order.begin(), order.begin() + top, order.end(), [&type_score](uint32_t a, uint32_t b) {
+        return type_score[a] != type_score[b] ? type_score[a] > type_score[b] : a < b;
+    });
     
     std::vector<NodeID> result;
-    for (size_t i = 0; i < std::min(static_cast<size_t>(count), scored_nodes.size()); i++) {
-        result.push_back(scored_nodes[i].first);
+    result.reserve(top);
+    for (size_t i = 0; i < top; i++) {
+        result.push_back(columns.node_ids[order[i]]);
     }
     
     return result;
@@ -376,18 +667,17 @@ uint32_t PoStakeEngine::get_total_keys_awarded(uint64_t epoch) const {
 }
 
 uint32_t PoStakeEngine::get_average_contribution_score() const {
-    auto active_nodes = tracker_.get_active_contributors();
-    if (active_nodes.empty()) {
+    const auto scores = score_epoch(tracker_.snapshot_active(), 0);
+    if (scores.size() == 0) {
         return 0;
     }
     
     uint64_t total_score = 0;
-    for (const auto& node_id : active_nodes) {
-        auto score = calculate_score(node_id);
-        total_score += score.total_score;
+    for (uint32_t score : scores.total_score) {
+        total_score += score;
     }
     
-    return static_cast<uint32_t>(total_score / active_nodes.size());
+    return static_cast<uint32_t>(total_score / scores.size());
 }
 
 void PoStakeEngine::initialize_default_rates() {
@@ -423,96 +713,23 @@ void PoStakeEngine::initialize_default_rates() {
 }
 
 uint32_t PoStakeEngine::calculate_uptime_score(const ContributionMetrics& metrics) const {
-    // Score based on uptime percentage and absolute time
-    float uptime_pct = metrics.uptime_percentage();
-    
-    // Base score from percentage (0-100)
-    uint32_t base_score = static_cast<uint32_t>(uptime_pct);
-    
-    // Bonus for long uptime (up to 100 points)
-    static constexpr uint64_t MONTH_SECONDS = 30 * 24 * 60 * 60;
-    uint32_t longevity_bonus = std::min(100u, static_cast<uint32_t>((metrics.total_uptime * 100) / MONTH_SECONDS));
-    
-    return static_cast<uint32_t>((base_score + longevity_bonus) * UPTIME_WEIGHT);
+    return uptime_points(metrics.uptime_percentage(), metrics.total_uptime, UPTIME_WEIGHT);
 }
 
 uint32_t PoStakeEngine::calculate_bandwidth_score(const ContributionMetrics& metrics) const {
-    // Score based on bytes routed
-    static constexpr uint64_t GB = 1024 * 1024 * 1024;
-    
-    // 1 point per GB routed
-    uint32_t score = static_cast<uint32_t>(metrics.bytes_routed / GB);
-    
-    // Cap at 200 points
-    if (score > 200) score = 200;
-    
-    return static_cast<uint32_t>(score * BANDWIDTH_WEIGHT);
+    return bandwidth_points(metrics.bytes_routed, BANDWIDTH_WEIGHT);
 }
 
 uint32_t PoStakeEngine::calculate_storage_score(const ContributionMetrics& metrics) const {
-    // Score based on Things hosted and storage provided
-    static constexpr uint64_t GB = 1024 * 1024 * 1024;
-    
-    // 10 points per Thing hosted
-    uint32_t thing_score = metrics.things_hosted * 10;
-    
-    // 1 point per GB stored
-    uint32_t storage_score = static_cast<uint32_t>(metrics.storage_bytes_provided / GB);
-    
-    uint32_t total = thing_score + storage_score;
-    if (total > 200) total = 200;
-    
-    return static_cast<uint32_t>(total * STORAGE_WEIGHT);
+    return storage_points(metrics.things_hosted, metrics.storage_bytes_provided, STORAGE_WEIGHT);
 }
 
 uint32_t PoStakeEngine::calculate_routing_score(const ContributionMetrics& metrics) const {
-    // Score based on successful routes and reliability
-    uint32_t base_score = std::min(100u, metrics.successful_routes);
-    
-    // Multiply by reliability (0.0 to 1.0)
-    uint32_t reliability_adjusted = static_cast<uint32_t>(base_score * metrics.routing_reliability);
-    
-    return static_cast<uint32_t>(reliability_adjusted * ROUTING_WEIGHT);
+    return routing_points(metrics.successful_routes, metrics.routing_reliability, ROUTING_WEIGHT);
 }
 
 uint32_t PoStakeEngine::calculate_witness_score(const ContributionMetrics& metrics) const {
-    // Score based on epoch witnessing
-    uint32_t total_epochs = metrics.epochs_witnessed + metrics.epochs_missed;
-    if (total_epochs == 0) {
-        return 0;
-    }
-    
-    float participation_rate = static_cast<float>(metrics.epochs_witnessed) / static_cast<float>(total_epochs);
-    uint32_t score = static_cast<uint32_t>(participation_rate * 100.0f);
-    
-    return static_cast<uint32_t>(score * WITNESS_WEIGHT);
-}
-
-core::KeyType PoStakeEngine::determine_key_type(const ContributionScore& score) const {
-    // Determine which key type to award based on contribution profile
-    if (score.storage_score > score.bandwidth_score && score.storage_score > score.routing_score) {
-        return core::KeyType::SERVICE;  // Good at hosting
-    } else if (score.bandwidth_score > score.storage_score && score.bandwidth_score > score.routing_score) {
-        return core::KeyType::ROUTING;  // Good at routing
-    } else {
-        return core::KeyType::NETWORK;  // Balanced contribution
-    }
-}
-
-uint32_t PoStakeEngine::calculate_key_count(const ContributionScore& score, core::KeyType key_type) const {
-    auto rate = get_earning_rate(key_type);
-    
-    if (score.total_score < rate.min_score_required) {
-        return 0;
-    }
-    
-    uint32_t keys = score.total_score / rate.points_per_key;
-    
-    if (keys > rate.max_per_epoch) {
-        keys = rate.max_per_epoch;
-    }
-    
-    return keys;
+    return witness_points(metrics.epochs_witnessed, metrics.epochs_missed, WITNESS_WEIGHT);
 }
 
 Hash256 PoStakeEngine::hash_contribution(const ContributionMetrics& metrics) const {
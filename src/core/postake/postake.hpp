@@ -3,6 +3,8 @@
 #include "cashew/common.hpp"
 #include "core/keys/key.hpp"
 #include "core/ledger/state.hpp"
+#include "runtime/executor.hpp"
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <optional>
@@ -60,6 +62,31 @@ struct ContributionMetrics {
     float routing_success_rate() const;
 };
 
+/**
+ * ContributionColumns - Struct-of-arrays snapshot of ContributionMetrics
+ * 
+ * One column per scored field, so epoch scoring runs as flat loops the
+ * compiler can vectorize instead of a lookup and a struct copy per node.
+ */
+struct ContributionColumns {
+    uint64_t taken_at = 0;  // Uptime percentages are relative to this time
+    
+    std::vector<NodeID> node_ids;
+    std::vector<uint64_t> total_uptime;
+    std::vector<uint64_t> first_seen;
+    std::vector<uint64_t> bytes_routed;
+    std::vector<uint64_t> storage_bytes_provided;
+    std::vector<uint32_t> things_hosted;
+    std::vector<uint32_t> successful_routes;
+    std::vector<float> routing_reliability;
+    std::vector<uint32_t> epochs_witnessed;
+    std::vector<uint32_t> epochs_missed;
+    
+    size_t size() const { return node_ids.size(); }
+    void reserve(size_t count);
+    void push_back(const ContributionMetrics& metrics);
+};
+
 /**
  * ContributionScore - Calculated score for key earning
  */
@@ -125,6 +152,25 @@ struct PoStakeReward {
     Hash256 proof_hash;  // Hash of contribution metrics
 };
 
+/**
+ * EpochScores - Scores, ranks and rewards of one epoch
+ * 
+ * Score columns are indexed like the ContributionColumns they came from.
+ */
+struct EpochScores {
+    std::vector<uint32_t> uptime_score;
+    std::vector<uint32_t> bandwidth_score;
+    std::vector<uint32_t> storage_score;
+    std::vector<uint32_t> routing_score;
+    std::vector<uint32_t> witness_score;
+    std::vector<uint32_t> total_score;
+    std::vector<uint32_t> rank;          // 0 = highest total score, ties in column order
+    std::vector<PoStakeReward> rewards;  // Nodes earning at least one key, in column order
+    
+    size_t size() const { return total_score.size(); }
+    ContributionScore score(const ContributionColumns& columns, size_t index) const;
+};
+
 /**
  * ContributionTracker - Tracks ongoing contributions
  */
@@ -142,6 +188,15 @@ public:
     void record_bytes_routed(const NodeID& node_id, uint64_t bytes);
     void record_traffic(const NodeID& node_id, uint64_t sent, uint64_t received);
     
+    // Traffic accumulated by the caller (see network::ActivityMonitor)
+    struct TrafficDelta {
+        NodeID node_id;
+        uint64_t bytes_sent = 0;
+        uint64_t bytes_received = 0;
+        uint64_t bytes_routed = 0;
+    };
+    void apply_traffic(const std::vector<TrafficDelta>& deltas);
+    
     // Storage tracking
     void record_thing_hosted(const NodeID& node_id, uint64_t size_bytes);
     void record_thing_removed(const NodeID& node_id, uint64_t size_bytes);
@@ -158,15 +213,38 @@ public:
     ContributionMetrics get_metrics(const NodeID& node_id) const;
     std::vector<NodeID> get_active_contributors() const;
     
+    /**
+     * Metrics of the active contributors (as get_metrics would return them),
+     * in get_active_contributors order
+     */
+    ContributionColumns snapshot_active() const;
+    
     // Cleanup
     void reset_metrics(const NodeID& node_id);
     void cleanup_inactive_nodes(uint64_t inactive_threshold = 86400);
     
-private:
-    std::map<NodeID, ContributionMetrics> metrics_;
-    std::map<NodeID, bool> online_status_;
-    std::map<NodeID, uint64_t> online_since_;
+    size_t tracked_nodes() const { return nodes_.size(); }
+    
+    static constexpr size_t MAX_TRACKED_NODES = 16384;
+    static constexpr uint64_t IDLE_EXPIRY = 86400;     // Seconds untouched before an offline node is dropped
+    static constexpr uint64_t PRUNE_INTERVAL = 1024;   // New nodes between idle sweeps
     
+private:
+    // One entry per node. Offline nodes untouched for IDLE_EXPIRY are swept
+    // every PRUNE_INTERVAL new nodes; past MAX_TRACKED_NODES the least
+    // recently touched are evicted, so memory stays bounded without callers
+    // remembering cleanup_inactive_nodes.
+    struct NodeContribution {
+        ContributionMetrics metrics;
+        uint64_t online_since = 0;  // 0 = offline
+        uint64_t last_touched = 0;  // Any record_* call, unlike metrics.last_seen
+    };
+    
+    std::map<NodeID, NodeContribution> nodes_;
+    uint64_t nodes_added_ = 0;
+    
+    NodeContribution& node_entry(const NodeID& node_id);
+    void evict_nodes(uint64_t now, const NodeID& keep);
     uint64_t current_timestamp() const;
     void update_routing_reliability(ContributionMetrics& metrics);
 };
@@ -209,6 +287,16 @@ public:
     void process_epoch(uint64_t epoch);
     std::vector<PoStakeReward> calculate_epoch_rewards(uint64_t epoch) const;
     
+    /**
+     * Score every node in columns in one pass: per-field and total scores,
+     * ranks and rewards. Large snapshots are split into chunks of at least
+     * MIN_NODES_PER_CHUNK, scored as BULK jobs on the executor and by the
+     * calling thread, which takes any chunk no worker has started.
+     */
+    EpochScores score_epoch(const ContributionColumns& columns, uint64_t epoch) const;
+    void set_executor(std::shared_ptr<runtime::Executor> executor) { executor_ = std::move(executor); }
+    static constexpr size_t MIN_NODES_PER_CHUNK = 8192;
+    
     // Award keys
     bool award_keys(const PoStakeReward& reward);
     
@@ -229,10 +317,12 @@ private:
     
     // Earning rates for each key type
     std::map<core::KeyType, KeyEarningRate> earning_rates_;
+    std::shared_ptr<runtime::Executor> executor_;  // Scoring runs serially without one
     
-    // Epoch history
+    // Epoch history (last EPOCHS_RETAINED epochs; older rewards are in the ledger)
     std::map<uint64_t, std::vector<EpochContribution>> epoch_contributions_;
     std::map<uint64_t, std::vector<PoStakeReward>> epoch_rewards_;
+    static constexpr size_t EPOCHS_RETAINED = 16;
     
     // Scoring weights
     static constexpr float UPTIME_WEIGHT = 0.3f;
@@ -249,8 +339,9 @@ private:
     uint32_t calculate_routing_score(const ContributionMetrics& metrics) const;
     uint32_t calculate_witness_score(const ContributionMetrics& metrics) const;
     
-    core::KeyType determine_key_type(const ContributionScore& score) const;
-    uint32_t calculate_key_count(const ContributionScore& score, core::KeyType key_type) const;
+    void score_range(const ContributionColumns& columns, EpochScores& scores,
+                     std::vector<uint32_t>& key_counts, std::vector<core::KeyType>& key_types,
+                     size_t begin, size_t end) const;
     
     Hash256 hash_contribution(const ContributionMetrics& metrics) const;
 };
@@ -1,11 +1,65 @@
 #include "attestation.hpp"
 #include "utils/logger.hpp"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <queue>
 #include <set>
 
 namespace cashew::reputation {
 
+namespace {
+
+constexpr double NO_PATH = std::numeric_limits<double>::infinity();
+
+// One direction of the bidirectional widest-path search
+struct SearchFrontier {
+    struct Label {
+        uint32_t node;
+        uint32_t hops;
+        double cost;
+        int32_t parent;   // Label index, -1 at the endpoint
+    };
+    
+    using QueueItem = std::pair<double, uint32_t>;  // (cost, label)
+    
+    std::vector<Label> labels;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    
+    // A label is only worth settling with fewer hops than every cheaper one
+    // already settled at its node; settled labels per node stay tiny
+    std::unordered_map<uint32_t, uint32_t> min_hops;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> settled;
+    
+    double top() const {
+        return queue.empty() ? NO_PATH : queue.top().first;
+    }
+    
+    bool dominated(uint32_t node, uint32_t hops) const {
+        auto it = min_hops.find(node);
+        return it != min_hops.end() && hops >= it->second;
+    }
+    
+    std::optional<uint32_t> push(uint32_t node, uint32_t hops, double cost, int32_t parent) {
+        if (dominated(node, hops)) {
+            return std::nullopt;
+        }
+        const auto index = static_cast<uint32_t>(labels.size());
+        labels.push_back({node, hops, cost, parent});
+        queue.push({cost, index});
+        return index;
+    }
+    
+    // Walk parents back to the endpoint this frontier started from
+    void append_chain(uint32_t label, std::vector<uint32_t>& out) const {
+        for (int32_t i = static_cast<int32_t>(label); i >= 0; i = labels[i].parent) {
+            out.push_back(labels[i].node);
+        }
+    }
+};
+
+} // namespace
+
 // AttestationSigner implementation
 
 std::vector<uint8_t> AttestationSigner::attestation_to_signable_bytes(
@@ -412,6 +466,54 @@ VouchingWorkflow::VouchingStats VouchingWorkflow::get_vouching_stats(const NodeI
 TrustPathFinder::TrustPathFinder(const TrustGraph& graph)
     : graph_(graph)
 {
+    refresh();
+}
+
+void TrustPathFinder::refresh() {
+    nodes_ = graph_.get_all_nodes();
+    
+    struct FlatEdge {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+    std::vector<FlatEdge> edges;
+    graph_.for_each_edge([&](const TrustEdge& edge) {
+        if (edge.trust_weight > MIN_EDGE_WEIGHT && edge.from != edge.to) {
+            edges.push_back({*index_of(edge.from), *index_of(edge.to),
+                             -std::log(static_cast<double>(edge.trust_weight))});
+        }
+    });
+    
+    auto build = [&](Adjacency& adjacency, bool reverse) {
+        adjacency.offsets.assign(nodes_.size() + 1, 0);
+        for (const auto& edge : edges) {
+            adjacency.offsets[(reverse ? edge.to : edge.from) + 1]++;
+        }
+        for (size_t i = 1; i < adjacency.offsets.size(); ++i) {
+            adjacency.offsets[i] += adjacency.offsets[i - 1];
+        }
+        
+        adjacency.neighbors.resize(edges.size());
+        adjacency.costs.resize(edges.size());
+        std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (const auto& edge : edges) {
+            uint32_t slot = cursor[reverse ? edge.to : edge.from]++;
+            adjacency.neighbors[slot] = reverse ? edge.from : edge.to;
+            adjacency.costs[slot] = edge.cost;
+        }
+    };
+    
+    build(outgoing_, false);
+    build(incoming_, true);
+}
+
+std::optional<uint32_t> TrustPathFinder::index_of(const NodeID& node) const {
+    auto it = std::lower_bound(nodes_.begin(), nodes_.end(), node);
+    if (it == nodes_.end() || *it != node) {
+        return std::nullopt;
+    }
+    return static_cast<uint32_t>(it - nodes_.begin());
 }
 
 void TrustPathFinder::dfs_find_paths(
@@ -431,10 +533,15 @@ void TrustPathFinder::dfs_find_paths(
         return;
     }
     
+    auto index = index_of(current);
+    if (!index) {
+        return;
+    }
+    
     visited.insert(current);
     
-    auto trusted = graph_.get_trusts(current);
-    for (const auto& next : trusted) {
+    for (uint32_t e = outgoing_.offsets[*index]; e < outgoing_.offsets[*index + 1]; ++e) {
+        const NodeID& next = nodes_[outgoing_.neighbors[e]];
         if (visited.find(next) == visited.end()) {
             current_path.push_back(next);
             dfs_find_paths(next, target, current_path, visited, all_paths, max_hops);
@@ -460,30 +567,125 @@ std::vector<std::vector<NodeID>> TrustPathFinder::find_all_paths(
     return all_paths;
 }
 
-std::optional<std::vector<NodeID>> TrustPathFinder::find_strongest_path(
+std::optional<TrustPathFinder::TrustPath> TrustPathFinder::find_widest_path(
     const NodeID& from,
     const NodeID& to,
     uint32_t max_hops
 ) const {
-    auto all_paths = find_all_paths(from, to, max_hops);
+    if (from == to) {
+        return TrustPath{{from}, 1.0f};
+    }
     
-    if (all_paths.empty()) {
+    auto source = index_of(from);
+    auto target = index_of(to);
+    if (!source || !target || max_hops == 0) {
         return std::nullopt;
     }
     
-    // Find path with highest strength
-    float max_strength = 0.0f;
-    std::vector<NodeID> strongest_path;
+    SearchFrontier forward;
+    SearchFrontier backward;
+    double best_cost = NO_PATH;
+    uint32_t best_forward = 0;
+    uint32_t best_backward = 0;
     
-    for (const auto& path : all_paths) {
-        float strength = calculate_path_strength(path);
-        if (strength > max_strength) {
-            max_strength = strength;
-            strongest_path = path;
+    // Join a label with the other frontier's settled labels at its node
+    auto meet = [&](const SearchFrontier::Label& label, uint32_t index,
+                    const SearchFrontier& other, bool is_forward) {
+        auto met = other.settled.find(label.node);
+        if (met == other.settled.end()) {
+            return;
+        }
+        for (uint32_t other_index : met->second) {
+            const auto& other_label = other.labels[other_index];
+            if (label.hops + other_label.hops <= max_hops && label.cost + other_label.cost < best_cost) {
+                best_cost = label.cost + other_label.cost;
+                best_forward = is_forward ? index : other_index;
+                best_backward = is_forward ? other_index : index;
+            }
+        }
+    };
+    
+    // Settle the cheapest label of one frontier, record meetings with the
+    // other, then relax its edges
+    auto step = [&](SearchFrontier& self, const SearchFrontier& other,
+                    const Adjacency& adjacency, bool is_forward) {
+        auto [cost, index] = self.queue.top();
+        self.queue.pop();
+        
+        const auto label = self.labels[index];
+        if (self.dominated(label.node, label.hops)) {
+            return;
+        }
+        self.min_hops[label.node] = label.hops;
+        self.settled[label.node].push_back(index);
+        
+        meet(self.labels[index], index, other, is_forward);
+        
+        if (label.hops >= max_hops) {
+            return;
+        }
+        for (uint32_t e = adjacency.offsets[label.node]; e < adjacency.offsets[label.node + 1]; ++e) {
+            // Check edges into the other frontier as they are crossed, not
+            // only when both sides settle the same node
+            auto pushed = self.push(adjacency.neighbors[e], label.hops + 1, cost + adjacency.costs[e],
+                                    static_cast<int32_t>(index));
+            if (pushed) {
+                meet(self.labels[*pushed], *pushed, other, is_forward);
+            }
+        }
+    };
+    
+    // Settle both endpoints first so either frontier running dry ends the search
+    forward.push(*source, 0, 0.0, -1);
+    backward.push(*target, 0, 0.0, -1);
+    step(forward, backward, outgoing_, true);
+    step(backward, forward, incoming_, false);
+    
+    while (true) {
+        const double forward_top = forward.top();
+        const double backward_top = backward.top();
+        
+        // Any undiscovered path costs at least the sum of the frontier minimums
+        if (forward_top + backward_top >= best_cost || (forward.queue.empty() && backward.queue.empty())) {
+            break;
+        }
+        
+        if (forward_top <= backward_top) {
+            step(forward, backward, outgoing_, true);
+        } else {
+            step(backward, forward, incoming_, false);
         }
     }
     
-    return strongest_path;
+    if (best_cost == NO_PATH) {
+        return std::nullopt;
+    }
+    
+    std::vector<uint32_t> indices;
+    forward.append_chain(best_forward, indices);
+    std::reverse(indices.begin(), indices.end());
+    indices.pop_back();  // Meeting node is also the head of the backward chain
+    backward.append_chain(best_backward, indices);
+    
+    TrustPath path;
+    path.nodes.reserve(indices.size());
+    for (uint32_t index : indices) {
+        path.nodes.push_back(nodes_[index]);
+    }
+    path.strength = static_cast<float>(std::exp(-best_cost));
+    return path;
+}
+
+std::optional<std::vector<NodeID>> TrustPathFinder::find_strongest_path(
+    const NodeID& from,
+    const NodeID& to,
+    uint32_t max_hops
+) const {
+    auto path = find_widest_path(from, to, max_hops);
+    if (!path) {
+        return std::nullopt;
+    }
+    return std::move(path->nodes);
 }
 
 float TrustPathFinder::calculate_path_strength(const std::vector<NodeID>& path) const {
@@ -540,25 +742,31 @@ std::optional<uint32_t> TrustPathFinder::calculate_trust_distance(
         return 0;
     }
     
+    auto source = index_of(from);
+    auto target = index_of(to);
+    if (!source || !target) {
+        return std::nullopt;
+    }
+    
     // BFS for shortest path
-    std::queue<std::pair<NodeID, uint32_t>> queue;
-    std::set<NodeID> visited;
+    std::queue<std::pair<uint32_t, uint32_t>> queue;
+    std::vector<bool> visited(nodes_.size(), false);
     
-    queue.push({from, 0});
-    visited.insert(from);
+    queue.push({*source, 0});
+    visited[*source] = true;
     
     while (!queue.empty()) {
         auto [current, distance] = queue.front();
         queue.pop();
         
-        if (current == to) {
+        if (current == *target) {
             return distance;
         }
         
-        auto trusted = graph_.get_trusts(current);
-        for (const auto& next : trusted) {
-            if (visited.find(next) == visited.end()) {
-                visited.insert(next);
+        for (uint32_t e = outgoing_.offsets[current]; e < outgoing_.offsets[current + 1]; ++e) {
+            uint32_t next = outgoing_.neighbors[e];
+            if (!visited[next]) {
+                visited[next] = true;
                 queue.push({next, distance + 1});
             }
         }
@@ -570,8 +778,7 @@ std::optional<uint32_t> TrustPathFinder::calculate_trust_distance(
 std::vector<NodeID> TrustPathFinder::find_bridge_nodes(float min_betweenness) const {
     std::vector<NodeID> bridges;
 
-    const auto nodes = graph_.get_all_nodes();
-    for (const auto& node : nodes) {
+    for (const auto& node : nodes_) {
         if (calculate_betweenness_centrality(node) >= min_betweenness) {
             bridges.push_back(node);
         }
@@ -581,7 +788,7 @@ std::vector<NodeID> TrustPathFinder::find_bridge_nodes(float min_betweenness) co
 }
 
 float TrustPathFinder::calculate_betweenness_centrality(const NodeID& node) const {
-    const auto nodes = graph_.get_all_nodes();
+    const auto& nodes = nodes_;
     if (nodes.size() < 3) {
         return 0.0f;
     }
@@ -615,17 +822,10 @@ float TrustPathFinder::calculate_betweenness_centrality(const NodeID& node) cons
 }
 
 std::vector<NodeID> TrustPathFinder::find_trust_hubs(uint32_t min_incoming_edges) const {
-    std::map<NodeID, uint32_t> incoming_counts;
-
-    const auto nodes = graph_.get_all_nodes();
-    for (const auto& node : nodes) {
-        incoming_counts[node] = static_cast<uint32_t>(graph_.get_trusted_by(node).size());
-    }
-    
     std::vector<NodeID> hubs;
-    for (const auto& [node, count] : incoming_counts) {
-        if (count >= min_incoming_edges) {
-            hubs.push_back(node);
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        if (incoming_.offsets[i + 1] - incoming_.offsets[i] >= min_incoming_edges) {
+            hubs.push_back(nodes_[i]);
         }
     }
     
@@ -150,14 +150,25 @@ private:
 
 /**
  * TrustPathFinder - Advanced trust graph traversal
+ * 
+ * Queries run over a compact adjacency snapshot of the graph taken at
+ * construction; call refresh() after the graph changes. Only edges heavier
+ * than MIN_EDGE_WEIGHT are followed, as with TrustGraph::get_trusts().
  */
 class TrustPathFinder {
 public:
     explicit TrustPathFinder(const TrustGraph& graph);
     ~TrustPathFinder() = default;
     
+    /**
+     * Re-snapshot the graph
+     */
+    void refresh();
+    
     /**
      * Find all paths between two nodes within max_hops
+     * Enumerates every path (exponential in graph density); use
+     * find_strongest_path() when only the best one is needed.
      */
     std::vector<std::vector<NodeID>> find_all_paths(
         const NodeID& from,
@@ -165,6 +176,26 @@ public:
         uint32_t max_hops = 5
     ) const;
     
+    /**
+     * TrustPath - A path and the product of its edge weights
+     */
+    struct TrustPath {
+        std::vector<NodeID> nodes;
+        float strength;
+    };
+    
+    /**
+     * Find the path with the highest product of edge weights using at most
+     * max_hops edges
+     * Bidirectional Dijkstra over -log(weight) with per-node hop labels;
+     * stops as soon as the two frontiers cannot improve on the best meeting.
+     */
+    std::optional<TrustPath> find_widest_path(
+        const NodeID& from,
+        const NodeID& to,
+        uint32_t max_hops = 5
+    ) const;
+    
     /**
      * Find the strongest trust path (highest cumulative trust weight)
      */
@@ -212,9 +243,24 @@ public:
      */
     std::vector<NodeID> find_trust_hubs(uint32_t min_incoming_edges = 5) const;
     
+    static constexpr float MIN_EDGE_WEIGHT = 0.3f;
+    
 private:
     const TrustGraph& graph_;
     
+    // Compressed sparse rows: edges of node i are [offsets[i], offsets[i+1])
+    struct Adjacency {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> neighbors;
+        std::vector<double> costs;      // -log(weight)
+    };
+    
+    std::vector<NodeID> nodes_;     // Sorted; a node's index is its position
+    Adjacency outgoing_;
+    Adjacency incoming_;
+    
+    std::optional<uint32_t> index_of(const NodeID& node) const;
+    
     // Helper for DFS path finding
     void dfs_find_paths(
         const NodeID& current,
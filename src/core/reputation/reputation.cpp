@@ -261,6 +261,14 @@ void TrustGraph::prune_weak_edges(float threshold) {
     }
 }
 
+void TrustGraph::for_each_edge(const std::function<void(const TrustEdge&)>& visitor) const {
+    for (const auto& [from_node, edges] : edges_) {
+        for (const auto& [to_node, edge] : edges) {
+            visitor(edge);
+        }
+    }
+}
+
 float TrustGraph::calculate_path_trust(const std::vector<NodeID>& path) const {
     if (path.size() < 2) {
         return 1.0f;
@@ -6,6 +6,7 @@
 #include <map>
 #include <set>
 #include <optional>
+#include <functional>
 
 namespace cashew::reputation {
 
@@ -140,6 +141,9 @@ public:
     std::vector<NodeID> get_trusts(const NodeID& node) const;
     std::vector<NodeID> get_all_nodes() const;
     
+    // Visit every edge (grouped by source node, in node order)
+    void for_each_edge(const std::function<void(const TrustEdge&)>& visitor) const;
+    
     // Community detection
     std::set<NodeID> find_trust_community(const NodeID& node, float min_trust = 0.5f) const;
     
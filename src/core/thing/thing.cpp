@@ -43,6 +43,11 @@ bool read_string(const bytes& data, size_t& offset, std::string& out) {
     return true;
 }
 
+const bytes& empty_bytes() {
+    static const bytes empty;
+    return empty;
+}
+
 std::filesystem::path default_data_dir() {
     if (const char* env_data_dir = std::getenv("CASHEW_DATA_DIR"); env_data_dir && env_data_dir[0] != '\0') {
         return std::filesystem::path(env_data_dir);
@@ -206,15 +211,44 @@ std::optional<Thing> Thing::create(
     return Thing(std::move(data), metadata);
 }
 
+Thing::Thing(std::shared_ptr<storage::Storage> storage, ThingMetadata metadata)
+    : metadata_(std::move(metadata))
+    , stored_(std::make_shared<StoredContent>())
+{
+    stored_->storage = std::move(storage);
+}
+
+std::shared_ptr<storage::Storage> Thing::default_storage() {
+    static std::mutex mutex;
+    static std::shared_ptr<storage::Storage> storage;
+    static std::filesystem::path storage_dir;
+
+    // Reopen only if CASHEW_DATA_DIR moved (tests point it at scratch dirs)
+    std::lock_guard<std::mutex> lock(mutex);
+    auto dir = default_data_dir() / "storage";
+    if (!storage || dir != storage_dir) {
+        storage = std::make_shared<storage::Storage>(dir);
+        storage_dir = dir;
+    }
+    return storage;
+}
+
 std::optional<Thing> Thing::load(const ContentHash& content_hash) {
-    storage::Storage storage(default_data_dir() / "storage");
+    return load(default_storage(), content_hash);
+}
+
+std::optional<Thing> Thing::load(std::shared_ptr<storage::Storage> storage,
+                                 const ContentHash& content_hash) {
+    if (!storage) {
+        return std::nullopt;
+    }
 
-    auto data_opt = storage.get_content(content_hash);
-    if (!data_opt) {
+    auto content_size = storage->content_size(content_hash);
+    if (!content_size) {
         return std::nullopt;
     }
 
-    auto meta_bytes = storage.get_metadata(metadata_key(content_hash));
+    auto meta_bytes = storage->get_metadata(metadata_key(content_hash));
     if (!meta_bytes) {
         CASHEW_LOG_WARN("Thing metadata missing for {}", content_hash.to_string());
         return std::nullopt;
@@ -226,20 +260,99 @@ std::optional<Thing> Thing::load(const ContentHash& content_hash) {
         return std::nullopt;
     }
 
-    return Thing::create(std::move(*data_opt), *metadata_opt);
+    // Cheap consistency checks now; the content itself is hashed on first use
+    if (metadata_opt->content_hash != content_hash) {
+        CASHEW_LOG_ERROR("Thing metadata for {} describes other content", content_hash.to_string());
+        return std::nullopt;
+    }
+    if (*content_size != metadata_opt->size_bytes || *content_size == 0 || *content_size > MAX_SIZE) {
+        CASHEW_LOG_ERROR("Size mismatch for {}: stored={}, metadata={}",
+                        content_hash.to_string(), *content_size, metadata_opt->size_bytes);
+        return std::nullopt;
+    }
+
+    return Thing(std::move(storage), std::move(*metadata_opt));
+}
+
+const bytes& Thing::data() const {
+    if (!stored_) {
+        return data_;
+    }
+
+    std::lock_guard<std::mutex> lock(stored_->mutex);
+    if (stored_->data) {
+        return *stored_->data;
+    }
+    if (stored_->verified == false) {
+        return empty_bytes();
+    }
+
+    auto data_opt = stored_->storage->get_content(metadata_.content_hash);
+    if (!data_opt || data_opt->size() != metadata_.size_bytes) {
+        CASHEW_LOG_ERROR("Failed to read content for {}", metadata_.content_hash.to_string());
+        return empty_bytes();
+    }
+
+    // Hash the bytes in hand rather than streaming the file a second time
+    if (!stored_->verified) {
+        stored_->verified = ContentHash(crypto::Blake3::hash(*data_opt)) == metadata_.content_hash;
+        if (!*stored_->verified) {
+            CASHEW_LOG_ERROR("Stored content for {} failed integrity check",
+                            metadata_.content_hash.to_string());
+            return empty_bytes();
+        }
+    }
+    stored_->data = std::move(*data_opt);
+    return *stored_->data;
+}
+
+bool Thing::is_resident() const {
+    if (!stored_) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(stored_->mutex);
+    return stored_->data.has_value();
+}
+
+bool Thing::ensure_verified() const {
+    std::lock_guard<std::mutex> lock(stored_->mutex);
+    if (!stored_->verified) {
+        stored_->verified = stored_->storage->verify_content(metadata_.content_hash);
+        if (!*stored_->verified) {
+            CASHEW_LOG_ERROR("Stored content for {} failed integrity check",
+                            metadata_.content_hash.to_string());
+        }
+    }
+    return *stored_->verified;
+}
+
+bool Thing::known_corrupt() const {
+    std::lock_guard<std::mutex> lock(stored_->mutex);
+    return stored_->verified == false;
 }
 
 bool Thing::verify_integrity() const {
+    if (stored_) {
+        return ensure_verified();
+    }
+
     Hash256 computed = crypto::Blake3::hash(data_);
     ContentHash computed_hash(computed);
     return computed_hash == metadata_.content_hash;
 }
 
 bool Thing::save() const {
-    storage::Storage storage(default_data_dir() / "storage");
+    return save(*default_storage());
+}
 
-    if (!storage.put_content(metadata_.content_hash, data_)) {
-        return false;
+bool Thing::save(storage::Storage& storage) const {
+    // A handle already lives in its own storage; only copy content elsewhere
+    const bool content_present = stored_ && stored_->storage.get() == &storage;
+    if (!content_present) {
+        const bytes& content = data();
+        if (content.empty() || !storage.put_content(metadata_.content_hash, content)) {
+            return false;
+        }
     }
 
     const bytes metadata_bytes = metadata_.serialize();
@@ -252,11 +365,27 @@ bool Thing::save() const {
 }
 
 bytes Thing::get_chunk(size_t offset, size_t length) const {
-    if (offset >= data_.size()) {
+    if (offset >= size()) {
         return bytes();
     }
     
-    size_t actual_length = std::min(length, data_.size() - offset);
+    size_t actual_length = std::min(length, size() - offset);
+    
+    if (stored_) {
+        if (known_corrupt()) {
+            return bytes();
+        }
+        {
+            std::lock_guard<std::mutex> lock(stored_->mutex);
+            if (stored_->data) {
+                return bytes(stored_->data->begin() + offset,
+                             stored_->data->begin() + offset + actual_length);
+            }
+        }
+        auto chunk = stored_->storage->get_content_range(metadata_.content_hash, offset, actual_length);
+        return chunk ? std::move(*chunk) : bytes();
+    }
+    
     bytes chunk(data_.begin() + offset, data_.begin() + offset + actual_length);
     return chunk;
 }
@@ -5,6 +5,12 @@
 #include <vector>
 #include <optional>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace cashew::storage {
+class Storage;
+}
 
 namespace cashew::core {
 
@@ -63,6 +69,13 @@ struct ThingMetadata {
  * 
  * Things are content-addressed, immutable units with max 500MB size.
  * They can be games, dictionaries, datasets, apps, or any static content.
+ * 
+ * A created Thing holds its content in memory. A loaded Thing is a handle:
+ * only metadata is read up front and get_chunk() reads ranges straight from
+ * storage without hashing the rest of the file. Verification is explicit:
+ * verify_integrity() streams the content through BLAKE3 once per handle
+ * (copies share the result), and data() hashes the payload it pulls in.
+ * Once a handle is known to be corrupt, get_chunk() serves nothing.
  */
 class Thing {
 public:
@@ -83,12 +96,26 @@ public:
     );
     
     /**
-     * Load a Thing from storage
+     * Load a Thing handle from the default storage (CASHEW_DATA_DIR)
      * @param content_hash Content hash
      * @return Thing or nullopt if not found
      */
     static std::optional<Thing> load(const ContentHash& content_hash);
     
+    /**
+     * Load a Thing handle from storage (metadata only; content is lazy)
+     * @param storage Storage holding the content and metadata
+     * @param content_hash Content hash
+     * @return Thing or nullopt if not found or inconsistent
+     */
+    static std::optional<Thing> load(std::shared_ptr<storage::Storage> storage,
+                                     const ContentHash& content_hash);
+    
+    /**
+     * Process-wide storage under CASHEW_DATA_DIR, opened on first use
+     */
+    static std::shared_ptr<storage::Storage> default_storage();
+    
     /**
      * Get content hash
      */
@@ -100,31 +127,47 @@ public:
     const ThingMetadata& metadata() const { return metadata_; }
     
     /**
-     * Get content data
+     * Get content data (loads and verifies the whole payload of a handle;
+     * empty if it fails verification)
      */
-    const bytes& data() const { return data_; }
+    const bytes& data() const;
     
     /**
      * Get content size
      */
-    size_t size() const { return data_.size(); }
+    size_t size() const { return metadata_.size_bytes; }
     
     /**
-     * Verify content integrity (hash matches)
+     * True if the content is held in memory
+     */
+    bool is_resident() const;
+    
+    /**
+     * Verify content integrity (hash matches); a handle hashes its stored
+     * content on the first call only
      */
     bool verify_integrity() const;
     
     /**
-     * Save Thing to storage
+     * Save Thing to the default storage
      * @return True if successful
      */
     bool save() const;
     
+    /**
+     * Save Thing to storage (content is not rewritten if already there)
+     * @return True if successful
+     */
+    bool save(storage::Storage& storage) const;
+    
     /**
      * Get a chunk of the content
+     *
+     * A handle reads just this range and does not verify it; call
+     * verify_integrity() first where stored content may be untrusted.
      * @param offset Start offset
      * @param length Chunk length
-     * @return Chunk data
+     * @return Chunk data (empty if the handle failed verification)
      */
     bytes get_chunk(size_t offset, size_t length) const;
 
@@ -134,8 +177,22 @@ private:
         , metadata_(std::move(metadata))
     {}
     
+    Thing(std::shared_ptr<storage::Storage> storage, ThingMetadata metadata);
+    
+    // Backing state of a loaded handle, shared by its copies
+    struct StoredContent {
+        std::shared_ptr<storage::Storage> storage;
+        std::mutex mutex;
+        std::optional<bool> verified;   // Unset until hashed once
+        std::optional<bytes> data;      // Set once data() pulls it in
+    };
+    
+    bool ensure_verified() const;
+    bool known_corrupt() const;
+    
     bytes data_;
     ThingMetadata metadata_;
+    std::shared_ptr<StoredContent> stored_;
 };
 
 } // namespace cashew::core
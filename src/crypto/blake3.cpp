@@ -2,6 +2,7 @@
 #include <blake3.h>
 #include <sstream>
 #include <iomanip>
+#include <istream>
 
 namespace cashew::crypto {
 
@@ -44,6 +45,23 @@ Hash256 Blake3::hash(const std::string& str) {
     return hash(data);
 }
 
+std::optional<Hash256> Blake3::hash_stream(std::istream& in) {
+    blake3_hasher hasher;
+    blake3_hasher_init(&hasher);
+    
+    char buffer[64 * 1024];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        blake3_hasher_update(&hasher, buffer, static_cast<size_t>(in.gcount()));
+    }
+    if (in.bad()) {
+        return std::nullopt;
+    }
+    
+    Hash256 result;
+    blake3_hasher_finalize(&hasher, result.data(), result.size());
+    return result;
+}
+
 std::string Blake3::hash_to_hex(const Hash256& hash) {
     return bytes_to_hex(hash.data(), hash.size());
 }
@@ -2,6 +2,7 @@
 
 #include "cashew/common.hpp"
 #include <optional>
+#include <iosfwd>
 
 namespace cashew::crypto {
 
@@ -22,6 +23,12 @@ public:
      */
     static Hash256 hash(const std::string& str);
     
+    /**
+     * Hash everything readable from a stream without buffering it whole
+     * @return Hash, or nullopt on a read error
+     */
+    static std::optional<Hash256> hash_stream(std::istream& in);
+    
     /**
      * Convert hash to hex string
      */
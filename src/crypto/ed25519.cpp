@@ -54,6 +54,17 @@ std::pair<PublicKey, SecretKey> Ed25519::generate_keypair() {
     return {pk, sk};
 }
 
+std::pair<PublicKey, SecretKey> Ed25519::keypair_from_seed(const Hash256& seed) {
+    PublicKey pk;
+    SecretKey sk;
+    
+    if (crypto_sign_seed_keypair(pk.data(), sk.data(), seed.data()) != 0) {
+        throw std::runtime_error("Failed to derive Ed25519 keypair");
+    }
+    
+    return {pk, sk};
+}
+
 Signature Ed25519::sign(const bytes& message, const SecretKey& secret_key) {
     Signature sig;
     unsigned long long sig_len;
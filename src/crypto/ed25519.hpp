@@ -18,6 +18,12 @@ public:
      */
     static std::pair<PublicKey, SecretKey> generate_keypair();
     
+    /**
+     * Derive a keypair deterministically from a 32-byte seed
+     * (simulations and tests that need reproducible identities)
+     */
+    static std::pair<PublicKey, SecretKey> keypair_from_seed(const Hash256& seed);
+    
     /**
      * Sign a message with a secret key
      * @param message The message to sign
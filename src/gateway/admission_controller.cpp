@@ -0,0 +1,160 @@
+#include "cashew/gateway/admission_controller.hpp"
+#include <algorithm>
+
+namespace cashew {
+namespace gateway {
+
+const char* endpoint_class_to_string(EndpointClass endpoint_class) {
+    switch (endpoint_class) {
+        case EndpointClass::STATIC: return "static";
+        case EndpointClass::CONTENT: return "content";
+        case EndpointClass::API: return "api";
+        case EndpointClass::AUTH: return "auth";
+        case EndpointClass::PRIORITY: return "priority";
+        default: return "unknown";
+    }
+}
+
+AdmissionController::Permit::~Permit() {
+    release();
+}
+
+AdmissionController::Permit::Permit(Permit&& other) noexcept
+    : gate_(other.gate_)
+    , admitted_(other.admitted_)
+    , queued_for_(other.queued_for_)
+{
+    other.gate_ = nullptr;
+    other.admitted_ = false;
+}
+
+AdmissionController::Permit& AdmissionController::Permit::operator=(Permit&& other) noexcept {
+    if (this != &other) {
+        release();
+        gate_ = other.gate_;
+        admitted_ = other.admitted_;
+        queued_for_ = other.queued_for_;
+        other.gate_ = nullptr;
+        other.admitted_ = false;
+    }
+    return *this;
+}
+
+void AdmissionController::Permit::release() {
+    if (!gate_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(gate_->mutex);
+        if (gate_->waiters.empty()) {
+            gate_->in_flight--;
+        } else {
+            // Hand the slot straight to the oldest waiter; notified under the
+            // lock because the waiter lives on its own stack
+            Waiter* next = gate_->waiters.front();
+            gate_->waiters.pop_front();
+            next->granted = true;
+            next->granted_cv.notify_one();
+        }
+    }
+    gate_ = nullptr;
+}
+
+AdmissionController::AdmissionController(const AdmissionConfig& config)
+    : config_(config)
+{
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ENDPOINT_CLASS_COUNT; ++i) {
+        gates_[i] = std::make_unique<Gate>();
+        gates_[i]->limit = config_.max_concurrent[i];
+        gates_[i]->last_empty = now;
+        gates_[i]->stats.limit = config_.max_concurrent[i];
+    }
+}
+
+AdmissionController::~AdmissionController() = default;
+
+AdmissionController::Permit AdmissionController::acquire(EndpointClass endpoint_class) {
+    Gate& gate = *gates_[static_cast<size_t>(endpoint_class)];
+    Permit permit;
+
+    std::unique_lock<std::mutex> lock(gate.mutex);
+    const auto arrived = std::chrono::steady_clock::now();
+    if (gate.waiters.empty()) {
+        gate.last_empty = arrived;
+    }
+
+    // A newcomer never takes a slot ahead of queued waiters: release() hands
+    // each freed slot to the front of the queue, already counted in flight
+    if (!gate.waiters.empty() || (gate.limit != 0 && gate.in_flight >= gate.limit)) {
+        const bool standing = arrived - gate.last_empty > config_.interval;
+        const auto budget = standing ? config_.target_queue_delay : config_.max_queue_delay;
+
+        Waiter waiter;
+        gate.waiters.push_back(&waiter);
+        const bool got_slot = waiter.granted_cv.wait_until(lock, arrived + budget,
+                                                           [&waiter]() { return waiter.granted; });
+        if (!got_slot) {
+            gate.waiters.erase(std::find(gate.waiters.begin(), gate.waiters.end(), &waiter));
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (gate.waiters.empty()) {
+            gate.last_empty = now;
+        }
+        if (!got_slot) {
+            gate.stats.shed++;
+            return permit;
+        }
+
+        permit.queued_for_ = std::chrono::duration_cast<std::chrono::microseconds>(now - arrived);
+        gate.stats.queued++;
+        gate.stats.total_queue_us += static_cast<uint64_t>(permit.queued_for_.count());
+    } else {
+        gate.in_flight++;
+    }
+
+    gate.stats.admitted++;
+    gate.stats.peak_in_flight = std::max(gate.stats.peak_in_flight, gate.in_flight);
+    permit.gate_ = &gate;
+    permit.admitted_ = true;
+    return permit;
+}
+
+AdmissionController::Permit AdmissionController::try_acquire(EndpointClass endpoint_class) {
+    Gate& gate = *gates_[static_cast<size_t>(endpoint_class)];
+    Permit permit;
+
+    std::lock_guard<std::mutex> lock(gate.mutex);
+    if (!gate.waiters.empty() || (gate.limit != 0 && gate.in_flight >= gate.limit)) {
+        gate.stats.shed++;
+        return permit;
+    }
+
+    gate.in_flight++;
+    gate.stats.admitted++;
+    gate.stats.peak_in_flight = std::max(gate.stats.peak_in_flight, gate.in_flight);
+    permit.gate_ = &gate;
+    permit.admitted_ = true;
+    return permit;
+}
+
+AdmissionController::Statistics AdmissionController::get_statistics() const {
+    Statistics stats;
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ENDPOINT_CLASS_COUNT; ++i) {
+        const Gate& gate = *gates_[i];
+        std::lock_guard<std::mutex> lock(gate.mutex);
+        auto& out = stats.classes[i];
+        out = gate.stats;
+        out.in_flight = gate.in_flight;
+        out.waiting = gate.waiters.size();
+        out.standing_queue = !gate.waiters.empty() && now - gate.last_empty > config_.interval;
+        stats.admitted += out.admitted;
+        stats.shed += out.shed;
+    }
+    return stats;
+}
+
+} // namespace gateway
+} // namespace cashew
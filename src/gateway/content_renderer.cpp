@@ -1,9 +1,13 @@
 #include "cashew/gateway/content_renderer.hpp"
 #include "../security/content_integrity.hpp"
+#include "../storage/kv_store.hpp"
+#include "../runtime/executor.hpp"
 #include "../utils/logger.hpp"
 #include <algorithm>
+#include <cctype>
 #include <sstream>
 #include <iomanip>
+#include <string_view>
 
 namespace cashew {
 namespace gateway {
@@ -38,13 +42,65 @@ bool has_extension(const std::string& filename, const std::string& ext) {
     return filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0;
 }
 
+constexpr std::string_view THING_PATH = "/api/thing/";
+constexpr std::string_view POPULARITY_PREFIX = "popularity/";
+
+int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parse exactly 64 hex digits at pos that are not part of a longer hex run
+bool parse_hash_at(std::string_view text, size_t pos, Hash256& out) {
+    if (pos + 64 > text.size()) {
+        return false;
+    }
+    if (pos + 64 < text.size() && hex_value(text[pos + 64]) >= 0) {
+        return false;
+    }
+    for (size_t i = 0; i < 32; ++i) {
+        int hi = hex_value(text[pos + i * 2]);
+        int lo = hex_value(text[pos + i * 2 + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+uint64_t get_u64(const std::vector<uint8_t>& in, size_t offset) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[offset + i]) << (i * 8);
+    }
+    return value;
+}
+
 } // anonymous namespace
 
 ContentRenderer::ContentRenderer(const ContentRendererConfig& config)
-    : config_(config)
-{}
+    : config_(config),
+      prefetch_guard_(std::make_shared<PrefetchGuard>())
+{
+    prefetch_guard_->owner = this;
+}
 
 ContentRenderer::~ContentRenderer() {
+    {
+        // Disarm queued prefetches and wait for running ones
+        std::unique_lock<std::mutex> lock(prefetch_guard_->mutex);
+        prefetch_guard_->owner = nullptr;
+        prefetch_guard_->idle_cv.wait(lock, [this]() { return prefetch_guard_->running == 0; });
+    }
     invalidate_cache();
 }
 
@@ -59,46 +115,44 @@ std::optional<ContentRenderer::RenderResult> ContentRenderer::render_content(
     // Try cache first
     auto cached = get_from_cache(content_hash);
     
-    std::vector<uint8_t> data;
+    // A cache hit owns its copy; a miss shares the fetched buffer with
+    // everyone else who asked for it at the same time
+    std::vector<uint8_t> owned;
+    std::shared_ptr<const std::vector<uint8_t>> shared;
     
     if (cached) {
         CASHEW_LOG_DEBUG("Cache hit for content: {}", hash_to_string(content_hash));
-        data = cached->data;
+        owned = std::move(cached->data);
         
         std::lock_guard<std::mutex> stats_lock(stats_mutex_);
         stats_.hit_count++;
     } else {
         CASHEW_LOG_DEBUG("Cache miss for content: {}", hash_to_string(content_hash));
         
-        // Fetch from network
-        auto fetched = fetch_from_network(content_hash);
-        if (!fetched) {
+        bool fetched_here = false;
+        shared = fetch_coalesced(content_hash, fetched_here);
+        
+        {
             std::lock_guard<std::mutex> stats_lock(stats_mutex_);
             stats_.miss_count++;
-            return std::nullopt;
+            if (!fetched_here) {
+                stats_.coalesced_count++;
+            }
         }
         
-        data = *fetched;
-        
-        // Verify content integrity (defense in depth)
-        auto integrity_result = security::ContentIntegrityChecker::verify_content(data, content_hash);
-        if (!integrity_result.is_valid) {
-            CASHEW_LOG_ERROR("Content integrity verification failed: {}", 
-                           integrity_result.error_message);
-            std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-            stats_.miss_count++;
+        if (!shared) {
             return std::nullopt;
         }
         
-        CASHEW_LOG_DEBUG("Content integrity verified ({} bytes)", integrity_result.content_size);
-        
-        // Add to cache
-        add_to_cache(content_hash, data);
-        
-        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
-        stats_.miss_count++;
+        // A freshly served page will be followed by requests for its assets
+        if (fetched_here && config_.prefetch_html_references && prefetch_executor_ && looks_like_html(*shared)) {
+            schedule_reference_prefetch(*shared);
+        }
     }
     
+    const std::vector<uint8_t>& data = shared ? *shared : owned;
+    record_access(content_hash, data.size());
+    
     // Extract metadata
     auto metadata = extract_metadata(content_hash, data);
     
@@ -123,8 +177,10 @@ std::optional<ContentRenderer::RenderResult> ContentRenderer::render_content(
         
         CASHEW_LOG_DEBUG("Serving partial content: {}-{}/{}", 
                         range_start, range_end, data.size());
+    } else if (shared) {
+        result.data = *shared;
     } else {
-        result.data = std::move(data);
+        result.data = std::move(owned);
     }
     
     // Sanitize HTML if enabled
@@ -180,19 +236,158 @@ bool ContentRenderer::prefetch(const Hash256& content_hash) {
         return true;
     }
     
-    // Fetch from network
-    auto data = fetch_from_network(content_hash);
-    if (!data) {
+    // Joins a client's in-flight fetch rather than racing it
+    bool fetched_here = false;
+    if (!fetch_coalesced(content_hash, fetched_here)) {
         return false;
     }
     
-    // Add to cache
-    add_to_cache(content_hash, *data);
+    if (fetched_here) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+        stats_.prefetch_count++;
+    }
     
     CASHEW_LOG_DEBUG("Prefetched content: {}", hash_to_string(content_hash));
     return true;
 }
 
+void ContentRenderer::set_prefetch_executor(std::shared_ptr<runtime::Executor> executor) {
+    prefetch_executor_ = std::move(executor);
+}
+
+std::vector<Hash256> ContentRenderer::extract_content_references(
+    const std::vector<uint8_t>& html,
+    size_t max_references
+) {
+    std::string_view text(reinterpret_cast<const char*>(html.data()), html.size());
+    std::vector<Hash256> references;
+    
+    auto add = [&references](const Hash256& hash) {
+        if (std::find(references.begin(), references.end(), hash) == references.end()) {
+            references.push_back(hash);
+        }
+    };
+    
+    // Walk the document once: gateway URLs anywhere (src, href, CSS url(),
+    // srcset...) and attribute values that are a bare content hash
+    for (size_t pos = 0; pos < text.size() && references.size() < max_references; ++pos) {
+        Hash256 hash{};
+        if (text.compare(pos, THING_PATH.size(), THING_PATH) == 0) {
+            if (parse_hash_at(text, pos + THING_PATH.size(), hash)) {
+                add(hash);
+            }
+            pos += THING_PATH.size() - 1;
+        } else if ((text[pos] == '"' || text[pos] == '\'') && pos > 0 && text[pos - 1] == '=') {
+            if (parse_hash_at(text, pos + 1, hash) && pos + 65 < text.size() && text[pos + 65] == text[pos]) {
+                add(hash);
+            }
+        }
+    }
+    
+    return references;
+}
+
+std::vector<ContentRenderer::PopularityEntry> ContentRenderer::get_popular_content(size_t max_count) const {
+    std::vector<PopularityEntry> entries;
+    {
+        std::lock_guard<std::mutex> lock(popularity_mutex_);
+        entries.reserve(popularity_.size());
+        for (const auto& [hash, counter] : popularity_) {
+            entries.push_back({hash, counter.count, counter.size_bytes});
+        }
+    }
+    
+    size_t count = std::min(max_count, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+        [](const PopularityEntry& a, const PopularityEntry& b) {
+            return a.access_count > b.access_count;
+        });
+    entries.resize(count);
+    return entries;
+}
+
+bool ContentRenderer::save_popularity(storage::KVStore& store) const {
+    storage::WriteBatch batch;
+    std::unordered_set<std::string> live_keys;
+    
+    {
+        std::lock_guard<std::mutex> lock(popularity_mutex_);
+        for (const auto& [hash, counter] : popularity_) {
+            std::string key = std::string(POPULARITY_PREFIX) + hash_to_string(hash);
+            std::vector<uint8_t> value;
+            value.reserve(16);
+            put_u64(value, counter.count);
+            put_u64(value, counter.size_bytes);
+            batch.put(key, value);
+            live_keys.insert(std::move(key));
+        }
+    }
+    
+    for (const auto& key : store.keys_with_prefix(std::string(POPULARITY_PREFIX))) {
+        if (live_keys.count(key) == 0) {
+            batch.remove(key);
+        }
+    }
+    
+    return batch.empty() || store.write(batch);
+}
+
+bool ContentRenderer::load_popularity(const storage::KVStore& store) {
+    std::unordered_map<Hash256, PopularityCounter> loaded;
+    
+    store.for_each_prefix(std::string(POPULARITY_PREFIX), [&](const std::string& key, const bytes& value) {
+        std::string_view hex(key);
+        hex.remove_prefix(POPULARITY_PREFIX.size());
+        
+        Hash256 hash{};
+        if (hex.size() != 64 || value.size() != 16 || !parse_hash_at(hex, 0, hash)) {
+            CASHEW_LOG_WARN("Skipping invalid popularity record: {}", key);
+            return true;
+        }
+        
+        // Halve on load: yesterday's traffic should not outrank today's forever
+        PopularityCounter counter;
+        counter.count = std::max<uint64_t>(1, get_u64(value, 0) / 2);
+        counter.size_bytes = get_u64(value, 8);
+        loaded[hash] = counter;
+        return loaded.size() < config_.popularity_capacity;
+    });
+    
+    std::lock_guard<std::mutex> lock(popularity_mutex_);
+    popularity_ = std::move(loaded);
+    CASHEW_LOG_INFO("Loaded popularity log ({} Things)", popularity_.size());
+    return true;
+}
+
+size_t ContentRenderer::warm_cache(size_t byte_budget) {
+    if (byte_budget == 0) {
+        byte_budget = static_cast<size_t>(
+            static_cast<double>(config_.max_cache_size_bytes) * config_.warm_cache_fraction);
+    }
+    
+    size_t warmed = 0;
+    size_t used = 0;
+    for (const auto& entry : get_popular_content(config_.popularity_capacity)) {
+        if (used >= byte_budget || warmed >= config_.max_cached_items) {
+            break;
+        }
+        if (entry.size_bytes > byte_budget - used) {
+            continue;  // A smaller, slightly less popular Thing may still fit
+        }
+        if (is_cached(entry.content_hash)) {
+            used += entry.size_bytes;
+            continue;
+        }
+        if (prefetch(entry.content_hash)) {
+            used += entry.size_bytes;
+            warmed++;
+        }
+    }
+    
+    CASHEW_LOG_INFO("Cache warmed with {} popular Things ({} bytes)", warmed, used);
+    return warmed;
+}
+
 bool ContentRenderer::is_cached(const Hash256& content_hash) const {
     std::lock_guard<std::mutex> lock(cache_mutex_);
     return cache_.find(content_hash) != cache_.end();
@@ -518,6 +713,66 @@ std::optional<std::vector<uint8_t>> ContentRenderer::fetch_from_network(
     }
 }
 
+std::shared_ptr<const std::vector<uint8_t>> ContentRenderer::fetch_coalesced(
+    const Hash256& content_hash,
+    bool& fetched_here
+) {
+    std::shared_ptr<InFlightFetch> flight;
+    {
+        std::unique_lock<std::mutex> lock(fetch_mutex_);
+        auto [it, inserted] = in_flight_fetches_.try_emplace(content_hash);
+        if (!inserted) {
+            flight = it->second;
+            fetch_cv_.wait(lock, [&flight]() { return flight->done; });
+            fetched_here = false;
+            return flight->data;
+        }
+        it->second = std::make_shared<InFlightFetch>();
+        flight = it->second;
+    }
+    fetched_here = true;
+    
+    // The previous leader may have filled the cache between our miss and now
+    std::shared_ptr<const std::vector<uint8_t>> result;
+    if (auto cached = get_from_cache(content_hash)) {
+        result = std::make_shared<const std::vector<uint8_t>>(std::move(cached->data));
+    } else {
+        {
+            // Waiters on other hashes queue here; waiters on this one are already parked
+            std::unique_lock<std::mutex> lock(fetch_mutex_);
+            const size_t limit = std::max<size_t>(1, config_.max_concurrent_fetches);
+            fetch_cv_.wait(lock, [this, limit]() { return active_fetches_ < limit; });
+            active_fetches_++;
+        }
+        
+        auto fetched = fetch_from_network(content_hash);
+        if (fetched) {
+            // Verify content integrity (defense in depth), once for all waiters
+            auto integrity_result = security::ContentIntegrityChecker::verify_content(*fetched, content_hash);
+            if (integrity_result.is_valid) {
+                CASHEW_LOG_DEBUG("Content integrity verified ({} bytes)", integrity_result.content_size);
+                result = std::make_shared<const std::vector<uint8_t>>(std::move(*fetched));
+                add_to_cache(content_hash, *result);
+            } else {
+                CASHEW_LOG_ERROR("Content integrity verification failed: {}",
+                               integrity_result.error_message);
+            }
+        }
+        
+        std::lock_guard<std::mutex> lock(fetch_mutex_);
+        active_fetches_--;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(fetch_mutex_);
+        flight->data = result;
+        flight->done = true;
+        in_flight_fetches_.erase(content_hash);
+    }
+    fetch_cv_.notify_all();
+    return result;
+}
+
 void ContentRenderer::add_to_cache(const Hash256& content_hash, const std::vector<uint8_t>& data) {
     std::lock_guard<std::mutex> lock(cache_mutex_);
     
@@ -602,6 +857,85 @@ void ContentRenderer::cleanup_expired() {
     }
 }
 
+void ContentRenderer::record_access(const Hash256& content_hash, size_t size_bytes) {
+    std::lock_guard<std::mutex> lock(popularity_mutex_);
+    
+    auto it = popularity_.find(content_hash);
+    if (it != popularity_.end()) {
+        it->second.count++;
+        it->second.size_bytes = size_bytes;
+        return;
+    }
+    
+    uint64_t inherited = 0;
+    if (popularity_.size() >= config_.popularity_capacity && !popularity_.empty()) {
+        // Space-saving: the newcomer replaces the least counted entry and
+        // inherits its count, so heavy hitters are never lost
+        auto min_it = std::min_element(popularity_.begin(), popularity_.end(),
+            [](const auto& a, const auto& b) { return a.second.count < b.second.count; });
+        inherited = min_it->second.count;
+        popularity_.erase(min_it);
+    }
+    
+    popularity_[content_hash] = PopularityCounter{inherited + 1, size_bytes};
+}
+
+void ContentRenderer::schedule_reference_prefetch(const std::vector<uint8_t>& html) {
+    auto references = extract_content_references(html, config_.max_prefetch_references);
+    
+    for (const auto& hash : references) {
+        if (is_cached(hash)) {
+            continue;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(prefetch_guard_->mutex);
+            if (prefetch_guard_->in_flight.size() >= config_.max_concurrent_fetches) {
+                break;
+            }
+            if (!prefetch_guard_->in_flight.insert(hash).second) {
+                continue;  // Another page already queued it
+            }
+        }
+        
+        prefetch_executor_->submit([guard = prefetch_guard_, hash]() {
+            ContentRenderer* owner = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(guard->mutex);
+                owner = guard->owner;
+                if (!owner) {
+                    return;
+                }
+                guard->running++;
+            }
+            
+            owner->prefetch(hash);
+            
+            std::lock_guard<std::mutex> lock(guard->mutex);
+            guard->in_flight.erase(hash);
+            guard->running--;
+            guard->idle_cv.notify_all();
+        }, runtime::Priority::BULK);
+    }
+}
+
+bool ContentRenderer::looks_like_html(const std::vector<uint8_t>& data) {
+    // Sniff like a browser would: leading markup within the first few hundred bytes
+    const size_t window = std::min<size_t>(data.size(), 512);
+    std::string head;
+    head.reserve(window);
+    for (size_t i = 0; i < window; ++i) {
+        head.push_back(static_cast<char>(std::tolower(data[i])));
+    }
+    
+    size_t start = head.find_first_not_of(" \t\r\n\xEF\xBB\xBF");
+    if (start == std::string::npos || head[start] != '<') {
+        return false;
+    }
+    return head.compare(start, 14, "<!doctype html") == 0 ||
+           head.find("<html", start) != std::string::npos;
+}
+
 ContentMetadata ContentRenderer::extract_metadata(
     const Hash256& content_hash,
     const std::vector<uint8_t>& data
@@ -1,12 +1,16 @@
 #include "cashew/gateway/gateway_server.hpp"
 #include "cashew/gateway/content_renderer.hpp"
+#include "native_http_server.hpp"
+#include "../runtime/executor.hpp"
 #include "../storage/storage.hpp"
 #include "../network/network.hpp"
 #include "../crypto/random.hpp"
 #include "../crypto/blake3.hpp"
 #include "../crypto/ed25519.hpp"
 #include "../security/content_integrity.hpp"
+#include "../security/admission.hpp"
 #include "../utils/logger.hpp"
+#include "../utils/maintenance_scheduler.hpp"
 
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "cashew/third_party/httplib.h"
@@ -52,12 +56,14 @@ std::string generate_session_id() {
         case HttpStatus::OK: return "200 OK";
         case HttpStatus::CREATED: return "201 Created";
         case HttpStatus::NO_CONTENT: return "204 No Content";
+        case HttpStatus::NOT_MODIFIED: return "304 Not Modified";
         case HttpStatus::BAD_REQUEST: return "400 Bad Request";
         case HttpStatus::UNAUTHORIZED: return "401 Unauthorized";
         case HttpStatus::FORBIDDEN: return "403 Forbidden";
         case HttpStatus::NOT_FOUND: return "404 Not Found";
         case HttpStatus::METHOD_NOT_ALLOWED: return "405 Method Not Allowed";
         case HttpStatus::CONFLICT: return "409 Conflict";
+        case HttpStatus::PAYLOAD_TOO_LARGE: return "413 Payload Too Large";
         case HttpStatus::INTERNAL_ERROR: return "500 Internal Server Error";
         case HttpStatus::NOT_IMPLEMENTED: return "501 Not Implemented";
         case HttpStatus::SERVICE_UNAVAILABLE: return "503 Service Unavailable";
@@ -102,6 +108,41 @@ std::string to_lower_ascii(std::string value) {
     return value;
 }
 
+// Header lookup that tolerates lower-cased names from proxies
+const std::string* find_header(const HttpRequest& request, const std::string& name) {
+    if (auto it = request.headers.find(name); it != request.headers.end()) {
+        return &it->second;
+    }
+    const std::string lowered = to_lower_ascii(name);
+    for (const auto& [key, value] : request.headers) {
+        if (to_lower_ascii(key) == lowered) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+bool is_hash_hex(const std::string& text) {
+    return text.size() == 64 && std::all_of(text.begin(), text.end(), [](unsigned char c) {
+        return std::isxdigit(c) != 0;
+    });
+}
+
+// Content is addressed by hash, so a matching ETag never goes stale. "*" is
+// not handled here: it only matches once the content is known to exist.
+bool etag_matches(const HttpRequest& request, const std::string& hash_hex) {
+    const std::string* if_none_match = find_header(request, "If-None-Match");
+    if (!if_none_match || !is_hash_hex(hash_hex)) {
+        return false;
+    }
+    return if_none_match->find("\"" + hash_hex + "\"") != std::string::npos;
+}
+
+bool if_none_match_any(const HttpRequest& request) {
+    const std::string* if_none_match = find_header(request, "If-None-Match");
+    return if_none_match && *if_none_match == "*";
+}
+
 std::string mime_from_path(const std::filesystem::path& path) {
     const std::string ext = to_lower_ascii(path.extension().string());
     if (ext == ".html" || ext == ".htm") return "text/html; charset=utf-8";
@@ -158,6 +199,23 @@ GatewayServer::GatewayServer(const GatewayConfig& config)
     : config_(config)
     , http_server_(std::make_unique<HttpServerImpl>())
 {
+    security::AdmissionPolicy admission_policy;
+    admission_policy.max_per_ip_per_minute = static_cast<uint32_t>(config_.max_requests_per_minute);
+    admission_policy.max_per_ip_per_hour = static_cast<uint32_t>(config_.max_requests_per_hour);
+    admission_policy.max_per_subnet_per_minute = static_cast<uint32_t>(config_.max_requests_per_subnet_per_minute);
+    admission_ = std::make_shared<security::IPAdmissionEngine>(admission_policy);
+    
+    AdmissionConfig admission_config;
+    admission_config.max_concurrent[static_cast<size_t>(EndpointClass::STATIC)] = config_.max_concurrent_static;
+    admission_config.max_concurrent[static_cast<size_t>(EndpointClass::CONTENT)] = config_.max_concurrent_content;
+    admission_config.max_concurrent[static_cast<size_t>(EndpointClass::API)] = config_.max_concurrent_api;
+    admission_config.max_concurrent[static_cast<size_t>(EndpointClass::AUTH)] = config_.max_concurrent_auth;
+    admission_config.max_concurrent[static_cast<size_t>(EndpointClass::PRIORITY)] = config_.max_concurrent_priority;
+    admission_config.target_queue_delay = config_.admission_target_delay;
+    admission_config.interval = config_.admission_interval;
+    admission_config.max_queue_delay = config_.admission_max_queue_delay;
+    admission_control_ = std::make_unique<AdmissionController>(admission_config);
+    
     stats_.started_at = std::chrono::system_clock::now();
     register_default_handlers();
 }
@@ -193,6 +251,19 @@ void GatewayServer::set_network_registry(std::shared_ptr<network::NetworkRegistr
     CASHEW_LOG_INFO("Network registry connected to gateway");
 }
 
+void GatewayServer::set_admission_engine(std::shared_ptr<security::IPAdmissionEngine> engine) {
+    if (!engine) {
+        return;
+    }
+    // Request windows and limits stay the gateway's own
+    admission_->share_blocks_with(*engine);
+    CASHEW_LOG_INFO("Shared admission block list connected to gateway");
+}
+
+void GatewayServer::set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+    maintenance_ = std::move(scheduler);
+}
+
 bool GatewayServer::start() {
     if (running_) {
         CASHEW_LOG_WARN("Gateway server already running");
@@ -204,6 +275,50 @@ bool GatewayServer::start() {
     
     running_ = true;
     
+    if (config_.use_native_http_engine && NativeHttpServer::is_supported()) {
+        http_executor_ = std::make_shared<runtime::Executor>(config_.http_worker_threads);
+        http_executor_->start();
+        
+        NativeHttpOptions options;
+        options.bind_address = config_.bind_address;
+        options.port = config_.http_port;
+        options.event_loops = config_.http_event_loops;
+        options.max_body_bytes = config_.max_request_body_size;
+        native_server_ = std::make_unique<NativeHttpServer>(
+            options,
+            [this](const HttpRequest& request) { return handle_request(request); },
+            http_executor_,
+            [](const HttpRequest& request) { return is_priority_request(request); });
+        
+        if (!native_server_->start()) {
+            native_server_.reset();
+            http_executor_->stop();
+            http_executor_.reset();
+            running_ = false;
+            return false;
+        }
+    } else {
+        if (config_.use_native_http_engine) {
+            CASHEW_LOG_WARN("Native HTTP engine not supported on this platform, using httplib");
+        }
+        start_httplib();
+    }
+    
+    if (maintenance_) {
+        maintenance_task_ = maintenance_->schedule_periodic(
+            "gateway.maintenance", std::chrono::seconds(10),
+            [this]() { run_maintenance(); });
+    }
+    
+    CASHEW_LOG_INFO("Gateway server started successfully");
+    return true;
+}
+
+uint16_t GatewayServer::bound_port() const {
+    return native_server_ ? native_server_->port() : config_.http_port;
+}
+
+void GatewayServer::start_httplib() {
     // Setup HTTP routes
     setup_http_routes();
     
@@ -227,9 +342,6 @@ bool GatewayServer::start() {
     
     // Give server time to start
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    
-    CASHEW_LOG_INFO("Gateway server started successfully");
-    return true;
 }
 
 void GatewayServer::stop() {
@@ -240,6 +352,18 @@ void GatewayServer::stop() {
     CASHEW_LOG_INFO("Stopping gateway server");
     running_ = false;
     
+    if (maintenance_ && maintenance_task_ != 0) {
+        maintenance_->cancel(maintenance_task_);
+        maintenance_task_ = 0;
+    }
+    
+    if (native_server_) {
+        native_server_->stop();
+        native_server_.reset();
+        http_executor_->stop();
+        http_executor_.reset();
+    }
+    
     // Stop HTTP server (this will unblock listen())
     http_server_->server.stop();
     
@@ -262,19 +386,23 @@ void GatewayServer::register_handler(
                      method_to_string(method), path_pattern);
 }
 
-void GatewayServer::process_requests() {
-    while (running_) {
-        // Periodic session cleanup
-        cleanup_sessions();
-        
-        // Sleep between cleanup cycles
-        std::this_thread::sleep_for(std::chrono::seconds(10));
-    }
+void GatewayServer::run_maintenance() {
+    cleanup_sessions();
+    admission_->cleanup();
 }
 
 void GatewayServer::setup_http_routes() {
     auto& server = http_server_->server;
 
+    // Same as the native engine: small keep-alive responses must not wait on Nagle
+    server.set_tcp_nodelay(true);
+
+    if (config_.http_worker_threads > 0) {
+        // Admission control sheds excess work, so the pool only needs to cover the class limits
+        const size_t workers = config_.http_worker_threads;
+        server.new_task_queue = [workers]() { return new httplib::ThreadPool(workers); };
+    }
+
     auto forward_request = [this](HttpMethod method, const httplib::Request& req, httplib::Response& res) {
         HttpRequest cashew_req;
         cashew_req.method = method;
@@ -334,9 +462,11 @@ void GatewayServer::setup_http_routes() {
 }
 
 HttpResponse GatewayServer::handle_request(const HttpRequest& request) {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    stats_.total_requests++;
-    stats_.bytes_received += request.body.size();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.total_requests++;
+        stats_.bytes_received += request.body.size();
+    }
     
     // Check rate limiting
     if (!check_rate_limit(request.client_ip)) {
@@ -347,8 +477,32 @@ HttpResponse GatewayServer::handle_request(const HttpRequest& request) {
         return response;
     }
     
+    // Admission control: bounded work per endpoint class. Cheap requests have
+    // their own class and never queue (they may run on an event loop thread).
+    const bool priority = is_priority_request(request);
+    const auto endpoint_class = priority ? EndpointClass::PRIORITY : classify_endpoint(request);
+    auto permit = priority ? admission_control_->try_acquire(endpoint_class)
+                           : admission_control_->acquire(endpoint_class);
+    if (!permit) {
+        CASHEW_LOG_DEBUG("Shed {} request for {}", endpoint_class_to_string(endpoint_class), request.path);
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.requests_shed++;
+        }
+        HttpResponse response;
+        response.status = HttpStatus::SERVICE_UNAVAILABLE;
+        response.headers["Retry-After"] = std::to_string(std::max<int64_t>(1, config_.shed_retry_after.count()));
+        response.set_json_body(R"({"error": "Server overloaded"})");
+        apply_cors_headers(response);
+        return response;
+    }
+    if (priority) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.priority_requests++;
+    }
+    
     // Get or create session
-    auto& session = get_or_create_session(request);
+    auto session = get_or_create_session(request);
     
     // Find handler
     auto handler_opt = find_handler(request.method, request.path);
@@ -365,6 +519,7 @@ HttpResponse GatewayServer::handle_request(const HttpRequest& request) {
 
             auto response = handle_static_file(static_req, session);
             apply_cors_headers(response);
+            std::lock_guard<std::mutex> lock(stats_mutex_);
             stats_.bytes_sent += response.body.size();
             return response;
         }
@@ -380,6 +535,7 @@ HttpResponse GatewayServer::handle_request(const HttpRequest& request) {
     try {
         auto response = (*handler_opt)(request, session);
         apply_cors_headers(response);
+        std::lock_guard<std::mutex> lock(stats_mutex_);
         stats_.bytes_sent += response.body.size();
         return response;
     } catch (const std::exception& e) {
@@ -392,6 +548,35 @@ HttpResponse GatewayServer::handle_request(const HttpRequest& request) {
     }
 }
 
+bool GatewayServer::is_priority_request(const HttpRequest& request) {
+    if (request.method == HttpMethod::OPTIONS) {
+        return true;
+    }
+    if (request.method != HttpMethod::GET && request.method != HttpMethod::HEAD) {
+        return false;
+    }
+    if (request.path == "/health" || request.path == "/api/health") {
+        return true;
+    }
+    // Revalidation of content we would answer with 304 costs no fetch
+    const std::string thing_prefix = "/api/thing/";
+    return request.path.rfind(thing_prefix, 0) == 0 &&
+           etag_matches(request, request.path.substr(thing_prefix.size()));
+}
+
+EndpointClass GatewayServer::classify_endpoint(const HttpRequest& request) {
+    if (request.path.rfind("/api/thing/", 0) == 0) {
+        return EndpointClass::CONTENT;
+    }
+    if (request.path == "/api/auth") {
+        return EndpointClass::AUTH;
+    }
+    if (request.path.rfind("/api/", 0) == 0) {
+        return EndpointClass::API;
+    }
+    return EndpointClass::STATIC;
+}
+
 std::optional<RequestHandler> GatewayServer::find_handler(
     HttpMethod method, 
     const std::string& path
@@ -414,7 +599,7 @@ std::optional<RequestHandler> GatewayServer::find_handler(
     return std::nullopt;
 }
 
-GatewaySession& GatewayServer::get_or_create_session(const HttpRequest& request) {
+GatewaySession GatewayServer::get_or_create_session(const HttpRequest& request) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
     
     // Try to find session from cookie
@@ -440,7 +625,7 @@ GatewaySession& GatewayServer::get_or_create_session(const HttpRequest& request)
     // Create new session
     if (sessions_.size() >= config_.max_sessions) {
         // Clean up oldest sessions
-        cleanup_sessions();
+        cleanup_sessions_locked();
     }
     
     GatewaySession new_session;
@@ -453,6 +638,20 @@ GatewaySession& GatewayServer::get_or_create_session(const HttpRequest& request)
     return it->second;
 }
 
+bool GatewayServer::update_session(GatewaySession& snapshot,
+                                   const std::function<void(GatewaySession&)>& change) {
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    
+    // The session may have expired while the handler ran
+    auto it = sessions_.find(snapshot.session_id);
+    if (it == sessions_.end()) {
+        return false;
+    }
+    change(it->second);
+    snapshot = it->second;
+    return true;
+}
+
 bool GatewayServer::validate_session(const std::string& session_id) {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
     
@@ -476,7 +675,10 @@ bool GatewayServer::validate_session(const std::string& session_id) {
 
 void GatewayServer::cleanup_sessions() {
     std::lock_guard<std::mutex> lock(sessions_mutex_);
-    
+    cleanup_sessions_locked();
+}
+
+void GatewayServer::cleanup_sessions_locked() {
     auto now = std::chrono::system_clock::now();
     
     for (auto it = sessions_.begin(); it != sessions_.end();) {
@@ -493,29 +695,14 @@ void GatewayServer::cleanup_sessions() {
 }
 
 bool GatewayServer::check_rate_limit(const std::string& client_ip) {
-    std::lock_guard<std::mutex> lock(rate_limit_mutex_);
-    
-    auto now = std::chrono::system_clock::now();
-    auto& rate_info = client_rates_[client_ip];
-    
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-        now - rate_info.last_request
-    );
-    
-    // Reset counters if enough time has passed
-    if (elapsed.count() >= 60) {
-        rate_info.requests_this_minute = 0;
-    }
-    if (elapsed.count() >= 3600) {
-        rate_info.requests_this_hour = 0;
+    // Sliding per-IP and per-subnet windows with fixed memory (see IPAdmissionEngine)
+    auto decision = admission_->admit_request(client_ip);
+    if (decision != security::AdmissionDecision::ALLOW) {
+        CASHEW_LOG_DEBUG("Request from {} refused: {}",
+                         client_ip, security::admission_decision_to_string(decision));
+        return false;
     }
-    
-    rate_info.requests_this_minute++;
-    rate_info.requests_this_hour++;
-    rate_info.last_request = now;
-    
-    return rate_info.requests_this_minute <= config_.max_requests_per_minute &&
-           rate_info.requests_this_hour <= config_.max_requests_per_hour;
+    return true;
 }
 
 void GatewayServer::apply_cors_headers(HttpResponse& response) const {
@@ -541,6 +728,10 @@ void GatewayServer::register_default_handlers() {
         [this](const HttpRequest& req, GatewaySession& session) {
             return handle_health(req, session);
         });
+    register_handler(HttpMethod::GET, "/api/health",
+        [this](const HttpRequest& req, GatewaySession& session) {
+            return handle_health(req, session);
+        });
     
     // Status endpoint
     register_handler(HttpMethod::GET, "/api/status",
@@ -643,7 +834,9 @@ HttpResponse GatewayServer::handle_status(const HttpRequest& /* req */, GatewayS
     json << R"("anonymous_sessions": )" << stats.anonymous_sessions << ",";
     json << R"("authenticated_sessions": )" << stats.authenticated_sessions << ",";
     json << R"("bytes_sent": )" << stats.bytes_sent << ",";
-    json << R"("bytes_received": )" << stats.bytes_received;
+    json << R"("bytes_received": )" << stats.bytes_received << ",";
+    json << R"("requests_shed": )" << stats.requests_shed << ",";
+    json << R"("priority_requests": )" << stats.priority_requests;
     json << "}";
     
     HttpResponse response;
@@ -862,21 +1055,30 @@ HttpResponse GatewayServer::handle_thing_content(const HttpRequest& req, Gateway
         response.set_json_body("{\"error\": \"Invalid hash format (expected 64 hex characters)\"}");
         return response;
     }
-    
-    Hash256 content_hash;
-    try {
-        for (size_t i = 0; i < 32; ++i) {
-            content_hash[i] = static_cast<uint8_t>(
-                std::stoi(hash_str.substr(i * 2, 2), nullptr, 16)
-            );
-        }
-    } catch (...) {
+    if (!is_hash_hex(hash_str)) {
         HttpResponse response;
         response.status = HttpStatus::BAD_REQUEST;
         response.set_json_body(R"({"error": "Invalid hash encoding"})");
         return response;
     }
     
+    auto not_modified = [&hash_str]() {
+        HttpResponse response;
+        response.status = HttpStatus::NOT_MODIFIED;
+        response.headers["ETag"] = "\"" + hash_str + "\"";
+        response.headers["Cache-Control"] = "public, max-age=3600";
+        return response;
+    };
+    
+    if (etag_matches(req, hash_str)) {
+        return not_modified();
+    }
+    
+    Hash256 content_hash;
+    for (size_t i = 0; i < 32; ++i) {
+        content_hash[i] = static_cast<uint8_t>(std::stoi(hash_str.substr(i * 2, 2), nullptr, 16));
+    }
+    
     // Check if content renderer is available
     if (!content_renderer_) {
         CASHEW_LOG_ERROR("Content renderer not initialized");
@@ -913,6 +1115,11 @@ HttpResponse GatewayServer::handle_thing_content(const HttpRequest& req, Gateway
     
     CASHEW_LOG_DEBUG("Content integrity verified: {} ({} bytes)", hash_str, integrity_result.content_size);
     
+    // "*" matches any current representation, so only now that it exists
+    if (if_none_match_any(req)) {
+        return not_modified();
+    }
+    
     // Build HTTP response from render result
     HttpResponse response;
     response.status = HttpStatus::OK;
@@ -1012,11 +1219,20 @@ HttpResponse GatewayServer::handle_authenticate(const HttpRequest& req, GatewayS
     }
     
     // Authentication successful - upgrade session capabilities
-    session.user_key = *public_key_opt;
-    session.is_anonymous = false;
-    session.can_post = true;
-    session.can_vote = true;
-    // can_host requires additional reputation check (future enhancement)
+    const PublicKey public_key = *public_key_opt;
+    const bool upgraded = update_session(session, [&public_key](GatewaySession& stored) {
+        stored.user_key = public_key;
+        stored.is_anonymous = false;
+        stored.can_post = true;
+        stored.can_vote = true;
+        // can_host requires additional reputation check (future enhancement)
+    });
+    if (!upgraded) {
+        HttpResponse response;
+        response.status = HttpStatus::UNAUTHORIZED;
+        response.set_json_body("{\"error\": \"Session expired\"}");
+        return response;
+    }
     
     CASHEW_LOG_INFO("User authenticated: {}", public_key_hex.substr(0, 16));
     
@@ -1163,6 +1379,7 @@ GatewayServer::Statistics GatewayServer::get_statistics() const {
     
     auto stats = stats_;
     stats.active_sessions = sessions_.size();
+    stats.admission = admission_control_->get_statistics();
     
     for (const auto& [id, session] : sessions_) {
         if (session.is_anonymous) {
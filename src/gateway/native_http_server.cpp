@@ -0,0 +1,903 @@
+#include "native_http_server.hpp"
+#include "../runtime/executor.hpp"
+#include "../utils/logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#ifdef CASHEW_PLATFORM_LINUX
+    #include <arpa/inet.h>
+    #include <errno.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace cashew {
+namespace gateway {
+
+namespace {
+
+constexpr size_t READ_CHUNK = 16 * 1024;
+constexpr size_t MAX_IOVECS = 64;
+constexpr size_t COMPACT_THRESHOLD = 64 * 1024;
+
+struct HeaderView {
+    std::string_view name;
+    std::string_view value;
+};
+
+// Views into the connection's read buffer; valid until the buffer is touched
+struct ParsedRequest {
+    std::string_view method;
+    std::string_view target;
+    std::vector<HeaderView> headers;
+    std::string_view body;
+    size_t total_bytes{0};
+    bool keep_alive{true};
+    bool expects_continue{false};
+};
+
+enum class ParseResult {
+    INCOMPLETE,
+    COMPLETE,
+    BAD_REQUEST,
+    TOO_LARGE,
+    UNSUPPORTED
+};
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool icontains(std::string_view haystack, std::string_view needle) {
+    if (needle.size() > haystack.size()) {
+        return false;
+    }
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+ParseResult parse_request(std::string_view input, const NativeHttpOptions& options, ParsedRequest& out) {
+    out.headers.clear();
+    out.expects_continue = false;
+
+    const size_t header_end = input.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) {
+        return input.size() > options.max_header_bytes ? ParseResult::TOO_LARGE : ParseResult::INCOMPLETE;
+    }
+    if (header_end > options.max_header_bytes) {
+        return ParseResult::TOO_LARGE;
+    }
+
+    std::string_view head = input.substr(0, header_end);
+    const size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    head = line_end == std::string_view::npos ? std::string_view() : head.substr(line_end + 2);
+
+    const size_t first_space = request_line.find(' ');
+    const size_t second_space = request_line.find(' ', first_space + 1);
+    if (first_space == std::string_view::npos || second_space == std::string_view::npos) {
+        return ParseResult::BAD_REQUEST;
+    }
+    out.method = request_line.substr(0, first_space);
+    out.target = request_line.substr(first_space + 1, second_space - first_space - 1);
+    const std::string_view version = request_line.substr(second_space + 1);
+    if (out.target.empty() || version.substr(0, 7) != "HTTP/1.") {
+        return ParseResult::BAD_REQUEST;
+    }
+
+    const bool http11 = version == "HTTP/1.1";
+    bool close_requested = false;
+    bool keep_alive_requested = false;
+    size_t content_length = 0;
+    bool has_content_length = false;
+
+    while (!head.empty()) {
+        const size_t end = head.find("\r\n");
+        const std::string_view line = head.substr(0, end);
+        head = end == std::string_view::npos ? std::string_view() : head.substr(end + 2);
+
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return ParseResult::BAD_REQUEST;
+        }
+        HeaderView header{line.substr(0, colon), trim(line.substr(colon + 1))};
+
+        if (iequals(header.name, "Content-Length")) {
+            size_t length = 0;
+            auto [ptr, ec] = std::from_chars(header.value.data(), header.value.data() + header.value.size(),
+                                             length);
+            if (ec != std::errc() || ptr != header.value.data() + header.value.size()) {
+                return ParseResult::BAD_REQUEST;
+            }
+            // Conflicting lengths would let a proxy and this engine split the stream differently
+            if (has_content_length && length != content_length) {
+                return ParseResult::BAD_REQUEST;
+            }
+            content_length = length;
+            has_content_length = true;
+        } else if (iequals(header.name, "Transfer-Encoding")) {
+            return ParseResult::UNSUPPORTED;
+        } else if (iequals(header.name, "Connection")) {
+            close_requested = close_requested || icontains(header.value, "close");
+            keep_alive_requested = keep_alive_requested || icontains(header.value, "keep-alive");
+        } else if (iequals(header.name, "Expect")) {
+            out.expects_continue = icontains(header.value, "100-continue");
+        }
+        out.headers.push_back(header);
+    }
+
+    if (content_length > options.max_body_bytes) {
+        return ParseResult::TOO_LARGE;
+    }
+
+    out.keep_alive = http11 ? !close_requested : keep_alive_requested;
+    const size_t body_start = header_end + 4;
+    if (input.size() - body_start < content_length) {
+        return ParseResult::INCOMPLETE;
+    }
+    out.body = input.substr(body_start, content_length);
+    out.total_bytes = body_start + content_length;
+    return ParseResult::COMPLETE;
+}
+
+std::optional<HttpMethod> parse_method(std::string_view method) {
+    if (method == "GET") return HttpMethod::GET;
+    if (method == "POST") return HttpMethod::POST;
+    if (method == "PUT") return HttpMethod::PUT;
+    if (method == "DELETE") return HttpMethod::DELETE;
+    if (method == "OPTIONS") return HttpMethod::OPTIONS;
+    if (method == "HEAD") return HttpMethod::HEAD;
+    return std::nullopt;
+}
+
+std::string url_decode(std::string_view text, bool plus_is_space) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (c == '%' && i + 2 < text.size()) {
+            uint8_t value = 0;
+            auto [ptr, ec] = std::from_chars(text.data() + i + 1, text.data() + i + 3, value, 16);
+            if (ec == std::errc() && ptr == text.data() + i + 3) {
+                out.push_back(static_cast<char>(value));
+                i += 2;
+                continue;
+            }
+        }
+        out.push_back(plus_is_space && c == '+' ? ' ' : c);
+    }
+    return out;
+}
+
+HttpRequest to_request(const ParsedRequest& parsed, HttpMethod method, const std::string& client_ip) {
+    HttpRequest request;
+    request.method = method;
+    request.client_ip = client_ip;
+
+    const size_t query_start = parsed.target.find('?');
+    request.path = url_decode(parsed.target.substr(0, query_start), false);
+    if (query_start != std::string_view::npos) {
+        std::string_view query = parsed.target.substr(query_start + 1);
+        while (!query.empty()) {
+            const size_t amp = query.find('&');
+            const std::string_view pair = query.substr(0, amp);
+            query = amp == std::string_view::npos ? std::string_view() : query.substr(amp + 1);
+            if (pair.empty()) {
+                continue;
+            }
+            const size_t eq = pair.find('=');
+            request.query_params[url_decode(pair.substr(0, eq), true)] =
+                eq == std::string_view::npos ? std::string() : url_decode(pair.substr(eq + 1), true);
+        }
+    }
+
+    request.headers.reserve(parsed.headers.size());
+    for (const auto& header : parsed.headers) {
+        request.headers.emplace(std::string(header.name), std::string(header.value));
+    }
+    request.body.assign(parsed.body.begin(), parsed.body.end());
+    return request;
+}
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default: return "Unknown";
+    }
+}
+
+} // anonymous namespace
+
+struct NativeHttpServer::Connection {
+    struct Outgoing {
+        std::string head;
+        std::vector<uint8_t> body;
+        size_t sent{0};  // Across head then body
+    };
+
+    int fd{-1};
+    uint64_t id{0};
+    std::string client_ip;
+    std::string input;
+    size_t consumed{0};
+    std::deque<Outgoing> output;
+    size_t output_bytes{0};  // Queued and not yet written
+    uint32_t interest{0};
+    bool dispatched{false};
+    bool output_paused{false};  // Parsing stopped at max_pending_output
+    bool close_after_write{false};
+    bool continue_sent{false};
+    bool peer_closed{false};  // EOF read; answer what is buffered, then close
+    std::chrono::steady_clock::time_point last_active;
+    std::chrono::steady_clock::time_point last_output;  // Last write progress, or first queued output
+
+    void enqueue(Outgoing out) {
+        if (output.empty()) {
+            last_output = std::chrono::steady_clock::now();
+        }
+        output_bytes += out.head.size() + out.body.size();
+        output.push_back(std::move(out));
+    }
+};
+
+struct NativeHttpServer::Completion {
+    int fd;
+    uint64_t connection_id;
+    HttpResponse response;
+    bool head_only;
+    bool keep_alive;
+};
+
+struct NativeHttpServer::EventLoop {
+    int epoll_fd{-1};
+    int listen_fd{-1};
+    int wake_fd{-1};
+    std::thread thread;
+    uint64_t next_connection_id{1};
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+
+    std::mutex completions_mutex;
+    std::vector<Completion> completions;
+};
+
+NativeHttpServer::NativeHttpServer(const NativeHttpOptions& options,
+                                   Handler handler,
+                                   std::shared_ptr<runtime::Executor> executor,
+                                   InlinePredicate run_inline)
+    : options_(options)
+    , handler_(std::move(handler))
+    , executor_(std::move(executor))
+    , run_inline_(std::move(run_inline))
+{
+}
+
+NativeHttpServer::~NativeHttpServer() {
+    stop();
+}
+
+bool NativeHttpServer::is_supported() {
+#ifdef CASHEW_PLATFORM_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+NativeHttpServer::Statistics NativeHttpServer::get_statistics() const {
+    Statistics stats;
+    stats.connections_accepted = connections_accepted_;
+    stats.requests = requests_;
+    stats.inline_requests = inline_requests_;
+    stats.pipelined_requests = pipelined_requests_;
+    stats.bad_requests = bad_requests_;
+    stats.bytes_received = bytes_received_;
+    stats.bytes_sent = bytes_sent_;
+    return stats;
+}
+
+#ifdef CASHEW_PLATFORM_LINUX
+
+bool NativeHttpServer::start() {
+    if (running_) {
+        return false;
+    }
+
+    loops_.clear();
+    uint16_t port = options_.port;
+    const size_t loop_count = std::max<size_t>(1, options_.event_loops);
+    for (size_t i = 0; i < loop_count; ++i) {
+        auto loop = std::make_unique<EventLoop>();
+        loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        loop->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->epoll_fd < 0 || loop->wake_fd < 0 || !open_listener(*loop, port)) {
+            CASHEW_LOG_ERROR("Native HTTP engine failed to listen on {}:{}: {}",
+                             options_.bind_address, port, strerror(errno));
+            loops_.push_back(std::move(loop));
+            stop();
+            return false;
+        }
+
+        // Later listeners share the first one's port (resolves port 0)
+        sockaddr_storage bound{};
+        socklen_t bound_len = sizeof(bound);
+        getsockname(loop->listen_fd, reinterpret_cast<sockaddr*>(&bound), &bound_len);
+        port = ntohs(bound.ss_family == AF_INET6
+                         ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                         : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN;
+        listen_event.data.fd = loop->listen_fd;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->listen_fd, &listen_event);
+
+        epoll_event wake_event{};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = loop->wake_fd;
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wake_fd, &wake_event);
+
+        loops_.push_back(std::move(loop));
+    }
+
+    bound_port_ = port;
+    running_ = true;
+    for (auto& loop : loops_) {
+        loop->thread = std::thread(&NativeHttpServer::run_loop, this, std::ref(*loop));
+    }
+
+    CASHEW_LOG_INFO("Native HTTP engine listening on {}:{} ({} event loops, handlers on {})",
+                    options_.bind_address, bound_port_, loops_.size(),
+                    executor_ ? "executor" : "event loops");
+    return true;
+}
+
+void NativeHttpServer::stop() {
+    const bool was_running = running_.exchange(false);
+    for (auto& loop : loops_) {
+        if (loop->wake_fd >= 0) {
+            const uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(loop->wake_fd, &one, sizeof(one));
+        }
+    }
+    for (auto& loop : loops_) {
+        if (loop->thread.joinable()) {
+            loop->thread.join();
+        }
+    }
+
+    // Handlers on the executor still reference this server
+    {
+        std::unique_lock<std::mutex> lock(dispatch_mutex_);
+        dispatch_cv_.wait(lock, [this]() { return dispatched_ == 0; });
+    }
+
+    for (auto& loop : loops_) {
+        while (!loop->connections.empty()) {
+            close_connection(*loop, loop->connections.begin()->first);
+        }
+        if (loop->listen_fd >= 0) {
+            ::close(loop->listen_fd);
+            loop->listen_fd = -1;
+        }
+        if (loop->epoll_fd >= 0) {
+            ::close(loop->epoll_fd);
+            loop->epoll_fd = -1;
+        }
+        if (loop->wake_fd >= 0) {
+            ::close(loop->wake_fd);
+            loop->wake_fd = -1;
+        }
+        loop->completions.clear();
+    }
+
+    if (was_running) {
+        CASHEW_LOG_INFO("Native HTTP engine stopped");
+    }
+}
+
+bool NativeHttpServer::open_listener(EventLoop& loop, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* results = nullptr;
+    const std::string service = std::to_string(port);
+    const char* host = options_.bind_address.empty() ? nullptr : options_.bind_address.c_str();
+    if (getaddrinfo(host, service.c_str(), &hints, &results) != 0 || !results) {
+        return false;
+    }
+
+    for (addrinfo* ai = results; ai; ai = ai->ai_next) {
+        const int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+        if (bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0) {
+            loop.listen_fd = fd;
+            break;
+        }
+        ::close(fd);
+    }
+
+    freeaddrinfo(results);
+    return loop.listen_fd >= 0;
+}
+
+void NativeHttpServer::run_loop(EventLoop& loop) {
+    constexpr int MAX_EVENTS = 128;
+    epoll_event events[MAX_EVENTS];
+    auto last_sweep = std::chrono::steady_clock::now();
+
+    while (running_) {
+        const int ready = epoll_wait(loop.epoll_fd, events, MAX_EVENTS, 1000);
+        if (ready < 0 && errno != EINTR) {
+            CASHEW_LOG_ERROR("epoll_wait failed: {}", strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == loop.listen_fd) {
+                accept_connections(loop);
+                continue;
+            }
+            if (fd == loop.wake_fd) {
+                uint64_t count = 0;
+                [[maybe_unused]] auto drained = ::read(loop.wake_fd, &count, sizeof(count));
+                drain_completions(loop);
+                continue;
+            }
+
+            auto it = loop.connections.find(fd);
+            if (it == loop.connections.end()) {
+                continue;
+            }
+            Connection& conn = *it->second;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close_connection(loop, fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flush(loop, conn);
+                if (!loop.connections.count(fd)) {
+                    continue;
+                }
+                if (conn.output_paused && conn.output_bytes < options_.max_pending_output) {
+                    process_input(loop, conn);  // Resume the pipeline once the client catches up
+                    if (!loop.connections.count(fd)) {
+                        continue;
+                    }
+                }
+            }
+            if (events[i].events & EPOLLIN) {
+                on_readable(loop, conn);
+            }
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_sweep >= std::chrono::seconds(1)) {
+            close_idle(loop);
+            last_sweep = now;
+        }
+    }
+}
+
+void NativeHttpServer::accept_connections(EventLoop& loop) {
+    while (true) {
+        sockaddr_storage addr{};
+        socklen_t addr_len = sizeof(addr);
+        const int fd = accept4(loop.listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                CASHEW_LOG_WARN("accept failed: {}", strerror(errno));
+            }
+            return;
+        }
+
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        auto conn = std::make_unique<Connection>();
+        conn->fd = fd;
+        conn->id = loop.next_connection_id++;
+        conn->last_active = std::chrono::steady_clock::now();
+
+        char host[INET6_ADDRSTRLEN] = {};
+        if (addr.ss_family == AF_INET6) {
+            inet_ntop(AF_INET6, &reinterpret_cast<sockaddr_in6*>(&addr)->sin6_addr, host, sizeof(host));
+        } else {
+            inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(&addr)->sin_addr, host, sizeof(host));
+        }
+        conn->client_ip = host;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(fd);
+            continue;
+        }
+        conn->interest = EPOLLIN;
+        loop.connections[fd] = std::move(conn);
+        connections_accepted_++;
+    }
+}
+
+void NativeHttpServer::on_readable(EventLoop& loop, Connection& conn) {
+    const int fd = conn.fd;
+    while (true) {
+        const size_t old_size = conn.input.size();
+        conn.input.resize(old_size + READ_CHUNK);
+        const ssize_t n = ::read(fd, conn.input.data() + old_size, READ_CHUNK);
+        conn.input.resize(old_size + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+
+        if (n > 0) {
+            bytes_received_ += static_cast<uint64_t>(n);
+            if (static_cast<size_t>(n) < READ_CHUNK) {
+                break;
+            }
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            close_connection(loop, fd);
+            return;
+        }
+        // Peer half-closed: requests already buffered still get their responses
+        conn.peer_closed = true;
+        break;
+    }
+
+    conn.last_active = std::chrono::steady_clock::now();
+    process_input(loop, conn);
+}
+
+void NativeHttpServer::process_input(EventLoop& loop, Connection& conn) {
+    const int fd = conn.fd;
+    ParsedRequest parsed;
+
+    while (true) {
+        conn.output_paused = false;
+
+        while (!conn.dispatched && !conn.close_after_write && conn.consumed < conn.input.size()) {
+            if (conn.output_bytes >= options_.max_pending_output) {
+                conn.output_paused = true;
+                break;
+            }
+
+            const std::string_view pending(conn.input.data() + conn.consumed, conn.input.size() - conn.consumed);
+            const ParseResult result = parse_request(pending, options_, parsed);
+
+            if (result == ParseResult::INCOMPLETE) {
+                if (parsed.expects_continue && !conn.continue_sent) {
+                    Connection::Outgoing interim;
+                    interim.head = "HTTP/1.1 100 Continue\r\n\r\n";
+                    conn.enqueue(std::move(interim));
+                    conn.continue_sent = true;
+                }
+                break;
+            }
+            if (result != ParseResult::COMPLETE) {
+                bad_requests_++;
+                queue_error(conn, result == ParseResult::TOO_LARGE ? HttpStatus::PAYLOAD_TOO_LARGE
+                                  : result == ParseResult::UNSUPPORTED ? HttpStatus::NOT_IMPLEMENTED
+                                  : HttpStatus::BAD_REQUEST);
+                break;
+            }
+
+            requests_++;
+            if (conn.consumed > 0) {
+                pipelined_requests_++;
+            }
+            conn.continue_sent = false;
+
+            const auto method = parse_method(parsed.method);
+            if (!method) {
+                conn.consumed += parsed.total_bytes;
+                queue_error(conn, HttpStatus::METHOD_NOT_ALLOWED);
+                break;
+            }
+
+            // HEAD is routed as GET; the body is dropped when the response is written
+            const bool head_only = *method == HttpMethod::HEAD;
+            HttpRequest request = to_request(parsed, head_only ? HttpMethod::GET : *method, conn.client_ip);
+            const bool keep_alive = parsed.keep_alive;
+            conn.consumed += parsed.total_bytes;
+
+            if (!executor_ || (run_inline_ && run_inline_(request))) {
+                inline_requests_++;
+                HttpResponse response;
+                try {
+                    response = handler_(request);
+                } catch (const std::exception& e) {
+                    CASHEW_LOG_ERROR("Handler error: {}", e.what());
+                    response.status = HttpStatus::INTERNAL_ERROR;
+                    response.set_json_body(R"({"error": "Internal server error"})");
+                }
+                queue_response(conn, std::move(response), head_only, keep_alive);
+                continue;
+            }
+
+            dispatch(loop, conn, std::move(request), head_only, keep_alive);
+        }
+
+        if (conn.consumed == conn.input.size()) {
+            conn.input.clear();
+            conn.consumed = 0;
+        } else if (conn.consumed > COMPACT_THRESHOLD) {
+            conn.input.erase(0, conn.consumed);
+            conn.consumed = 0;
+        }
+
+        flush(loop, conn);
+
+        // Output may have drained straight to the socket; if so keep parsing
+        if (!loop.connections.count(fd) || !conn.output_paused ||
+            conn.output_bytes >= options_.max_pending_output) {
+            return;
+        }
+    }
+}
+
+void NativeHttpServer::dispatch(EventLoop& loop, Connection& conn, HttpRequest request,
+                                bool head_only, bool keep_alive) {
+    conn.dispatched = true;
+    {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        dispatched_++;
+    }
+
+    EventLoop* target = &loop;
+    const int fd = conn.fd;
+    const uint64_t id = conn.id;
+    auto job = [this, target, fd, id, request = std::move(request), head_only, keep_alive]() {
+        Completion completion{fd, id, HttpResponse(), head_only, keep_alive};
+        try {
+            completion.response = handler_(request);
+        } catch (const std::exception& e) {
+            CASHEW_LOG_ERROR("Handler error: {}", e.what());
+            completion.response.status = HttpStatus::INTERNAL_ERROR;
+            completion.response.set_json_body(R"({"error": "Internal server error"})");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(target->completions_mutex);
+            target->completions.push_back(std::move(completion));
+        }
+        const uint64_t one = 1;
+        [[maybe_unused]] auto written = ::write(target->wake_fd, &one, sizeof(one));
+
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        if (--dispatched_ == 0) {
+            dispatch_cv_.notify_all();
+        }
+    };
+    executor_->submit(std::move(job), runtime::Priority::NORMAL);
+}
+
+void NativeHttpServer::drain_completions(EventLoop& loop) {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(loop.completions_mutex);
+        ready.swap(loop.completions);
+    }
+
+    for (auto& completion : ready) {
+        auto it = loop.connections.find(completion.fd);
+        if (it == loop.connections.end() || it->second->id != completion.connection_id) {
+            continue;  // Client went away while the handler ran
+        }
+        Connection& conn = *it->second;
+        conn.dispatched = false;
+        queue_response(conn, std::move(completion.response), completion.head_only, completion.keep_alive);
+        process_input(loop, conn);  // Pipelined requests waiting behind this one
+    }
+}
+
+void NativeHttpServer::queue_response(Connection& conn, HttpResponse response, bool head_only, bool keep_alive) {
+    const int status = static_cast<int>(response.status);
+    Connection::Outgoing out;
+    out.head.reserve(160 + response.headers.size() * 48);
+    out.head.append("HTTP/1.1 ").append(std::to_string(status)).append(" ").append(reason_phrase(status)).append("\r\n");
+    for (const auto& [name, value] : response.headers) {
+        if (iequals(name, "Content-Length") || iequals(name, "Connection")) {
+            continue;
+        }
+        out.head.append(name).append(": ").append(value).append("\r\n");
+    }
+    if (status != 204 && status != 304) {
+        out.head.append("Content-Length: ").append(std::to_string(response.body.size())).append("\r\n");
+    }
+    out.head.append(keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+
+    if (!head_only && status != 204 && status != 304) {
+        out.body = std::move(response.body);
+    }
+    conn.enqueue(std::move(out));
+    if (!keep_alive) {
+        conn.close_after_write = true;
+    }
+}
+
+void NativeHttpServer::queue_error(Connection& conn, HttpStatus status) {
+    HttpResponse response;
+    response.status = status;
+    response.set_json_body(std::string(R"({"error": ")") + reason_phrase(static_cast<int>(status)) + "\"}");
+    queue_response(conn, std::move(response), false, false);
+}
+
+void NativeHttpServer::flush(EventLoop& loop, Connection& conn) {
+    while (!conn.output.empty()) {
+        iovec iov[MAX_IOVECS];
+        size_t count = 0;
+        for (const auto& out : conn.output) {
+            if (count + 2 > MAX_IOVECS) {
+                break;
+            }
+            if (out.sent < out.head.size()) {
+                iov[count].iov_base = const_cast<char*>(out.head.data() + out.sent);
+                iov[count].iov_len = out.head.size() - out.sent;
+                count++;
+            }
+            const size_t body_sent = out.sent > out.head.size() ? out.sent - out.head.size() : 0;
+            if (body_sent < out.body.size()) {
+                iov[count].iov_base = const_cast<uint8_t*>(out.body.data() + body_sent);
+                iov[count].iov_len = out.body.size() - body_sent;
+                count++;
+            }
+        }
+
+        const ssize_t written = ::writev(conn.fd, iov, static_cast<int>(count));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            close_connection(loop, conn.fd);
+            return;
+        }
+
+        bytes_sent_ += static_cast<uint64_t>(written);
+        size_t remaining = static_cast<size_t>(written);
+        while (remaining > 0 && !conn.output.empty()) {
+            auto& out = conn.output.front();
+            const size_t left = out.head.size() + out.body.size() - out.sent;
+            const size_t step = std::min(left, remaining);
+            out.sent += step;
+            conn.output_bytes -= step;
+            remaining -= step;
+            if (out.sent == out.head.size() + out.body.size()) {
+                conn.output.pop_front();
+            }
+        }
+        conn.last_active = std::chrono::steady_clock::now();
+        conn.last_output = conn.last_active;
+    }
+
+    // After EOF, close once nothing more can be answered: no handler running
+    // and no complete request left behind the output high-water mark
+    const bool peer_done = conn.peer_closed && !conn.dispatched && !conn.output_paused;
+    if (conn.output.empty() && (conn.close_after_write || peer_done)) {
+        close_connection(loop, conn.fd);
+        return;
+    }
+    update_interest(loop, conn);
+}
+
+void NativeHttpServer::update_interest(EventLoop& loop, Connection& conn) {
+    // Stop reading while a handler runs, before closing or while output is
+    // over the high-water mark: this is the backpressure
+    const bool paused = conn.dispatched || conn.close_after_write || conn.output_paused || conn.peer_closed;
+    uint32_t wanted = paused ? 0u : static_cast<uint32_t>(EPOLLIN);
+    if (!conn.output.empty()) {
+        wanted |= EPOLLOUT;
+    }
+    if (wanted == conn.interest) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = wanted;
+    event.data.fd = conn.fd;
+    epoll_ctl(loop.epoll_fd, EPOLL_CTL_MOD, conn.fd, &event);
+    conn.interest = wanted;
+}
+
+void NativeHttpServer::close_connection(EventLoop& loop, int fd) {
+    auto it = loop.connections.find(fd);
+    if (it == loop.connections.end()) {
+        return;
+    }
+    if (loop.epoll_fd >= 0) {
+        epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+    ::close(fd);
+    loop.connections.erase(it);
+}
+
+void NativeHttpServer::close_idle(EventLoop& loop) {
+    const auto cutoff = std::chrono::steady_clock::now() - options_.keep_alive_timeout;
+    std::vector<int> idle;
+    for (const auto& [fd, conn] : loop.connections) {
+        // Idle keep-alive, or a client that stopped reading its responses. A
+        // connection whose handler is still running with nothing queued is left alone.
+        const bool idle_keep_alive = !conn->dispatched && conn->output.empty() && conn->last_active < cutoff;
+        const bool write_stalled = !conn->output.empty() && conn->last_output < cutoff;
+        if (idle_keep_alive || write_stalled) {
+            idle.push_back(fd);
+        }
+    }
+    for (int fd : idle) {
+        close_connection(loop, fd);
+    }
+}
+
+#else
+
+bool NativeHttpServer::start() {
+    CASHEW_LOG_ERROR("Native HTTP engine is not available on this platform");
+    return false;
+}
+
+void NativeHttpServer::stop() {
+    running_ = false;
+}
+
+#endif
+
+} // namespace gateway
+} // namespace cashew
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "cashew/gateway/gateway_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cashew {
+
+namespace runtime { class Executor; }
+
+namespace gateway {
+
+/**
+ * NativeHttpServer configuration
+ */
+struct NativeHttpOptions {
+    std::string bind_address{"0.0.0.0"};
+    uint16_t port{8080};                         // 0 = any free port (see port())
+    size_t event_loops{2};
+    size_t max_header_bytes{16 * 1024};
+    size_t max_body_bytes{10 * 1024 * 1024};
+    size_t max_pending_output{1024 * 1024};     // Stop parsing pipelined input above this until drained
+    std::chrono::seconds keep_alive_timeout{5};
+};
+
+/**
+ * NativeHttpServer - In-tree HTTP/1.1 engine for the gateway (Linux, epoll)
+ *
+ * Each event loop thread owns an SO_REUSEPORT listener, so the kernel spreads
+ * new connections across loops and a connection never changes threads.
+ * Connections are kept alive and may pipeline: requests are parsed in place
+ * as string views over the read buffer and answered strictly in order, and
+ * queued responses go out with one writev of header and body buffers. A client
+ * that pipelines without reading is paused once its queued output passes
+ * max_pending_output and resumed when the socket drains.
+ *
+ * Requests accepted by run_inline (cheap ones such as health checks) are
+ * handled on the loop thread. Everything else runs on the executor while the
+ * connection stops reading, so a slow handler never stalls other connections.
+ * Without an executor every request runs inline.
+ *
+ * Chunked request bodies are not supported (501).
+ */
+class NativeHttpServer {
+public:
+    using Handler = std::function<HttpResponse(const HttpRequest&)>;
+    using InlinePredicate = std::function<bool(const HttpRequest&)>;
+
+    NativeHttpServer(const NativeHttpOptions& options,
+                     Handler handler,
+                     std::shared_ptr<runtime::Executor> executor,
+                     InlinePredicate run_inline = nullptr);
+    ~NativeHttpServer();
+
+    NativeHttpServer(const NativeHttpServer&) = delete;
+    NativeHttpServer& operator=(const NativeHttpServer&) = delete;
+
+    /**
+     * Whether this platform has the engine (epoll)
+     */
+    static bool is_supported();
+
+    /**
+     * Bind, listen and start the event loops
+     * @return false if the address could not be bound
+     */
+    bool start();
+
+    /**
+     * Stop the loops, close connections and wait for dispatched handlers
+     */
+    void stop();
+
+    bool is_running() const { return running_; }
+
+    /**
+     * Bound port (resolved when started with port 0)
+     */
+    uint16_t port() const { return bound_port_; }
+
+    struct Statistics {
+        uint64_t connections_accepted{0};
+        uint64_t requests{0};
+        uint64_t inline_requests{0};
+        uint64_t pipelined_requests{0};  // Parsed from data that arrived behind another request
+        uint64_t bad_requests{0};
+        uint64_t bytes_received{0};
+        uint64_t bytes_sent{0};
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    struct Connection;
+    struct EventLoop;
+    struct Completion;
+
+    NativeHttpOptions options_;
+    Handler handler_;
+    std::shared_ptr<runtime::Executor> executor_;
+    InlinePredicate run_inline_;
+
+    std::atomic<bool> running_{false};
+    uint16_t bound_port_{0};
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+
+    // Handlers still running on the executor (stop() waits for them)
+    std::mutex dispatch_mutex_;
+    std::condition_variable dispatch_cv_;
+    size_t dispatched_{0};
+
+    std::atomic<uint64_t> connections_accepted_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> inline_requests_{0};
+    std::atomic<uint64_t> pipelined_requests_{0};
+    std::atomic<uint64_t> bad_requests_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+
+    bool open_listener(EventLoop& loop, uint16_t port);
+    void run_loop(EventLoop& loop);
+    void accept_connections(EventLoop& loop);
+    void on_readable(EventLoop& loop, Connection& conn);
+    void process_input(EventLoop& loop, Connection& conn);
+    void dispatch(EventLoop& loop, Connection& conn, HttpRequest request, bool head_only, bool keep_alive);
+    void drain_completions(EventLoop& loop);
+    void queue_response(Connection& conn, HttpResponse response, bool head_only, bool keep_alive);
+    void queue_error(Connection& conn, HttpStatus status);
+    void flush(EventLoop& loop, Connection& conn);
+    void update_interest(EventLoop& loop, Connection& conn);
+    void close_connection(EventLoop& loop, int fd);
+    void close_idle(EventLoop& loop);
+};
+
+} // namespace gateway
+} // namespace cashew
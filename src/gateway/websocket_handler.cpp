@@ -1,5 +1,6 @@
 #include "cashew/gateway/websocket_handler.hpp"
 #include "../utils/logger.hpp"
+#include "../utils/maintenance_scheduler.hpp"
 #include <algorithm>
 
 namespace cashew {
@@ -102,6 +103,10 @@ WebSocketHandler::~WebSocketHandler() {
     }
 }
 
+void WebSocketHandler::set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+    maintenance_ = std::move(scheduler);
+}
+
 void WebSocketHandler::start() {
     if (running_) {
         CASHEW_LOG_WARN("WebSocket handler already running");
@@ -111,6 +116,14 @@ void WebSocketHandler::start() {
     CASHEW_LOG_INFO("Starting WebSocket handler");
     running_ = true;
     
+    if (maintenance_) {
+        keepalive_task_ = maintenance_->schedule_periodic(
+            "websocket.keepalive",
+            std::chrono::duration_cast<std::chrono::milliseconds>(config_.ping_interval),
+            [this]() { run_keepalive(); });
+        return;
+    }
+    
     keepalive_thread_ = std::thread([this]() {
         keepalive_loop();
     });
@@ -124,6 +137,11 @@ void WebSocketHandler::stop() {
     CASHEW_LOG_INFO("Stopping WebSocket handler");
     running_ = false;
     
+    if (maintenance_ && keepalive_task_ != 0) {
+        maintenance_->cancel(keepalive_task_);
+        keepalive_task_ = 0;
+    }
+    
     if (keepalive_thread_.joinable()) {
         keepalive_thread_.join();
     }
@@ -342,6 +360,12 @@ void WebSocketHandler::keepalive_loop() {
             break;
         }
         
+        run_keepalive();
+    }
+}
+
+void WebSocketHandler::run_keepalive() {
+    {
         // Send pings and check timeouts
         std::lock_guard<std::mutex> lock(connections_mutex_);
         
@@ -370,9 +394,9 @@ void WebSocketHandler::keepalive_loop() {
             
             ++it;
         }
-        
-        cleanup_connections();
     }
+    
+    cleanup_connections();
 }
 
 void WebSocketHandler::cleanup_connections() {
@@ -33,6 +33,8 @@
 // Utilities
 #include "utils/logger.hpp"
 #include "utils/config.hpp"
+#include "utils/maintenance_scheduler.hpp"
+#include "runtime/executor.hpp"
 #include "cashew/common.hpp"
 
 // Utility: Convert Hash256 to hex string
@@ -198,8 +200,13 @@ int run_content_add(const std::string& config_path, int argc, char** argv) {
     const std::string hash_str = content_hash.to_string();
     const std::string filename = content_path.filename().string();
 
-    storage.put_metadata("mime_" + hash_str, cashew::bytes(mime.begin(), mime.end()));
-    storage.put_metadata("name_" + hash_str, cashew::bytes(filename.begin(), filename.end()));
+    cashew::storage::WriteBatch metadata;
+    metadata.put("mime_" + hash_str, cashew::bytes(mime.begin(), mime.end()));
+    metadata.put("name_" + hash_str, cashew::bytes(filename.begin(), filename.end()));
+    if (!storage.write_metadata(metadata)) {
+        std::cerr << "Failed to store metadata\n";
+        return 1;
+    }
 
     const auto gateway_port = get_config_value<uint16_t>(
         config, "http_port", {"gateway", "http_port"}, 8080
@@ -347,10 +354,15 @@ int run_node(const std::string& config_path) {
     CASHEW_LOG_INFO("Initializing network registry...");
     auto network_registry = std::make_shared<cashew::network::NetworkRegistry>();
 
-    // Try to load existing networks from disk
+    // Networks live in the storage metadata store; import the old networks/ directory once
+    auto& metadata_store = storage->metadata_store();
+    network_registry->load_from_store(metadata_store);
     std::string networks_dir = data_dir + "/networks";
-    if (std::filesystem::exists(networks_dir)) {
+    if (network_registry->total_network_count() == 0 && std::filesystem::exists(networks_dir)) {
         network_registry->load_from_disk(networks_dir);
+        if (network_registry->save_to_store(metadata_store)) {
+            std::filesystem::remove_all(networks_dir);
+        }
     }
 
     CASHEW_LOG_INFO("Network registry initialized: {} networks ({} healthy)",
@@ -376,6 +388,15 @@ int run_node(const std::string& config_path) {
         return storage->get_content(content_hash);
     });
 
+    // Page asset prefetch and startup cache warming run as bulk work
+    auto executor = std::make_shared<cashew::runtime::Executor>(2);
+    executor->start();
+    content_renderer->set_prefetch_executor(executor);
+    content_renderer->load_popularity(metadata_store);
+    executor->submit([content_renderer]() {
+        content_renderer->warm_cache();
+    }, cashew::runtime::Priority::BULK);
+
     CASHEW_LOG_INFO("Content renderer initialized with storage callback");
 
     // 5. WebSocket Handler
@@ -385,7 +406,12 @@ int run_node(const std::string& config_path) {
     ws_config.timeout = std::chrono::seconds(300);
     ws_config.max_connections = 1000;
 
+    // One scheduler thread runs all periodic upkeep (keepalive, session expiry)
+    auto maintenance = std::make_shared<cashew::utils::MaintenanceScheduler>();
+    maintenance->start();
+
     auto websocket_handler = std::make_shared<cashew::gateway::WebSocketHandler>(ws_config);
+    websocket_handler->set_maintenance_scheduler(maintenance);
     websocket_handler->start();
 
     CASHEW_LOG_INFO("WebSocket handler started");
@@ -424,6 +450,7 @@ int run_node(const std::string& config_path) {
     gateway->set_storage(storage);
     gateway->set_content_renderer(content_renderer);
     gateway->set_network_registry(network_registry);
+    gateway->set_maintenance_scheduler(maintenance);
 
     CASHEW_LOG_INFO("Gateway server configured with all dependencies");
 
@@ -462,10 +489,13 @@ int run_node(const std::string& config_path) {
 
     CASHEW_LOG_INFO("Stopping WebSocket handler...");
     websocket_handler->stop();
+    maintenance->stop();
 
     CASHEW_LOG_INFO("Saving network state...");
-    std::filesystem::create_directories(networks_dir);
-    network_registry->save_to_disk(networks_dir);
+    network_registry->save_to_store(metadata_store);
+    executor->stop();
+    content_renderer->save_popularity(metadata_store);
+    metadata_store.sync();
 
     CASHEW_LOG_INFO("");
     CASHEW_LOG_INFO("Node stopped. Goodbye! ");
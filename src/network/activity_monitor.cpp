@@ -3,9 +3,17 @@
 
 namespace cashew::network {
 
+namespace {
+
+// Distinguishes monitors in the per-thread shard cache (addresses get reused)
+std::atomic<uint64_t> next_monitor_id{1};
+
+} // namespace
+
 // ActivityMonitor implementation
 ActivityMonitor::ActivityMonitor(postake::ContributionTracker& tracker)
     : tracker_(tracker),
+      instance_id_(next_monitor_id++),
       monitoring_local_(false),
       total_connections_(0),
       total_bytes_routed_(0),
@@ -15,11 +23,34 @@ ActivityMonitor::ActivityMonitor(postake::ContributionTracker& tracker)
     spdlog::info("ActivityMonitor initialized");
 }
 
+ActivityMonitor::~ActivityMonitor() {
+    stop_periodic_flush();
+    flush_traffic();
+}
+
+bool ActivityMonitor::start_periodic_flush(std::chrono::milliseconds interval) {
+    if (!maintenance_ || flush_task_ != 0) {
+        return false;
+    }
+    
+    flush_task_ = maintenance_->schedule_periodic(
+        "activity.flush_traffic", interval, [this]() { flush_traffic(); });
+    return flush_task_ != 0;
+}
+
+void ActivityMonitor::stop_periodic_flush() {
+    if (maintenance_ && flush_task_ != 0) {
+        maintenance_->cancel(flush_task_);
+    }
+    flush_task_ = 0;
+}
+
 void ActivityMonitor::start_monitoring_local_node(const NodeID& local_node_id) {
     local_node_id_ = local_node_id;
     monitoring_local_ = true;
     
     // Report this node as online
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
     tracker_.record_node_online(local_node_id);
     
     spdlog::info("Started monitoring local node: {}", 
@@ -27,8 +58,12 @@ void ActivityMonitor::start_monitoring_local_node(const NodeID& local_node_id) {
 }
 
 void ActivityMonitor::stop_monitoring_local_node() {
+    // Buffered traffic still belongs to the local node
+    flush_traffic();
+    
     if (local_node_id_.has_value()) {
         // Report this node as offline
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
         tracker_.record_node_offline(local_node_id_.value());
         
         spdlog::info("Stopped monitoring local node: {}",
@@ -41,15 +76,27 @@ void ActivityMonitor::stop_monitoring_local_node() {
 
 void ActivityMonitor::on_peer_connected(const NodeID& peer_id) {
     total_connections_++;
+    peer_index(peer_id);
     
     // Report peer as online
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
     tracker_.record_node_online(peer_id);
     
     spdlog::debug("Peer connected: {}", peer_id.to_string().substr(0, 8));
 }
 
 void ActivityMonitor::on_peer_disconnected(const NodeID& peer_id) {
+    // Its slot is reclaimed once nobody holds it (see reclaim_departed_peers)
+    {
+        std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+        auto it = peer_indices_.find(peer_id.id);
+        if (it != peer_indices_.end()) {
+            peers_[it->second].state = PeerSlot::State::DEPARTED;
+        }
+    }
+    
     // Report peer as offline
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
     tracker_.record_node_offline(peer_id);
     
     spdlog::debug("Peer disconnected: {}", peer_id.to_string().substr(0, 8));
@@ -57,6 +104,7 @@ void ActivityMonitor::on_peer_disconnected(const NodeID& peer_id) {
 
 void ActivityMonitor::on_session_established(const NodeID& peer_id) {
     // Session established means peer is definitely online and responsive
+    std::lock_guard<std::mutex> lock(tracker_mutex_);
     tracker_.record_node_online(peer_id);
     
     spdlog::debug("Session established with: {}", peer_id.to_string().substr(0, 8));
@@ -70,38 +118,234 @@ void ActivityMonitor::on_session_closed(const NodeID& peer_id) {
 }
 
 void ActivityMonitor::on_bytes_sent(const NodeID& peer_id, uint64_t bytes) {
-    // If we're monitoring local node, this is traffic FROM us TO peer
-    if (monitoring_local_ && local_node_id_.has_value()) {
-        tracker_.record_traffic(local_node_id_.value(), bytes, 0);
+    on_bytes_sent(peer_index(peer_id), bytes);
+}
+
+void ActivityMonitor::on_bytes_received(const NodeID& peer_id, uint64_t bytes) {
+    on_bytes_received(peer_index(peer_id), bytes);
+}
+
+void ActivityMonitor::on_bytes_routed_for(const NodeID& node_id, uint64_t bytes) {
+    on_bytes_routed_for(peer_index(node_id), bytes);
+}
+
+uint32_t ActivityMonitor::peer_index(const NodeID& peer_id) {
+    {
+        std::shared_lock<std::shared_mutex> lock(peers_mutex_);
+        auto it = peer_indices_.find(peer_id.id);
+        if (it != peer_indices_.end() && peers_[it->second].state == PeerSlot::State::ACTIVE) {
+            return it->second;
+        }
     }
     
-    // The peer is receiving bytes
-    tracker_.record_traffic(peer_id, 0, bytes);
+    std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+    return assign_index_locked(peer_id);
 }
 
-void ActivityMonitor::on_bytes_received(const NodeID& peer_id, uint64_t bytes) {
-    // If we're monitoring local node, this is traffic FROM peer TO us
-    if (monitoring_local_ && local_node_id_.has_value()) {
-        tracker_.record_traffic(local_node_id_.value(), 0, bytes);
+uint32_t ActivityMonitor::hold_peer(const NodeID& peer_id) {
+    std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+    const uint32_t index = assign_index_locked(peer_id);
+    peers_[index].holders++;
+    return index;
+}
+
+void ActivityMonitor::release_peer(uint32_t peer_index) {
+    std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+    if (peer_index < peers_.size() && peers_[peer_index].holders > 0) {
+        peers_[peer_index].holders--;
+    }
+}
+
+uint32_t ActivityMonitor::assign_index_locked(const NodeID& peer_id) {
+    auto it = peer_indices_.find(peer_id.id);
+    if (it != peer_indices_.end()) {
+        peers_[it->second].state = PeerSlot::State::ACTIVE;  // Back before it was retired
+        return it->second;
     }
     
-    // The peer is sending bytes
-    tracker_.record_traffic(peer_id, bytes, 0);
+    uint32_t index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+        peers_[index] = PeerSlot{peer_id};
+    } else {
+        index = static_cast<uint32_t>(peers_.size());
+        peers_.push_back(PeerSlot{peer_id});
+    }
+    peer_indices_.emplace(peer_id.id, index);
+    return index;
 }
 
-void ActivityMonitor::on_bytes_routed_for(const NodeID& node_id, uint64_t bytes) {
+void ActivityMonitor::reclaim_departed_peers() {
+    std::unique_lock<std::shared_mutex> lock(peers_mutex_);
+    for (uint32_t i = 0; i < peers_.size(); ++i) {
+        auto& slot = peers_[i];
+        if (slot.state == PeerSlot::State::RETIRED) {
+            slot.state = PeerSlot::State::FREE;
+            free_slots_.push_back(i);
+        } else if (slot.state == PeerSlot::State::DEPARTED && slot.holders == 0) {
+            peer_indices_.erase(slot.node_id.id);
+            slot.state = PeerSlot::State::RETIRED;
+        }
+    }
+}
+
+size_t ActivityMonitor::tracked_peer_count() const {
+    std::shared_lock<std::shared_mutex> lock(peers_mutex_);
+    return peer_indices_.size();
+}
+
+size_t ActivityMonitor::peer_slot_count() const {
+    std::shared_lock<std::shared_mutex> lock(peers_mutex_);
+    return peers_.size();
+}
+
+void ActivityMonitor::on_bytes_sent(uint32_t peer_index, uint64_t bytes) {
+    // Traffic FROM us TO peer: the peer is receiving bytes
+    record_peer_traffic(peer_index, bytes, 0, 0);
+}
+
+void ActivityMonitor::on_bytes_received(uint32_t peer_index, uint64_t bytes) {
+    // Traffic FROM peer TO us: the peer is sending bytes
+    record_peer_traffic(peer_index, 0, bytes, 0);
+}
+
+void ActivityMonitor::on_bytes_routed_for(uint32_t peer_index, uint64_t bytes) {
     // This node routed traffic on behalf of others
-    tracker_.record_bytes_routed(node_id, bytes);
+    record_peer_traffic(peer_index, 0, 0, bytes);
+}
+
+ActivityMonitor::TrafficShard& ActivityMonitor::local_shard() {
+    struct CachedShard {
+        uint64_t monitor_id = 0;
+        TrafficShard* shard = nullptr;
+    };
+    thread_local CachedShard cached;
+    
+    if (cached.monitor_id != instance_id_) {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        auto& shard = shards_[std::this_thread::get_id()];
+        if (!shard) {
+            shard = std::make_unique<TrafficShard>();
+        }
+        cached.monitor_id = instance_id_;
+        cached.shard = shard.get();
+    }
+    return *cached.shard;
+}
+
+void ActivityMonitor::record_peer_traffic(uint32_t peer_index, uint64_t sent_to,
+                                          uint64_t received_from, uint64_t routed) {
+    TrafficShard& shard = local_shard();
+    bool flush_due = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (peer_index >= shard.peers.size()) {
+            shard.peers.resize(static_cast<size_t>(peer_index) + 1);
+        }
+        auto& peer = shard.peers[peer_index];
+        peer.sent_to += sent_to;
+        peer.received_from += received_from;
+        peer.routed += routed;
+        if (monitoring_local_) {
+            shard.local_sent += sent_to;
+            shard.local_received += received_from;
+        }
+        flush_due = ++shard.pending_events >= FLUSH_BATCH;
+    }
+    
+    // Whoever hits the batch size flushes every thread; skip if a flush is running
+    if (flush_due) {
+        std::unique_lock<std::mutex> lock(flush_mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            lock.unlock();
+            flush_traffic();
+        }
+    }
+}
+
+void ActivityMonitor::flush_traffic() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+    
+    std::vector<PeerTraffic> merged;
+    uint64_t local_sent = 0;
+    uint64_t local_received = 0;
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        for (auto& [thread_id, shard] : shards_) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            if (shard->pending_events == 0) {
+                continue;
+            }
+            if (shard->peers.size() > merged.size()) {
+                merged.resize(shard->peers.size());
+            }
+            for (size_t i = 0; i < shard->peers.size(); ++i) {
+                auto& peer = shard->peers[i];
+                merged[i].sent_to += peer.sent_to;
+                merged[i].received_from += peer.received_from;
+                merged[i].routed += peer.routed;
+                total_bytes_routed_ += peer.routed;
+                peer = PeerTraffic{};
+            }
+            local_sent += shard->local_sent;
+            local_received += shard->local_received;
+            shard->local_sent = 0;
+            shard->local_received = 0;
+            shard->pending_events = 0;
+        }
+    }
+    
+    std::vector<postake::ContributionTracker::TrafficDelta> deltas;
+    {
+        std::shared_lock<std::shared_mutex> lock(peers_mutex_);
+        for (size_t i = 0; i < merged.size(); ++i) {
+            const auto& peer = merged[i];
+            if (peer.sent_to == 0 && peer.received_from == 0 && peer.routed == 0) {
+                continue;
+            }
+            postake::ContributionTracker::TrafficDelta delta;
+            delta.node_id = peers_[i].node_id;
+            delta.bytes_sent = peer.received_from;
+            delta.bytes_received = peer.sent_to;
+            delta.bytes_routed = peer.routed;
+            deltas.push_back(delta);
+        }
+    }
+    if ((local_sent != 0 || local_received != 0) && local_node_id_.has_value()) {
+        postake::ContributionTracker::TrafficDelta delta;
+        delta.node_id = local_node_id_.value();
+        delta.bytes_sent = local_sent;
+        delta.bytes_received = local_received;
+        deltas.push_back(delta);
+    }
     
-    total_bytes_routed_ += bytes;
+    if (!deltas.empty()) {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.apply_traffic(deltas);
+    }
     
-    spdlog::debug("Node {} routed {} bytes", 
-        node_id.to_string().substr(0, 8), bytes);
+    reclaim_departed_peers();
+}
+
+uint64_t ActivityMonitor::total_bytes_routed() const {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    uint64_t total = total_bytes_routed_;
+    for (const auto& [thread_id, shard] : shards_) {
+        std::lock_guard<std::mutex> shard_lock(shard->mutex);
+        for (const auto& peer : shard->peers) {
+            total += peer.routed;
+        }
+    }
+    return total;
 }
 
 void ActivityMonitor::on_thing_hosted(const NodeID& node_id, const Hash256& thing_hash, uint64_t size_bytes) {
     // Record hosting contribution
-    tracker_.record_thing_hosted(node_id, size_bytes);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_thing_hosted(node_id, size_bytes);
+    }
     
     // Track locally
     {
@@ -118,7 +362,10 @@ void ActivityMonitor::on_thing_hosted(const NodeID& node_id, const Hash256& thin
 
 void ActivityMonitor::on_thing_removed(const NodeID& node_id, const Hash256& thing_hash, uint64_t size_bytes) {
     // Record removal
-    tracker_.record_thing_removed(node_id, size_bytes);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_thing_removed(node_id, size_bytes);
+    }
     
     // Remove from local tracking
     {
@@ -133,7 +380,10 @@ void ActivityMonitor::on_thing_removed(const NodeID& node_id, const Hash256& thi
 
 void ActivityMonitor::on_route_successful(const NodeID& node_id, const Hash256& content_hash) {
     // Record successful routing
-    tracker_.record_successful_route(node_id);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_successful_route(node_id);
+    }
     
     total_routes_monitored_++;
     
@@ -143,7 +393,10 @@ void ActivityMonitor::on_route_successful(const NodeID& node_id, const Hash256&
 
 void ActivityMonitor::on_route_failed(const NodeID& node_id, const Hash256& content_hash) {
     // Record failed routing
-    tracker_.record_failed_route(node_id);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_failed_route(node_id);
+    }
     
     total_routes_monitored_++;
     
@@ -152,16 +405,27 @@ void ActivityMonitor::on_route_failed(const NodeID& node_id, const Hash256& cont
 }
 
 void ActivityMonitor::on_epoch_witnessed(const NodeID& node_id, uint64_t epoch) {
+    // Epoch boundary: scores for the epoch need exact traffic totals
+    flush_traffic();
+    
     // Record epoch participation
-    tracker_.record_epoch_witness(node_id, epoch);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_epoch_witness(node_id, epoch);
+    }
     
     spdlog::debug("Node {} witnessed epoch {}",
         node_id.to_string().substr(0, 8), epoch);
 }
 
 void ActivityMonitor::on_epoch_missed(const NodeID& node_id, uint64_t epoch) {
+    flush_traffic();
+    
     // Record missed epoch
-    tracker_.record_epoch_missed(node_id, epoch);
+    {
+        std::lock_guard<std::mutex> lock(tracker_mutex_);
+        tracker_.record_epoch_missed(node_id, epoch);
+    }
     
     spdlog::debug("Node {} missed epoch {}",
         node_id.to_string().substr(0, 8), epoch);
@@ -174,6 +438,7 @@ MonitoredSession::MonitoredSession(
 )
     : session_(std::move(session)),
       monitor_(monitor),
+      peer_index_(monitor.hold_peer(session_->get_remote_node_id())),
       bytes_sent_(0),
       bytes_received_(0)
 {
@@ -184,6 +449,7 @@ MonitoredSession::MonitoredSession(
 MonitoredSession::~MonitoredSession() {
     // Notify monitor of session closure
     monitor_.on_session_closed(session_->get_remote_node_id());
+    monitor_.release_peer(peer_index_);
 }
 
 std::optional<std::vector<uint8_t>> MonitoredSession::encrypt_and_send(
@@ -196,7 +462,7 @@ std::optional<std::vector<uint8_t>> MonitoredSession::encrypt_and_send(
         bytes_sent_ += bytes;
         
         // Report to monitor
-        monitor_.on_bytes_sent(session_->get_remote_node_id(), bytes);
+        monitor_.on_bytes_sent(peer_index_, bytes);
     }
     
     return ciphertext;
@@ -209,7 +475,7 @@ std::optional<std::vector<uint8_t>> MonitoredSession::receive_and_decrypt(
     bytes_received_ += bytes;
     
     // Report to monitor
-    monitor_.on_bytes_received(session_->get_remote_node_id(), bytes);
+    monitor_.on_bytes_received(peer_index_, bytes);
     
     return session_->decrypt_message(ciphertext);
 }
@@ -235,10 +501,12 @@ std::shared_ptr<Connection> MonitoredConnectionManager::create_monitored_connect
         // Set up callbacks to monitor activity
         
         // Data callback to track received bytes
-        conn->set_data_callback([this, remote_node_id](
+        // The index is held until the connection goes down
+        const uint32_t peer_index = monitor_.hold_peer(remote_node_id);
+        conn->set_data_callback([this, peer_index](
             const std::vector<uint8_t>& data
         ) {
-            monitor_.on_bytes_received(remote_node_id, data.size());
+            monitor_.on_bytes_received(peer_index, data.size());
         });
         
         // Connect callback
@@ -247,8 +515,9 @@ std::shared_ptr<Connection> MonitoredConnectionManager::create_monitored_connect
         });
         
         // Disconnect callback
-        conn->set_disconnected_callback([this, remote_node_id]() {
+        conn->set_disconnected_callback([this, remote_node_id, peer_index]() {
             monitor_.on_peer_disconnected(remote_node_id);
+            monitor_.release_peer(peer_index);
         });
     }
     
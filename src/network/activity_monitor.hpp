@@ -4,8 +4,14 @@
 #include "core/postake/postake.hpp"
 #include "network/session.hpp"
 #include "network/connection.hpp"
+#include "utils/maintenance_scheduler.hpp"
 #include <memory>
 #include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace cashew::network {
 
@@ -19,11 +25,27 @@ namespace cashew::network {
  * - Traffic sent/received
  * - Thing hosting activity
  * - Routing success/failure
+ *
+ * Traffic is reported per message, so it is not written to the tracker
+ * directly. Each thread adds into its own buffer indexed by a dense peer
+ * index (see peer_index), and the buffers are folded into the tracker in one
+ * batch every FLUSH_BATCH events on a thread, at epoch boundaries, every
+ * FLUSH_INTERVAL on the maintenance scheduler (start_periodic_flush), and on
+ * flush_traffic(). Call flush_traffic() before scoring so totals are exact.
+ *
+ * Peer slots are reused so churn does not grow the buffers. A peer that has
+ * disconnected and is no longer held (hold_peer) leaves the index map at the
+ * next flush and its slot is reused after the one after that, so traffic
+ * recorded through a stale index in between still reaches the old peer.
  */
 class ActivityMonitor {
 public:
     explicit ActivityMonitor(postake::ContributionTracker& tracker);
-    ~ActivityMonitor() = default;
+    ~ActivityMonitor();
+    
+    // Traffic events a thread buffers before it flushes on its own
+    static constexpr uint32_t FLUSH_BATCH = 4096;
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{5000};
     
     // Node lifecycle monitoring
     void on_peer_connected(const NodeID& peer_id);
@@ -36,6 +58,28 @@ public:
     void on_bytes_received(const NodeID& peer_id, uint64_t bytes);
     void on_bytes_routed_for(const NodeID& node_id, uint64_t bytes);
     
+    // Same, by peer index (no lookup; callers cache the index per peer).
+    // Long-lived holders take the index with hold_peer so it outlives a
+    // disconnect, and release it when done.
+    uint32_t peer_index(const NodeID& peer_id);
+    uint32_t hold_peer(const NodeID& peer_id);
+    void release_peer(uint32_t peer_index);
+    void on_bytes_sent(uint32_t peer_index, uint64_t bytes);
+    void on_bytes_received(uint32_t peer_index, uint64_t bytes);
+    void on_bytes_routed_for(uint32_t peer_index, uint64_t bytes);
+    
+    /**
+     * Fold all buffered traffic into the tracker
+     */
+    void flush_traffic();
+    
+    // Time-based flush, for nodes whose traffic never reaches FLUSH_BATCH
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+        maintenance_ = std::move(scheduler);
+    }
+    bool start_periodic_flush(std::chrono::milliseconds interval = FLUSH_INTERVAL);
+    void stop_periodic_flush();
+    
     // Content monitoring
     void on_thing_hosted(const NodeID& node_id, const Hash256& thing_hash, uint64_t size_bytes);
     void on_thing_removed(const NodeID& node_id, const Hash256& thing_hash, uint64_t size_bytes);
@@ -54,12 +98,56 @@ public:
     
     // Statistics
     uint64_t total_connections_monitored() const { return total_connections_; }
-    uint64_t total_bytes_routed() const { return total_bytes_routed_; }
+    uint64_t total_bytes_routed() const;  // Includes traffic not yet flushed
     uint64_t total_things_hosted() const { return total_things_hosted_; }
     uint64_t total_routes_monitored() const { return total_routes_monitored_; }
+    size_t tracked_peer_count() const;  // Peers holding an index
+    size_t peer_slot_count() const;     // Slots allocated, in use or free
     
 private:
+    struct PeerTraffic {
+        uint64_t sent_to = 0;
+        uint64_t received_from = 0;
+        uint64_t routed = 0;
+    };
+    
+    // One per thread; only contended while a flush drains it
+    struct TrafficShard {
+        std::mutex mutex;
+        std::vector<PeerTraffic> peers;  // Indexed by peer index
+        uint64_t local_sent = 0;
+        uint64_t local_received = 0;
+        uint32_t pending_events = 0;
+    };
+    
+    struct PeerSlot {
+        enum class State : uint8_t {
+            ACTIVE,
+            DEPARTED,  // Disconnected; retired at the next flush once unheld
+            RETIRED,   // Out of the index map; freed at the next flush
+            FREE
+        };
+        NodeID node_id;
+        uint32_t holders = 0;
+        State state = State::ACTIVE;
+    };
+    
     postake::ContributionTracker& tracker_;
+    std::mutex tracker_mutex_;
+    
+    // Dense peer indices, reused after a departed peer's slot is freed
+    std::unordered_map<Hash256, uint32_t> peer_indices_;
+    std::vector<PeerSlot> peers_;
+    std::vector<uint32_t> free_slots_;
+    mutable std::shared_mutex peers_mutex_;
+    
+    const uint64_t instance_id_;
+    std::unordered_map<std::thread::id, std::unique_ptr<TrafficShard>> shards_;
+    mutable std::mutex shards_mutex_;
+    std::mutex flush_mutex_;
+    
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    uint64_t flush_task_ = 0;
     
     // Local node tracking
     std::optional<NodeID> local_node_id_;
@@ -74,6 +162,11 @@ private:
     // Track hosted Things
     std::map<Hash256, uint64_t> hosted_things_;  // thing_hash -> size_bytes
     std::mutex hosted_mutex_;
+    
+    TrafficShard& local_shard();
+    uint32_t assign_index_locked(const NodeID& peer_id);  // peers_mutex_ held exclusively
+    void reclaim_departed_peers();
+    void record_peer_traffic(uint32_t peer_index, uint64_t sent_to, uint64_t received_from, uint64_t routed);
 };
 
 /**
@@ -101,6 +194,7 @@ public:
 private:
     std::shared_ptr<Session> session_;
     ActivityMonitor& monitor_;
+    uint32_t peer_index_;
     
     std::atomic<uint64_t> bytes_sent_;
     std::atomic<uint64_t> bytes_received_;
@@ -1,4 +1,5 @@
 #include "network/connection.hpp"
+#include "runtime/executor.hpp"
 #include "utils/logger.hpp"
 #include <cstring>
 #include <sstream>
@@ -420,21 +421,33 @@ std::optional<std::vector<uint8_t>> TCPConnection::receive(size_t max_bytes) {
 }
 
 void TCPConnection::async_send(const std::vector<uint8_t>& data, std::function<void(bool)> callback) {
-    std::thread([this, data, callback]() {
+    auto job = [this, data, callback]() {
         bool result = send(data);
         if (callback) {
             callback(result);
         }
-    }).detach();
+    };
+    
+    if (executor_) {
+        executor_->submit(std::move(job), runtime::Priority::BULK);
+    } else {
+        std::thread(std::move(job)).detach();
+    }
 }
 
 void TCPConnection::async_receive(size_t max_bytes, DataCallback callback) {
-    std::thread([this, max_bytes, callback]() {
+    auto job = [this, max_bytes, callback]() {
         auto result = receive(max_bytes);
         if (result && callback) {
             callback(*result);
         }
-    }).detach();
+    };
+    
+    if (executor_) {
+        executor_->submit(std::move(job), runtime::Priority::BULK);
+    } else {
+        std::thread(std::move(job)).detach();
+    }
 }
 
 SocketAddress TCPConnection::get_local_address() const {
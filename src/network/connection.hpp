@@ -10,6 +10,10 @@
 #include <map>
 #include <mutex>
 
+namespace cashew::runtime {
+class Executor;
+}
+
 namespace cashew::network {
 
 /**
@@ -191,6 +195,12 @@ public:
     void set_nodelay(bool enable);
     void set_keepalive(bool enable, uint32_t idle_seconds = 60);
     
+    /**
+     * Run async_send/async_receive as BULK jobs on executor instead of
+     * spawning a detached thread per call
+     */
+    void set_executor(std::shared_ptr<runtime::Executor> executor) { executor_ = std::move(executor); }
+    
 private:
     int socket_fd_;
     ConnectionState state_;
@@ -202,6 +212,7 @@ private:
     std::chrono::steady_clock::time_point connected_at_;
     
     std::shared_ptr<BandwidthLimiter> bandwidth_limiter_;
+    std::shared_ptr<runtime::Executor> executor_;
     
     // Async I/O thread
     std::thread async_thread_;
@@ -0,0 +1,303 @@
+#include "content_digest.hpp"
+#include "crypto/blake3.hpp"
+#include "crypto/ed25519.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace cashew::network {
+
+namespace {
+
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Content hashes are already uniform; spread two halves for block and bits
+std::pair<uint64_t, uint64_t> key_hashes(const ContentHash& content_hash) {
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    for (int i = 0; i < 8; ++i) {
+        lo |= static_cast<uint64_t>(content_hash.hash[i]) << (i * 8);
+        hi |= static_cast<uint64_t>(content_hash.hash[8 + i]) << (i * 8);
+    }
+    return {mix64(lo), mix64(hi)};
+}
+
+size_t block_count_for(size_t expected_items) {
+    return (std::max<size_t>(expected_items, 64) * 12 + 511) / 512;
+}
+
+void write_u32(std::vector<uint8_t>& data, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        data.push_back((value >> (i * 8)) & 0xFF);
+    }
+}
+
+void write_u64(std::vector<uint8_t>& data, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        data.push_back((value >> (i * 8)) & 0xFF);
+    }
+}
+
+uint32_t read_u32(const std::vector<uint8_t>& data, size_t& offset) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(data[offset++]) << (i * 8);
+    }
+    return value;
+}
+
+uint64_t read_u64(const std::vector<uint8_t>& data, size_t& offset) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(data[offset++]) << (i * 8);
+    }
+    return value;
+}
+
+void write_hashes(std::vector<uint8_t>& data, const std::vector<ContentHash>& hashes) {
+    write_u32(data, static_cast<uint32_t>(hashes.size()));
+    for (const auto& content_hash : hashes) {
+        data.insert(data.end(), content_hash.hash.begin(), content_hash.hash.end());
+    }
+}
+
+bool read_hashes(const std::vector<uint8_t>& data, size_t& offset, std::vector<ContentHash>& hashes) {
+    if (offset + 4 > data.size()) return false;
+    uint32_t count = read_u32(data, offset);
+    if (count > ContentDigest::MAX_DELTA_ITEMS || offset + count * 32ULL > data.size()) {
+        return false;
+    }
+    hashes.resize(count);
+    for (auto& content_hash : hashes) {
+        std::copy(data.begin() + offset, data.begin() + offset + 32, content_hash.hash.begin());
+        offset += 32;
+    }
+    return true;
+}
+
+} // namespace
+
+// ContentSetFilter implementation
+
+ContentSetFilter::ContentSetFilter(size_t expected_items)
+    : blocks_(block_count_for(expected_items), Block{}) {
+}
+
+size_t ContentSetFilter::memory_bytes_for(size_t expected_items) {
+    return block_count_for(expected_items) * sizeof(Block);
+}
+
+void ContentSetFilter::insert(const ContentHash& content_hash) {
+    auto [block_hash, bit_hash] = key_hashes(content_hash);
+    Block& block = blocks_[block_hash % blocks_.size()];
+    for (size_t i = 0; i < PROBES; ++i) {
+        const size_t bit = (bit_hash >> (i * 9)) & 511;
+        block.words[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool ContentSetFilter::might_contain(const ContentHash& content_hash) const {
+    auto [block_hash, bit_hash] = key_hashes(content_hash);
+    const Block& block = blocks_[block_hash % blocks_.size()];
+    for (size_t i = 0; i < PROBES; ++i) {
+        const size_t bit = (bit_hash >> (i * 9)) & 511;
+        if ((block.words[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> ContentSetFilter::to_bytes() const {
+    std::vector<uint8_t> data;
+    data.reserve(4 + memory_bytes());
+    write_u32(data, static_cast<uint32_t>(blocks_.size()));
+    for (const auto& block : blocks_) {
+        for (uint64_t word : block.words) {
+            write_u64(data, word);
+        }
+    }
+    return data;
+}
+
+std::optional<ContentSetFilter> ContentSetFilter::from_bytes(const std::vector<uint8_t>& data, size_t& offset) {
+    if (offset + 4 > data.size()) {
+        return std::nullopt;
+    }
+    uint32_t block_count = read_u32(data, offset);
+    if (block_count == 0 || block_count > MAX_BLOCKS ||
+        offset + block_count * sizeof(Block) > data.size()) {
+        return std::nullopt;
+    }
+
+    ContentSetFilter filter(0);
+    filter.blocks_.assign(block_count, Block{});
+    for (auto& block : filter.blocks_) {
+        for (auto& word : block.words) {
+            word = read_u64(data, offset);
+        }
+    }
+    return filter;
+}
+
+// ContentDigest implementation
+
+std::vector<uint8_t> ContentDigest::signing_bytes() const {
+    auto data = to_bytes();
+    data.resize(data.size() - signature.size());
+    return data;
+}
+
+bool ContentDigest::verify_signature() const {
+    if (crypto::Blake3::hash(bytes(hosting_key.begin(), hosting_key.end())) != hosting_node.id) {
+        return false;
+    }
+    return crypto::Ed25519::verify(signing_bytes(), signature, hosting_key);
+}
+
+std::vector<uint8_t> ContentDigest::to_bytes() const {
+    std::vector<uint8_t> data;
+    data.reserve(32 + 32 + 1 + 8 + 8 + 4 + (filter ? 4 + filter->memory_bytes() : 0) +
+                 8 + 32 * (added.size() + removed.size()) + 8 + 64);
+
+    data.insert(data.end(), hosting_node.id.begin(), hosting_node.id.end());
+    data.insert(data.end(), hosting_key.begin(), hosting_key.end());
+    data.push_back(is_full() ? 1 : 0);
+    write_u64(data, since_version);
+    write_u64(data, version);
+    write_u32(data, item_count);
+
+    if (filter) {
+        auto filter_bytes = filter->to_bytes();
+        data.insert(data.end(), filter_bytes.begin(), filter_bytes.end());
+    }
+    write_hashes(data, added);
+    write_hashes(data, removed);
+
+    write_u64(data, timestamp);
+    data.insert(data.end(), signature.begin(), signature.end());
+
+    return data;
+}
+
+std::optional<ContentDigest> ContentDigest::from_bytes(const std::vector<uint8_t>& data) {
+    if (data.size() < 32 + 32 + 1 + 8 + 8 + 4 + 4 + 4 + 8 + 64) {
+        return std::nullopt;
+    }
+
+    ContentDigest digest;
+    size_t offset = 0;
+
+    std::copy(data.begin(), data.begin() + 32, digest.hosting_node.id.begin());
+    offset += 32;
+    std::copy(data.begin() + offset, data.begin() + offset + 32, digest.hosting_key.begin());
+    offset += 32;
+
+    uint8_t full = data[offset++];
+    digest.since_version = read_u64(data, offset);
+    digest.version = read_u64(data, offset);
+    digest.item_count = read_u32(data, offset);
+
+    if (full == 1) {
+        digest.filter = ContentSetFilter::from_bytes(data, offset);
+        if (!digest.filter) return std::nullopt;
+    }
+    if (!read_hashes(data, offset, digest.added) ||
+        !read_hashes(data, offset, digest.removed)) {
+        return std::nullopt;
+    }
+
+    if (offset + 8 + 64 > data.size()) return std::nullopt;
+    digest.timestamp = read_u64(data, offset);
+    std::copy(data.begin() + offset, data.begin() + offset + 64, digest.signature.begin());
+
+    return digest;
+}
+
+// ContentSetTracker implementation
+
+ContentSetTracker::ContentSetTracker(uint64_t incarnation)
+    : version_(incarnation) {
+}
+
+uint64_t ContentSetTracker::default_incarnation() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+bool ContentSetTracker::add(const ContentHash& content_hash) {
+    if (!items_.insert(content_hash).second) {
+        return false;
+    }
+    // Re-adding something withdrawn since the last digest is no change at all
+    if (pending_removed_.erase(content_hash) == 0) {
+        pending_added_.insert(content_hash);
+    }
+    return true;
+}
+
+bool ContentSetTracker::remove(const ContentHash& content_hash) {
+    if (items_.erase(content_hash) == 0) {
+        return false;
+    }
+    if (pending_added_.erase(content_hash) == 0) {
+        pending_removed_.insert(content_hash);
+    }
+    return true;
+}
+
+void ContentSetTracker::bump_version() {
+    if (has_pending_changes()) {
+        ++version_;
+        pending_added_.clear();
+        pending_removed_.clear();
+    }
+}
+
+ContentDigest ContentSetTracker::full_digest() {
+    bump_version();
+
+    issued_ = true;
+    wear_limit_ = std::max<size_t>(items_.size(), 64) / 4;
+    added_since_full_ = 0;
+    withdrawn_since_full_ = 0;
+
+    ContentDigest digest;
+    digest.version = version_;
+    digest.item_count = static_cast<uint32_t>(items_.size());
+    digest.filter = ContentSetFilter(items_.size());
+    for (const auto& content_hash : items_) {
+        digest.filter->insert(content_hash);
+    }
+    return digest;
+}
+
+ContentDigest ContentSetTracker::next_digest() {
+    // Nobody holds a base before the first digest
+    const size_t changes = pending_added_.size() + pending_removed_.size();
+    const bool worn = added_since_full_ + pending_added_.size() > wear_limit_ ||
+                      withdrawn_since_full_ + pending_removed_.size() > wear_limit_;
+    if (!issued_ || worn || changes > ContentDigest::MAX_DELTA_ITEMS ||
+        changes * 32 >= ContentSetFilter::memory_bytes_for(items_.size())) {
+        return full_digest();
+    }
+    added_since_full_ += pending_added_.size();
+    withdrawn_since_full_ += pending_removed_.size();
+
+    ContentDigest digest;
+    digest.since_version = version_;
+    digest.added.assign(pending_added_.begin(), pending_added_.end());
+    digest.removed.assign(pending_removed_.begin(), pending_removed_.end());
+    bump_version();
+    digest.version = version_;
+    digest.item_count = static_cast<uint32_t>(items_.size());
+    return digest;
+}
+
+} // namespace cashew::network
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "cashew/common.hpp"
+#include <array>
+#include <set>
+#include <vector>
+#include <optional>
+
+namespace cashew::network {
+
+/**
+ * ContentSetFilter - Blocked Bloom filter over content hashes
+ *
+ * Same layout as RevocationFilter: each hash maps to one 64-byte block.
+ * Hashing is unseeded, so a filter built by one node can be shipped and
+ * probed as-is by any other. No false negatives; entries cannot be removed.
+ */
+class ContentSetFilter {
+public:
+    explicit ContentSetFilter(size_t expected_items = 1024);
+
+    void insert(const ContentHash& content_hash);
+    bool might_contain(const ContentHash& content_hash) const;
+
+    size_t memory_bytes() const { return blocks_.size() * sizeof(Block); }
+    static size_t memory_bytes_for(size_t expected_items);
+
+    std::vector<uint8_t> to_bytes() const;
+    static std::optional<ContentSetFilter> from_bytes(const std::vector<uint8_t>& data, size_t& offset);
+
+    static constexpr size_t MAX_BLOCKS = 65536;  // 4 MiB, ~2.8M items
+
+private:
+    struct alignas(64) Block {
+        std::array<uint64_t, 8> words;
+    };
+
+    static constexpr size_t BITS_PER_KEY = 12;
+    static constexpr size_t PROBES = 7;
+
+    std::vector<Block> blocks_;
+};
+
+/**
+ * ContentDigest - A node's hosted content set, signed and versioned
+ *
+ * A full digest carries a filter over the whole set. A delta carries the
+ * hashes added and removed since `since_version` and only applies on top of
+ * exactly that version; a receiver that missed one waits for the next full
+ * digest.
+ *
+ * The digest carries the hosting node's public key, so it is verifiable on
+ * its own: the node ID must be the key's hash and the signature must cover
+ * every other field.
+ */
+struct ContentDigest {
+    NodeID hosting_node{};
+    PublicKey hosting_key{};
+    uint64_t since_version = 0;  // Deltas only
+    uint64_t version = 0;
+    uint32_t item_count = 0;     // Size of the set at version
+    std::optional<ContentSetFilter> filter;  // Full digests only
+    std::vector<ContentHash> added;
+    std::vector<ContentHash> removed;
+    uint64_t timestamp = 0;
+    Signature signature{};
+
+    static constexpr size_t MAX_DELTA_ITEMS = 4096;
+
+    bool is_full() const { return filter.has_value(); }
+
+    std::vector<uint8_t> signing_bytes() const;  // to_bytes() without the signature
+    bool verify_signature() const;
+
+    std::vector<uint8_t> to_bytes() const;
+    static std::optional<ContentDigest> from_bytes(const std::vector<uint8_t>& data);
+};
+
+/**
+ * ContentSetTracker - Local hosted set and the digests that describe it
+ *
+ * Changes accumulate until the next digest. Deltas are sent while they are
+ * smaller than a fresh filter would be; otherwise a full digest goes out.
+ * A full digest is also re-issued once receivers' copies have worn: after
+ * deltas have added or withdrawn more than a quarter of the set the last
+ * filter was sized for (added hashes overfill it and raise its false
+ * positive rate; withdrawn ones are held on the side).
+ *
+ * Versions start at the incarnation, by default the wall clock in
+ * microseconds at construction, and count up by one per digest. A restarted
+ * node therefore continues above every version it announced before, and
+ * receivers accept its first full digest instead of discarding it as stale.
+ */
+class ContentSetTracker {
+public:
+    explicit ContentSetTracker(uint64_t incarnation = default_incarnation());
+
+    static uint64_t default_incarnation();
+
+    // Return false when nothing changed
+    bool add(const ContentHash& content_hash);
+    bool remove(const ContentHash& content_hash);
+
+    bool contains(const ContentHash& content_hash) const { return items_.count(content_hash) > 0; }
+    bool has_pending_changes() const { return !pending_added_.empty() || !pending_removed_.empty(); }
+    size_t size() const { return items_.size(); }
+    uint64_t version() const { return version_; }
+    bool has_issued() const { return issued_; }  // Whether any digest went out
+
+    // hosting_node, timestamp and signature are left to the caller
+    ContentDigest full_digest();
+    ContentDigest next_digest();
+
+private:
+    std::set<ContentHash> items_;
+    std::set<ContentHash> pending_added_;
+    std::set<ContentHash> pending_removed_;
+    uint64_t version_;
+    bool issued_ = false;
+
+    // Delta changes receivers have stacked on the last full digest
+    size_t wear_limit_ = 0;
+    size_t added_since_full_ = 0;
+    size_t withdrawn_since_full_ = 0;
+
+    void bump_version();
+};
+
+} // namespace cashew::network
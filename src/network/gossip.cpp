@@ -1,5 +1,6 @@
 #include "gossip.hpp"
 #include "utils/logger.hpp"
+#include "utils/maintenance_scheduler.hpp"
 #include "crypto/blake3.hpp"
 #include "crypto/random.hpp"
 #include <algorithm>
@@ -522,6 +523,30 @@ GossipMessage GossipProtocol::create_content_announcement(
     return message;
 }
 
+GossipMessage GossipProtocol::create_content_digest(ContentDigest digest) {
+    digest.hosting_node = local_node_id_;
+    digest.hosting_key = local_public_key_.value_or(PublicKey{});
+    
+    auto now = std::chrono::system_clock::now();
+    digest.timestamp = 
+        std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    
+    if (sign_callback_) {
+        digest.signature = sign_callback_(digest.signing_bytes());
+    } else {
+        digest.signature = Signature{};
+    }
+    
+    GossipMessage message;
+    message.type = GossipMessageType::CONTENT_DIGEST;
+    message.payload = digest.to_bytes();
+    message.timestamp = digest.timestamp;
+    message.hop_count = 0;
+    message.message_id = message.compute_id();
+    
+    return message;
+}
+
 void GossipProtocol::register_handler(GossipMessageType type, GossipHandler handler) {
     handlers_.push_back({type, handler});
 }
@@ -667,8 +692,10 @@ GossipScheduler::GossipScheduler(GossipProtocol& protocol)
       running_(false),
       peer_announcement_interval_(DEFAULT_PEER_INTERVAL_SECONDS),
       state_update_interval_(DEFAULT_STATE_INTERVAL_SECONDS),
+      content_digest_interval_(DEFAULT_DIGEST_INTERVAL_SECONDS),
       last_peer_announcement_(0),
-      last_state_update_(0) {
+      last_state_update_(0),
+      last_content_digest_(0) {
 }
 
 GossipScheduler::~GossipScheduler() {
@@ -681,6 +708,26 @@ void GossipScheduler::start() {
     }
 
     running_ = true;
+    
+    if (maintenance_) {
+        maintenance_tasks_.push_back(maintenance_->schedule_periodic(
+            "gossip.peer_announcement",
+            std::chrono::duration_cast<std::chrono::milliseconds>(peer_announcement_interval_),
+            [this]() { run_peer_announcement(); },
+            0.1, std::chrono::milliseconds(0)));
+        maintenance_tasks_.push_back(maintenance_->schedule_periodic(
+            "gossip.state_update",
+            std::chrono::duration_cast<std::chrono::milliseconds>(state_update_interval_),
+            [this]() { run_state_update(); },
+            0.1, std::chrono::milliseconds(0)));
+        maintenance_tasks_.push_back(maintenance_->schedule_periodic(
+            "gossip.content_digest",
+            std::chrono::duration_cast<std::chrono::milliseconds>(content_digest_interval_),
+            [this]() { run_content_digest(); }));
+        CASHEW_LOG_INFO("Started gossip scheduler (shared maintenance scheduler)");
+        return;
+    }
+    
     scheduler_thread_ = std::thread(&GossipScheduler::run_scheduler_loop, this);
     CASHEW_LOG_INFO("Started gossip scheduler");
 }
@@ -691,6 +738,12 @@ void GossipScheduler::stop() {
     }
 
     running_ = false;
+    if (maintenance_) {
+        for (auto task_id : maintenance_tasks_) {
+            maintenance_->cancel(task_id);
+        }
+    }
+    maintenance_tasks_.clear();
     if (scheduler_thread_.joinable()) {
         scheduler_thread_.join();
     }
@@ -706,9 +759,44 @@ void GossipScheduler::announce_peer(const NodeCapabilities& capabilities) {
         std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
 }
 
-void GossipScheduler::announce_content(const ContentHash& content_hash, uint64_t content_size) {
-    auto message = protocol_.create_content_announcement(content_hash, content_size);
-    protocol_.broadcast_message(message);
+void GossipScheduler::announce_content(const ContentHash& content_hash, uint64_t /*content_size*/) {
+    std::lock_guard<std::mutex> lock(content_mutex_);
+    hosted_content_.add(content_hash);
+}
+
+void GossipScheduler::withdraw_content(const ContentHash& content_hash) {
+    std::lock_guard<std::mutex> lock(content_mutex_);
+    hosted_content_.remove(content_hash);
+}
+
+size_t GossipScheduler::hosted_content_count() const {
+    std::lock_guard<std::mutex> lock(content_mutex_);
+    return hosted_content_.size();
+}
+
+bool GossipScheduler::publish_content_digest(bool full) {
+    ContentDigest digest;
+    {
+        std::lock_guard<std::mutex> lock(content_mutex_);
+        if (full) {
+            // Nothing hosted and nothing ever withdrawn: no digest needed
+            if (hosted_content_.size() == 0 && !hosted_content_.has_issued() &&
+                !hosted_content_.has_pending_changes()) {
+                return false;
+            }
+            digest = hosted_content_.full_digest();
+        } else {
+            if (!hosted_content_.has_pending_changes()) {
+                return false;
+            }
+            digest = hosted_content_.next_digest();
+        }
+    }
+    
+    protocol_.broadcast_message(protocol_.create_content_digest(std::move(digest)));
+    last_content_digest_ = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return true;
 }
 
 void GossipScheduler::run_scheduler_loop() {
@@ -718,18 +806,38 @@ void GossipScheduler::run_scheduler_loop() {
 
         if (last_peer_announcement_ == 0 ||
             now - last_peer_announcement_ >= static_cast<uint64_t>(peer_announcement_interval_.count())) {
-            NodeCapabilities default_caps;
-            announce_peer(default_caps);
+            run_peer_announcement();
         }
 
         if (last_state_update_ == 0 ||
             now - last_state_update_ >= static_cast<uint64_t>(state_update_interval_.count())) {
-            protocol_.cleanup_old_seen_messages();
-            last_state_update_ = now;
+            run_state_update();
+        }
+
+        if (now - last_content_digest_ >= static_cast<uint64_t>(content_digest_interval_.count())) {
+            run_content_digest();
         }
 
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 }
 
+void GossipScheduler::run_peer_announcement() {
+    NodeCapabilities default_caps;
+    announce_peer(default_caps);
+    
+    // Periodic full digest lets receivers that missed a delta resync
+    publish_content_digest(true);
+}
+
+void GossipScheduler::run_content_digest() {
+    publish_content_digest(false);
+}
+
+void GossipScheduler::run_state_update() {
+    protocol_.cleanup_old_seen_messages();
+    last_state_update_ = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 } // namespace cashew::network
@@ -2,12 +2,17 @@
 
 #include "cashew/common.hpp"
 #include "core/keys/key.hpp"
+#include "network/content_digest.hpp"
 #include <vector>
 #include <optional>
 #include <set>
 #include <functional>
 #include <chrono>
 #include <thread>
+#include <memory>
+#include <mutex>
+
+namespace cashew::utils { class MaintenanceScheduler; }
 
 namespace cashew::network {
 
@@ -20,7 +25,8 @@ enum class GossipMessageType : uint8_t {
     NETWORK_STATE_UPDATE = 3,   // Network-wide state update
     KEY_REVOCATION = 4,         // Revoked key announcement
     NODE_CAPABILITY = 5,        // Node capability advertisement
-    TOKEN_REVOCATION = 6        // Capability token revocation list
+    TOKEN_REVOCATION = 6,       // Capability token revocation list
+    CONTENT_DIGEST = 7          // Node's hosted content set (filter or delta)
 };
 
 /**
@@ -59,6 +65,9 @@ struct PeerAnnouncement {
 
 /**
  * ContentAnnouncement - Node announcing it hosts specific content
+ *
+ * One signed message per Thing; GossipScheduler advertises hosted content
+ * with ContentDigest instead.
  */
 struct ContentAnnouncement {
     ContentHash content_hash;
@@ -155,6 +164,8 @@ public:
         uint64_t content_size,
         std::optional<Hash256> network_id = std::nullopt
     );
+    // Fills in hosting node, timestamp and signature
+    GossipMessage create_content_digest(ContentDigest digest);
     GossipMessage create_network_state_update(const NetworkStateUpdate& state);
     GossipMessage create_key_revocation(const PublicKey& revoked_key, const std::string& reason);
     
@@ -234,7 +245,8 @@ private:
  * 
  * Manages periodic announcements and state updates:
  * - Peer announcements every 5 minutes
- * - Content announcements on change
+ * - Content digests: deltas batched per digest interval, full digest
+ *   alongside every peer announcement
  * - Network state every epoch (10 minutes)
  */
 class GossipScheduler {
@@ -247,9 +259,22 @@ public:
     void stop();
     bool is_running() const { return running_; }
     
+    /**
+     * Run periodic work on a shared maintenance scheduler instead of a
+     * dedicated thread (takes effect on the next start())
+     */
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+        maintenance_ = std::move(scheduler);
+    }
+    
     // Immediate announcements
     void announce_peer(const NodeCapabilities& capabilities);
+    
+    // Hosted content changes go out with the next content digest
     void announce_content(const ContentHash& content_hash, uint64_t content_size);
+    void withdraw_content(const ContentHash& content_hash);
+    // Broadcast pending changes now (or the full set); false if nothing to send
+    bool publish_content_digest(bool full = false);
     
     // Configuration
     void set_peer_announcement_interval(std::chrono::seconds interval) {
@@ -258,9 +283,13 @@ public:
     void set_state_update_interval(std::chrono::seconds interval) {
         state_update_interval_ = interval;
     }
+    void set_content_digest_interval(std::chrono::seconds interval) {
+        content_digest_interval_ = interval;
+    }
     
     // For testing
     uint64_t get_last_peer_announcement_time() const { return last_peer_announcement_; }
+    size_t hosted_content_count() const;
 
 private:
     GossipProtocol& protocol_;
@@ -269,19 +298,33 @@ private:
     // Intervals
     std::chrono::seconds peer_announcement_interval_;
     std::chrono::seconds state_update_interval_;
+    std::chrono::seconds content_digest_interval_;
     
     // Last announcement times
     uint64_t last_peer_announcement_;
     uint64_t last_state_update_;
+    uint64_t last_content_digest_;
+    
+    // Hosted content set (announce_content may be called from any thread)
+    mutable std::mutex content_mutex_;
+    ContentSetTracker hosted_content_;
     
     // Default intervals
     static constexpr uint64_t DEFAULT_PEER_INTERVAL_SECONDS = 300;  // 5 minutes
     static constexpr uint64_t DEFAULT_STATE_INTERVAL_SECONDS = 600;  // 10 minutes
+    static constexpr uint64_t DEFAULT_DIGEST_INTERVAL_SECONDS = 30;
     
     // Background thread management
     void run_scheduler_loop();
+    void run_peer_announcement();
+    void run_state_update();
+    void run_content_digest();
     
     std::thread scheduler_thread_;
+    
+    // Shared scheduler (replaces scheduler_thread_ when set)
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    std::vector<uint64_t> maintenance_tasks_;
 };
 
 } // namespace cashew::network
@@ -3,6 +3,7 @@
 #include "crypto/random.hpp"
 #include "utils/logger.hpp"
 #include <algorithm>
+#include <limits>
 
 namespace cashew::network {
 
@@ -45,6 +46,13 @@ std::vector<uint8_t> LedgerSyncMessage::serialize() const {
         data.insert(data.end(), event_data.begin(), event_data.end());
     }
     
+    // Payload (4-byte size, then bytes)
+    uint32_t payload_size = static_cast<uint32_t>(payload.size());
+    for (int i = 0; i < 4; i++) {
+        data.push_back(static_cast<uint8_t>(payload_size >> (i * 8)));
+    }
+    data.insert(data.end(), payload.begin(), payload.end());
+    
     return data;
 }
 
@@ -107,9 +115,52 @@ std::optional<LedgerSyncMessage> LedgerSyncMessage::deserialize(const std::vecto
         msg.events.push_back(*event);
     }
     
+    // Payload (absent in messages from older nodes)
+    if (offset + 4 <= data.size()) {
+        uint32_t payload_size = 0;
+        for (int i = 0; i < 4; i++) {
+            payload_size |= static_cast<uint32_t>(data[offset++]) << (i * 8);
+        }
+        if (payload_size > data.size() - offset) {
+            return std::nullopt;
+        }
+        msg.payload.assign(data.begin() + offset, data.begin() + offset + payload_size);
+    }
+    
     return msg;
 }
 
+// SyncCursor methods
+
+std::vector<uint8_t> SyncCursor::to_bytes() const {
+    std::vector<uint8_t> data;
+    data.reserve(SIZE);
+    for (int i = 0; i < 8; i++) {
+        data.push_back(static_cast<uint8_t>(epoch >> (i * 8)));
+    }
+    for (int i = 0; i < 4; i++) {
+        data.push_back(static_cast<uint8_t>(offset >> (i * 8)));
+    }
+    data.insert(data.end(), next_event_id.begin(), next_event_id.end());
+    return data;
+}
+
+std::optional<SyncCursor> SyncCursor::from_bytes(const std::vector<uint8_t>& data, size_t offset) {
+    if (offset > data.size() || data.size() - offset < SIZE) {
+        return std::nullopt;
+    }
+    
+    SyncCursor cursor;
+    for (int i = 0; i < 8; i++) {
+        cursor.epoch |= static_cast<uint64_t>(data[offset++]) << (i * 8);
+    }
+    for (int i = 0; i < 4; i++) {
+        cursor.offset |= static_cast<uint32_t>(data[offset++]) << (i * 8);
+    }
+    std::copy(data.begin() + offset, data.begin() + offset + 32, cursor.next_event_id.begin());
+    return cursor;
+}
+
 // LedgerGossipBridge methods
 
 LedgerGossipBridge::LedgerGossipBridge(ledger::Ledger& ledger,
@@ -122,41 +173,93 @@ LedgerGossipBridge::LedgerGossipBridge(ledger::Ledger& ledger,
 }
 
 void LedgerGossipBridge::broadcast_event(const ledger::LedgerEvent& event) {
+    if (pending_events_.empty()) {
+        batch_started_ = std::chrono::steady_clock::now();
+    }
+    pending_events_.push_back(event);
+    
+    if (batch_window_.count() <= 0 || pending_events_.size() >= MAX_BATCH_EVENTS) {
+        flush_event_batch();
+    } else {
+        flush_event_batch_if_due();
+    }
+}
+
+bool LedgerGossipBridge::flush_event_batch_if_due() {
+    if (pending_events_.empty() ||
+        std::chrono::steady_clock::now() - batch_started_ < batch_window_) {
+        return false;
+    }
+    flush_event_batch();
+    return true;
+}
+
+void LedgerGossipBridge::flush_event_batch() {
+    if (pending_events_.empty()) {
+        return;
+    }
+    
     LedgerSyncMessage msg;
     msg.type = LedgerSyncMessage::Type::EVENT_BROADCAST;
-    msg.events.push_back(event);
-    msg.start_epoch = event.epoch;
-    msg.end_epoch = event.epoch;
+    msg.events = std::move(pending_events_);
+    pending_events_.clear();
+    msg.start_epoch = msg.events.front().epoch;
+    msg.end_epoch = msg.events.back().epoch;
     msg.ledger_hash = ledger_.get_latest_hash();
     
     auto serialized = msg.serialize();
     
+    // A lone event keeps its own ID; a batch is identified by its events
+    Hash256 message_id = msg.events.front().event_id;
+    if (msg.events.size() > 1) {
+        std::vector<uint8_t> id_data;
+        id_data.reserve(msg.events.size() * message_id.size());
+        for (const auto& event : msg.events) {
+            id_data.insert(id_data.end(), event.event_id.begin(), event.event_id.end());
+        }
+        message_id = crypto::Blake3::hash(id_data);
+    }
+    
     // Create gossip message
     GossipMessage gossip_msg;
     gossip_msg.type = GossipMessageType::NETWORK_STATE_UPDATE;
-    gossip_msg.message_id = event.event_id;
-    gossip_msg.payload = serialized;
+    gossip_msg.message_id = message_id;
+    gossip_msg.payload = std::move(serialized);
     gossip_msg.timestamp = current_timestamp();
     gossip_msg.hop_count = 0;
     
     gossip_.broadcast_message(gossip_msg);
     
-    events_sent_++;
-    CASHEW_LOG_DEBUG("Broadcast ledger event (epoch {})", event.epoch);
+    events_sent_ += msg.events.size();
+    batches_sent_++;
+    CASHEW_LOG_DEBUG("Broadcast {} ledger events (epoch {} to {})",
+                    msg.events.size(), msg.start_epoch, msg.end_epoch);
 }
 
 void LedgerGossipBridge::broadcast_checkpoint(uint64_t epoch) {
     LedgerSyncMessage msg;
     msg.type = LedgerSyncMessage::Type::CHECKPOINT;
     msg.start_epoch = epoch;
-    msg.end_epoch = epoch;
+    msg.end_epoch = ledger_.tip_epoch();  // Advertised tip, what peers catch up to
     msg.ledger_hash = ledger_.get_latest_hash();
     
+    // Snapshot of the state at this checkpoint, carrying the signatures
+    // peers have announced for the same state so far
+    latest_snapshot_ = state_manager_.create_state_snapshot(snapshot_chunk_size_);
+    auto& manifest = latest_snapshot_->manifest;
+    if (snapshot_signer_) {
+        manifest.sign(snapshot_signer_->node_id, snapshot_signer_->public_key, snapshot_signer_->secret_key);
+    }
+    if (latest_peer_manifest_) {
+        manifest.merge_signatures(*latest_peer_manifest_);
+    }
+    msg.payload = manifest.to_bytes();
+    
     auto serialized = msg.serialize();
     
     GossipMessage gossip_msg;
     gossip_msg.type = GossipMessageType::NETWORK_STATE_UPDATE;
-    gossip_msg.message_id = msg.ledger_hash;
+    gossip_msg.message_id = crypto::Blake3::hash(serialized);
     gossip_msg.payload = serialized;
     gossip_msg.timestamp = current_timestamp();
     gossip_msg.hop_count = 0;
@@ -167,79 +270,247 @@ void LedgerGossipBridge::broadcast_checkpoint(uint64_t epoch) {
                    epoch, crypto::Blake3::hash_to_hex(msg.ledger_hash).substr(0, 16));
 }
 
-void LedgerGossipBridge::request_sync(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch) {
+void LedgerGossipBridge::request_sync(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch,
+                                      const std::optional<SyncCursor>& cursor) {
     LedgerSyncMessage msg;
     msg.type = LedgerSyncMessage::Type::SYNC_REQUEST;
     msg.start_epoch = start_epoch;
     msg.end_epoch = end_epoch;
     msg.ledger_hash = ledger_.get_latest_hash();
     
-    auto serialized = msg.serialize();
-    
-    GossipMessage gossip_msg;
-    gossip_msg.type = GossipMessageType::NETWORK_STATE_UPDATE;
-    
-    // Create unique message ID for sync request
-    std::vector<uint8_t> id_data;
-    for (int i = 0; i < 8; i++) {
-        id_data.push_back(static_cast<uint8_t>(start_epoch >> (i * 8)));
-        id_data.push_back(static_cast<uint8_t>(end_epoch >> (i * 8)));
+    // Paging: preferred page size, then where to resume
+    const uint32_t page_bytes = static_cast<uint32_t>(std::min<size_t>(sync_page_bytes_, SYNC_PAGE_BYTES));
+    for (int i = 0; i < 4; i++) {
+        msg.payload.push_back(static_cast<uint8_t>(page_bytes >> (i * 8)));
+    }
+    if (cursor) {
+        const auto cursor_bytes = cursor->to_bytes();
+        msg.payload.insert(msg.payload.end(), cursor_bytes.begin(), cursor_bytes.end());
     }
-    gossip_msg.message_id = crypto::Blake3::hash(id_data);
-    
-    gossip_msg.payload = serialized;
-    gossip_msg.timestamp = current_timestamp();
-    gossip_msg.hop_count = 0;
     
-    gossip_.send_direct_message(peer_id, gossip_msg);
+    send_sync_message(peer_id, msg);
     
     sync_requests_++;
     CASHEW_LOG_DEBUG("Requested sync from epoch {} to {}", start_epoch, end_epoch);
 }
 
-void LedgerGossipBridge::handle_sync_request(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch) {
-    // Get events in range (filter all events by epoch)
-    auto all_events = ledger_.get_all_events();
-    std::vector<ledger::LedgerEvent> events;
-    for (const auto& evt : all_events) {
-        if (evt.epoch >= start_epoch && evt.epoch <= end_epoch) {
-            events.push_back(evt);
+void LedgerGossipBridge::handle_sync_request(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch,
+                                             const std::vector<uint8_t>& paging) {
+    // Requests from older nodes carry no paging and get the default page
+    size_t page_bytes = SYNC_PAGE_BYTES;
+    if (paging.size() >= 4) {
+        uint32_t requested = 0;
+        for (int i = 0; i < 4; i++) {
+            requested |= static_cast<uint32_t>(paging[i]) << (i * 8);
+        }
+        if (requested > 0) {
+            page_bytes = std::min<size_t>(requested, SYNC_PAGE_BYTES);
         }
     }
     
+    // Resume from the cursor's epoch straight out of the epoch index
+    uint64_t from_epoch = start_epoch;
+    size_t skip = 0;
+    const auto cursor = SyncCursor::from_bytes(paging, 4);
+    if (cursor && cursor->epoch >= start_epoch && cursor->epoch <= end_epoch) {
+        from_epoch = cursor->epoch;
+        skip = cursor->offset;
+    }
+    const auto events = ledger_.events_in_epochs(from_epoch, end_epoch);
+    if (cursor && (skip >= events.size() || events[skip].event_id != cursor->next_event_id ||
+                   events[skip].epoch != cursor->epoch)) {
+        // Our ledger differs from the cursor's; resend that epoch, the requester dedups
+        skip = 0;
+    }
+    
     LedgerSyncMessage msg;
     msg.type = LedgerSyncMessage::Type::SYNC_RESPONSE;
-    msg.events = events;
     msg.start_epoch = start_epoch;
     msg.end_epoch = end_epoch;
     msg.ledger_hash = ledger_.get_latest_hash();
     
-    auto serialized = msg.serialize();
+    // Fill the page up to its byte budget, always at least one event
+    static constexpr size_t PAGE_OVERHEAD = 57 + 4 + SyncCursor::SIZE;
+    size_t page_size = PAGE_OVERHEAD;
+    size_t epoch_offset = skip;
+    size_t index = skip;
+    for (; index < events.size(); ++index) {
+        const auto& event = events[index];
+        const size_t event_size = 4 + event.serialized_size();
+        if (!msg.events.empty() && page_size + event_size > page_bytes) {
+            break;
+        }
+        if (index > skip && event.epoch != events[index - 1].epoch) {
+            epoch_offset = 0;
+        }
+        msg.events.push_back(event);
+        page_size += event_size;
+        epoch_offset++;
+    }
     
-    GossipMessage gossip_msg;
-    gossip_msg.type = GossipMessageType::NETWORK_STATE_UPDATE;
-    gossip_msg.message_id = crypto::Blake3::hash(serialized);
-    gossip_msg.payload = serialized;
-    gossip_msg.timestamp = current_timestamp();
-    gossip_msg.hop_count = 0;
+    if (index < events.size()) {
+        SyncCursor next;
+        next.epoch = events[index].epoch;
+        next.offset = static_cast<uint32_t>(events[index].epoch == msg.events.back().epoch ? epoch_offset : 0);
+        next.next_event_id = events[index].event_id;
+        msg.payload = next.to_bytes();
+    }
     
-    gossip_.send_direct_message(peer_id, gossip_msg);
+    send_sync_message(peer_id, msg);
     
-    CASHEW_LOG_DEBUG("Sent sync response: {} events (epoch {} to {})", 
-                    events.size(), start_epoch, end_epoch);
+    CASHEW_LOG_DEBUG("Sent sync page: {} events (epoch {} to {}, {} more)", 
+                    msg.events.size(), start_epoch, end_epoch, events.size() - index);
 }
 
-void LedgerGossipBridge::handle_sync_response(const NodeID& peer_id, 
-                                               const std::vector<ledger::LedgerEvent>& events) {
-    for (const auto& event : events) {
-        process_received_event(event);
+void LedgerGossipBridge::handle_sync_response(const NodeID& peer_id, const LedgerSyncMessage& message) {
+    const auto cursor = SyncCursor::from_bytes(message.payload);
+    if (!message.events.empty()) {
+        update_peer_sync_state(peer_id, message.events.back().epoch, message.events.back().event_id);
+    }
+    
+    auto range = std::find_if(catch_up_.begin(), catch_up_.end(), [&](const CatchUpRange& candidate) {
+        return !candidate.complete && candidate.peer_id == peer_id &&
+               candidate.start_epoch == message.start_epoch && candidate.end_epoch == message.end_epoch;
+    });
+    
+    if (range == catch_up_.end()) {
+        for (const auto& event : message.events) {
+            process_received_event(event);
+        }
+        // Plain syncs keep paging; stray pages during a catch-up are not followed
+        if (cursor && catch_up_.empty()) {
+            request_sync(peer_id, message.start_epoch, message.end_epoch, cursor);
+        }
+        CASHEW_LOG_INFO("Processed sync response: {} events", message.events.size());
+        return;
     }
     
-    if (!events.empty()) {
-        update_peer_sync_state(peer_id, events.back().epoch, events.back().event_id);
+    range->buffered.insert(range->buffered.end(), message.events.begin(), message.events.end());
+    range->cursor = cursor;
+    range->complete = !cursor;
+    if (cursor) {
+        // Ranges ahead of the head stop paging while too much is held out of order
+        const bool is_head = static_cast<size_t>(range - catch_up_.begin()) == catch_up_head_;
+        if (is_head || catch_up_buffered_events() < catch_up_buffer_limit_) {
+            request_range(*range);
+        } else {
+            range->parked = true;
+        }
     }
     
-    CASHEW_LOG_INFO("Processed sync response: {} events", events.size());
+    apply_catch_up();
+}
+
+bool LedgerGossipBridge::begin_catch_up(uint64_t start_epoch, uint64_t end_epoch,
+                                        const std::vector<NodeID>& peers) {
+    if (peers.empty() || start_epoch > end_epoch || is_catching_up()) {
+        return false;
+    }
+    
+    // Split the part peers have advertised evenly; the last range stays open
+    const uint64_t known_end = std::min(end_epoch, std::max(start_epoch, advertised_tip(peers)));
+    const uint64_t span = known_end - start_epoch + 1;
+    const uint64_t count = std::min<uint64_t>(peers.size(), span);
+    const uint64_t width = span / count;
+    const uint64_t extra = span % count;
+    
+    catch_up_peers_ = peers;
+    catch_up_head_ = 0;
+    uint64_t next_start = start_epoch;
+    for (uint64_t i = 0; i < count; ++i) {
+        CatchUpRange range;
+        range.peer_id = peers[i];
+        range.start_epoch = next_start;
+        range.end_epoch = (i + 1 == count) ? end_epoch : next_start + width + (i < extra ? 1 : 0) - 1;
+        next_start = range.end_epoch + 1;
+        catch_up_.push_back(std::move(range));
+    }
+    
+    for (auto& range : catch_up_) {
+        request_range(range);
+    }
+    
+    CASHEW_LOG_INFO("Catching up on epochs {} to {} from {} peers", start_epoch, known_end, count);
+    return true;
+}
+
+uint64_t LedgerGossipBridge::advertised_tip(const std::vector<NodeID>& peers) const {
+    std::optional<uint64_t> tip;
+    for (const auto& peer_id : peers) {
+        auto it = peer_sync_states_.find(peer_id);
+        if (it != peer_sync_states_.end()) {
+            tip = std::max(tip.value_or(0), it->second.last_synced_epoch);
+        }
+    }
+    // Peers not heard from yet may hold anything up to now
+    return tip.value_or(ledger_.current_epoch());
+}
+
+void LedgerGossipBridge::request_range(CatchUpRange& range) {
+    range.parked = false;
+    range.deadline = std::chrono::steady_clock::now() + catch_up_timeout_;
+    request_sync(range.peer_id, range.start_epoch, range.end_epoch, range.cursor);
+}
+
+size_t LedgerGossipBridge::catch_up_buffered_events() const {
+    size_t total = 0;
+    for (const auto& range : catch_up_) {
+        total += range.buffered.size();
+    }
+    return total;
+}
+
+void LedgerGossipBridge::catch_up_peer_failed(const NodeID& peer_id) {
+    catch_up_peers_.erase(std::remove(catch_up_peers_.begin(), catch_up_peers_.end(), peer_id),
+                          catch_up_peers_.end());
+    if (catch_up_peers_.empty()) {
+        CASHEW_LOG_WARN("Ledger catch-up failed: no peers left");
+        catch_up_.clear();
+        catch_up_head_ = 0;
+        return;
+    }
+    
+    // Hand each unfinished range to the remaining peers, resuming at its cursor
+    size_t next_peer = 0;
+    for (auto& range : catch_up_) {
+        if (range.complete || range.peer_id != peer_id) {
+            continue;
+        }
+        range.peer_id = catch_up_peers_[next_peer++ % catch_up_peers_.size()];
+        if (!range.parked) {
+            request_range(range);
+        }
+    }
+}
+
+void LedgerGossipBridge::apply_catch_up() {
+    while (catch_up_head_ < catch_up_.size()) {
+        auto& range = catch_up_[catch_up_head_];
+        for (const auto& event : range.buffered) {
+            process_received_event(event);
+        }
+        range.buffered.clear();
+        if (!range.complete) {
+            break;
+        }
+        catch_up_head_++;
+    }
+    
+    if (catch_up_head_ < catch_up_.size()) {
+        // Earlier ranges drained: parked ones may page again, the head first
+        for (size_t i = catch_up_head_; i < catch_up_.size(); ++i) {
+            auto& range = catch_up_[i];
+            if (range.parked && (i == catch_up_head_ || catch_up_buffered_events() < catch_up_buffer_limit_)) {
+                request_range(range);
+            }
+        }
+        return;
+    }
+    
+    CASHEW_LOG_INFO("Ledger catch-up complete ({} events)", ledger_.event_count());
+    catch_up_.clear();
+    catch_up_peers_.clear();
+    catch_up_head_ = 0;
 }
 
 void LedgerGossipBridge::handle_gossip_message(const NodeID& source, const GossipMessage& message) {
@@ -252,30 +523,223 @@ void LedgerGossipBridge::handle_gossip_message(const NodeID& source, const Gossi
     
     switch (sync_msg->type) {
         case LedgerSyncMessage::Type::EVENT_BROADCAST:
-            for (const auto& event : sync_msg->events) {
-                process_received_event(event);
-            }
+            process_received_batch(sync_msg->events);
             break;
             
         case LedgerSyncMessage::Type::SYNC_REQUEST:
-            handle_sync_request(source, sync_msg->start_epoch, sync_msg->end_epoch);
+            handle_sync_request(source, sync_msg->start_epoch, sync_msg->end_epoch, sync_msg->payload);
             break;
             
         case LedgerSyncMessage::Type::SYNC_RESPONSE:
-            handle_sync_response(source, sync_msg->events);
+            handle_sync_response(source, *sync_msg);
             break;
             
         case LedgerSyncMessage::Type::CHECKPOINT:
-            update_peer_sync_state(source, sync_msg->start_epoch, sync_msg->ledger_hash);
+            handle_checkpoint(source, *sync_msg);
+            break;
+            
+        case LedgerSyncMessage::Type::SNAPSHOT_REQUEST:
+            handle_snapshot_request(source, sync_msg->start_epoch,
+                                    static_cast<uint32_t>(sync_msg->end_epoch));
+            break;
+            
+        case LedgerSyncMessage::Type::SNAPSHOT_CHUNK:
+            handle_snapshot_chunk(source, sync_msg->start_epoch,
+                                  static_cast<uint32_t>(sync_msg->end_epoch),
+                                  std::move(sync_msg->payload));
+            break;
+    }
+}
+
+void LedgerGossipBridge::set_snapshot_signer(const NodeID& node_id, const PublicKey& public_key,
+                                             const SecretKey& secret_key) {
+    snapshot_signer_ = SnapshotSigner{node_id, public_key, secret_key};
+}
+
+void LedgerGossipBridge::handle_checkpoint(const NodeID& peer_id, const LedgerSyncMessage& message) {
+    update_peer_sync_state(peer_id, message.end_epoch, message.ledger_hash);
+    
+    if (message.payload.empty()) {
+        return;
+    }
+    auto manifest = ledger::StateSnapshotManifest::from_bytes(message.payload);
+    if (!manifest || manifest->ledger_hash != message.ledger_hash) {
+        CASHEW_LOG_WARN("Ignoring checkpoint with malformed snapshot manifest");
+        return;
+    }
+    
+    // Co-signing: signatures for the state we hold accumulate across peers.
+    // merge_signatures() takes only signatures that verify.
+    if (latest_snapshot_) {
+        latest_snapshot_->manifest.merge_signatures(*manifest);
+    }
+    
+    if (latest_peer_manifest_ && latest_peer_manifest_->snapshot_id() == manifest->snapshot_id()) {
+        latest_peer_manifest_->merge_signatures(*manifest);
+    } else if (!latest_peer_manifest_ || manifest->epoch >= latest_peer_manifest_->epoch) {
+        ledger::StateSnapshotManifest adopted = *manifest;
+        adopted.signatures.clear();
+        adopted.merge_signatures(*manifest);
+        latest_peer_manifest_ = std::move(adopted);
+    }
+}
+
+bool LedgerGossipBridge::begin_snapshot_bootstrap(const ledger::StateSnapshotManifest& manifest,
+                                                  const std::vector<NodeID>& peers,
+                                                  const std::map<NodeID, PublicKey>& trusted_signers,
+                                                  size_t quorum) {
+    if (peers.empty() || !manifest.has_quorum(trusted_signers, quorum)) {
+        CASHEW_LOG_WARN("Snapshot for epoch {} lacks a signer quorum", manifest.epoch);
+        return false;
+    }
+    
+    snapshot_download_.emplace(manifest);
+    snapshot_peers_ = peers;
+    snapshot_chunk_deadlines_.clear();
+    for (const auto& peer_id : snapshot_peers_) {
+        request_snapshot_chunks(peer_id);
+    }
+    
+    CASHEW_LOG_INFO("Bootstrapping from snapshot (epoch {}, {} chunks, {} peers)",
+                   manifest.epoch, manifest.chunk_hashes.size(), peers.size());
+    return true;
+}
+
+void LedgerGossipBridge::request_snapshot_chunks(const NodeID& peer_id) {
+    const auto& manifest = snapshot_download_->manifest();
+    const auto deadline = std::chrono::steady_clock::now() + snapshot_chunk_timeout_;
+    while (auto index = snapshot_download_->next_chunk_for(peer_id)) {
+        snapshot_chunk_deadlines_[{peer_id, *index}] = deadline;
+        LedgerSyncMessage msg;
+        msg.type = LedgerSyncMessage::Type::SNAPSHOT_REQUEST;
+        msg.start_epoch = manifest.epoch;
+        msg.end_epoch = *index;
+        msg.ledger_hash = manifest.ledger_hash;
+        send_sync_message(peer_id, msg);
+    }
+}
+
+void LedgerGossipBridge::handle_snapshot_request(const NodeID& peer_id, uint64_t epoch, uint32_t chunk_index) {
+    if (!latest_snapshot_ || latest_snapshot_->manifest.epoch != epoch ||
+        chunk_index >= latest_snapshot_->chunks.size()) {
+        return;
+    }
+    
+    LedgerSyncMessage msg;
+    msg.type = LedgerSyncMessage::Type::SNAPSHOT_CHUNK;
+    msg.start_epoch = epoch;
+    msg.end_epoch = chunk_index;
+    msg.ledger_hash = latest_snapshot_->manifest.ledger_hash;
+    msg.payload = latest_snapshot_->chunks[chunk_index];
+    send_sync_message(peer_id, msg);
+}
+
+void LedgerGossipBridge::handle_snapshot_chunk(const NodeID& peer_id, uint64_t epoch, uint32_t chunk_index,
+                                               std::vector<uint8_t> chunk) {
+    if (!snapshot_download_ || snapshot_download_->manifest().epoch != epoch) {
+        return;
+    }
+    
+    snapshot_chunk_deadlines_.erase({peer_id, chunk_index});
+    if (!snapshot_download_->add_chunk(peer_id, chunk_index, std::move(chunk))) {
+        // Bad data: stop asking this peer and hand its chunks to the others
+        snapshot_peer_failed(peer_id);
+        return;
+    }
+    
+    if (!snapshot_download_->is_complete()) {
+        request_snapshot_chunks(peer_id);
+        return;
+    }
+    
+    const auto manifest = snapshot_download_->manifest();
+    const bool restored = state_manager_.restore_state_snapshot(manifest, snapshot_download_->chunks());
+    const auto peers = std::move(snapshot_peers_);
+    snapshot_download_.reset();
+    snapshot_peers_.clear();
+    snapshot_chunk_deadlines_.clear();
+    if (!restored) {
+        CASHEW_LOG_WARN("Snapshot bootstrap failed: state did not decode");
+        return;
+    }
+    
+    // Only the tail needs replaying. The snapshot epoch may have gained
+    // events after the snapshot was taken, so sync from that epoch and skip
+    // what the snapshot already covers.
+    if (manifest.event_count > 0) {
+        snapshot_tail_anchor_ = manifest.ledger_hash;
+    }
+    if (!begin_catch_up(manifest.epoch, std::numeric_limits<uint64_t>::max(), peers)) {
+        request_sync(peer_id, manifest.epoch, std::numeric_limits<uint64_t>::max());
+    }
+}
+
+void LedgerGossipBridge::snapshot_peer_failed(const NodeID& peer_id) {
+    snapshot_download_->peer_failed(peer_id);
+    for (auto it = snapshot_chunk_deadlines_.begin(); it != snapshot_chunk_deadlines_.end();) {
+        it = it->first.first == peer_id ? snapshot_chunk_deadlines_.erase(it) : std::next(it);
+    }
+    snapshot_peers_.erase(std::remove(snapshot_peers_.begin(), snapshot_peers_.end(), peer_id),
+                          snapshot_peers_.end());
+    for (const auto& other : snapshot_peers_) {
+        request_snapshot_chunks(other);
+    }
+    if (snapshot_peers_.empty()) {
+        CASHEW_LOG_WARN("Snapshot bootstrap failed: no peers left");
+        snapshot_download_.reset();
+        snapshot_chunk_deadlines_.clear();
+    }
+}
+
+void LedgerGossipBridge::expire_stalled_requests() {
+    const auto now = std::chrono::steady_clock::now();
+    
+    // A peer that leaves a snapshot chunk unanswered is dropped
+    while (snapshot_download_) {
+        auto stalled = std::find_if(snapshot_chunk_deadlines_.begin(), snapshot_chunk_deadlines_.end(),
+                                    [now](const auto& entry) { return entry.second <= now; });
+        if (stalled == snapshot_chunk_deadlines_.end()) {
+            break;
+        }
+        const NodeID peer_id = stalled->first.first;
+        CASHEW_LOG_WARN("Snapshot chunk {} timed out, failing over", stalled->first.second);
+        snapshot_peer_failed(peer_id);
+    }
+    
+    // A peer that leaves a catch-up page unanswered hands its ranges to the others
+    while (is_catching_up()) {
+        auto stalled = std::find_if(catch_up_.begin(), catch_up_.end(), [now](const CatchUpRange& range) {
+            return !range.complete && !range.parked && range.deadline <= now;
+        });
+        if (stalled == catch_up_.end()) {
             break;
+        }
+        CASHEW_LOG_WARN("Catch-up of epochs {} to {} timed out, failing over",
+                        stalled->start_epoch, stalled->end_epoch);
+        catch_up_peer_failed(stalled->peer_id);
     }
 }
 
+void LedgerGossipBridge::send_sync_message(const NodeID& peer_id, const LedgerSyncMessage& message) {
+    auto serialized = message.serialize();
+    
+    GossipMessage gossip_msg;
+    gossip_msg.type = GossipMessageType::NETWORK_STATE_UPDATE;
+    gossip_msg.message_id = crypto::Blake3::hash(serialized);
+    gossip_msg.payload = std::move(serialized);
+    gossip_msg.timestamp = current_timestamp();
+    gossip_msg.hop_count = 0;
+    
+    gossip_.send_direct_message(peer_id, gossip_msg);
+}
+
 void LedgerGossipBridge::sync_with_network() {
-    uint64_t current_epoch = ledger_.current_epoch();
+    // Compare tips, not the wall-clock epoch: peers advertise the epoch of
+    // their last event, which never runs ahead of the clock
+    const uint64_t tip = ledger_.tip_epoch();
     
-    // Find highest known epoch from peers
-    uint64_t max_peer_epoch = current_epoch;
+    // Find highest tip advertised by peers
+    uint64_t max_peer_epoch = tip;
     for (const auto& [peer_id, state] : peer_sync_states_) {
         if (state.last_synced_epoch > max_peer_epoch) {
             max_peer_epoch = state.last_synced_epoch;
@@ -283,32 +747,36 @@ void LedgerGossipBridge::sync_with_network() {
     }
     
     // Request missing epochs
-    if (max_peer_epoch > current_epoch) {
-        // Pick a random peer with higher epoch
+    if (max_peer_epoch > tip && !is_catching_up()) {
+        // Page disjoint ranges from every peer that is ahead
         std::vector<NodeID> candidates;
         for (const auto& [peer_id, state] : peer_sync_states_) {
-            if (state.last_synced_epoch > current_epoch) {
+            if (state.last_synced_epoch > tip) {
                 candidates.push_back(peer_id);
             }
         }
         
         if (!candidates.empty()) {
-            const uint32_t index = crypto::Random::uniform(static_cast<uint32_t>(candidates.size()));
-            request_sync(candidates[index], current_epoch + 1, max_peer_epoch);
+            // Shuffled so repeated catch-ups spread over the peers
+            for (size_t i = candidates.size(); i > 1; --i) {
+                std::swap(candidates[i - 1], candidates[crypto::Random::uniform(static_cast<uint32_t>(i))]);
+            }
+            // From our tip's own epoch, which may have gained events since
+            begin_catch_up(tip, max_peer_epoch, candidates);
         }
     }
 }
 
 void LedgerGossipBridge::validate_consistency() {
-    // Check for conflicts between our ledger and peer states
-    uint64_t current_epoch = ledger_.current_epoch();
+    // Check for conflicts between our ledger and peer states at the same tip
+    uint64_t tip = ledger_.tip_epoch();
     Hash256 our_hash = ledger_.get_latest_hash();
     
     for (const auto& [peer_id, state] : peer_sync_states_) {
-        if (state.last_synced_epoch == current_epoch && state.last_known_hash != our_hash) {
-            CASHEW_LOG_WARN("Ledger hash mismatch with peer at epoch {}", current_epoch);
-            if (current_epoch > 0) {
-                request_sync(peer_id, current_epoch, current_epoch);
+        if (state.last_synced_epoch == tip && state.last_known_hash != our_hash) {
+            CASHEW_LOG_WARN("Ledger hash mismatch with peer at epoch {}", tip);
+            if (tip > 0) {
+                request_sync(peer_id, tip, tip);
             }
         }
     }
@@ -335,12 +803,12 @@ bool LedgerGossipBridge::is_synced() const {
         return false;  // No peers to sync with
     }
     
-    uint64_t current_epoch = ledger_.current_epoch();
+    uint64_t tip = ledger_.tip_epoch();
     
     // Check if we're caught up with majority of peers
     size_t synced_count = 0;
     for (const auto& [peer_id, state] : peer_sync_states_) {
-        if (state.last_synced_epoch <= current_epoch + 1) {
+        if (state.last_synced_epoch <= tip + 1) {
             synced_count++;
         }
     }
@@ -354,10 +822,10 @@ uint64_t LedgerGossipBridge::get_sync_epoch() const {
 
 std::vector<NodeID> LedgerGossipBridge::get_synced_peers() const {
     std::vector<NodeID> result;
-    uint64_t current_epoch = ledger_.current_epoch();
+    uint64_t tip = ledger_.tip_epoch();
     
     for (const auto& [peer_id, state] : peer_sync_states_) {
-        if (state.last_synced_epoch >= current_epoch - 1) {
+        if (state.last_synced_epoch + 1 >= tip) {
             result.push_back(peer_id);
         }
     }
@@ -366,11 +834,19 @@ std::vector<NodeID> LedgerGossipBridge::get_synced_peers() const {
 }
 
 void LedgerGossipBridge::process_received_event(const ledger::LedgerEvent& event) {
-    // Check if already seen
-    if (seen_event_ids_.find(event.event_id) != seen_event_ids_.end()) {
+    // Check if already seen (catch-up resends the tip's epoch)
+    if (seen_event_ids_.find(event.event_id) != seen_event_ids_.end() || ledger_.contains_event(event.event_id)) {
         return;
     }
     
+    // After a snapshot bootstrap, events up to the snapshot tip are already in state
+    if (snapshot_tail_anchor_) {
+        if (event.previous_hash != *snapshot_tail_anchor_) {
+            return;
+        }
+        snapshot_tail_anchor_.reset();
+    }
+    
     // Validate event chain
     if (!validate_event_chain(event)) {
         CASHEW_LOG_WARN("Invalid event chain, rejecting event");
@@ -389,6 +865,31 @@ void LedgerGossipBridge::process_received_event(const ledger::LedgerEvent& event
     }
 }
 
+void LedgerGossipBridge::process_received_batch(const std::vector<ledger::LedgerEvent>& events) {
+    if (batch_verifier_) {
+        std::vector<ledger::LedgerEvent> unseen;
+        unseen.reserve(events.size());
+        for (const auto& event : events) {
+            if (seen_event_ids_.find(event.event_id) == seen_event_ids_.end()) {
+                unseen.push_back(event);
+            }
+        }
+        if (unseen.empty()) {
+            return;
+        }
+        if (!batch_verifier_(unseen)) {
+            batches_rejected_++;
+            CASHEW_LOG_WARN("Rejected ledger event batch ({} events) with invalid signatures", unseen.size());
+            return;
+        }
+    }
+    
+    // Events of a batch come in chain order
+    for (const auto& event : events) {
+        process_received_event(event);
+    }
+}
+
 bool LedgerGossipBridge::validate_event_chain(const ledger::LedgerEvent& event) const {
     const uint64_t now = current_timestamp();
     static constexpr uint64_t MAX_FUTURE_SKEW_SECONDS = 5 * 60;
@@ -448,6 +949,9 @@ void LedgerSyncScheduler::tick() {
         return;
     }
     
+    bridge_.flush_event_batch_if_due();
+    bridge_.expire_stalled_requests();
+    
     uint64_t current = current_timestamp();
     
     // Periodic sync
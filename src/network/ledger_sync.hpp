@@ -4,6 +4,8 @@
 #include "core/ledger/ledger.hpp"
 #include "core/ledger/state.hpp"
 #include "network/gossip.hpp"
+#include <chrono>
+#include <functional>
 #include <vector>
 #include <map>
 #include <set>
@@ -17,9 +19,11 @@ namespace cashew::network {
 struct LedgerSyncMessage {
     enum class Type {
         EVENT_BROADCAST,      // New event to propagate
-        SYNC_REQUEST,         // Request events from epoch range
-        SYNC_RESPONSE,        // Response with requested events
-        CHECKPOINT           // Periodic ledger checkpoint
+        SYNC_REQUEST,         // Request events from epoch range (payload: page size, cursor)
+        SYNC_RESPONSE,        // Page of requested events (payload: cursor if more remain)
+        CHECKPOINT,          // Periodic ledger checkpoint (end_epoch: tip, payload: snapshot manifest)
+        SNAPSHOT_REQUEST,    // Request snapshot chunk end_epoch of the snapshot at start_epoch
+        SNAPSHOT_CHUNK       // Requested chunk (payload)
     };
     
     Type type;
@@ -27,11 +31,31 @@ struct LedgerSyncMessage {
     uint64_t start_epoch;
     uint64_t end_epoch;
     Hash256 ledger_hash;      // For validation
+    std::vector<uint8_t> payload;
     
     std::vector<uint8_t> serialize() const;
     static std::optional<LedgerSyncMessage> deserialize(const std::vector<uint8_t>& data);
 };
 
+/**
+ * SyncCursor - Continuation token of a paged sync
+ * 
+ * Names the next event to send by its epoch and its offset among that
+ * epoch's events, so the responder resumes straight from its epoch index.
+ * The event ID guards against the responder's ledger having changed; any
+ * peer holding the same chain can resume from the cursor.
+ */
+struct SyncCursor {
+    uint64_t epoch = 0;
+    uint32_t offset = 0;
+    Hash256 next_event_id{};
+    
+    static constexpr size_t SIZE = 8 + 4 + 32;
+    
+    std::vector<uint8_t> to_bytes() const;
+    static std::optional<SyncCursor> from_bytes(const std::vector<uint8_t>& data, size_t offset = 0);
+};
+
 /**
  * SyncState - Track synchronization progress with peers
  */
@@ -55,7 +79,7 @@ struct SyncState {
  * - Maintain consistency across network
  * 
  * Design:
- * - Events gossipped immediately when created
+ * - Events gossipped when created, optionally coalesced into batches
  * - Periodic sync requests for missing epochs
  * - Checkpoint broadcast every N epochs
  * - Conflict detection and resolution
@@ -71,16 +95,99 @@ public:
     void broadcast_event(const ledger::LedgerEvent& event);
     void broadcast_checkpoint(uint64_t epoch);
     
-    // Synchronization
-    void request_sync(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch);
-    void handle_sync_request(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch);
-    void handle_sync_response(const NodeID& peer_id, const std::vector<ledger::LedgerEvent>& events);
+    // Event batching
+    
+    /**
+     * Hold broadcast events for up to `window` and send them as one
+     * EVENT_BROADCAST with a single dedup ID. A batch also goes out once it
+     * holds MAX_BATCH_EVENTS. Zero (the default) sends every event at once.
+     */
+    void set_event_batch_window(std::chrono::milliseconds window) { batch_window_ = window; }
+    void flush_event_batch();
+    bool flush_event_batch_if_due();  // Called from LedgerSyncScheduler::tick
+    size_t pending_batch_size() const { return pending_events_.size(); }
+    
+    /**
+     * Verifies the unseen events of a received batch in one call, before
+     * any of them is applied. A batch that fails is dropped whole.
+     */
+    using EventBatchVerifier = std::function<bool(const std::vector<ledger::LedgerEvent>&)>;
+    void set_event_batch_verifier(EventBatchVerifier verifier) { batch_verifier_ = std::move(verifier); }
+    
+    static constexpr size_t MAX_BATCH_EVENTS = 256;
+    
+    // State snapshots (taken with each checkpoint)
+    
+    /**
+     * Sign the snapshots this node takes, and co-sign matching snapshots
+     * announced by peers
+     */
+    void set_snapshot_signer(const NodeID& node_id, const PublicKey& public_key, const SecretKey& secret_key);
+    void set_snapshot_chunk_size(size_t chunk_size) { snapshot_chunk_size_ = chunk_size; }
+    const std::optional<ledger::StateSnapshotData>& latest_snapshot() const { return latest_snapshot_; }
+    std::optional<ledger::StateSnapshotManifest> latest_peer_manifest() const { return latest_peer_manifest_; }
+    
+    /**
+     * Bootstrap state from a snapshot instead of replaying the whole ledger.
+     * Chunks are requested from all peers in parallel; a peer that leaves a
+     * chunk unanswered past the chunk timeout is dropped like one sending bad
+     * data. Once assembled and restored, the ledger is anchored at the
+     * snapshot and synced from the snapshot's epoch on, skipping the events
+     * the snapshot already covers.
+     * @return false if the manifest lacks a quorum of trusted signatures
+     */
+    bool begin_snapshot_bootstrap(const ledger::StateSnapshotManifest& manifest,
+                                  const std::vector<NodeID>& peers,
+                                  const std::map<NodeID, PublicKey>& trusted_signers,
+                                  size_t quorum);
+    bool is_bootstrapping() const { return snapshot_download_.has_value(); }
+    void set_snapshot_chunk_timeout(std::chrono::milliseconds timeout) { snapshot_chunk_timeout_ = timeout; }
+    void handle_snapshot_request(const NodeID& peer_id, uint64_t epoch, uint32_t chunk_index);
+    void handle_snapshot_chunk(const NodeID& peer_id, uint64_t epoch, uint32_t chunk_index,
+                               std::vector<uint8_t> chunk);
+    
+    // Synchronization (paged: each response carries a cursor until the range is done)
+    void request_sync(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch,
+                      const std::optional<SyncCursor>& cursor = std::nullopt);
+    void handle_sync_request(const NodeID& peer_id, uint64_t start_epoch, uint64_t end_epoch,
+                             const std::vector<uint8_t>& paging = {});
+    void handle_sync_response(const NodeID& peer_id, const LedgerSyncMessage& message);
+    void set_sync_page_bytes(size_t page_bytes) { sync_page_bytes_ = page_bytes; }
+    
+    /**
+     * Catch up on [start_epoch, end_epoch] from several peers at once. The
+     * range is split into disjoint epoch ranges, one per peer, each paged in
+     * parallel; events are applied in epoch order as soon as everything
+     * before them has arrived. The split covers epochs up to the highest tip
+     * the peers have advertised; the last range is open-ended beyond that.
+     *
+     * A range whose page is not answered within the catch-up timeout moves
+     * to another peer. Ranges ahead of the first unfinished one stop paging
+     * once the catch-up buffer limit of out-of-order events is reached, and
+     * resume as earlier ranges drain.
+     */
+    bool begin_catch_up(uint64_t start_epoch, uint64_t end_epoch, const std::vector<NodeID>& peers);
+    bool is_catching_up() const { return !catch_up_.empty(); }
+    void catch_up_peer_failed(const NodeID& peer_id);  // Its unfinished ranges resume on other peers
+    void set_catch_up_timeout(std::chrono::milliseconds timeout) { catch_up_timeout_ = timeout; }
+    void set_catch_up_buffer_limit(size_t events) { catch_up_buffer_limit_ = events; }
+    size_t catch_up_buffered_events() const;
+    
+    static constexpr size_t SYNC_PAGE_BYTES = 256 * 1024;
+    static constexpr size_t CATCH_UP_BUFFER_EVENTS = 16 * 1024;
+    static constexpr std::chrono::milliseconds SNAPSHOT_CHUNK_TIMEOUT{10000};
+    static constexpr std::chrono::milliseconds CATCH_UP_TIMEOUT{10000};
+    
+    /**
+     * Fail over requests whose deadline has passed (called from LedgerSyncScheduler::tick)
+     */
+    void expire_stalled_requests();
     
     // Message handling
     void handle_gossip_message(const NodeID& source, const GossipMessage& message);
     
     // Periodic maintenance
-    void sync_with_network();      // Request missing events
+    void sync_with_network();      // Catch up to the highest tip peers advertised
     void validate_consistency();   // Check for conflicts
     void cleanup_sync_state();
     
@@ -93,6 +200,8 @@ public:
     uint64_t get_events_received() const { return events_received_; }
     uint64_t get_events_sent() const { return events_sent_; }
     uint64_t get_sync_requests() const { return sync_requests_; }
+    uint64_t get_batches_sent() const { return batches_sent_; }
+    uint64_t get_batches_rejected() const { return batches_rejected_; }
     
 private:
     ledger::Ledger& ledger_;
@@ -103,15 +212,65 @@ private:
     std::map<NodeID, SyncState> peer_sync_states_;
     std::set<Hash256> seen_event_ids_;  // Deduplication
     
+    // Outgoing event batch
+    std::vector<ledger::LedgerEvent> pending_events_;
+    std::chrono::steady_clock::time_point batch_started_;
+    std::chrono::milliseconds batch_window_{0};
+    EventBatchVerifier batch_verifier_;
+    
+    // Snapshots
+    struct SnapshotSigner {
+        NodeID node_id;
+        PublicKey public_key;
+        SecretKey secret_key;
+    };
+    std::optional<SnapshotSigner> snapshot_signer_;
+    size_t snapshot_chunk_size_ = ledger::StateManager::SNAPSHOT_CHUNK_SIZE;
+    std::optional<ledger::StateSnapshotData> latest_snapshot_;
+    std::optional<ledger::StateSnapshotManifest> latest_peer_manifest_;
+    std::optional<ledger::SnapshotAssembler> snapshot_download_;
+    std::vector<NodeID> snapshot_peers_;
+    std::map<std::pair<NodeID, uint32_t>, std::chrono::steady_clock::time_point> snapshot_chunk_deadlines_;
+    std::chrono::milliseconds snapshot_chunk_timeout_ = SNAPSHOT_CHUNK_TIMEOUT;
+    std::optional<Hash256> snapshot_tail_anchor_;  // Tail events up to this tip are in the snapshot
+    
+    // Paged catch-up
+    struct CatchUpRange {
+        NodeID peer_id;
+        uint64_t start_epoch;
+        uint64_t end_epoch;
+        std::optional<SyncCursor> cursor;           // Next page, once one has arrived
+        std::vector<ledger::LedgerEvent> buffered;  // Held until earlier ranges are applied
+        std::chrono::steady_clock::time_point deadline;  // For the outstanding page
+        bool parked = false;                        // Paging held back by the buffer limit
+        bool complete = false;
+    };
+    std::vector<CatchUpRange> catch_up_;  // In epoch order
+    size_t catch_up_head_ = 0;            // First range not yet fully applied
+    std::vector<NodeID> catch_up_peers_;
+    size_t sync_page_bytes_ = SYNC_PAGE_BYTES;
+    std::chrono::milliseconds catch_up_timeout_ = CATCH_UP_TIMEOUT;
+    size_t catch_up_buffer_limit_ = CATCH_UP_BUFFER_EVENTS;
+    
     // Statistics
     uint64_t events_received_;
     uint64_t events_sent_;
     uint64_t sync_requests_;
+    uint64_t batches_sent_ = 0;
+    uint64_t batches_rejected_ = 0;
     
     // Helpers
     void process_received_event(const ledger::LedgerEvent& event);
+    void process_received_batch(const std::vector<ledger::LedgerEvent>& events);
     bool validate_event_chain(const ledger::LedgerEvent& event) const;
     void update_peer_sync_state(const NodeID& peer_id, uint64_t epoch, const Hash256& hash);
+    void handle_checkpoint(const NodeID& peer_id, const LedgerSyncMessage& message);
+    void request_snapshot_chunks(const NodeID& peer_id);
+    void snapshot_peer_failed(const NodeID& peer_id);
+    void send_sync_message(const NodeID& peer_id, const LedgerSyncMessage& message);
+    void request_range(CatchUpRange& range);
+    void apply_catch_up();
+    uint64_t advertised_tip(const std::vector<NodeID>& peers) const;
     
     uint64_t current_timestamp() const;
 };
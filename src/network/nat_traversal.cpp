@@ -1,7 +1,11 @@
 #include "network/nat_traversal.hpp"
+#include "utils/maintenance_scheduler.hpp"
+#include "runtime/executor.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 #include <random>
 #include <cstring>
+#include <thread>
 
 #ifdef CASHEW_PLATFORM_WINDOWS
 #include <winsock2.h>
@@ -13,6 +17,8 @@
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <cerrno>
 #endif
 
 namespace cashew::network {
@@ -58,6 +64,50 @@ static uint32_t read_uint32(const uint8_t* data) {
            static_cast<uint32_t>(data[3]);
 }
 
+static void close_socket(int sock) {
+#ifdef CASHEW_PLATFORM_WINDOWS
+    closesocket(sock);
+#else
+    close(sock);
+#endif
+}
+
+static bool set_non_blocking(int sock) {
+#ifdef CASHEW_PLATFORM_WINDOWS
+    u_long mode = 1;
+    return ioctlsocket(sock, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(sock, F_GETFL, 0);
+    return flags >= 0 && fcntl(sock, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+static std::string ipv4_to_string(const struct sockaddr_in& addr) {
+    char ip_str[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &addr.sin_addr, ip_str, INET_ADDRSTRLEN);
+    return std::string(ip_str);
+}
+
+// Source IP the kernel would pick to reach dest; connecting a UDP socket
+// only does a route lookup, nothing is sent
+static std::optional<std::string> local_ip_towards(const struct sockaddr_storage& dest,
+                                                   socklen_t dest_len) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        return std::nullopt;
+    }
+    
+    std::optional<std::string> ip;
+    struct sockaddr_in local{};
+    socklen_t local_len = sizeof(local);
+    if (connect(sock, reinterpret_cast<const struct sockaddr*>(&dest), dest_len) == 0 &&
+        getsockname(sock, reinterpret_cast<struct sockaddr*>(&local), &local_len) == 0) {
+        ip = ipv4_to_string(local);
+    }
+    close_socket(sock);
+    return ip;
+}
+
 // PublicAddress methods
 std::string PublicAddress::to_string() const {
     return ip + ":" + std::to_string(port);
@@ -192,19 +242,32 @@ std::optional<SocketAddress> STUNMessage::get_mapped_address() const {
 
 // NATTraversal methods
 NATTraversal::NATTraversal() 
-    : timeout_(std::chrono::milliseconds(3000)) {
+    : timeout_(std::chrono::milliseconds(3000)),
+      initial_rto_(std::chrono::milliseconds(500)),
+      resolver_(std::make_shared<Resolver>()) {
     // Initialize with default STUN servers
     stun_servers_ = DEFAULT_STUN_SERVERS;
 }
 
+NATTraversal::~NATTraversal() {
+    stop_background_refresh();
+}
+
 void NATTraversal::add_stun_server(const STUNServer& server) {
+    std::lock_guard<std::mutex> lock(mutex_);
     stun_servers_.push_back(server);
 }
 
 void NATTraversal::clear_stun_servers() {
+    std::lock_guard<std::mutex> lock(mutex_);
     stun_servers_.clear();
 }
 
+std::vector<STUNServer> NATTraversal::get_stun_servers() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stun_servers_;
+}
+
 bool NATTraversal::is_cache_valid() const {
     if (!cached_address_.has_value()) {
         return false;
@@ -219,6 +282,7 @@ bool NATTraversal::is_cache_valid() const {
 }
 
 std::optional<PublicAddress> NATTraversal::get_cached_address() const {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (is_cache_valid()) {
         return cached_address_;
     }
@@ -226,9 +290,16 @@ std::optional<PublicAddress> NATTraversal::get_cached_address() const {
 }
 
 void NATTraversal::clear_cache() {
+    std::lock_guard<std::mutex> lock(mutex_);
     cached_address_.reset();
 }
 
+void NATTraversal::store_cache(const PublicAddress& address) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cached_address_ = address;
+    cache_time_ = std::chrono::steady_clock::now();
+}
+
 STUNMessage NATTraversal::create_binding_request() {
     STUNMessage msg;
     msg.message_type = STUNMessage::BINDING_REQUEST;
@@ -239,160 +310,377 @@ STUNMessage NATTraversal::create_binding_request() {
     return msg;
 }
 
-std::optional<PublicAddress> NATTraversal::query_stun_server(const STUNServer& server) {
-    spdlog::debug("Querying STUN server: {}:{}", server.host, server.port);
+NATTraversal::ProbeResult NATTraversal::probe_stun_servers(bool first_answer_wins) {
+    using Clock = std::chrono::steady_clock;
+    
+    ProbeResult probe;
+    std::vector<STUNServer> servers;
+    std::chrono::milliseconds timeout;
+    std::chrono::milliseconds initial_rto;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        servers = stun_servers_;
+        timeout = timeout_;
+        initial_rto = initial_rto_;
+    }
+    if (servers.empty()) {
+        return probe;
+    }
     
-    // Create UDP socket
     int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock < 0) {
         spdlog::error("Failed to create UDP socket for STUN query");
-        return std::nullopt;
+        return probe;
     }
-    
-    // Set socket timeout
-#ifdef CASHEW_PLATFORM_WINDOWS
-    DWORD timeout_ms = static_cast<DWORD>(timeout_.count());
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_ms, sizeof(timeout_ms));
-#else
-    struct timeval tv;
-    tv.tv_sec = timeout_.count() / 1000;
-    tv.tv_usec = (timeout_.count() % 1000) * 1000;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-#endif
-    
-    // Resolve STUN server address
-    struct addrinfo hints{}, *result = nullptr;
-    hints.ai_family = AF_INET;
-    hints.ai_socktype = SOCK_DGRAM;
-    
-    int err = getaddrinfo(server.host.c_str(), std::to_string(server.port).c_str(), &hints, &result);
-    if (err != 0 || !result) {
-        spdlog::error("Failed to resolve STUN server: {}", server.host);
-#ifdef CASHEW_PLATFORM_WINDOWS
-        closesocket(sock);
-#else
-        close(sock);
-#endif
-        return std::nullopt;
+    if (!set_non_blocking(sock)) {
+        spdlog::error("Failed to make STUN socket non-blocking");
+        close_socket(sock);
+        return probe;
     }
     
-    // Create and send STUN binding request
-    STUNMessage request = create_binding_request();
-    std::vector<uint8_t> request_data = request.to_bytes();
-    
-    ssize_t sent = sendto(sock, reinterpret_cast<const char*>(request_data.data()), 
-                          request_data.size(), 0, result->ai_addr, result->ai_addrlen);
-    
-    if (sent < 0) {
-        spdlog::error("Failed to send STUN binding request");
-        freeaddrinfo(result);
-#ifdef CASHEW_PLATFORM_WINDOWS
-        closesocket(sock);
-#else
-        close(sock);
-#endif
-        return std::nullopt;
+    // Lookups run on their own threads so a slow resolver holds up only its
+    // own server; each request goes out as soon as its address is known.
+    // A lookup that outlives the probe finishes into state nobody reads, and
+    // until it does its server is skipped, so there is never more than one
+    // lookup per server however often probes time out.
+    struct Lookups {
+        struct Resolved {
+            size_t server_index;
+            bool ok;
+            struct sockaddr_storage addr;
+            socklen_t addr_len;
+        };
+        std::mutex mutex;
+        std::vector<Resolved> done;
+    };
+    auto lookups = std::make_shared<Lookups>();
+    size_t pending_lookups = 0;
+    for (size_t i = 0; i < servers.size(); ++i) {
+        std::string key = servers[i].host + ":" + std::to_string(servers[i].port);
+        {
+            std::lock_guard<std::mutex> lock(resolver_->mutex);
+            auto& pending = resolver_->pending;
+            if (std::find(pending.begin(), pending.end(), key) != pending.end()) {
+                spdlog::debug("Still resolving STUN server {}, skipping it", servers[i].host);
+                continue;
+            }
+            pending.push_back(key);
+        }
+        ++pending_lookups;
+        std::thread([lookups, resolver = resolver_, key = std::move(key), i,
+                     host = servers[i].host, port = std::to_string(servers[i].port)]() {
+            struct addrinfo hints{}, *result = nullptr;
+            hints.ai_family = AF_INET;
+            hints.ai_socktype = SOCK_DGRAM;
+            
+            Lookups::Resolved resolved{i, false, {}, 0};
+            if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) == 0 && result) {
+                resolved.ok = true;
+                std::memcpy(&resolved.addr, result->ai_addr, result->ai_addrlen);
+                resolved.addr_len = static_cast<socklen_t>(result->ai_addrlen);
+            }
+            if (result) {
+                freeaddrinfo(result);
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(resolver->mutex);
+                auto& pending = resolver->pending;
+                pending.erase(std::find(pending.begin(), pending.end(), key));
+            }
+            std::lock_guard<std::mutex> lock(lookups->mutex);
+            lookups->done.push_back(resolved);
+        }).detach();
     }
     
-    // Receive response
-    std::vector<uint8_t> response_data(1024);
-    struct sockaddr_storage from_addr{};
-    socklen_t from_len = sizeof(from_addr);
-    
-    ssize_t received = recvfrom(sock, reinterpret_cast<char*>(response_data.data()),
-                                response_data.size(), 0,
-                                reinterpret_cast<struct sockaddr*>(&from_addr), &from_len);
-    
-    freeaddrinfo(result);
+    // One outstanding binding request per resolved server
+    struct Transaction {
+        size_t server_index;
+        struct sockaddr_storage addr;
+        socklen_t addr_len;
+        STUNMessage request;
+        std::vector<uint8_t> request_data;
+        size_t transmissions = 0;
+        std::chrono::milliseconds rto;
+        Clock::time_point next_send;
+        bool answered = false;
+    };
+    
+    std::vector<Transaction> transactions;
+    transactions.reserve(servers.size());
+    
+    const auto start = Clock::now();
+    const auto deadline = start + timeout;
+    
+    std::vector<uint8_t> buffer(1024);
+    size_t outstanding = 0;
+    
+    while (outstanding > 0 || pending_lookups > 0) {
+        auto now = Clock::now();
+        if (now >= deadline) {
+            break;
+        }
+        
+        // Start a transaction for every server resolved since the last pass
+        std::vector<Lookups::Resolved> resolved;
+        {
+            std::lock_guard<std::mutex> lock(lookups->mutex);
+            resolved.swap(lookups->done);
+        }
+        for (const auto& entry : resolved) {
+            --pending_lookups;
+            if (!entry.ok) {
+                spdlog::warn("Failed to resolve STUN server: {}", servers[entry.server_index].host);
+                continue;
+            }
+            
+            Transaction tx;
+            tx.server_index = entry.server_index;
+            tx.addr = entry.addr;
+            tx.addr_len = entry.addr_len;
+            tx.request = create_binding_request();
+            tx.request_data = tx.request.to_bytes();
+            tx.rto = initial_rto;
+            tx.next_send = now;
+            transactions.push_back(std::move(tx));
+            ++outstanding;
+            ++probe.servers_queried;
+        }
+        
+        // (Re)transmit whatever is due; RTO doubles after every send
+        auto wake_at = deadline;
+        for (auto& tx : transactions) {
+            if (tx.answered || tx.transmissions >= MAX_TRANSMISSIONS) {
+                continue;
+            }
+            if (now >= tx.next_send) {
+                sendto(sock, reinterpret_cast<const char*>(tx.request_data.data()),
+                       tx.request_data.size(), 0,
+                       reinterpret_cast<const struct sockaddr*>(&tx.addr), tx.addr_len);
+                ++tx.transmissions;
+                tx.next_send = now + tx.rto;
+                tx.rto *= 2;
+            }
+            if (tx.transmissions < MAX_TRANSMISSIONS) {
+                wake_at = std::min(wake_at, tx.next_send);
+            }
+        }
+        
+        if (pending_lookups > 0) {
+            wake_at = std::min(wake_at, now + LOOKUP_POLL_INTERVAL);
+        }
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(wake_at - now).count() + 1;
+        
 #ifdef CASHEW_PLATFORM_WINDOWS
-    closesocket(sock);
+        WSAPOLLFD pfd{};
+        pfd.fd = sock;
+        pfd.events = POLLRDNORM;
+        int ready = WSAPoll(&pfd, 1, static_cast<int>(wait));
 #else
-    close(sock);
+        struct pollfd pfd{};
+        pfd.fd = sock;
+        pfd.events = POLLIN;
+        int ready = poll(&pfd, 1, static_cast<int>(wait));
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
 #endif
+        if (ready < 0) {
+            spdlog::error("Polling STUN socket failed");
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        
+        // Drain every datagram that has arrived
+        while (outstanding > 0) {
+            struct sockaddr_storage from_addr{};
+            socklen_t from_len = sizeof(from_addr);
+            
+            auto received = recvfrom(sock, reinterpret_cast<char*>(buffer.data()),
+                                     buffer.size(), 0,
+                                     reinterpret_cast<struct sockaddr*>(&from_addr), &from_len);
+            if (received < 0) {
+                break;
+            }
+            
+            auto response = STUNMessage::from_bytes(
+                std::vector<uint8_t>(buffer.begin(), buffer.begin() + received));
+            if (!response.has_value() ||
+                response->message_type != STUNMessage::BINDING_RESPONSE) {
+                continue;
+            }
+            
+            auto it = std::find_if(transactions.begin(), transactions.end(),
+                [&](const Transaction& tx) {
+                    return !tx.answered && tx.request.transaction_id == response->transaction_id;
+                });
+            if (it == transactions.end()) {
+                continue;  // Stale retransmission answer or unrelated datagram
+            }
+            
+            auto mapped = response->get_mapped_address();
+            if (!mapped.has_value()) {
+                spdlog::warn("STUN response from {} missing mapped address",
+                             servers[it->server_index].host);
+                continue;
+            }
+            
+            it->answered = true;
+            --outstanding;
+            probe.answers.push_back({it->server_index, *mapped});
+            
+            if (first_answer_wins) {
+                outstanding = 0;
+                pending_lookups = 0;
+            }
+        }
+    }
     
-    if (received < 0) {
-        spdlog::error("Failed to receive STUN response (timeout or error)");
-        return std::nullopt;
+    // Our own address on the probe socket, for comparing against the mappings
+    if (!probe.answers.empty() && !first_answer_wins) {
+        struct sockaddr_in local{};
+        socklen_t local_len = sizeof(local);
+        if (getsockname(sock, reinterpret_cast<struct sockaddr*>(&local), &local_len) == 0) {
+            const auto& answered = *std::find_if(transactions.begin(), transactions.end(),
+                [&](const Transaction& tx) {
+                    return tx.server_index == probe.answers.front().server_index;
+                });
+            auto ip = local_ip_towards(answered.addr, answered.addr_len);
+            if (ip.has_value()) {
+                probe.local = SocketAddress(*ip, ntohs(local.sin_port));
+            }
+        }
     }
     
-    response_data.resize(received);
+    close_socket(sock);
     
-    // Parse STUN response
-    auto response_msg = STUNMessage::from_bytes(response_data);
-    if (!response_msg.has_value()) {
-        spdlog::error("Failed to parse STUN response");
-        return std::nullopt;
+    spdlog::debug("STUN probe: {}/{} servers answered in {} ms",
+                  probe.answers.size(), probe.servers_queried,
+                  std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+    return probe;
+}
+
+NATType NATTraversal::classify(const ProbeResult& probe) {
+    size_t quorum = std::min(NAT_TYPE_QUORUM, probe.servers_queried);
+    if (probe.answers.empty() || probe.answers.size() < quorum) {
+        return NATType::UNKNOWN;
     }
     
-    // Verify transaction ID matches
-    if (response_msg->transaction_id != request.transaction_id) {
-        spdlog::error("STUN response transaction ID mismatch");
-        return std::nullopt;
+    // A mapping that changes with the destination is symmetric NAT
+    const auto& first = probe.answers.front().mapped;
+    for (const auto& answer : probe.answers) {
+        if (answer.mapped.host != first.host || answer.mapped.port != first.port) {
+            return NATType::SYMMETRIC;
+        }
     }
     
-    // Check message type
-    if (response_msg->message_type != STUNMessage::BINDING_RESPONSE) {
-        spdlog::error("STUN response is not a binding response");
-        return std::nullopt;
-    }
-    
-    // Extract mapped address
-    auto mapped_addr = response_msg->get_mapped_address();
-    if (!mapped_addr.has_value()) {
-        spdlog::error("STUN response missing mapped address");
-        return std::nullopt;
+    if (probe.local.has_value() &&
+        probe.local->host == first.host && probe.local->port == first.port) {
+        return NATType::OPEN_INTERNET;
     }
     
+    // Filtering behaviour (full cone vs restricted) needs CHANGE-REQUEST
+    // support from the servers (RFC 5780); stay with the conservative default
+    return NATType::FULL_CONE;
+}
+
+static PublicAddress make_public_address(const SocketAddress& mapped, NATType nat_type) {
     PublicAddress public_addr;
-    public_addr.ip = mapped_addr->host;
-    public_addr.port = mapped_addr->port;
-    public_addr.nat_type = NATType::UNKNOWN;  // Will be determined by detect_nat_type
+    public_addr.ip = mapped.host;
+    public_addr.port = mapped.port;
+    public_addr.nat_type = nat_type;
     public_addr.discovered_at = std::chrono::system_clock::now().time_since_epoch().count();
-    
-    spdlog::info("Discovered public address via STUN: {}", public_addr.to_string());
-    
     return public_addr;
 }
 
 std::optional<PublicAddress> NATTraversal::discover_public_address() {
     // Check cache first
-    if (is_cache_valid()) {
+    if (auto cached = get_cached_address()) {
         spdlog::debug("Using cached public address");
-        return cached_address_;
+        return cached;
     }
     
-    // Try each STUN server until one succeeds
-    for (const auto& server : stun_servers_) {
-        auto result = query_stun_server(server);
-        if (result.has_value()) {
-            cached_address_ = result;
-            cache_time_ = std::chrono::steady_clock::now();
-            return result;
-        }
+    auto probe = probe_stun_servers(true);
+    if (probe.answers.empty()) {
+        spdlog::error("Failed to discover public address from any STUN server");
+        return std::nullopt;
     }
     
-    spdlog::error("Failed to discover public address from any STUN server");
-    return std::nullopt;
+    // NAT type is determined by detect_nat_type
+    auto public_addr = make_public_address(probe.answers.front().mapped, NATType::UNKNOWN);
+    spdlog::info("Discovered public address via STUN: {}", public_addr.to_string());
+    store_cache(public_addr);
+    return public_addr;
+}
+
+std::optional<PublicAddress> NATTraversal::refresh_cache() {
+    auto probe = probe_stun_servers(false);
+    if (probe.answers.empty()) {
+        return std::nullopt;
+    }
+    
+    auto public_addr = make_public_address(probe.answers.front().mapped, classify(probe));
+    store_cache(public_addr);
+    return public_addr;
 }
 
 NATType NATTraversal::detect_nat_type() {
-    // Simplified NAT type detection
-    // Full RFC 5780 implementation would require multiple STUN queries
-    // with different source/destination combinations
+    // One probe round yields both the address and the classification
+    if (auto cached = get_cached_address()) {
+        if (cached->nat_type != NATType::UNKNOWN) {
+            return cached->nat_type;
+        }
+    }
     
-    auto public_addr = discover_public_address();
+    auto public_addr = refresh_cache();
     if (!public_addr.has_value()) {
         return NATType::UNKNOWN;
     }
+    return public_addr->nat_type;
+}
+
+bool NATTraversal::start_background_refresh() {
+    if (!maintenance_ || !executor_ || refresh_task_ != 0) {
+        return false;
+    }
     
-    // Use a conservative default classification when public mapping is discoverable.
-    // A complete implementation would:
-    // 1. Test if we can receive from different IP (FULL_CONE vs RESTRICTED_CONE)
-    // 2. Test if we can receive from different port (RESTRICTED_CONE vs PORT_RESTRICTED)
-    // 3. Test if port changes per destination (SYMMETRIC)
+    // Runs once immediately to warm the cache, then ahead of every expiry.
+    // The scheduler only hands the probe to the executor; a tick that finds
+    // the previous probe still running does nothing.
+    refresh_task_ = maintenance_->schedule_periodic(
+        "nat.stun_refresh", std::chrono::seconds(REFRESH_INTERVAL_SECONDS),
+        [this]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (refresh_running_ || !executor_->is_running()) {
+                    return;
+                }
+                refresh_running_ = true;
+            }
+            executor_->submit([this]() {
+                if (!refresh_cache().has_value()) {
+                    spdlog::warn("Background STUN refresh got no answers");
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                refresh_running_ = false;
+                refresh_done_.notify_all();
+            }, runtime::Priority::BULK);
+        },
+        0.1, std::chrono::milliseconds(0));
+    return refresh_task_ != 0;
+}
+
+void NATTraversal::stop_background_refresh() {
+    if (maintenance_ && refresh_task_ != 0) {
+        maintenance_->cancel(refresh_task_);
+    }
+    refresh_task_ = 0;
     
-    spdlog::info("NAT type detection: assuming FULL_CONE (simplified implementation)");
-    return NATType::FULL_CONE;
+    // A probe already handed to the executor still refers to this object
+    std::unique_lock<std::mutex> lock(mutex_);
+    refresh_done_.wait(lock, [this]() { return !refresh_running_; });
 }
 
 } // namespace cashew::network
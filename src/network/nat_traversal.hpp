@@ -4,8 +4,13 @@
 #include "network/connection.hpp"
 #include <string>
 #include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <optional>
 
+namespace cashew::utils { class MaintenanceScheduler; }
+namespace cashew::runtime { class Executor; }
+
 namespace cashew::network {
 
 /**
@@ -85,39 +90,94 @@ struct STUNMessage {
 
 /**
  * NATTraversal - STUN-like NAT traversal implementation
+ *
+ * Every configured server is probed at once from a single non-blocking
+ * socket; responses are matched back to their server by transaction ID.
  */
 class NATTraversal {
 public:
     NATTraversal();
-    ~NATTraversal() = default;
+    ~NATTraversal();
     
     // Configuration
     void add_stun_server(const STUNServer& server);
     void clear_stun_servers();
-    std::vector<STUNServer> get_stun_servers() const { return stun_servers_; }
+    std::vector<STUNServer> get_stun_servers() const;
     
     // NAT detection
+    // First server to answer wins
     std::optional<PublicAddress> discover_public_address();
+    // Waits for every server; needs NAT_TYPE_QUORUM answers to classify
     NATType detect_nat_type();
     
     // Cache management
     std::optional<PublicAddress> get_cached_address() const;
     void clear_cache();
     
+    // Background refresh: the scheduler triggers a re-probe before the cache
+    // expires and the probe itself runs as a BULK job on the executor, so
+    // neither thread is held for a whole probe timeout. Needs both set.
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+        maintenance_ = std::move(scheduler);
+    }
+    void set_executor(std::shared_ptr<runtime::Executor> executor) { executor_ = std::move(executor); }
+    bool start_background_refresh();
+    void stop_background_refresh();
+    
     // Timeout configuration
+    // timeout bounds a whole probe; initial_rto is the first retransmission
+    // timeout, doubled on each retransmission (RFC 5389 section 7.2.1)
     void set_timeout(std::chrono::milliseconds timeout) { timeout_ = timeout; }
     std::chrono::milliseconds get_timeout() const { return timeout_; }
+    void set_initial_rto(std::chrono::milliseconds rto) { initial_rto_ = rto; }
+    std::chrono::milliseconds get_initial_rto() const { return initial_rto_; }
+    
+    static constexpr size_t MAX_TRANSMISSIONS = 7;  // Rc in RFC 5389
+    static constexpr size_t NAT_TYPE_QUORUM = 2;
     
 private:
+    struct STUNAnswer {
+        size_t server_index;
+        SocketAddress mapped;
+    };
+    
+    // Host lookups still running, shared with the resolver threads; a
+    // server whose lookup has not finished is skipped by later probes
+    struct Resolver {
+        std::mutex mutex;
+        std::vector<std::string> pending;  // "host:port"
+    };
+    
+    struct ProbeResult {
+        std::vector<STUNAnswer> answers;
+        std::optional<SocketAddress> local;  // Our side of the probe socket
+        size_t servers_queried = 0;
+    };
+    
+    mutable std::mutex mutex_;
     std::vector<STUNServer> stun_servers_;
     std::optional<PublicAddress> cached_address_;
     std::chrono::milliseconds timeout_;
+    std::chrono::milliseconds initial_rto_;
     std::chrono::steady_clock::time_point cache_time_;
     
+    std::shared_ptr<Resolver> resolver_;
+    
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    std::shared_ptr<runtime::Executor> executor_;
+    uint64_t refresh_task_ = 0;
+    bool refresh_running_ = false;  // Guarded by mutex_
+    std::condition_variable refresh_done_;
+    
     static constexpr uint64_t CACHE_VALIDITY_SECONDS = 300;  // 5 minutes
+    static constexpr uint64_t REFRESH_INTERVAL_SECONDS = 240;
+    static constexpr std::chrono::milliseconds LOOKUP_POLL_INTERVAL{5};  // While servers are resolving
     
     bool is_cache_valid() const;
-    std::optional<PublicAddress> query_stun_server(const STUNServer& server);
+    ProbeResult probe_stun_servers(bool first_answer_wins);
+    std::optional<PublicAddress> refresh_cache();
+    static NATType classify(const ProbeResult& probe);
+    void store_cache(const PublicAddress& address);
     STUNMessage create_binding_request();
 };
 
@@ -1,4 +1,6 @@
 #include "network.hpp"
+#include "network/peer_metrics.hpp"
+#include "storage/kv_store.hpp"
 #include "utils/logger.hpp"
 #include "crypto/blake3.hpp"
 #include "crypto/random.hpp"
@@ -7,6 +9,7 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <set>
 
 namespace {
 
@@ -35,8 +38,10 @@ bool read_fixed(const std::vector<uint8_t>& data, size_t& offset, uint8_t* dest,
     return true;
 }
 
-std::string network_file_name(const cashew::network::NetworkID& id) {
-    return cashew::crypto::Blake3::hash_to_hex(id.id) + ".bin";
+constexpr const char* NETWORK_KEY_PREFIX = "network/";
+
+std::string network_key(const cashew::network::NetworkID& id) {
+    return NETWORK_KEY_PREFIX + cashew::crypto::Blake3::hash_to_hex(id.id);
 }
 
 } // namespace
@@ -338,23 +343,27 @@ std::vector<NodeID> Network::get_replication_candidates() const {
     return candidates;
 }
 
-NodeID Network::select_best_source_for_replication() const {
-    auto candidates = get_replication_candidates();
-    
-    if (candidates.empty()) {
-        return NodeID{};
-    }
-    
-    // Find member with highest reliability score
+NodeID Network::select_best_source_for_replication(const PeerMetrics* metrics) const {
+    // Same eligibility as get_replication_candidates, scored in one pass
     const NetworkMember* best = nullptr;
+    float best_score = -1.0f;
+    
     for (const auto& member : members_) {
-        for (const auto& candidate_id : candidates) {
-            if (member.node_id == candidate_id) {
-                if (!best || member.reliability_score > best->reliability_score) {
-                    best = &member;
-                }
-                break;
-            }
+        if (!is_member_active(member) ||
+            !member.has_complete_replica ||
+            member.reliability_score < MIN_RELIABILITY_SCORE) {
+            continue;
+        }
+        
+        // Highest reliability, scaled by measured RTT/throughput
+        float score = member.reliability_score;
+        if (metrics) {
+            score *= metrics->speed_factor(member.node_id);
+        }
+        
+        if (score > best_score) {
+            best_score = score;
+            best = &member;
         }
     }
     
@@ -629,34 +638,59 @@ size_t NetworkRegistry::total_network_count() const {
     return networks_.size();
 }
 
-bool NetworkRegistry::save_to_disk(const std::string& directory) {
-    std::error_code ec;
-    std::filesystem::create_directories(directory, ec);
-    if (ec) {
-        CASHEW_LOG_ERROR("Failed to create network directory {}: {}", directory, ec.message());
-        return false;
-    }
+bool NetworkRegistry::save_to_store(storage::KVStore& store) const {
+    storage::WriteBatch batch;
+    std::set<std::string> live_keys;
 
-    bool all_ok = true;
     for (const auto& network : networks_) {
-        const auto file_path = std::filesystem::path(directory) / network_file_name(network.get_id());
-        const auto payload = network.serialize();
+        auto key = network_key(network.get_id());
+        auto payload = network.serialize();
 
-        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
-        if (!out) {
-            CASHEW_LOG_ERROR("Failed to open network file for write: {}", file_path.string());
-            all_ok = false;
-            continue;
+        auto existing = store.get(key);
+        if (!existing || *existing != payload) {
+            batch.put(key, payload);
         }
+        live_keys.insert(std::move(key));
+    }
 
-        out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
-        if (!out.good()) {
-            CASHEW_LOG_ERROR("Failed to write network file: {}", file_path.string());
-            all_ok = false;
+    // Drop networks that left the registry since the last save
+    for (const auto& key : store.keys_with_prefix(NETWORK_KEY_PREFIX)) {
+        if (live_keys.count(key) == 0) {
+            batch.remove(key);
         }
     }
 
-    return all_ok;
+    if (!store.write(batch)) {
+        CASHEW_LOG_ERROR("Failed to persist network registry ({} changes)", batch.size());
+        return false;
+    }
+    return true;
+}
+
+bool NetworkRegistry::load_from_store(const storage::KVStore& store) {
+    std::vector<Network> loaded;
+
+    store.for_each_prefix(NETWORK_KEY_PREFIX, [&loaded](const std::string& key, const std::vector<uint8_t>& value) {
+        auto network = Network::deserialize(value);
+        if (!network.has_value()) {
+            CASHEW_LOG_WARN("Skipping invalid network record: {}", key);
+            return true;
+        }
+        loaded.push_back(std::move(*network));
+        return true;
+    });
+
+    networks_ = std::move(loaded);
+    return true;
+}
+
+bool NetworkRegistry::save_to_disk(const std::string& directory) {
+    storage::KVStore store(directory);
+    if (!store.is_open()) {
+        CASHEW_LOG_ERROR("Failed to open network store in {}", directory);
+        return false;
+    }
+    return save_to_store(store);
 }
 
 bool NetworkRegistry::load_from_disk(const std::string& directory) {
@@ -664,43 +698,42 @@ bool NetworkRegistry::load_from_disk(const std::string& directory) {
         return true;
     }
 
-    std::vector<Network> loaded;
+    storage::KVStore store(directory);
+    if (!store.is_open()) {
+        CASHEW_LOG_ERROR("Failed to open network store in {}", directory);
+        return false;
+    }
+
+    // Import per-network .bin files written by older versions
+    storage::WriteBatch legacy;
+    std::vector<std::filesystem::path> legacy_files;
 
     for (const auto& entry : std::filesystem::directory_iterator(directory)) {
         if (!entry.is_regular_file() || entry.path().extension() != ".bin") {
             continue;
         }
 
-        std::ifstream in(entry.path(), std::ios::binary | std::ios::ate);
-        if (!in) {
-            CASHEW_LOG_WARN("Skipping unreadable network file: {}", entry.path().string());
-            continue;
-        }
-
-        const auto size = in.tellg();
-        if (size <= 0) {
-            continue;
-        }
-
-        in.seekg(0, std::ios::beg);
-        std::vector<uint8_t> bytes(static_cast<size_t>(size));
-        in.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
-        if (!in.good()) {
-            CASHEW_LOG_WARN("Skipping partially read network file: {}", entry.path().string());
-            continue;
-        }
-
-        auto network = Network::deserialize(bytes);
+        std::ifstream in(entry.path(), std::ios::binary);
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto network = in.bad() ? std::nullopt : Network::deserialize(bytes);
         if (!network.has_value()) {
             CASHEW_LOG_WARN("Skipping invalid network file: {}", entry.path().string());
             continue;
         }
 
-        loaded.push_back(std::move(*network));
+        legacy.put(network_key(network->get_id()), bytes);
+        legacy_files.push_back(entry.path());
     }
 
-    networks_ = std::move(loaded);
-    return true;
+    if (!legacy.empty() && store.write(legacy)) {
+        std::error_code ec;
+        for (const auto& path : legacy_files) {
+            std::filesystem::remove(path, ec);
+        }
+        CASHEW_LOG_INFO("Migrated {} network files into network store", legacy_files.size());
+    }
+
+    return load_from_store(store);
 }
 
 // ============================================================================
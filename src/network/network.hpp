@@ -7,8 +7,14 @@
 #include <optional>
 #include <chrono>
 
+namespace cashew::storage {
+class KVStore;
+}
+
 namespace cashew::network {
 
+class PeerMetrics;
+
 /**
  * NetworkID - Unique identifier for a network hosting a single Thing
  */
@@ -163,9 +169,9 @@ public:
     void mark_member_active(const NodeID& node_id);
     void mark_replica_complete(const NodeID& node_id, bool complete);
     
-    // Replication coordination
+    // Replication coordination (source choice weighs measured speed when metrics are given)
     std::vector<NodeID> get_replication_candidates() const;
-    NodeID select_best_source_for_replication() const;
+    NodeID select_best_source_for_replication(const PeerMetrics* metrics = nullptr) const;
     
     // Redundancy adjustment
     bool adjust_redundancy();  // Returns true if changes were made
@@ -230,7 +236,11 @@ public:
     size_t healthy_network_count() const;
     size_t total_network_count() const;
     
-    // Persistence
+    // Persistence (one "network/<id>" record per network; unchanged records are not rewritten)
+    bool save_to_store(storage::KVStore& store) const;
+    bool load_from_store(const storage::KVStore& store);
+    
+    // Persistence to a standalone store in directory (imports legacy per-network .bin files)
     bool save_to_disk(const std::string& directory);
     bool load_from_disk(const std::string& directory);
 
@@ -1,5 +1,7 @@
 #include "network/peer.hpp"
+#include "cashew/time_utils.hpp"
 #include "network/router.hpp"
+#include "storage/kv_store.hpp"
 #include "crypto/random.hpp"
 #include "crypto/ed25519.hpp"
 #include "crypto/blake3.hpp"
@@ -11,6 +13,59 @@
 
 namespace cashew::network {
 
+namespace {
+
+constexpr const char* PEER_KEY_PREFIX = "peer/";
+constexpr const char* BOOTSTRAP_KEY_PREFIX = "bootstrap/";
+
+nlohmann::json peer_to_json(const PeerInfo& info) {
+    nlohmann::json peer_obj;
+    peer_obj["node_id"] = info.node_id.to_string();
+    peer_obj["address"] = info.address;
+    peer_obj["first_seen"] = info.first_seen;
+    peer_obj["last_seen"] = info.last_seen;
+    peer_obj["connection_attempts"] = info.connection_attempts;
+    peer_obj["successful_connections"] = info.successful_connections;
+    peer_obj["is_bootstrap"] = info.is_bootstrap;
+    return peer_obj;
+}
+
+PeerInfo peer_from_json(const nlohmann::json& peer_obj) {
+    PeerInfo info;
+    info.node_id = NodeID::from_string(peer_obj["node_id"]);
+    info.address = peer_obj["address"];
+    info.first_seen = peer_obj["first_seen"];
+    info.last_seen = peer_obj["last_seen"];
+    info.connection_attempts = peer_obj["connection_attempts"];
+    info.successful_connections = peer_obj["successful_connections"];
+    info.is_bootstrap = peer_obj["is_bootstrap"];
+    return info;
+}
+
+nlohmann::json bootstrap_to_json(const BootstrapNode& node) {
+    nlohmann::json node_obj;
+    node_obj["address"] = node.address;
+    node_obj["public_key"] = hash_to_hex(Hash256(node.public_key));
+    node_obj["description"] = node.description;
+    return node_obj;
+}
+
+BootstrapNode bootstrap_from_json(const nlohmann::json& node_obj) {
+    BootstrapNode node;
+    node.address = node_obj["address"];
+    auto pubkey_hash = hex_to_hash(node_obj["public_key"]);
+    std::copy(pubkey_hash.begin(), pubkey_hash.end(), node.public_key.begin());
+    node.description = node_obj["description"];
+    return node;
+}
+
+bytes json_to_bytes(const nlohmann::json& j) {
+    const std::string text = j.dump();
+    return bytes(text.begin(), text.end());
+}
+
+} // namespace
+
 // PeerInfo methods
 
 float PeerInfo::reliability_score() const {
@@ -30,13 +85,10 @@ float PeerInfo::reliability_score() const {
 }
 
 bool PeerInfo::is_stale() const {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    uint64_t current_time = static_cast<uint64_t>(now_time_t);
+    const uint64_t current_time = time::CoarseClock::now_seconds();
     
     static constexpr uint64_t PEER_STALE_TIMEOUT = 3600;  // 1 hour
-    uint64_t age = current_time - last_seen;
-    return age > PEER_STALE_TIMEOUT;
+    return current_time > last_seen && current_time - last_seen > PEER_STALE_TIMEOUT;
 }
 
 // PeerConnection methods
@@ -147,6 +199,7 @@ std::vector<NodeID> PeerDiscovery::select_peers_to_connect(
     std::vector<ScoredPeer> scored_peers;
     scored_peers.reserve(discovered_peers_.size());
     
+    const uint64_t now = time::CoarseClock::now_seconds();
     for (const auto& [node_id, info] : discovered_peers_) {
         // Skip excluded peers
         if (exclude.find(node_id) != exclude.end()) {
@@ -160,24 +213,29 @@ std::vector<NodeID> PeerDiscovery::select_peers_to_connect(
         
         // Calculate score
         float reliability = info.reliability_score();
-        float recency = 1.0f;  // Could factor in last_seen
+        
+        // Peers seen recently are more likely to still be reachable
+        uint64_t age = now > info.last_seen ? now - info.last_seen : 0;
+        float recency = 1.0f - 0.5f * std::min(1.0f, static_cast<float>(age) / PEER_STALE_TIMEOUT);
+        
+        // Measured RTT/throughput (1.0 for peers we have not measured)
+        float speed = metrics_ ? metrics_->speed_factor(node_id) : 1.0f;
         
         // Bootstrap nodes get priority
         float bootstrap_bonus = info.is_bootstrap ? 0.5f : 0.0f;
         
-        float score = reliability * recency + bootstrap_bonus;
+        float score = reliability * recency * speed + bootstrap_bonus;
         scored_peers.push_back({node_id, score});
     }
     
-    // Sort by score (descending)
-    std::sort(scored_peers.begin(), scored_peers.end(),
+    // Top-k by score (descending); the tail is left unordered
+    size_t num_results = std::min(count, scored_peers.size());
+    std::partial_sort(scored_peers.begin(), scored_peers.begin() + num_results, scored_peers.end(),
         [](const ScoredPeer& a, const ScoredPeer& b) {
             return a.score > b.score;
         });
     
-    // Return top N
     std::vector<NodeID> result;
-    size_t num_results = std::min(count, scored_peers.size());
     result.reserve(num_results);
     
     for (size_t i = 0; i < num_results; ++i) {
@@ -325,26 +383,14 @@ bool PeerDiscovery::save_to_disk(const std::string& filepath) const {
         // Save bootstrap nodes
         nlohmann::json bootstrap_array = nlohmann::json::array();
         for (const auto& node : bootstrap_nodes_) {
-            nlohmann::json node_obj;
-            node_obj["address"] = node.address;
-            node_obj["public_key"] = hash_to_hex(Hash256(node.public_key));
-            node_obj["description"] = node.description;
-            bootstrap_array.push_back(node_obj);
+            bootstrap_array.push_back(bootstrap_to_json(node));
         }
         j["bootstrap_nodes"] = bootstrap_array;
         
         // Save discovered peers
         nlohmann::json peers_array = nlohmann::json::array();
         for (const auto& [node_id, info] : discovered_peers_) {
-            nlohmann::json peer_obj;
-            peer_obj["node_id"] = node_id.to_string();
-            peer_obj["address"] = info.address;
-            peer_obj["first_seen"] = info.first_seen;
-            peer_obj["last_seen"] = info.last_seen;
-            peer_obj["connection_attempts"] = info.connection_attempts;
-            peer_obj["successful_connections"] = info.successful_connections;
-            peer_obj["is_bootstrap"] = info.is_bootstrap;
-            peers_array.push_back(peer_obj);
+            peers_array.push_back(peer_to_json(info));
         }
         j["discovered_peers"] = peers_array;
         
@@ -381,27 +427,14 @@ bool PeerDiscovery::load_from_disk(const std::string& filepath) {
         // Load bootstrap nodes
         if (j.contains("bootstrap_nodes")) {
             for (const auto& node_obj : j["bootstrap_nodes"]) {
-                BootstrapNode node;
-                node.address = node_obj["address"];
-                auto pubkey_hash = hex_to_hash(node_obj["public_key"]);
-                std::copy(pubkey_hash.begin(), pubkey_hash.end(), node.public_key.begin());
-                node.description = node_obj["description"];
-                bootstrap_nodes_.push_back(node);
+                bootstrap_nodes_.push_back(bootstrap_from_json(node_obj));
             }
         }
         
         // Load discovered peers
         if (j.contains("discovered_peers")) {
             for (const auto& peer_obj : j["discovered_peers"]) {
-                PeerInfo info;
-                info.node_id = NodeID::from_string(peer_obj["node_id"]);
-                info.address = peer_obj["address"];
-                info.first_seen = peer_obj["first_seen"];
-                info.last_seen = peer_obj["last_seen"];
-                info.connection_attempts = peer_obj["connection_attempts"];
-                info.successful_connections = peer_obj["successful_connections"];
-                info.is_bootstrap = peer_obj["is_bootstrap"];
-                
+                PeerInfo info = peer_from_json(peer_obj);
                 discovered_peers_[info.node_id] = info;
             }
         }
@@ -414,6 +447,81 @@ bool PeerDiscovery::load_from_disk(const std::string& filepath) {
     }
 }
 
+bool PeerDiscovery::save_to_store(storage::KVStore& store) const {
+    storage::WriteBatch batch;
+    std::set<std::string> live_keys;
+    
+    auto stage = [&](std::string key, const nlohmann::json& record) {
+        auto value = json_to_bytes(record);
+        auto existing = store.get(key);
+        if (!existing || *existing != value) {
+            batch.put(key, value);
+        }
+        live_keys.insert(std::move(key));
+    };
+    
+    for (const auto& node : bootstrap_nodes_) {
+        stage(BOOTSTRAP_KEY_PREFIX + node.address, bootstrap_to_json(node));
+    }
+    for (const auto& [node_id, info] : discovered_peers_) {
+        stage(PEER_KEY_PREFIX + hash_to_hex(node_id.id), peer_to_json(info));
+    }
+    
+    // Forget peers that were cleaned up since the last save
+    for (const char* prefix : {BOOTSTRAP_KEY_PREFIX, PEER_KEY_PREFIX}) {
+        for (const auto& key : store.keys_with_prefix(prefix)) {
+            if (live_keys.count(key) == 0) {
+                batch.remove(key);
+            }
+        }
+    }
+    
+    if (!store.write(batch)) {
+        CASHEW_LOG_ERROR("Failed to persist peer database ({} changes)", batch.size());
+        return false;
+    }
+    
+    CASHEW_LOG_DEBUG("Saved peer database ({} changed records)", batch.size());
+    return true;
+}
+
+bool PeerDiscovery::load_from_store(const storage::KVStore& store) {
+    std::vector<BootstrapNode> bootstrap_nodes;
+    std::map<NodeID, PeerInfo> peers;
+    
+    auto parse = [](const bytes& value) {
+        return nlohmann::json::parse(value.begin(), value.end(), nullptr, false);
+    };
+    
+    store.for_each_prefix(BOOTSTRAP_KEY_PREFIX, [&](const std::string& key, const bytes& value) {
+        auto record = parse(value);
+        try {
+            bootstrap_nodes.push_back(bootstrap_from_json(record));
+        } catch (const std::exception& e) {
+            CASHEW_LOG_WARN("Skipping invalid bootstrap record {}: {}", key, e.what());
+        }
+        return true;
+    });
+    
+    store.for_each_prefix(PEER_KEY_PREFIX, [&](const std::string& key, const bytes& value) {
+        auto record = parse(value);
+        try {
+            PeerInfo info = peer_from_json(record);
+            peers[info.node_id] = info;
+        } catch (const std::exception& e) {
+            CASHEW_LOG_WARN("Skipping invalid peer record {}: {}", key, e.what());
+        }
+        return true;
+    });
+    
+    bootstrap_nodes_ = std::move(bootstrap_nodes);
+    discovered_peers_ = std::move(peers);
+    
+    CASHEW_LOG_INFO("Loaded peer database ({} peers, {} bootstrap nodes)",
+                   discovered_peers_.size(), bootstrap_nodes_.size());
+    return true;
+}
+
 std::string PeerDiscovery::extract_subnet(const std::string& address) const {
     // Extract IP from address (format: "ip:port")
     size_t colon_pos = address.find(':');
@@ -471,6 +579,7 @@ PeerManager::PeerManager(
       total_connections_made_(0),
       total_connection_failures_(0)
 {
+    discovery_.set_peer_metrics(&metrics_);
     CASHEW_LOG_INFO("PeerManager initialized");
 }
 
@@ -625,6 +734,9 @@ void PeerManager::maintain_peer_connections() {
     // Cleanup idle connections
     cleanup_idle_connections();
     
+    // Keep latency estimates fresh for connected peers
+    probe_peer_latency();
+    
     // Try to maintain target peer count
     size_t current_count = active_connection_count();
     
@@ -718,7 +830,7 @@ void PeerManager::attempt_reconnections() {
 
 bool PeerManager::send_to_peer(const NodeID& peer_id, const std::vector<uint8_t>& data) {
     auto it = active_connections_.find(peer_id);
-    if (it == active_connections_.end()) {
+    if (it == active_connections_.end() || !transport_) {
         return false;
     }
     
@@ -729,7 +841,7 @@ bool PeerManager::send_to_peer(const NodeID& peer_id, const std::vector<uint8_t>
     }
 
     auto encrypted = conn.session->encrypt_message(data);
-    if (!encrypted.has_value()) {
+    if (!encrypted.has_value() || !transport_(peer_id, *encrypted)) {
         return false;
     }
     
@@ -737,10 +849,69 @@ bool PeerManager::send_to_peer(const NodeID& peer_id, const std::vector<uint8_t>
     conn.bytes_sent += data.size();
     conn.last_activity = current_timestamp();
     
-    CASHEW_LOG_DEBUG("Prepared and encrypted {} bytes to peer", data.size());
+    CASHEW_LOG_DEBUG("Sent {} encrypted bytes to peer", data.size());
     return true;
 }
 
+bool PeerManager::handle_incoming_frame(const NodeID& peer_id, const std::vector<uint8_t>& frame) {
+    auto it = active_connections_.find(peer_id);
+    if (it == active_connections_.end() || !it->second.session) {
+        return false;
+    }
+    
+    auto plaintext = it->second.session->decrypt_message(frame);
+    if (!plaintext || plaintext->empty()) {
+        CASHEW_LOG_WARN("Dropping undecryptable frame from peer");
+        return false;
+    }
+    
+    it->second.bytes_received += plaintext->size();
+    it->second.last_activity = current_timestamp();
+    dispatch_message(peer_id, *plaintext);
+    return true;
+}
+
+void PeerManager::dispatch_message(const NodeID& peer_id, const std::vector<uint8_t>& data) {
+    if (data.empty()) {
+        return;
+    }
+    
+    switch (data[0]) {
+        case 0x01:  // PEER_ANNOUNCEMENT
+            if (auto msg = PeerAnnouncementMessage::from_bytes(data)) {
+                handle_peer_announcement(*msg);
+            }
+            return;
+        case 0x02:  // PEER_REQUEST
+            if (auto msg = PeerRequestMessage::from_bytes(data)) {
+                handle_peer_request(peer_id, *msg);
+            }
+            return;
+        case 0x03:  // PEER_RESPONSE
+            if (auto msg = PeerResponseMessage::from_bytes(data)) {
+                handle_peer_response(*msg);
+            }
+            return;
+        case 0x04:  // NAT_TRAVERSAL_REQUEST
+            if (auto msg = NATTraversalRequest::from_bytes(data)) {
+                handle_nat_traversal_request(peer_id, *msg);
+            }
+            return;
+        case 0x06:  // PEER_PROBE
+        case 0x07:  // PEER_PROBE_REPLY
+            if (auto msg = PeerProbeMessage::from_bytes(data)) {
+                handle_peer_probe(peer_id, *msg);
+            }
+            return;
+        default:
+            break;
+    }
+    
+    if (message_received_callback_) {
+        message_received_callback_(peer_id, data);
+    }
+}
+
 void PeerManager::broadcast_to_peers(const std::vector<uint8_t>& data) {
     size_t sent_count = 0;
     
@@ -875,6 +1046,11 @@ void PeerManager::handle_failed_connection(const NodeID& peer_id) {
 
 void PeerManager::cleanup_connection(const NodeID& peer_id) {
     active_connections_.erase(peer_id);
+    last_probe_.erase(peer_id);
+    for (auto it = pending_probes_.begin(); it != pending_probes_.end();) {
+        it = it->second.peer_id == peer_id ? pending_probes_.erase(it) : std::next(it);
+    }
+    metrics_.forget(peer_id);
 }
 
 uint64_t PeerManager::current_timestamp() const {
@@ -1062,6 +1238,68 @@ void PeerManager::handle_nat_traversal_request(const NodeID& requesting_peer, co
     CASHEW_LOG_DEBUG("Sent NAT traversal response to peer");
 }
 
+void PeerManager::handle_peer_probe(const NodeID& peer_id, const PeerProbeMessage& msg) {
+    if (!msg.is_reply) {
+        if (msg.sender_id != peer_id) {
+            CASHEW_LOG_WARN("Peer probe sender ID mismatch");
+            return;
+        }
+        
+        // Echo straight back; the prober measures the round trip
+        PeerProbeMessage reply = msg;
+        reply.is_reply = true;
+        send_to_peer(peer_id, reply.to_bytes());
+        return;
+    }
+    
+    auto it = pending_probes_.find(msg.nonce);
+    if (it == pending_probes_.end() || it->second.peer_id != peer_id) {
+        return;  // Unknown, expired, or answered by the wrong peer
+    }
+    
+    auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - it->second.sent_at);
+    pending_probes_.erase(it);
+    metrics_.record_rtt(peer_id, rtt);
+}
+
+void PeerManager::probe_peer_latency() {
+    // Without a transport no probe could be answered; timing them out would
+    // mark every connected peer slower than the unmeasured ones
+    if (!transport_) {
+        return;
+    }
+    
+    const auto steady_now = std::chrono::steady_clock::now();
+    
+    // Unanswered probes count against the peer
+    for (auto it = pending_probes_.begin(); it != pending_probes_.end();) {
+        if (steady_now - it->second.sent_at > PROBE_TIMEOUT) {
+            metrics_.record_failure(it->second.peer_id);
+            it = pending_probes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    const uint64_t now = current_timestamp();
+    for (const auto& [peer_id, conn] : active_connections_) {
+        auto last_it = last_probe_.find(peer_id);
+        if (last_it != last_probe_.end() && now - last_it->second < PROBE_INTERVAL_SECONDS) {
+            continue;
+        }
+        
+        PeerProbeMessage probe;
+        probe.sender_id = local_node_id_;
+        probe.nonce = crypto::Random::generate_uint64();
+        
+        if (send_to_peer(peer_id, probe.to_bytes())) {
+            pending_probes_[probe.nonce] = PendingProbe{peer_id, steady_now};
+            last_probe_[peer_id] = now;
+        }
+    }
+}
+
 bool PeerManager::save_peer_database(const std::string& filepath) const {
     return discovery_.save_to_disk(filepath);
 }
@@ -1070,6 +1308,14 @@ bool PeerManager::load_peer_database(const std::string& filepath) {
     return const_cast<PeerDiscovery&>(discovery_).load_from_disk(filepath);
 }
 
+bool PeerManager::save_peer_database(storage::KVStore& store) const {
+    return discovery_.save_to_store(store);
+}
+
+bool PeerManager::load_peer_database(const storage::KVStore& store) {
+    return discovery_.load_from_store(store);
+}
+
 // PeerStatistics methods
 
 std::string PeerStatistics::to_string() const {
@@ -1451,6 +1697,53 @@ std::optional<NATTraversalRequest> NATTraversalRequest::from_bytes(const std::ve
     return req;
 }
 
+// Peer probe methods
+
+std::vector<uint8_t> PeerProbeMessage::to_bytes() const {
+    std::vector<uint8_t> data;
+    
+    // Message type (1 byte)
+    data.push_back(is_reply ? 0x07 : 0x06);  // PEER_PROBE / PEER_PROBE_REPLY
+    
+    // Sender node ID (32 bytes)
+    data.insert(data.end(), sender_id.id.begin(), sender_id.id.end());
+    
+    // Nonce (8 bytes)
+    for (int i = 7; i >= 0; --i) {
+        data.push_back((nonce >> (i * 8)) & 0xFF);
+    }
+    
+    return data;
+}
+
+std::optional<PeerProbeMessage> PeerProbeMessage::from_bytes(const std::vector<uint8_t>& data) {
+    if (data.size() != 41) {  // Fixed size
+        return std::nullopt;
+    }
+    
+    size_t offset = 0;
+    
+    // Message type
+    uint8_t type = data[offset++];
+    if (type != 0x06 && type != 0x07) {
+        return std::nullopt;
+    }
+    
+    PeerProbeMessage msg;
+    msg.is_reply = (type == 0x07);
+    
+    // Sender node ID
+    std::copy(data.begin() + offset, data.begin() + offset + 32, msg.sender_id.id.begin());
+    offset += 32;
+    
+    // Nonce
+    for (int i = 0; i < 8; ++i) {
+        msg.nonce = (msg.nonce << 8) | data[offset++];
+    }
+    
+    return msg;
+}
+
 std::vector<uint8_t> NATTraversalResponse::to_bytes() const {
     std::vector<uint8_t> data;
     
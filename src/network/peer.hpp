@@ -3,6 +3,7 @@
 #include "cashew/common.hpp"
 #include "network/session.hpp"
 #include "network/gossip.hpp"
+#include "network/peer_metrics.hpp"
 #include <vector>
 #include <map>
 #include <set>
@@ -10,6 +11,10 @@
 #include <chrono>
 #include <functional>
 
+namespace cashew::storage {
+class KVStore;
+}
+
 namespace cashew::network {
 
 // Forward declarations
@@ -165,6 +170,20 @@ struct NATTraversalResponse {
     static std::optional<NATTraversalResponse> from_bytes(const std::vector<uint8_t>& data);
 };
 
+/**
+ * PeerProbeMessage - Latency probe; the peer echoes it back with is_reply set
+ */
+struct PeerProbeMessage {
+    NodeID sender_id;
+    uint64_t nonce;
+    bool is_reply;
+    
+    PeerProbeMessage() : nonce(0), is_reply(false) {}
+    
+    std::vector<uint8_t> to_bytes() const;
+    static std::optional<PeerProbeMessage> from_bytes(const std::vector<uint8_t>& data);
+};
+
 /**
  * PeerDiversity - Tracks peer diversity for resilience
  */
@@ -198,7 +217,9 @@ public:
     std::vector<PeerInfo> get_discovered_peers() const;
     std::optional<PeerInfo> get_peer_info(const NodeID& node_id) const;
     
-    // Selection
+    // Selection (weighted by measured speed when metrics are set)
+    void set_peer_metrics(const PeerMetrics* metrics) { metrics_ = metrics; }
+    
     std::vector<NodeID> select_peers_to_connect(
         size_t count,
         const std::set<NodeID>& exclude
@@ -218,10 +239,14 @@ public:
     // Diversity
     PeerDiversity calculate_diversity(const std::vector<NodeID>& connected_peers) const;
     
-    // Peer database persistence
+    // Peer database persistence (JSON document)
     bool save_to_disk(const std::string& filepath) const;
     bool load_from_disk(const std::string& filepath);
     
+    // Peer database persistence (one record per peer; only changed peers are rewritten)
+    bool save_to_store(storage::KVStore& store) const;
+    bool load_from_store(const storage::KVStore& store);
+    
     // Cleanup
     void cleanup_stale_peers();
     size_t peer_count() const { return discovered_peers_.size(); }
@@ -229,6 +254,7 @@ public:
 private:
     std::vector<BootstrapNode> bootstrap_nodes_;
     std::map<NodeID, PeerInfo> discovered_peers_;
+    const PeerMetrics* metrics_ = nullptr;
     
     static constexpr uint64_t PEER_STALE_TIMEOUT = 3600;  // 1 hour
     
@@ -285,6 +311,15 @@ public:
     void attempt_reconnections();
     
     // Sending messages (integrates with Router/Gossip)
+    
+    /**
+     * Transport for encrypted frames; without one nothing is sent and
+     * send_to_peer returns false
+     */
+    using PeerTransport = std::function<bool(const NodeID&, const std::vector<uint8_t>&)>;
+    void set_transport(PeerTransport transport) { transport_ = std::move(transport); }
+    bool has_transport() const { return static_cast<bool>(transport_); }
+    
     bool send_to_peer(const NodeID& peer_id, const std::vector<uint8_t>& data);
     void broadcast_to_peers(const std::vector<uint8_t>& data);
     void send_to_random_peers(const std::vector<uint8_t>& data, size_t count);
@@ -312,15 +347,30 @@ public:
     uint64_t total_bytes_sent() const;
     uint64_t total_bytes_received() const;
     
+    /**
+     * Decrypt a frame received from a connected peer and dispatch it by
+     * message type; types PeerManager does not own go to the message callback
+     */
+    bool handle_incoming_frame(const NodeID& peer_id, const std::vector<uint8_t>& frame);
+    void dispatch_message(const NodeID& peer_id, const std::vector<uint8_t>& data);
+    
     // Message handlers
     void handle_peer_announcement(const PeerAnnouncementMessage& msg);
     void handle_peer_request(const NodeID& requesting_peer, const PeerRequestMessage& msg);
     void handle_peer_response(const PeerResponseMessage& msg);
     void handle_nat_traversal_request(const NodeID& requesting_peer, const NATTraversalRequest& req);
+    void handle_peer_probe(const NodeID& peer_id, const PeerProbeMessage& msg);
+    
+    // Latency probing (also run by maintain_peer_connections; idle without a transport)
+    void probe_peer_latency();
+    PeerMetrics& peer_metrics() { return metrics_; }
+    const PeerMetrics& peer_metrics() const { return metrics_; }
     
     // Peer database
     bool save_peer_database(const std::string& filepath) const;
     bool load_peer_database(const std::string& filepath);
+    bool save_peer_database(storage::KVStore& store) const;
+    bool load_peer_database(const storage::KVStore& store);
 
 private:
     NodeID local_node_id_;
@@ -337,6 +387,20 @@ private:
     std::map<NodeID, uint64_t> last_connection_attempt_;
     std::map<NodeID, uint32_t> connection_failure_count_;
     
+    // Latency probing
+    struct PendingProbe {
+        NodeID peer_id;
+        std::chrono::steady_clock::time_point sent_at;
+    };
+    PeerMetrics metrics_;
+    std::map<uint64_t, PendingProbe> pending_probes_;  // By nonce
+    std::map<NodeID, uint64_t> last_probe_;
+    
+    static constexpr uint64_t PROBE_INTERVAL_SECONDS = 30;
+    static constexpr auto PROBE_TIMEOUT = std::chrono::seconds(10);
+    
+    PeerTransport transport_;
+    
     // Callbacks
     PeerConnectedCallback peer_connected_callback_;
     PeerDisconnectedCallback peer_disconnected_callback_;
@@ -0,0 +1,93 @@
+#include "network/peer_metrics.hpp"
+#include "cashew/time_utils.hpp"
+#include <algorithm>
+
+namespace cashew::network {
+
+void PeerMetrics::record_rtt(const NodeID& node_id, std::chrono::microseconds rtt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& perf = peers_[node_id];
+    update_rtt_locked(perf, static_cast<double>(rtt.count()) / 1000.0);
+}
+
+void PeerMetrics::record_transfer(const NodeID& node_id, size_t bytes, std::chrono::microseconds elapsed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& perf = peers_[node_id];
+
+    const double elapsed_ms = std::max(0.001, static_cast<double>(elapsed.count()) / 1000.0);
+    if (bytes < MIN_THROUGHPUT_SAMPLE_BYTES) {
+        update_rtt_locked(perf, elapsed_ms);
+        return;
+    }
+
+    // Remove the latency share we already know about so throughput is not double-counted
+    const double latency_ms = perf.rtt_samples > 0 ? perf.rtt_ms : 0.0;
+    const double transfer_ms = std::max(elapsed_ms - latency_ms, elapsed_ms * 0.5);
+    const double sample_bps = static_cast<double>(bytes) * 1000.0 / transfer_ms;
+
+    if (perf.transfer_samples == 0) {
+        perf.throughput_bps = sample_bps;
+    } else {
+        perf.throughput_bps += THROUGHPUT_ALPHA * (sample_bps - perf.throughput_bps);
+    }
+    perf.transfer_samples++;
+    perf.last_updated = time::CoarseClock::now_seconds();
+}
+
+void PeerMetrics::record_failure(const NodeID& node_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& perf = peers_[node_id];
+    perf.failures++;
+    update_rtt_locked(perf, FAILURE_RTT_MS);
+}
+
+std::optional<PeerPerformance> PeerMetrics::get(const NodeID& node_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peers_.find(node_id);
+    if (it == peers_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+double PeerMetrics::expected_fetch_ms(const NodeID& node_id, size_t bytes) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = peers_.find(node_id);
+    return estimate_fetch_ms(it != peers_.end() ? &it->second : nullptr, bytes);
+}
+
+float PeerMetrics::speed_factor(const NodeID& node_id) const {
+    const double baseline = estimate_fetch_ms(nullptr, TYPICAL_TRANSFER_BYTES);
+    const double expected = expected_fetch_ms(node_id, TYPICAL_TRANSFER_BYTES);
+    const float factor = static_cast<float>(baseline / std::max(expected, 0.001));
+    return std::clamp(factor, MIN_SPEED_FACTOR, MAX_SPEED_FACTOR);
+}
+
+void PeerMetrics::forget(const NodeID& node_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peers_.erase(node_id);
+}
+
+size_t PeerMetrics::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peers_.size();
+}
+
+void PeerMetrics::update_rtt_locked(PeerPerformance& perf, double sample_ms) {
+    if (perf.rtt_samples == 0) {
+        perf.rtt_ms = sample_ms;
+    } else {
+        perf.rtt_ms += RTT_ALPHA * (sample_ms - perf.rtt_ms);
+    }
+    perf.rtt_samples++;
+    perf.last_updated = time::CoarseClock::now_seconds();
+}
+
+double PeerMetrics::estimate_fetch_ms(const PeerPerformance* perf, size_t bytes) {
+    // Unmeasured components fall back to defaults so new peers are neither favoured nor starved
+    const double rtt_ms = (perf && perf->rtt_samples > 0) ? perf->rtt_ms : DEFAULT_RTT_MS;
+    const double throughput = (perf && perf->transfer_samples > 0) ? perf->throughput_bps : DEFAULT_THROUGHPUT_BPS;
+    return rtt_ms + static_cast<double>(bytes) * 1000.0 / std::max(throughput, 1.0);
+}
+
+} // namespace cashew::network
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "cashew/common.hpp"
+#include <unordered_map>
+#include <optional>
+#include <chrono>
+#include <mutex>
+
+namespace cashew::network {
+
+/**
+ * PeerPerformance - Smoothed latency/throughput estimate for one peer
+ */
+struct PeerPerformance {
+    double rtt_ms;              // EWMA round-trip time (0 = no sample yet)
+    double throughput_bps;      // EWMA delivered bytes/second (0 = no sample yet)
+    uint32_t rtt_samples;
+    uint32_t transfer_samples;
+    uint32_t failures;
+    uint64_t last_updated;      // Unix seconds
+
+    PeerPerformance()
+        : rtt_ms(0.0), throughput_bps(0.0),
+          rtt_samples(0), transfer_samples(0), failures(0), last_updated(0) {}
+};
+
+/**
+ * PeerMetrics - Per-peer RTT and throughput estimates
+ *
+ * Fed actively (probe round trips) and passively (completed transfers).
+ * Estimates are exponentially weighted so a peer that slows down is
+ * noticed within a few samples. speed_factor() turns an estimate into a
+ * multiplier for selection scores: 1.0 for unmeasured peers, above 1.0 for
+ * peers faster than the defaults, below 1.0 for slower or failing ones.
+ *
+ * Thread-safe.
+ */
+class PeerMetrics {
+public:
+    PeerMetrics() = default;
+
+    void record_rtt(const NodeID& node_id, std::chrono::microseconds rtt);
+
+    /**
+     * Record a completed transfer of bytes that took elapsed end to end
+     * Small transfers are latency-bound and only update the RTT estimate.
+     */
+    void record_transfer(const NodeID& node_id, size_t bytes, std::chrono::microseconds elapsed);
+
+    /**
+     * Record a timeout or failed transfer (counted as a slow RTT sample)
+     */
+    void record_failure(const NodeID& node_id);
+
+    std::optional<PeerPerformance> get(const NodeID& node_id) const;
+
+    /**
+     * Expected time to fetch bytes from node_id, in milliseconds
+     */
+    double expected_fetch_ms(const NodeID& node_id, size_t bytes = TYPICAL_TRANSFER_BYTES) const;
+
+    /**
+     * Selection multiplier, clamped to [MIN_SPEED_FACTOR, MAX_SPEED_FACTOR]
+     */
+    float speed_factor(const NodeID& node_id) const;
+
+    void forget(const NodeID& node_id);
+    size_t size() const;
+
+    static constexpr double RTT_ALPHA = 0.125;          // Same gain as TCP SRTT
+    static constexpr double THROUGHPUT_ALPHA = 0.25;
+    static constexpr double DEFAULT_RTT_MS = 150.0;
+    static constexpr double DEFAULT_THROUGHPUT_BPS = 256.0 * 1024.0;
+    static constexpr double FAILURE_RTT_MS = 5000.0;
+    static constexpr size_t TYPICAL_TRANSFER_BYTES = 64 * 1024;
+    static constexpr size_t MIN_THROUGHPUT_SAMPLE_BYTES = 16 * 1024;
+    static constexpr float MIN_SPEED_FACTOR = 0.05f;
+    static constexpr float MAX_SPEED_FACTOR = 8.0f;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<NodeID, PeerPerformance> peers_;
+
+    void update_rtt_locked(PeerPerformance& perf, double sample_ms);
+    static double estimate_fetch_ms(const PeerPerformance* perf, size_t bytes);
+};
+
+} // namespace cashew::network
@@ -1,8 +1,11 @@
 #include "network/router.hpp"
+#include "network/gossip.hpp"
+#include "cashew/time_utils.hpp"
 #include "crypto/blake3.hpp"
 #include "crypto/random.hpp"
 #include "crypto/ed25519.hpp"
 #include "utils/logger.hpp"
+#include "utils/maintenance_scheduler.hpp"
 #include <algorithm>
 #include <sstream>
 #include <cstring>
@@ -54,13 +57,11 @@ std::vector<uint8_t> content_response_signing_bytes(const ContentResponse& respo
 // RoutingEntry methods
 
 bool RoutingEntry::is_stale() const {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    uint64_t current_timestamp = static_cast<uint64_t>(now_time_t);
+    const uint64_t current_timestamp = time::CoarseClock::now_seconds();
     
     static constexpr uint64_t ENTRY_TTL_SECONDS = 3600;  // 1 hour
-    uint64_t age = current_timestamp - last_seen_timestamp;
-    return age > ENTRY_TTL_SECONDS;
+    return current_timestamp > last_seen_timestamp &&
+           current_timestamp - last_seen_timestamp > ENTRY_TTL_SECONDS;
 }
 
 // ContentRequest methods
@@ -99,6 +100,17 @@ std::vector<uint8_t> ContentRequest::to_bytes() const {
         data.insert(data.end(), layer.begin(), layer.end());
     }
     
+    // Deadline as the remaining budget in ms (8 bytes, trailing so older
+    // decoders ignore it; 0 = none, an expired deadline goes out as 1)
+    uint64_t budget_ms = 0;
+    if (deadline_ms != 0) {
+        const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+        budget_ms = deadline_ms > now_ms ? deadline_ms - now_ms : 1;
+    }
+    for (int i = 0; i < 8; ++i) {
+        data.push_back(static_cast<uint8_t>(budget_ms >> (i * 8)));
+    }
+    
     return data;
 }
 
@@ -158,6 +170,18 @@ std::optional<ContentRequest> ContentRequest::from_bytes(const std::vector<uint8
         offset += layer_size;
     }
     
+    // Deadline budget (absent from older senders), made local
+    if (offset + 8 <= data.size()) {
+        uint64_t budget_ms = 0;
+        for (int i = 0; i < 8; ++i) {
+            budget_ms |= static_cast<uint64_t>(data[offset++]) << (i * 8);
+        }
+        if (budget_ms != 0) {
+            const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+            req.deadline_ms = budget_ms > UINT64_MAX - now_ms ? UINT64_MAX : now_ms + budget_ms;
+        }
+    }
+    
     return req;
 }
 
@@ -301,6 +325,7 @@ void RoutingTable::remove_node(const NodeID& node_id) {
     }
     
     entries_.erase(it);
+    content_filters_.erase(node_id);
     CASHEW_LOG_DEBUG("Removed routing entry for node");
 }
 
@@ -392,61 +417,137 @@ void RoutingTable::remove_content_advertisement(const NodeID& node_id, const Con
     }
 }
 
-std::vector<NodeID> RoutingTable::find_hosts_for_content(const ContentHash& content_hash) const {
+bool RoutingTable::apply_content_digest(const ContentDigest& digest) {
+    if (!digest.verify_signature()) {
+        CASHEW_LOG_WARN("Rejected content digest v{}: bad signature", digest.version);
+        return false;
+    }
+    
+    auto it = content_filters_.find(digest.hosting_node);
+    
+    if (digest.is_full()) {
+        if (it != content_filters_.end() && digest.version < it->second.version) {
+            return false;
+        }
+        auto& entry = content_filters_[digest.hosting_node];
+        entry.version = digest.version;
+        entry.filter = *digest.filter;
+        entry.withdrawn.clear();
+        CASHEW_LOG_DEBUG("Applied full content digest v{} ({} items)", digest.version, digest.item_count);
+        return true;
+    }
+    
+    if (it == content_filters_.end() || it->second.version != digest.since_version) {
+        CASHEW_LOG_DEBUG("Content digest delta does not follow held version, waiting for full digest");
+        return false;
+    }
+    
+    auto& entry = it->second;
+    for (const auto& content_hash : digest.added) {
+        entry.filter.insert(content_hash);
+        entry.withdrawn.erase(content_hash);
+    }
+    for (const auto& content_hash : digest.removed) {
+        entry.withdrawn.insert(content_hash);
+    }
+    entry.version = digest.version;
+    return true;
+}
+
+std::optional<uint64_t> RoutingTable::get_content_digest_version(const NodeID& node_id) const {
+    auto it = content_filters_.find(node_id);
+    if (it == content_filters_.end()) {
+        return std::nullopt;
+    }
+    return it->second.version;
+}
+
+size_t RoutingTable::content_filter_bytes() const {
+    size_t total = 0;
+    for (const auto& [node_id, entry] : content_filters_) {
+        total += entry.filter.memory_bytes() + entry.withdrawn.size() * sizeof(ContentHash);
+    }
+    return total;
+}
+
+std::vector<NodeID> RoutingTable::hosts_for(const ContentHash& content_hash) const {
+    std::vector<NodeID> hosts;
     auto it = content_index_.find(content_hash);
-    if (it == content_index_.end()) {
-        return {};
+    if (it != content_index_.end()) {
+        hosts = it->second;
     }
-    return it->second;
+    
+    // One cache-line probe per node that advertises by digest
+    for (const auto& [node_id, entry] : content_filters_) {
+        if (entry.filter.might_contain(content_hash) &&
+            entry.withdrawn.count(content_hash) == 0 &&
+            std::find(hosts.begin(), hosts.end(), node_id) == hosts.end()) {
+            hosts.push_back(node_id);
+        }
+    }
+    return hosts;
+}
+
+std::vector<NodeID> RoutingTable::find_hosts_for_content(const ContentHash& content_hash) const {
+    return hosts_for(content_hash);
 }
 
 bool RoutingTable::has_content_route(const ContentHash& content_hash) const {
     auto it = content_index_.find(content_hash);
-    return it != content_index_.end() && !it->second.empty();
+    if (it != content_index_.end() && !it->second.empty()) {
+        return true;
+    }
+    for (const auto& [node_id, entry] : content_filters_) {
+        if (entry.filter.might_contain(content_hash) && entry.withdrawn.count(content_hash) == 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
-std::optional<NodeID> RoutingTable::select_best_host(const ContentHash& content_hash) const {
-    auto hosts = find_hosts_for_content(content_hash);
-    if (hosts.empty()) {
+std::optional<float> RoutingTable::score_host(const NodeID& node_id) const {
+    auto it = entries_.find(node_id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    
+    const auto& entry = it->second;
+    
+    // Skip stale or unreliable entries
+    if (entry.is_stale() || entry.reliability_score < MIN_RELIABILITY_SCORE) {
         return std::nullopt;
     }
     
-    // Find host with best score (lowest hops * highest reliability)
-    NodeID best_host = hosts[0];
+    // Score: higher is better (lower hops, higher reliability, faster measured transfers)
+    float score = entry.reliability_score / (1.0f + static_cast<float>(entry.hop_distance));
+    if (metrics_) {
+        score *= metrics_->speed_factor(node_id);
+    }
+    return score;
+}
+
+std::optional<NodeID> RoutingTable::select_best_host(const ContentHash& content_hash) const {
+    auto hosts = hosts_for(content_hash);
+    
+    std::optional<NodeID> best_host;
     float best_score = -1.0f;
     
     for (const auto& host : hosts) {
-        auto entry_opt = get_entry(host);
-        if (!entry_opt) continue;
-        
-        const auto& entry = *entry_opt;
-        
-        // Skip stale or unreliable entries
-        if (entry.is_stale() || entry.reliability_score < MIN_RELIABILITY_SCORE) {
-            continue;
-        }
-        
-        // Score: higher is better (lower hops, higher reliability)
-        float score = entry.reliability_score / (1.0f + static_cast<float>(entry.hop_distance));
-        
-        if (score > best_score) {
-            best_score = score;
+        auto score = score_host(host);
+        if (score && *score > best_score) {
+            best_score = *score;
             best_host = host;
         }
     }
     
-    if (best_score < 0.0f) {
-        return std::nullopt;
-    }
-    
     return best_host;
 }
 
 std::vector<NodeID> RoutingTable::select_multiple_hosts(const ContentHash& content_hash, size_t count) const {
-    auto hosts = find_hosts_for_content(content_hash);
-    if (hosts.empty()) {
+    if (count == 0) {
         return {};
     }
+    auto hosts = hosts_for(content_hash);
     
     // Score all hosts
     struct ScoredHost {
@@ -458,29 +559,19 @@ std::vector<NodeID> RoutingTable::select_multiple_hosts(const ContentHash& conte
     scored_hosts.reserve(hosts.size());
     
     for (const auto& host : hosts) {
-        auto entry_opt = get_entry(host);
-        if (!entry_opt) continue;
-        
-        const auto& entry = *entry_opt;
-        
-        // Skip stale or unreliable entries
-        if (entry.is_stale() || entry.reliability_score < MIN_RELIABILITY_SCORE) {
-            continue;
+        if (auto score = score_host(host)) {
+            scored_hosts.push_back({host, *score});
         }
-        
-        float score = entry.reliability_score / (1.0f + static_cast<float>(entry.hop_distance));
-        scored_hosts.push_back({host, score});
     }
     
-    // Sort by score (descending)
-    std::sort(scored_hosts.begin(), scored_hosts.end(),
+    // Top-k by score (descending); the tail is left unordered
+    size_t num_results = std::min(count, scored_hosts.size());
+    std::partial_sort(scored_hosts.begin(), scored_hosts.begin() + num_results, scored_hosts.end(),
         [](const ScoredHost& a, const ScoredHost& b) {
             return a.score > b.score;
         });
     
-    // Return top N
     std::vector<NodeID> result;
-    size_t num_results = std::min(count, scored_hosts.size());
     result.reserve(num_results);
     
     for (size_t i = 0; i < num_results; ++i) {
@@ -511,12 +602,8 @@ void RoutingTable::cleanup_stale_entries() {
 // PendingRequest methods
 
 bool PendingRequest::has_timed_out() const {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    uint64_t current_timestamp = static_cast<uint64_t>(now_time_t);
-    
-    uint64_t age = current_timestamp - timestamp;
-    return age > TIMEOUT_SECONDS;
+    const uint64_t current_timestamp = time::CoarseClock::now_seconds();
+    return current_timestamp > timestamp && current_timestamp - timestamp > TIMEOUT_SECONDS;
 }
 
 // Router methods
@@ -534,7 +621,43 @@ Router::Router(const NodeID& local_node_id)
     CASHEW_LOG_INFO("Router initialized for local node");
 }
 
-Hash256 Router::request_content(const ContentHash& content_hash, uint8_t hop_limit) {
+Router::~Router() {
+    set_maintenance_scheduler(nullptr);
+}
+
+void Router::set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler) {
+    // Not under mutex_: cancel waits for an in-flight run, which takes it
+    if (maintenance_ && hedge_task_ != 0) {
+        maintenance_->cancel(hedge_task_);
+    }
+    hedge_task_ = 0;
+    maintenance_ = std::move(scheduler);
+    if (maintenance_) {
+        hedge_task_ = maintenance_->schedule_periodic("router.hedges", MIN_HEDGE_DELAY,
+                                                      [this]() { process_hedges(); }, 0.0);
+    }
+}
+
+Hash256 Router::request_content(
+    const ContentHash& content_hash,
+    uint8_t hop_limit,
+    std::chrono::milliseconds deadline
+) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // Already fetching this content: share that request (and its response)
+    auto existing = pending_by_content_.find(content_hash.hash);
+    if (existing != pending_by_content_.end()) {
+        auto it = pending_requests_.find(existing->second);
+        if (it != pending_requests_.end()) {
+            // The deadline stays the one the hosts were sent; extending it here
+            // would only keep us waiting after they have given up
+            it->second.callers++;
+            coalesced_requests_++;
+            CASHEW_LOG_DEBUG("Coalesced content request with one in flight");
+            return it->first;
+        }
+    }
+    
     // Create request
     ContentRequest request;
     request.content_hash = content_hash;
@@ -545,6 +668,9 @@ Hash256 Router::request_content(const ContentHash& content_hash, uint8_t hop_lim
     auto now = std::chrono::system_clock::now();
     auto now_time_t = std::chrono::system_clock::to_time_t(now);
     request.timestamp = static_cast<uint64_t>(now_time_t);
+    if (deadline.count() > 0) {
+        request.deadline_ms = time::CoarseClock::now_milliseconds() + static_cast<uint64_t>(deadline.count());
+    }
     
     // Track request
     PendingRequest pending;
@@ -553,13 +679,23 @@ Hash256 Router::request_content(const ContentHash& content_hash, uint8_t hop_lim
     pending.original_requester = local_node_id_;
     pending.timestamp = request.timestamp;
     pending.retries = 0;
+    pending.created_at = std::chrono::steady_clock::now();
+    pending.deadline_ms = request.deadline_ms;
+    pending.hop_limit = request.hop_limit;
+    
+    // Find next hop; a hedge to the next-best host follows if this one is slow
+    auto next_hop_opt = select_next_hop(content_hash);
+    if (next_hop_opt) {
+        pending.attempts.push_back({*next_hop_opt, pending.created_at});
+        pending.hedge_at = pending.created_at + hedge_delay_;
+    }
     
+    // Track before sending: an in-process transport may answer synchronously
     pending_requests_[request.request_id] = pending;
     
-    // Find next hop
-    auto next_hop_opt = select_next_hop(content_hash);
-    if (!next_hop_opt.id.empty()) {
-        send_request_to_peer(next_hop_opt, request);
+    if (next_hop_opt) {
+        pending_by_content_[content_hash.hash] = request.request_id;
+        send_request_to_peer(*next_hop_opt, request);
         requests_sent_++;
         CASHEW_LOG_DEBUG("Sent content request (hop limit {})", hop_limit);
     } else {
@@ -567,15 +703,32 @@ Hash256 Router::request_content(const ContentHash& content_hash, uint8_t hop_lim
         if (content_not_found_callback_) {
             content_not_found_callback_(content_hash);
         }
+        resolve_waiters(content_hash, std::nullopt);
     }
     
     return request.request_id;
 }
 
+runtime::Task<std::optional<std::vector<uint8_t>>> Router::fetch_content(
+    ContentHash content_hash,
+    uint8_t hop_limit,
+    std::chrono::milliseconds deadline
+) {
+    // Register before sending: an in-process transport may answer synchronously
+    ContentCompletion completion;
+    {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        content_waiters_[content_hash.hash].push_back(completion);
+        request_content(content_hash, hop_limit, deadline);
+    }
+    co_return co_await completion;
+}
+
 Hash256 Router::request_content_with_onion_routing(
     const ContentHash& content_hash,
     const std::vector<NodeID>& route_path
 ) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     // Create request
     ContentRequest request;
     request.content_hash = content_hash;
@@ -598,6 +751,10 @@ Hash256 Router::request_content_with_onion_routing(
     pending.original_requester = local_node_id_;
     pending.timestamp = request.timestamp;
     pending.retries = 0;
+    pending.created_at = std::chrono::steady_clock::now();
+    if (!route_path.empty()) {
+        pending.attempts.push_back({route_path[0], pending.created_at});  // Fixed route: never hedged
+    }
     
     pending_requests_[request.request_id] = pending;
     
@@ -612,6 +769,7 @@ Hash256 Router::request_content_with_onion_routing(
 }
 
 void Router::handle_content_request(const ContentRequest& request) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     requests_received_++;
     
     // Check if hop limit exceeded
@@ -620,6 +778,19 @@ void Router::handle_content_request(const ContentRequest& request) {
         return;
     }
     
+    // Nobody is waiting for an answer that would arrive after the deadline
+    const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+    if (request.is_past_deadline(now_ms)) {
+        deadline_drops_++;
+        CASHEW_LOG_DEBUG("Content request past its deadline, dropping");
+        return;
+    }
+    
+    if (cancelled_requests_.count(request.request_id) > 0) {
+        CASHEW_LOG_DEBUG("Content request already cancelled, dropping");
+        return;
+    }
+    
     // Decrypt onion layer if present
     if (!request.onion_layers.empty()) {
         auto decrypted_opt = decrypt_onion_layer(request.onion_layers[0]);
@@ -680,7 +851,7 @@ void Router::handle_content_request(const ContentRequest& request) {
     
     // Forward to next hop
     auto next_hop = select_next_hop(request.content_hash);
-    if (next_hop.id.empty()) {
+    if (!next_hop) {
         CASHEW_LOG_WARN("No route to forward content request");
         return;
     }
@@ -689,12 +860,19 @@ void Router::handle_content_request(const ContentRequest& request) {
     ContentRequest forwarded = request;
     forwarded.hop_limit--;
     
-    send_request_to_peer(next_hop, forwarded);
+    // Remember the hop so a cancel from the requester can follow the request
+    const uint64_t expires_ms = request.deadline_ms != 0
+        ? request.deadline_ms
+        : now_ms + PendingRequest::TIMEOUT_SECONDS * 1000;
+    forwarded_requests_[request.request_id] = ForwardedRequest{*next_hop, expires_ms};
+    
+    send_request_to_peer(*next_hop, forwarded);
     forwards_++;
     CASHEW_LOG_DEBUG("Forwarded content request (remaining hops: {})", forwarded.hop_limit);
 }
 
 void Router::handle_content_response(const ContentResponse& response) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     responses_received_++;
     
     // Check if this is for one of our pending requests
@@ -722,18 +900,63 @@ void Router::handle_content_response(const ContentResponse& response) {
         // Update reliability score for hosting node
         routing_table_.update_node_reliability(response.hosting_node, 1.0f);
         
-        // Remove from pending
-        pending_requests_.erase(it);
+        // First valid response wins; credit the attempt it answers (the first
+        // one when a multi-hop answer cannot be attributed)
+        PendingRequest pending = take_pending(it);
+        
+        const auto now = std::chrono::steady_clock::now();
+        size_t winner = 0;
+        for (size_t i = 0; i < pending.attempts.size(); ++i) {
+            if (pending.attempts[i].peer_id == response.hosting_node) {
+                winner = i;
+                break;
+            }
+        }
+        if (winner > 0) {
+            hedge_wins_++;
+        }
+        
+        record_latency(std::chrono::duration_cast<std::chrono::microseconds>(now - pending.created_at));
+        if (metrics_ && !pending.attempts.empty()) {
+            const auto& attempt = pending.attempts[winner];
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - attempt.sent_at);
+            metrics_->record_transfer(attempt.peer_id, response.content_data.size(), elapsed);
+        }
+        
+        resolve_waiters(response.content_hash, response.content_data);
+        
+        // Losing hedges: stop the other hosts doing work nobody needs
+        for (size_t i = 0; i < pending.attempts.size(); ++i) {
+            if (i != winner) {
+                send_cancel_to_peer(pending.attempts[i].peer_id, response.request_id);
+            }
+        }
     } else {
         CASHEW_LOG_DEBUG("Received response for unknown request, ignoring");
     }
 }
 
 void Router::update_routing_table(const NodeID& node_id, uint8_t hop_distance) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     routing_table_.add_node(node_id, hop_distance);
 }
 
+void Router::register_gossip_handlers(GossipProtocol& gossip) {
+    gossip.register_handler(GossipMessageType::CONTENT_DIGEST, [this](const GossipMessage& message) {
+        auto digest = ContentDigest::from_bytes(message.payload);
+        if (!digest || digest->hosting_node == local_node_id_) {
+            return;
+        }
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        if (routing_table_.apply_content_digest(*digest)) {
+            update_routing_table(digest->hosting_node,
+                                 static_cast<uint8_t>(std::min<int>(message.hop_count + 1, 255)));
+        }
+    });
+}
+
 void Router::advertise_local_content(const ContentHash& content_hash) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     // Add to local content list
     if (std::find(local_content_.begin(), local_content_.end(), content_hash) == local_content_.end()) {
         local_content_.push_back(content_hash);
@@ -745,6 +968,7 @@ void Router::advertise_local_content(const ContentHash& content_hash) {
 }
 
 void Router::remove_local_content(const ContentHash& content_hash) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     local_content_.erase(
         std::remove(local_content_.begin(), local_content_.end(), content_hash),
         local_content_.end()
@@ -754,6 +978,7 @@ void Router::remove_local_content(const ContentHash& content_hash) {
 }
 
 std::optional<PendingRequest> Router::get_pending_request(const Hash256& request_id) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto it = pending_requests_.find(request_id);
     if (it == pending_requests_.end()) {
         return std::nullopt;
@@ -762,25 +987,56 @@ std::optional<PendingRequest> Router::get_pending_request(const Hash256& request
 }
 
 void Router::cancel_request(const Hash256& request_id) {
-    pending_requests_.erase(request_id);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = pending_requests_.find(request_id);
+    if (it == pending_requests_.end()) {
+        return;
+    }
+    
+    // Other callers still want the content
+    if (it->second.callers > 1) {
+        it->second.callers--;
+        return;
+    }
+    
+    PendingRequest pending = take_pending(it);
+    resolve_waiters(pending.content_hash, std::nullopt);
+    
+    for (const auto& attempt : pending.attempts) {
+        send_cancel_to_peer(attempt.peer_id, request_id);
+    }
+}
+
+void Router::handle_content_cancel(const Hash256& request_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+    
+    auto it = forwarded_requests_.find(request_id);
+    if (it == forwarded_requests_.end()) {
+        // Cancel overtook the request (or we served it already): drop it if it shows up
+        cancelled_requests_[request_id] = now_ms + PendingRequest::TIMEOUT_SECONDS * 1000;
+        return;
+    }
+    
+    ForwardedRequest forwarded = it->second;
+    forwarded_requests_.erase(it);
+    cancelled_requests_[request_id] = forwarded.expires_ms;
+    
+    send_cancel_to_peer(forwarded.next_hop, request_id);
 }
 
 void Router::cleanup_timed_out_requests() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     std::vector<Hash256> to_remove;
     
     for (const auto& [request_id, pending] : pending_requests_) {
         if (pending.has_timed_out()) {
             to_remove.push_back(request_id);
-            
-            // Notify callback
-            if (content_not_found_callback_) {
-                content_not_found_callback_(pending.content_hash);
-            }
         }
     }
     
     for (const auto& request_id : to_remove) {
-        pending_requests_.erase(request_id);
+        fail_request(request_id);
     }
     
     if (!to_remove.empty()) {
@@ -788,9 +1044,188 @@ void Router::cleanup_timed_out_requests() {
     }
 }
 
+void Router::process_hedges() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+    
+    std::vector<Hash256> due;
+    std::vector<Hash256> expired;
+    
+    for (const auto& [request_id, pending] : pending_requests_) {
+        if (pending.deadline_ms != 0 && now_ms >= pending.deadline_ms) {
+            expired.push_back(request_id);
+        } else if (pending.hedge_at && *pending.hedge_at <= now) {
+            due.push_back(request_id);
+        }
+    }
+    
+    // Sending may complete a request synchronously, so look each one up again
+    for (const auto& request_id : due) {
+        auto it = pending_requests_.find(request_id);
+        if (it != pending_requests_.end()) {
+            send_hedge(it->second);
+        }
+    }
+    
+    for (const auto& request_id : expired) {
+        deadline_drops_++;
+        fail_request(request_id);
+    }
+    
+    prune_forwarded(now_ms);
+}
+
+std::optional<std::chrono::steady_clock::time_point> Router::next_hedge_due() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+    const uint64_t now_ms = time::CoarseClock::now_milliseconds();
+    
+    std::optional<std::chrono::steady_clock::time_point> next;
+    auto consider = [&next](std::chrono::steady_clock::time_point due) {
+        if (!next || due < *next) {
+            next = due;
+        }
+    };
+    
+    for (const auto& [request_id, pending] : pending_requests_) {
+        if (pending.hedge_at) {
+            consider(*pending.hedge_at);
+        }
+        if (pending.deadline_ms != 0) {
+            const uint64_t remaining = pending.deadline_ms > now_ms ? pending.deadline_ms - now_ms : 0;
+            consider(now + std::chrono::milliseconds(remaining));
+        }
+    }
+    
+    return next;
+}
+
+size_t Router::pending_request_count() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return pending_requests_.size();
+}
+
+std::chrono::milliseconds Router::hedge_delay() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return hedge_delay_;
+}
+
 void Router::update_statistics() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     routing_table_.cleanup_stale_entries();
     cleanup_timed_out_requests();
+    process_hedges();
+}
+
+void Router::record_latency(std::chrono::microseconds latency) {
+    const uint64_t sample = static_cast<uint64_t>(std::max<int64_t>(0, latency.count()));
+    if (latency_samples_.size() < LATENCY_WINDOW) {
+        latency_samples_.push_back(sample);
+    } else {
+        latency_samples_[latency_next_] = sample;
+    }
+    latency_next_ = (latency_next_ + 1) % LATENCY_WINDOW;
+    
+    // Recompute the p95 every few samples rather than on every response
+    if (latency_samples_.size() < MIN_LATENCY_SAMPLES || latency_next_ % 8 != 0) {
+        return;
+    }
+    
+    std::vector<uint64_t> sorted = latency_samples_;
+    auto p95 = sorted.begin() + static_cast<std::ptrdiff_t>((sorted.size() * 95) / 100);
+    std::nth_element(sorted.begin(), p95, sorted.end());
+    
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::microseconds(*p95));
+    hedge_delay_ = std::clamp(delay, MIN_HEDGE_DELAY, MAX_HEDGE_DELAY);
+}
+
+bool Router::send_hedge(PendingRequest& pending) {
+    pending.hedge_at.reset();
+    if (pending.attempts.empty() || pending.attempts.size() > MAX_HEDGES) {
+        return false;
+    }
+    
+    // Next-best host we have not asked yet
+    std::optional<NodeID> next_host;
+    auto hosts = routing_table_.select_multiple_hosts(pending.content_hash, pending.attempts.size() + 1);
+    for (const auto& host : hosts) {
+        bool attempted = std::any_of(pending.attempts.begin(), pending.attempts.end(),
+            [&host](const PendingRequest::Attempt& attempt) { return attempt.peer_id == host; });
+        if (!attempted) {
+            next_host = host;
+            break;
+        }
+    }
+    if (!next_host) {
+        return false;
+    }
+    
+    const auto now = std::chrono::steady_clock::now();
+    pending.attempts.push_back({*next_host, now});
+    if (pending.attempts.size() <= MAX_HEDGES) {
+        pending.hedge_at = now + hedge_delay_;
+    }
+    
+    // Same request ID, so whichever host answers first completes the request
+    ContentRequest request;
+    request.content_hash = pending.content_hash;
+    request.requester_id = local_node_id_;
+    request.request_id = pending.request_id;
+    request.hop_limit = pending.hop_limit;
+    request.timestamp = pending.timestamp;
+    request.deadline_ms = pending.deadline_ms;
+    
+    hedges_sent_++;
+    requests_sent_++;
+    CASHEW_LOG_DEBUG("Hedging content request after {} ms", hedge_delay_.count());
+    
+    // Last: pending may be erased by a synchronous response
+    send_request_to_peer(*next_host, request);
+    return true;
+}
+
+void Router::fail_request(const Hash256& request_id) {
+    auto it = pending_requests_.find(request_id);
+    if (it == pending_requests_.end()) {
+        return;
+    }
+    
+    PendingRequest pending = take_pending(it);
+    
+    if (content_not_found_callback_) {
+        content_not_found_callback_(pending.content_hash);
+    }
+    
+    for (const auto& attempt : pending.attempts) {
+        if (metrics_) {
+            metrics_->record_failure(attempt.peer_id);
+        }
+        send_cancel_to_peer(attempt.peer_id, request_id);
+    }
+    
+    resolve_waiters(pending.content_hash, std::nullopt);
+}
+
+PendingRequest Router::take_pending(std::map<Hash256, PendingRequest>::iterator it) {
+    PendingRequest pending = std::move(it->second);
+    
+    auto indexed = pending_by_content_.find(pending.content_hash.hash);
+    if (indexed != pending_by_content_.end() && indexed->second == it->first) {
+        pending_by_content_.erase(indexed);
+    }
+    
+    pending_requests_.erase(it);
+    return pending;
+}
+
+void Router::prune_forwarded(uint64_t now_ms) {
+    for (auto it = forwarded_requests_.begin(); it != forwarded_requests_.end();) {
+        it = it->second.expires_ms <= now_ms ? forwarded_requests_.erase(it) : std::next(it);
+    }
+    for (auto it = cancelled_requests_.begin(); it != cancelled_requests_.end();) {
+        it = it->second <= now_ms ? cancelled_requests_.erase(it) : std::next(it);
+    }
 }
 
 Hash256 Router::generate_request_id() {
@@ -812,14 +1247,8 @@ Hash256 Router::generate_request_id() {
     return crypto::Blake3::hash(id_data);
 }
 
-NodeID Router::select_next_hop(const ContentHash& content_hash) const {
-    auto best_host_opt = routing_table_.select_best_host(content_hash);
-    if (best_host_opt) {
-        return *best_host_opt;
-    }
-    
-    // No specific route, return empty
-    return NodeID{};
+std::optional<NodeID> Router::select_next_hop(const ContentHash& content_hash) const {
+    return routing_table_.select_best_host(content_hash);
 }
 
 bool Router::should_forward_request(const ContentRequest& request) const {
@@ -841,6 +1270,21 @@ bool Router::can_serve_locally(const ContentHash& content_hash) const {
     return std::find(local_content_.begin(), local_content_.end(), content_hash) != local_content_.end();
 }
 
+void Router::resolve_waiters(const ContentHash& content_hash, std::optional<std::vector<uint8_t>> content) {
+    auto it = content_waiters_.find(content_hash.hash);
+    if (it == content_waiters_.end()) {
+        return;
+    }
+    
+    // Detach first: an off-pool waiter resumes inline and may re-enter the router
+    auto waiters = std::move(it->second);
+    content_waiters_.erase(it);
+    
+    for (const auto& waiter : waiters) {
+        waiter.set(content);
+    }
+}
+
 std::vector<std::vector<uint8_t>> Router::create_onion_layers(
     const std::vector<NodeID>& route_path,
     const std::vector<uint8_t>& payload
@@ -909,6 +1353,17 @@ void Router::send_request_to_peer(const NodeID& peer_id, const ContentRequest& r
     CASHEW_LOG_DEBUG("Router request send callback is not configured; dropping request");
 }
 
+void Router::send_cancel_to_peer(const NodeID& peer_id, const Hash256& request_id) {
+    if (peer_id == local_node_id_) {
+        return;
+    }
+    
+    if (cancel_send_callback_ && !cancel_send_callback_(peer_id, request_id)) {
+        CASHEW_LOG_DEBUG("Router failed to send cancel to peer {}",
+                         cashew::hash_to_hex(peer_id.id).substr(0, 16));
+    }
+}
+
 void Router::send_response_to_peer(const NodeID& peer_id, const ContentResponse& response) {
     if (response_send_callback_) {
         if (!response_send_callback_(peer_id, response)) {
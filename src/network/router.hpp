@@ -2,14 +2,26 @@
 
 #include "cashew/common.hpp"
 #include "core/thing/thing.hpp"
+#include "runtime/executor.hpp"
+#include "network/peer_metrics.hpp"
+#include "network/content_digest.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <optional>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <chrono>
 #include <functional>
 
+namespace cashew::utils { class MaintenanceScheduler; }
+
 namespace cashew::network {
 
+class GossipProtocol;
+
 /**
  * RoutingEntry - Information about a node and its advertised content
  */
@@ -39,12 +51,19 @@ struct ContentRequest {
     Hash256 request_id;  // Unique request ID
     uint8_t hop_limit;
     uint64_t timestamp;
+    // Local CoarseClock ms after which nobody wants the answer (0 = none).
+    // Sent as the remaining budget and turned back into a local deadline on
+    // receipt, so peers' clocks need not agree.
+    uint64_t deadline_ms = 0;
     
     // Optional onion routing layers
     std::vector<std::vector<uint8_t>> onion_layers;
     
     static constexpr uint8_t DEFAULT_HOP_LIMIT = 8;
     static constexpr uint8_t MAX_HOP_LIMIT = 16;
+    static constexpr std::chrono::milliseconds DEFAULT_DEADLINE{30000};  // PendingRequest::TIMEOUT_SECONDS
+    
+    bool is_past_deadline(uint64_t now_ms) const { return deadline_ms != 0 && now_ms >= deadline_ms; }
     
     std::vector<uint8_t> to_bytes() const;
     static std::optional<ContentRequest> from_bytes(const std::vector<uint8_t>& data);
@@ -98,25 +117,53 @@ public:
     void advertise_content(const NodeID& node_id, const ContentHash& content_hash);
     void remove_content_advertisement(const NodeID& node_id, const ContentHash& content_hash);
     
-    // Content lookup
+    /**
+     * Apply a node's content digest: a full digest replaces its filter, a
+     * delta must build on the version held. Returns false if ignored
+     * (not signed by the hosting node's key, stale, or a delta on top of a
+     * version we don't have).
+     * Filter hits may be false positives; lookups treat them as hosts.
+     */
+    bool apply_content_digest(const ContentDigest& digest);
+    std::optional<uint64_t> get_content_digest_version(const NodeID& node_id) const;
+    
+    // Content lookup (exact index plus per-node filters)
     std::vector<NodeID> find_hosts_for_content(const ContentHash& content_hash) const;
     bool has_content_route(const ContentHash& content_hash) const;
     
-    // Best route selection
+    // Best route selection (weighted by measured speed when metrics are set)
     std::optional<NodeID> select_best_host(const ContentHash& content_hash) const;
     std::vector<NodeID> select_multiple_hosts(const ContentHash& content_hash, size_t count) const;
     
+    void set_peer_metrics(const PeerMetrics* metrics) { metrics_ = metrics; }
+    
     // Maintenance
     void cleanup_stale_entries();
     size_t entry_count() const { return entries_.size(); }
     size_t content_index_size() const { return content_index_.size(); }
+    size_t content_filter_count() const { return content_filters_.size(); }
+    size_t content_filter_bytes() const;
 
 private:
+    // Digest-advertised content of one node
+    struct NodeContentFilter {
+        uint64_t version = 0;
+        ContentSetFilter filter;
+        std::set<ContentHash> withdrawn;  // Removed since the filter was built
+    };
+    
     std::map<NodeID, RoutingEntry> entries_;
     std::map<ContentHash, std::vector<NodeID>> content_index_;
+    std::map<NodeID, NodeContentFilter> content_filters_;
+    const PeerMetrics* metrics_ = nullptr;
     
     static constexpr uint64_t ENTRY_TTL_SECONDS = 3600;  // 1 hour
     static constexpr float MIN_RELIABILITY_SCORE = 0.3f;
+    
+    std::vector<NodeID> hosts_for(const ContentHash& content_hash) const;
+    
+    // Score for a usable host (higher is better), nullopt for stale/unreliable ones
+    std::optional<float> score_host(const NodeID& node_id) const;
 };
 
 /**
@@ -129,6 +176,19 @@ struct PendingRequest {
     uint64_t timestamp;
     uint8_t retries;
     
+    // Hosts the request went to and when; attempts after the first are hedges
+    struct Attempt {
+        NodeID peer_id;
+        std::chrono::steady_clock::time_point sent_at;
+    };
+    std::vector<Attempt> attempts;
+    
+    std::chrono::steady_clock::time_point created_at;
+    std::optional<std::chrono::steady_clock::time_point> hedge_at;  // Next hedge due
+    uint64_t deadline_ms = 0;
+    uint8_t hop_limit = ContentRequest::DEFAULT_HOP_LIMIT;
+    uint32_t callers = 1;  // request_content calls sharing this request (coalesced)
+    
     static constexpr uint8_t MAX_RETRIES = 3;
     static constexpr uint64_t TIMEOUT_SECONDS = 30;
     
@@ -145,16 +205,28 @@ struct PendingRequest {
  * - Request/response tracking
  * - Optional onion routing for privacy
  * - Local caching
+ *
+ * Thread-safe: one internal lock, held while callbacks run (a synchronous
+ * transport may call back into the router). Set callbacks before attaching
+ * a maintenance scheduler; get_routing_table() bypasses the lock.
  */
 class Router {
 public:
     Router(const NodeID& local_node_id);
-    ~Router() = default;
+    ~Router();
     
     // Content requests
+    // Hedged: if the first host is slower than usual, the next-best host is
+    // asked too and the first valid response wins (see process_hedges).
+    // Coalesced: while a routed request for the hash is outstanding, its ID
+    // is returned instead of sending another one. A joining caller gets the
+    // shared request's deadline, whatever it asked for (hosts already have
+    // that one), and its cancel_request only counts it out: the request is
+    // cancelled when the last caller sharing it cancels.
     Hash256 request_content(
         const ContentHash& content_hash,
-        uint8_t hop_limit = ContentRequest::DEFAULT_HOP_LIMIT
+        uint8_t hop_limit = ContentRequest::DEFAULT_HOP_LIMIT,
+        std::chrono::milliseconds deadline = ContentRequest::DEFAULT_DEADLINE
     );
     
     Hash256 request_content_with_onion_routing(
@@ -162,9 +234,21 @@ public:
         const std::vector<NodeID>& route_path
     );
     
+    /**
+     * Awaitable content request
+     * Resolves with the verified content, or nullopt when there is no route,
+     * the request times out or it is cancelled.
+     */
+    runtime::Task<std::optional<std::vector<uint8_t>>> fetch_content(
+        ContentHash content_hash,
+        uint8_t hop_limit = ContentRequest::DEFAULT_HOP_LIMIT,
+        std::chrono::milliseconds deadline = ContentRequest::DEFAULT_DEADLINE
+    );
+    
     // Request handling (when we receive a request)
     void handle_content_request(const ContentRequest& request);
     void handle_content_response(const ContentResponse& response);
+    void handle_content_cancel(const Hash256& request_id);
     
     // Routing table management
     void update_routing_table(const NodeID& node_id, uint8_t hop_distance);
@@ -174,10 +258,23 @@ public:
     RoutingTable& get_routing_table() { return routing_table_; }
     const RoutingTable& get_routing_table() const { return routing_table_; }
     
+    /**
+     * Feed other nodes' signed CONTENT_DIGEST gossip into the routing table
+     */
+    void register_gossip_handlers(GossipProtocol& gossip);
+    
+    /**
+     * Record per-peer fetch latency/throughput into metrics and prefer fast hosts
+     */
+    void set_peer_metrics(PeerMetrics* metrics) {
+        metrics_ = metrics;
+        routing_table_.set_peer_metrics(metrics);
+    }
+    
     // Request tracking
     std::optional<PendingRequest> get_pending_request(const Hash256& request_id) const;
     void cancel_request(const Hash256& request_id);
-    size_t pending_request_count() const { return pending_requests_.size(); }
+    size_t pending_request_count() const;
     
     // Callbacks
     using ContentReceivedCallback = std::function<void(const ContentHash&, const std::vector<uint8_t>&)>;
@@ -187,6 +284,7 @@ public:
     using ResponseVerifyCallback = std::function<bool(const ContentResponse&)>;
     using RequestSendCallback = std::function<bool(const NodeID&, const ContentRequest&)>;
     using ResponseSendCallback = std::function<bool(const NodeID&, const ContentResponse&)>;
+    using CancelSendCallback = std::function<bool(const NodeID&, const Hash256&)>;
     
     void set_content_received_callback(ContentReceivedCallback callback) {
         content_received_callback_ = callback;
@@ -215,6 +313,10 @@ public:
     void set_response_send_callback(ResponseSendCallback callback) {
         response_send_callback_ = std::move(callback);
     }
+
+    void set_cancel_send_callback(CancelSendCallback callback) {
+        cancel_send_callback_ = std::move(callback);
+    }
     
     // Statistics
     uint64_t requests_sent() const { return requests_sent_; }
@@ -222,21 +324,58 @@ public:
     uint64_t responses_sent() const { return responses_sent_; }
     uint64_t responses_received() const { return responses_received_; }
     uint64_t forwards() const { return forwards_; }
+    uint64_t hedges_sent() const { return hedges_sent_; }
+    uint64_t hedge_wins() const { return hedge_wins_; }
+    uint64_t deadline_drops() const { return deadline_drops_; }
+    uint64_t coalesced_requests() const { return coalesced_requests_; }
+    
+    /**
+     * Current hedge delay: p95 of recent fetch latencies, clamped
+     */
+    std::chrono::milliseconds hedge_delay() const;
     
     // Maintenance
     void cleanup_timed_out_requests();
     void update_statistics();
+    
+    /**
+     * Send due hedges and fail requests past their deadline
+     * Call at least every MIN_HEDGE_DELAY while requests are pending, or
+     * attach a maintenance scheduler to do so.
+     */
+    void process_hedges();
+    
+    /**
+     * Run process_hedges every MIN_HEDGE_DELAY on a shared maintenance
+     * scheduler (nullptr detaches)
+     */
+    void set_maintenance_scheduler(std::shared_ptr<utils::MaintenanceScheduler> scheduler);
+    std::optional<std::chrono::steady_clock::time_point> next_hedge_due() const;
+    
+    static constexpr size_t MAX_HEDGES = 1;  // Extra hosts asked per request
+    static constexpr std::chrono::milliseconds MIN_HEDGE_DELAY{20};
+    static constexpr std::chrono::milliseconds MAX_HEDGE_DELAY{2000};
+    static constexpr std::chrono::milliseconds DEFAULT_HEDGE_DELAY{250};
 
 private:
+    mutable std::recursive_mutex mutex_;
     NodeID local_node_id_;
     RoutingTable routing_table_;
     
     // Pending requests
     std::map<Hash256, PendingRequest> pending_requests_;
+    std::unordered_map<Hash256, Hash256> pending_by_content_;  // content hash -> our routed request
     
     // Local content we can serve
     std::vector<ContentHash> local_content_;
     
+    // Shared latency/throughput estimates (not owned)
+    PeerMetrics* metrics_ = nullptr;
+    
+    // Coroutines awaiting content (fetch_content), keyed by content hash
+    using ContentCompletion = runtime::Completion<std::optional<std::vector<uint8_t>>>;
+    std::unordered_map<Hash256, std::vector<ContentCompletion>> content_waiters_;
+    
     // Callbacks
     ContentReceivedCallback content_received_callback_;
     ContentNotFoundCallback content_not_found_callback_;
@@ -245,22 +384,52 @@ private:
     ResponseVerifyCallback response_verify_callback_;
     RequestSendCallback request_send_callback_;
     ResponseSendCallback response_send_callback_;
+    CancelSendCallback cancel_send_callback_;
+    
+    // Requests we forwarded, so a cancel can follow them (pruned at deadline)
+    struct ForwardedRequest {
+        NodeID next_hop;
+        uint64_t expires_ms;
+    };
+    std::unordered_map<Hash256, ForwardedRequest> forwarded_requests_;
+    std::unordered_map<Hash256, uint64_t> cancelled_requests_;  // id -> expires_ms
+    
+    // Recent successful fetch latencies (microseconds) for the hedge delay
+    static constexpr size_t LATENCY_WINDOW = 128;
+    static constexpr size_t MIN_LATENCY_SAMPLES = 16;
+    std::vector<uint64_t> latency_samples_;
+    size_t latency_next_ = 0;
+    std::chrono::milliseconds hedge_delay_{DEFAULT_HEDGE_DELAY};
+    
+    // Periodic process_hedges
+    std::shared_ptr<utils::MaintenanceScheduler> maintenance_;
+    uint64_t hedge_task_ = 0;
     
     // Statistics
-    uint64_t requests_sent_;
-    uint64_t requests_received_;
-    uint64_t responses_sent_;
-    uint64_t responses_received_;
-    uint64_t forwards_;
+    std::atomic<uint64_t> requests_sent_;
+    std::atomic<uint64_t> requests_received_;
+    std::atomic<uint64_t> responses_sent_;
+    std::atomic<uint64_t> responses_received_;
+    std::atomic<uint64_t> forwards_;
+    std::atomic<uint64_t> hedges_sent_{0};
+    std::atomic<uint64_t> hedge_wins_{0};
+    std::atomic<uint64_t> deadline_drops_{0};
+    std::atomic<uint64_t> coalesced_requests_{0};
     
     // Request ID generation
     uint64_t next_request_counter_;
     
     // Helpers
     Hash256 generate_request_id();
-    NodeID select_next_hop(const ContentHash& content_hash) const;
+    std::optional<NodeID> select_next_hop(const ContentHash& content_hash) const;
     bool should_forward_request(const ContentRequest& request) const;
     bool can_serve_locally(const ContentHash& content_hash) const;
+    void resolve_waiters(const ContentHash& content_hash, std::optional<std::vector<uint8_t>> content);
+    void record_latency(std::chrono::microseconds latency);
+    bool send_hedge(PendingRequest& pending);
+    void fail_request(const Hash256& request_id);
+    PendingRequest take_pending(std::map<Hash256, PendingRequest>::iterator it);
+    void prune_forwarded(uint64_t now_ms);
     
     // Onion routing helpers
     std::vector<std::vector<uint8_t>> create_onion_layers(
@@ -275,6 +444,7 @@ private:
     // Transport integration points (wired by higher-level networking components).
     void send_request_to_peer(const NodeID& peer_id, const ContentRequest& request);
     void send_response_to_peer(const NodeID& peer_id, const ContentResponse& response);
+    void send_cancel_to_peer(const NodeID& peer_id, const Hash256& request_id);
 };
 
 /**
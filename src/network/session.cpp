@@ -1,4 +1,5 @@
 #include "session.hpp"
+#include "cashew/time_utils.hpp"
 #include "utils/logger.hpp"
 #include "crypto/random.hpp"
 #include "crypto/blake3.hpp"
@@ -406,12 +407,10 @@ bool Session::should_rekey() const {
 }
 
 bool Session::has_timed_out() const {
-    auto now = std::chrono::system_clock::now();
-    uint64_t now_seconds = 
-        std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+    const uint64_t now_seconds = time::CoarseClock::now_seconds();
     
-    uint64_t idle = now_seconds - last_activity_timestamp_;
-    return idle >= IDLE_TIMEOUT_SECONDS;
+    return now_seconds > last_activity_timestamp_ &&
+           now_seconds - last_activity_timestamp_ >= IDLE_TIMEOUT_SECONDS;
 }
 
 uint64_t Session::get_age_seconds() const {
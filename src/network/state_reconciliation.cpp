@@ -3,7 +3,6 @@
 #include "crypto/blake3.hpp"
 #include <algorithm>
 #include <chrono>
-#include <set>
 
 namespace cashew::network {
 
@@ -47,14 +46,14 @@ std::optional<StateConflict> StateReconciliation::detect_conflict(
     conflict.peer_id = peer_id;
     conflict.detected_at = current_timestamp();
     
-    // Get our events for comparison.
-    conflict.local_events = ledger_.get_all_events();
+    // Compare against our ledger in place rather than copying it.
+    conflict.local_event_count = ledger_.event_count();
     conflict.remote_events = peer_events;
     
     // Classify the specific type of conflict
     conflict.type = classify_conflict(
         local_hash, peer_hash,
-        conflict.local_events, conflict.remote_events
+        conflict.local_event_count, conflict.remote_events
     );
     
     conflict.description = "Ledger state divergence detected";
@@ -251,6 +250,7 @@ MergeResult StateReconciliation::reconcile_with_quorum(
     conflict.epoch = current_epoch;
     conflict.local_hash = our_hash;
     conflict.remote_hash = quorum_hash;
+    conflict.local_event_count = ledger_.event_count();
     conflict.remote_events = hash_to_events[quorum_hash];
     conflict.detected_at = current_timestamp();
     conflict.description = "Local state differs from quorum consensus";
@@ -272,14 +272,8 @@ std::vector<ledger::LedgerEvent> StateReconciliation::find_missing_events(
 ) {
     std::vector<ledger::LedgerEvent> missing;
 
-    const auto local_events = ledger_.get_all_events();
-    std::set<Hash256> local_event_ids;
-    for (const auto& event : local_events) {
-        local_event_ids.insert(event.event_id);
-    }
-
     for (const auto& remote_event : remote_events) {
-        if (local_event_ids.find(remote_event.event_id) == local_event_ids.end()) {
+        if (!ledger_.contains_event(remote_event.event_id)) {
             missing.push_back(remote_event);
         }
     }
@@ -292,14 +286,14 @@ std::vector<ledger::LedgerEvent> StateReconciliation::find_missing_events(
 ConflictType StateReconciliation::classify_conflict(
     const Hash256& local_hash,
     const Hash256& remote_hash,
-    const std::vector<ledger::LedgerEvent>& local_events,
+    size_t local_event_count,
     const std::vector<ledger::LedgerEvent>& remote_events
 ) {
     if (local_hash == remote_hash) {
         return ConflictType::HASH_MISMATCH; // Shouldn't happen
     }
     
-    if (local_events.size() != remote_events.size()) {
+    if (local_event_count != remote_events.size()) {
         return ConflictType::MISSING_EVENTS;
     }
     
@@ -376,7 +370,7 @@ bool StateReconciliation::apply_merge_both(const StateConflict& conflict) {
 }
 
 bool StateReconciliation::apply_highest_work(const StateConflict& conflict) {
-    uint32_t local_work = calculate_proof_of_work(conflict.local_events);
+    uint32_t local_work = calculate_proof_of_work(ledger_.events_of_type(ledger::EventType::KEY_ISSUED));
     uint32_t remote_work = calculate_proof_of_work(conflict.remote_events);
     
     CASHEW_LOG_INFO("PoW comparison: local={}, remote={}", local_work, remote_work);
@@ -388,6 +382,20 @@ bool StateReconciliation::apply_highest_work(const StateConflict& conflict) {
     }
 }
 
+uint32_t StateReconciliation::calculate_proof_of_work(
+    const ledger::EventRange& events
+) {
+    uint32_t total_work = 0;
+    
+    for (const auto& event : events) {
+        if (event.event_type == ledger::EventType::KEY_ISSUED) {
+            total_work += 1;
+        }
+    }
+    
+    return total_work;
+}
+
 uint32_t StateReconciliation::calculate_proof_of_work(
     const std::vector<ledger::LedgerEvent>& events
 ) {
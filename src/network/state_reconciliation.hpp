@@ -31,7 +31,7 @@ struct StateConflict {
     Hash256 local_hash;
     Hash256 remote_hash;
     
-    std::vector<ledger::LedgerEvent> local_events;
+    size_t local_event_count;  // Local events are read from the ledger in place
     std::vector<ledger::LedgerEvent> remote_events;
     
     NodeID peer_id;
@@ -135,7 +135,7 @@ private:
     ConflictType classify_conflict(
         const Hash256& local_hash,
         const Hash256& remote_hash,
-        const std::vector<ledger::LedgerEvent>& local_events,
+        size_t local_event_count,
         const std::vector<ledger::LedgerEvent>& remote_events
     );
     
@@ -146,6 +146,7 @@ private:
     bool apply_merge_both(const StateConflict& conflict);
     bool apply_highest_work(const StateConflict& conflict);
     
+    uint32_t calculate_proof_of_work(const ledger::EventRange& events);
     uint32_t calculate_proof_of_work(const std::vector<ledger::LedgerEvent>& events);
     Hash256 compute_state_hash(const std::vector<ledger::LedgerEvent>& events, uint64_t epoch);
     
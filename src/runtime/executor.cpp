@@ -0,0 +1,303 @@
+#include "runtime/executor.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+
+namespace cashew::runtime {
+
+namespace {
+
+thread_local Executor* tls_executor = nullptr;
+thread_local size_t tls_worker_index = 0;
+
+size_t resolve_worker_count(size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+detail::Detached run_spawned(Executor* executor, Task<void> task, Priority priority) {
+    co_await executor->schedule(priority);
+    try {
+        co_await std::move(task);
+    } catch (const std::exception& e) {
+        CASHEW_LOG_ERROR("Spawned task failed: {}", e.what());
+    } catch (...) {
+        CASHEW_LOG_ERROR("Spawned task failed with unknown exception");
+    }
+}
+
+} // namespace
+
+Executor::Executor(size_t worker_count)
+    : bulk_limit_(std::max<size_t>(1, resolve_worker_count(worker_count) - 1))
+{
+    const size_t count = resolve_worker_count(worker_count);
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+Executor::~Executor() {
+    stop();
+}
+
+void Executor::start() {
+    if (running_) {
+        return;
+    }
+
+    stopping_ = false;
+    running_ = true;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&Executor::worker_loop, this, i);
+    }
+    timer_thread_ = std::thread(&Executor::timer_loop, this);
+
+    CASHEW_LOG_INFO("Runtime executor started ({} workers, {} for bulk work)",
+                    workers_.size(), bulk_limit_);
+}
+
+void Executor::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> idle_lock(idle_mutex_);
+        std::lock_guard<std::mutex> timer_lock(timer_mutex_);
+        stopping_ = true;
+    }
+    idle_cv_.notify_all();
+    timer_cv_.notify_all();
+
+    if (timer_thread_.joinable()) {
+        timer_thread_.join();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    size_t dropped_timers = 0;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        dropped_timers = timers_.size();
+        timers_.clear();
+    }
+
+    running_ = false;
+    CASHEW_LOG_INFO("Runtime executor stopped ({} pending timers dropped)", dropped_timers);
+}
+
+void Executor::submit(Job job, Priority priority) {
+    const size_t level = static_cast<size_t>(priority);
+    submitted_++;
+    queued_[level]++;  // Count first so a racing pop never underflows
+
+    if (tls_executor == this) {
+        Worker& worker = *workers_[tls_worker_index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.queues[level].push_back(std::move(job));
+    } else {
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        inject_queues_[level].push_back(std::move(job));
+    }
+
+    notify_workers();
+}
+
+void Executor::submit_after(std::chrono::milliseconds delay, Job job, Priority priority) {
+    if (delay.count() <= 0) {
+        submit(std::move(job), priority);
+        return;
+    }
+
+    const auto due = std::chrono::steady_clock::now() + delay;
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        timers_.emplace(due, Timer{std::move(job), priority});
+    }
+    timer_cv_.notify_one();
+}
+
+void Executor::spawn(Task<void> task, Priority priority) {
+    run_spawned(this, std::move(task), priority);
+}
+
+Executor* Executor::current() {
+    return tls_executor;
+}
+
+Executor::Statistics Executor::get_statistics() const {
+    Statistics stats{};
+    stats.submitted = submitted_;
+    stats.executed = executed_;
+    stats.stolen = stolen_;
+    stats.timers_fired = timers_fired_;
+    stats.failures = failures_;
+    for (const auto& count : queued_) {
+        stats.queued += count;
+    }
+    {
+        std::lock_guard<std::mutex> lock(timer_mutex_);
+        stats.pending_timers = timers_.size();
+    }
+    stats.workers = workers_.size();
+    return stats;
+}
+
+void Executor::worker_loop(size_t index) {
+    tls_executor = this;
+    tls_worker_index = index;
+
+    while (true) {
+        Job job;
+        Priority taken = Priority::NORMAL;
+        if (try_take(index, job, taken)) {
+            try {
+                job();
+            } catch (const std::exception& e) {
+                failures_++;
+                CASHEW_LOG_ERROR("Executor job failed: {}", e.what());
+            } catch (...) {
+                failures_++;
+                CASHEW_LOG_ERROR("Executor job failed with unknown exception");
+            }
+            executed_++;
+
+            if (taken == Priority::BULK) {
+                bulk_running_--;
+                notify_workers();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        const auto drained = [this]() {
+            return stopping_ && queued_[0] + queued_[1] + queued_[2] == 0;
+        };
+        idle_cv_.wait(lock, [this, &drained]() { return drained() || has_runnable_work(); });
+        if (drained()) {
+            break;
+        }
+    }
+
+    tls_executor = nullptr;
+}
+
+void Executor::timer_loop() {
+    std::unique_lock<std::mutex> lock(timer_mutex_);
+
+    while (!stopping_) {
+        if (timers_.empty()) {
+            timer_cv_.wait(lock, [this]() { return stopping_ || !timers_.empty(); });
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto next_due = timers_.begin()->first;
+        if (now < next_due) {
+            // Re-check on wake: an earlier timer may have been added
+            timer_cv_.wait_until(lock, next_due);
+            continue;
+        }
+
+        std::vector<Timer> due;
+        auto end = timers_.upper_bound(now);
+        for (auto it = timers_.begin(); it != end; ++it) {
+            due.push_back(std::move(it->second));
+        }
+        timers_.erase(timers_.begin(), end);
+
+        lock.unlock();
+        for (auto& timer : due) {
+            timers_fired_++;
+            submit(std::move(timer.job), timer.priority);
+        }
+        lock.lock();
+    }
+}
+
+bool Executor::has_runnable_work() const {
+    if (queued_[0] + queued_[1] > 0) {
+        return true;
+    }
+    return queued_[2] > 0 && bulk_running_ < bulk_limit_;
+}
+
+bool Executor::try_take(size_t index, Job& job, Priority& taken) {
+    for (size_t level = 0; level < PRIORITY_LEVELS; ++level) {
+        const bool bulk = (level == static_cast<size_t>(Priority::BULK));
+        if (bulk && bulk_running_.fetch_add(1) >= bulk_limit_) {
+            bulk_running_--;
+            continue;  // Keep a worker free for latency-sensitive jobs
+        }
+
+        if (pop_local(index, level, job) || pop_injected(level, job) || steal(index, level, job)) {
+            queued_[level]--;
+            taken = static_cast<Priority>(level);
+            return true;
+        }
+
+        if (bulk) {
+            bulk_running_--;
+            if (queued_[level] > 0) {
+                notify_workers();  // Our reservation may have hidden the job from a sleeper
+            }
+        }
+    }
+    return false;
+}
+
+bool Executor::pop_local(size_t index, size_t level, Job& job) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    auto& queue = worker.queues[level];
+    if (queue.empty()) {
+        return false;
+    }
+    job = std::move(queue.back());
+    queue.pop_back();
+    return true;
+}
+
+bool Executor::pop_injected(size_t level, Job& job) {
+    std::lock_guard<std::mutex> lock(inject_mutex_);
+    auto& queue = inject_queues_[level];
+    if (queue.empty()) {
+        return false;
+    }
+    job = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+bool Executor::steal(size_t thief, size_t level, Job& job) {
+    const size_t count = workers_.size();
+    for (size_t offset = 1; offset < count; ++offset) {
+        Worker& victim = *workers_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        auto& queue = victim.queues[level];
+        if (queue.empty()) {
+            continue;
+        }
+        job = std::move(queue.front());
+        queue.pop_front();
+        stolen_++;
+        return true;
+    }
+    return false;
+}
+
+void Executor::notify_workers() {
+    {
+        // Pairs with the predicate check in worker_loop so wakeups are not lost
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+    }
+    idle_cv_.notify_one();
+}
+
+} // namespace cashew::runtime
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "runtime/task.hpp"
+#include <cstdint>
+#include <array>
+#include <deque>
+#include <map>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace cashew::runtime {
+
+/**
+ * Priority - Scheduling class for executor jobs
+ *
+ * Workers always drain LATENCY before NORMAL before BULK. BULK jobs
+ * (signature batches, hashing, blocking storage/socket calls) may occupy at
+ * most worker_count - 1 workers, so one worker is always free for
+ * latency-sensitive work.
+ */
+enum class Priority : uint8_t {
+    LATENCY = 0,
+    NORMAL = 1,
+    BULK = 2
+};
+
+/**
+ * Executor - Work-stealing thread pool for the node runtime
+ *
+ * Each worker owns one deque per priority. Jobs submitted from a worker go
+ * to the back of its own deque and are popped LIFO (cache-warm); idle
+ * workers steal from the front of other workers' deques. Jobs submitted from
+ * outside the pool go through a shared injection queue.
+ *
+ * Coroutines hop onto the pool with co_await schedule(), sleep with
+ * co_await sleep_for(), and push blocking calls off latency-sensitive
+ * workers with co_await run(fn, Priority::BULK).
+ *
+ * Thread-safe.
+ */
+class Executor {
+public:
+    using Job = std::function<void()>;
+
+    static constexpr size_t PRIORITY_LEVELS = 3;
+
+    /**
+     * @param worker_count Number of workers (0 = hardware concurrency)
+     */
+    explicit Executor(size_t worker_count = 0);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Start/stop the worker and timer threads; stop() runs queued jobs first
+    void start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    /**
+     * Queue job for execution
+     */
+    void submit(Job job, Priority priority = Priority::NORMAL);
+
+    /**
+     * Queue job once delay has elapsed
+     */
+    void submit_after(std::chrono::milliseconds delay, Job job, Priority priority = Priority::NORMAL);
+
+    /**
+     * Awaitable: continue the coroutine on a worker at priority
+     */
+    auto schedule(Priority priority = Priority::NORMAL) {
+        struct Awaiter {
+            Executor* executor;
+            Priority priority;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const {
+                executor->submit([handle]() { handle.resume(); }, priority);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this, priority};
+    }
+
+    /**
+     * Awaitable: continue the coroutine on a worker after delay
+     */
+    auto sleep_for(std::chrono::milliseconds delay, Priority priority = Priority::NORMAL) {
+        struct Awaiter {
+            Executor* executor;
+            std::chrono::milliseconds delay;
+            Priority priority;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) const {
+                executor->submit_after(delay, [handle]() { handle.resume(); }, priority);
+            }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{this, delay, priority};
+    }
+
+    /**
+     * Run fn on a worker at priority and return its result
+     *
+     * After a BULK job the awaiting coroutine is moved back to NORMAL so it
+     * does not keep holding a bulk slot.
+     */
+    template<typename F>
+    Task<std::invoke_result_t<F&>> run(F fn, Priority priority = Priority::BULK) {
+        using Result = std::invoke_result_t<F&>;
+        co_await schedule(priority);
+
+        if constexpr (std::is_void_v<Result>) {
+            fn();
+            if (priority == Priority::BULK) {
+                co_await schedule(Priority::NORMAL);
+            }
+        } else {
+            Result result = fn();
+            if (priority == Priority::BULK) {
+                co_await schedule(Priority::NORMAL);
+            }
+            co_return result;
+        }
+    }
+
+    /**
+     * Start task on the pool without waiting for it; exceptions are logged
+     */
+    void spawn(Task<void> task, Priority priority = Priority::NORMAL);
+
+    /**
+     * Executor owning the calling worker thread (nullptr off-pool)
+     */
+    static Executor* current();
+
+    size_t worker_count() const { return workers_.size(); }
+
+    // Statistics
+    struct Statistics {
+        uint64_t submitted;
+        uint64_t executed;
+        uint64_t stolen;
+        uint64_t timers_fired;
+        uint64_t failures;
+        size_t queued;
+        size_t pending_timers;
+        size_t workers;
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::array<std::deque<Job>, PRIORITY_LEVELS> queues;
+        std::thread thread;
+    };
+
+    struct Timer {
+        Job job;
+        Priority priority;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    const size_t bulk_limit_;
+
+    std::mutex inject_mutex_;
+    std::array<std::deque<Job>, PRIORITY_LEVELS> inject_queues_;
+
+    std::array<std::atomic<size_t>, PRIORITY_LEVELS> queued_{};
+    std::atomic<size_t> bulk_running_{0};
+
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    mutable std::mutex timer_mutex_;
+    std::condition_variable timer_cv_;
+    std::multimap<std::chrono::steady_clock::time_point, Timer> timers_;
+    std::thread timer_thread_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> stolen_{0};
+    std::atomic<uint64_t> timers_fired_{0};
+    std::atomic<uint64_t> failures_{0};
+
+    void worker_loop(size_t index);
+    void timer_loop();
+
+    bool has_runnable_work() const;
+    bool try_take(size_t index, Job& job, Priority& taken);
+    bool pop_local(size_t index, size_t level, Job& job);
+    bool pop_injected(size_t level, Job& job);
+    bool steal(size_t thief, size_t level, Job& job);
+    void notify_workers();
+};
+
+/**
+ * Completion - One-shot value that a coroutine can co_await
+ *
+ * Bridges callback-driven code (peer responses, socket completions) into
+ * coroutines: the callback calls set(), the awaiting coroutine resumes on
+ * the executor it was running on (or inline if it was awaited off-pool).
+ * Copies share state. At most one coroutine may await a Completion.
+ */
+template<typename T>
+class Completion {
+public:
+    Completion() : state_(std::make_shared<State>()) {}
+
+    /**
+     * Publish value and wake the awaiting coroutine
+     * @return false if a value was already set
+     */
+    bool set(T value) const {
+        std::coroutine_handle<> waiter;
+        Executor* executor = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (state_->value) {
+                return false;
+            }
+            state_->value.emplace(std::move(value));
+            waiter = std::exchange(state_->waiter, {});
+            executor = state_->executor;
+        }
+
+        if (waiter) {
+            if (executor && executor->is_running()) {
+                executor->submit([waiter]() { waiter.resume(); }, Priority::LATENCY);
+            } else {
+                waiter.resume();
+            }
+        }
+        return true;
+    }
+
+    bool is_set() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        return state_->value.has_value();
+    }
+
+    auto operator co_await() const noexcept {
+        struct Awaiter {
+            std::shared_ptr<State> state;
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle) const {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->value) {
+                    return false;  // Already set: continue without suspending
+                }
+                state->waiter = handle;
+                state->executor = Executor::current();
+                return true;
+            }
+
+            T await_resume() const {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                return std::move(*state->value);
+            }
+        };
+        return Awaiter{state_};
+    }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::optional<T> value;
+        std::coroutine_handle<> waiter;
+        Executor* executor = nullptr;
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace cashew::runtime
@@ -81,7 +81,8 @@ AccessDecision AccessDecision::deny(const std::string& reason) {
 // AccessControl methods
 
 AccessControl::AccessControl(ledger::StateManager& state_manager)
-    : state_manager_(state_manager)
+    : state_manager_(state_manager),
+      cache_stats_{}
 {
     initialize_default_policies();
     CASHEW_LOG_INFO("AccessControl initialized");
@@ -212,19 +213,67 @@ void AccessControl::initialize_default_policies() {
 
 void AccessControl::set_policy(Capability capability, const AccessPolicy& policy) {
     policies_[capability] = policy;
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    decision_cache_.clear();
 }
 
 AccessPolicy AccessControl::get_policy(Capability capability) const {
+    return policy_for(capability);
+}
+
+const AccessPolicy& AccessControl::policy_for(Capability capability) const {
+    static const AccessPolicy empty_policy;  // Empty policy (deny all)
     auto it = policies_.find(capability);
     if (it == policies_.end()) {
-        return AccessPolicy{};  // Empty policy (deny all)
+        return empty_policy;
     }
     return it->second;
 }
 
 AccessDecision AccessControl::check_access(const AccessRequest& request) const {
-    auto policy = get_policy(request.capability);
+    const AccessPolicy& policy = policy_for(request.capability);
+    
+    // PoW-gated decisions depend on the submitted solution, not just on state
+    if (policy.requires_pow) {
+        return evaluate_access(request, policy);
+    }
     
+    DecisionKey key{request.requester, request.capability, false, Hash256{}};
+    if (policy.requires_network_membership && request.network_id) {
+        key.has_network = true;
+        key.network_id = *request.network_id;
+    }
+    
+    const uint64_t state_generation = state_manager_.state_generation();
+    const uint64_t node_generation = state_manager_.node_generation(request.requester);
+    
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = decision_cache_.find(key);
+        if (it != decision_cache_.end() &&
+            it->second.state_generation == state_generation &&
+            it->second.node_generation == node_generation) {
+            cache_stats_.decision_hits++;
+            return AccessDecision{it->second.granted, it->second.reason, std::nullopt};
+        }
+        cache_stats_.decision_misses++;
+    }
+    
+    AccessDecision decision = evaluate_access(request, policy);
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (decision_cache_.size() >= MAX_CACHED_DECISIONS) {
+        decision_cache_.clear();
+    }
+    decision_cache_[key] = CachedDecision{state_generation, node_generation,
+                                          decision.granted, decision.reason};
+    return decision;
+}
+
+AccessDecision AccessControl::evaluate_access(const AccessRequest& request,
+                                              const AccessPolicy& policy) const
+{
     // Check if node is active
     if (!state_manager_.is_node_active(request.requester)) {
         return AccessDecision::deny("Node is not active");
@@ -313,7 +362,7 @@ bool AccessControl::can_vouch_for_node(const NodeID& voucher, const NodeID& vouc
 }
 
 bool AccessControl::can_create_network(const NodeID& node_id) const {
-    auto policy = get_policy(Capability::CREATE_NETWORK);
+    const auto& policy = policy_for(Capability::CREATE_NETWORK);
     
     if (!check_key_requirements(node_id, policy)) {
         return false;
@@ -323,7 +372,7 @@ bool AccessControl::can_create_network(const NodeID& node_id) const {
 }
 
 bool AccessControl::can_issue_invitation(const NodeID& node_id, const Hash256& network_id) const {
-    auto policy = get_policy(Capability::ISSUE_INVITATIONS);
+    const auto& policy = policy_for(Capability::ISSUE_INVITATIONS);
     
     if (!check_key_requirements(node_id, policy)) {
         return false;
@@ -333,7 +382,7 @@ bool AccessControl::can_issue_invitation(const NodeID& node_id, const Hash256& n
 }
 
 bool AccessControl::can_moderate_content(const NodeID& node_id, const Hash256& network_id) const {
-    auto policy = get_policy(Capability::MODERATE_CONTENT);
+    const auto& policy = policy_for(Capability::MODERATE_CONTENT);
     
     if (!check_reputation_requirements(node_id, policy)) {
         return false;
@@ -390,8 +439,40 @@ bool AccessControl::verify_token(const CapabilityToken& token) const {
     if (token.is_expired()) {
         return false;
     }
-
-    return token.signature == derive_token_signature(token);
+    
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = token_cache_.find(token.signature);
+        if (it != token_cache_.end() &&
+            it->second.node_id == token.node_id &&
+            it->second.capability == token.capability &&
+            it->second.issued_at == token.issued_at &&
+            it->second.expires_at == token.expires_at &&
+            it->second.context == token.context) {
+            cache_stats_.token_hits++;
+            return true;
+        }
+        cache_stats_.token_misses++;
+    }
+    
+    if (token.signature != derive_token_signature(token)) {
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (token_cache_.size() >= MAX_CACHED_TOKENS) {
+        // Drop expired tokens first; start over if everything is still live
+        const uint64_t now = static_cast<uint64_t>(
+            std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+        for (auto it = token_cache_.begin(); it != token_cache_.end();) {
+            it = (it->second.expires_at <= now) ? token_cache_.erase(it) : std::next(it);
+        }
+        if (token_cache_.size() >= MAX_CACHED_TOKENS) {
+            token_cache_.clear();
+        }
+    }
+    token_cache_[token.signature] = token;
+    return true;
 }
 
 AccessLevel AccessControl::get_access_level(const NodeID& node_id) const {
@@ -447,6 +528,20 @@ size_t AccessControl::count_nodes_with_capability(Capability capability) const {
     return count;
 }
 
+AccessControl::CacheStatistics AccessControl::get_cache_statistics() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    CacheStatistics stats = cache_stats_;
+    stats.cached_decisions = decision_cache_.size();
+    stats.cached_tokens = token_cache_.size();
+    return stats;
+}
+
+void AccessControl::clear_caches() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    decision_cache_.clear();
+    token_cache_.clear();
+}
+
 bool AccessControl::check_key_requirements(const NodeID& node_id, const AccessPolicy& policy) const {
     if (policy.required_key_count == 0) {
         return true;  // No key requirement
@@ -484,13 +579,8 @@ bool AccessControl::check_network_requirements(const NodeID& node_id,
     }
     
     if (policy.required_role) {
-        auto network_state = state_manager_.get_network_state(network_id);
-        if (!network_state) {
-            return false;
-        }
-        
-        std::string actual_role = network_state->get_member_role(node_id);
-        return actual_role == *policy.required_role;
+        auto actual_role = state_manager_.get_member_role(node_id, network_id);
+        return actual_role && *actual_role == *policy.required_role;
     }
     
     return true;
@@ -512,13 +602,8 @@ bool AccessControl::check_pow_requirements(const std::vector<uint8_t>& pow_solut
 }
 
 bool AccessControl::is_network_founder(const NodeID& node_id, const Hash256& network_id) const {
-    auto network_state = state_manager_.get_network_state(network_id);
-    if (!network_state) {
-        return false;
-    }
-    
-    std::string role = network_state->get_member_role(node_id);
-    return role == "FOUNDER";
+    auto role = state_manager_.get_member_role(node_id, network_id);
+    return role && *role == "FOUNDER";
 }
 
 bool AccessControl::has_any_keys(const NodeID& node_id) const {
@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <unordered_map>
+#include <mutex>
 
 namespace cashew::security {
 
@@ -136,6 +138,11 @@ struct AccessDecision {
  * 
  * This implements the access control model described in your notes:
  * "Viewing is free, but to *do* stuff you need keys"
+ * 
+ * Decisions for (node, capability, network) are memoized and stamped with
+ * the StateManager generations they were computed at; a ledger event that
+ * touches the node (or a global state change) makes the entry stale.
+ * Verified tokens are remembered until they expire.
  */
 class AccessControl {
 public:
@@ -180,10 +187,74 @@ public:
     // Statistics
     size_t count_nodes_with_capability(Capability capability) const;
     
+    struct CacheStatistics {
+        uint64_t decision_hits;
+        uint64_t decision_misses;
+        uint64_t token_hits;
+        uint64_t token_misses;
+        size_t cached_decisions;
+        size_t cached_tokens;
+    };
+    
+    CacheStatistics get_cache_statistics() const;
+    void clear_caches();
+    
 private:
+    static constexpr size_t MAX_CACHED_DECISIONS = 65536;
+    static constexpr size_t MAX_CACHED_TOKENS = 16384;
+    
+    struct DecisionKey {
+        NodeID node_id;
+        Capability capability;
+        bool has_network;
+        Hash256 network_id;
+        
+        bool operator==(const DecisionKey& other) const {
+            return node_id == other.node_id && capability == other.capability &&
+                   has_network == other.has_network && network_id == other.network_id;
+        }
+    };
+    
+    struct DecisionKeyHash {
+        size_t operator()(const DecisionKey& key) const {
+            size_t h = std::hash<Hash256>()(key.node_id.id);
+            h ^= static_cast<size_t>(key.capability) * 0x9E3779B97F4A7C15ULL;
+            if (key.has_network) {
+                h ^= std::hash<Hash256>()(key.network_id) + 0x7F4A7C15ULL + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
+    
+    struct CachedDecision {
+        uint64_t state_generation;
+        uint64_t node_generation;
+        bool granted;
+        std::string reason;
+    };
+    
+    struct SignatureHash {
+        size_t operator()(const Signature& signature) const {
+            size_t h = 0;
+            for (size_t i = 0; i < 8; ++i) {
+                h = (h << 8) | signature[i];
+            }
+            return h;
+        }
+    };
+    
     ledger::StateManager& state_manager_;
     std::map<Capability, AccessPolicy> policies_;
     
+    // Memoized decisions and verified tokens
+    mutable std::mutex cache_mutex_;
+    mutable std::unordered_map<DecisionKey, CachedDecision, DecisionKeyHash> decision_cache_;
+    mutable std::unordered_map<Signature, CapabilityToken, SignatureHash> token_cache_;
+    mutable CacheStatistics cache_stats_;
+    
+    const AccessPolicy& policy_for(Capability capability) const;
+    AccessDecision evaluate_access(const AccessRequest& request, const AccessPolicy& policy) const;
+    
     // Default policies
     void initialize_default_policies();
     
@@ -0,0 +1,645 @@
+#include "security/admission.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+// Platform-specific includes
+#ifdef CASHEW_PLATFORM_WINDOWS
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+#endif
+
+namespace cashew::security {
+
+namespace {
+
+constexpr uint64_t EMPTY_BUCKET = std::numeric_limits<uint64_t>::max();
+constexpr uint8_t IPV4_MAPPED_OFFSET = 96;  // ::ffff:0:0/96
+
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t prefix_mask(uint8_t bits) {
+    return bits == 0 ? 0 : (~0ULL << (64 - bits));
+}
+
+uint64_t load_be64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+size_t round_up_pow2(size_t v) {
+    size_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+} // anonymous namespace
+
+// IPKey methods
+
+std::optional<IPKey> IPKey::parse(const std::string& address) {
+    std::string text = address;
+    if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+        text = text.substr(1, text.size() - 2);
+    }
+    if (text.empty()) {
+        return std::nullopt;
+    }
+
+    IPKey key;
+    if (text.find(':') == std::string::npos) {
+        in_addr v4{};
+        if (inet_pton(AF_INET, text.c_str(), &v4) != 1) {
+            return std::nullopt;
+        }
+        uint8_t raw[4];
+        std::memcpy(raw, &v4, sizeof(raw));
+        key.hi = 0;
+        key.lo = 0x0000FFFF00000000ULL |
+                 (static_cast<uint64_t>(raw[0]) << 24) |
+                 (static_cast<uint64_t>(raw[1]) << 16) |
+                 (static_cast<uint64_t>(raw[2]) << 8) |
+                 static_cast<uint64_t>(raw[3]);
+        key.family = IPFamily::IPv4;
+        return key;
+    }
+
+    in6_addr v6{};
+    if (inet_pton(AF_INET6, text.c_str(), &v6) != 1) {
+        return std::nullopt;
+    }
+    uint8_t raw[16];
+    std::memcpy(raw, &v6, sizeof(raw));
+    key.hi = load_be64(raw);
+    key.lo = load_be64(raw + 8);
+
+    // Treat IPv4-mapped IPv6 literals as IPv4 so they share limits
+    key.family = (key.hi == 0 && (key.lo >> 32) == 0xFFFF) ? IPFamily::IPv4 : IPFamily::IPv6;
+    return key;
+}
+
+std::optional<std::pair<IPKey, uint8_t>> IPKey::parse_cidr(const std::string& cidr) {
+    auto slash = cidr.find('/');
+    auto key = parse(cidr.substr(0, slash));
+    if (!key) {
+        return std::nullopt;
+    }
+
+    uint8_t prefix_len = 128;
+    if (slash != std::string::npos) {
+        const std::string len_str = cidr.substr(slash + 1);
+        if (len_str.empty() || len_str.size() > 3 ||
+            !std::all_of(len_str.begin(), len_str.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return std::nullopt;
+        }
+        const int len = std::stoi(len_str);
+        const int max_len = (key->family == IPFamily::IPv4) ? 32 : 128;
+        if (len > max_len) {
+            return std::nullopt;
+        }
+        prefix_len = static_cast<uint8_t>(key->family == IPFamily::IPv4 ? len + IPV4_MAPPED_OFFSET : len);
+    }
+
+    return std::make_pair(key->masked(prefix_len), prefix_len);
+}
+
+IPKey IPKey::from_opaque(const std::string& identifier) {
+    // FNV-1a over the identifier, split into two independent halves
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (unsigned char c : identifier) {
+        h ^= c;
+        h *= 0x100000001B3ULL;
+    }
+
+    IPKey key;
+    key.hi = mix64(h);
+    key.lo = mix64(h ^ 0x5851F42D4C957F2DULL);
+    key.family = IPFamily::OPAQUE;
+    return key;
+}
+
+IPKey IPKey::masked(uint8_t prefix_len) const {
+    IPKey out = *this;
+    if (prefix_len >= 128) {
+        return out;
+    }
+    if (prefix_len <= 64) {
+        out.hi &= prefix_mask(prefix_len);
+        out.lo = 0;
+    } else {
+        out.lo &= prefix_mask(static_cast<uint8_t>(prefix_len - 64));
+    }
+    return out;
+}
+
+bool IPKey::bit(size_t index) const {
+    if (index < 64) {
+        return (hi >> (63 - index)) & 1;
+    }
+    return (lo >> (127 - index)) & 1;
+}
+
+// PrefixTrie methods
+
+PrefixTrie::PrefixTrie(size_t max_nodes)
+    : max_nodes_(std::max<size_t>(max_nodes, 1)),
+      entry_count_(0)
+{
+    nodes_.emplace_back();  // Root
+}
+
+std::optional<uint32_t> PrefixTrie::allocate_node() {
+    if (!free_list_.empty()) {
+        uint32_t index = free_list_.back();
+        free_list_.pop_back();
+        nodes_[index] = Node();
+        return index;
+    }
+    if (nodes_.size() >= max_nodes_) {
+        return std::nullopt;
+    }
+    if (nodes_.size() == nodes_.capacity()) {
+        // Grow geometrically but never past the configured pool size
+        nodes_.reserve(std::min(max_nodes_, std::max<size_t>(nodes_.capacity() * 2, 64)));
+    }
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+bool PrefixTrie::insert(const IPKey& key, uint8_t prefix_len, uint64_t expiry_time) {
+    prefix_len = std::min<uint8_t>(prefix_len, 128);
+
+    uint32_t node = 0;
+    for (size_t depth = 0; depth < prefix_len; ++depth) {
+        const int b = key.bit(depth) ? 1 : 0;
+        if (nodes_[node].child[b] == NO_CHILD) {
+            auto allocated = allocate_node();
+            if (!allocated) {
+                return false;
+            }
+            nodes_[node].child[b] = *allocated;
+        }
+        node = nodes_[node].child[b];
+    }
+
+    if (nodes_[node].expiry_time == 0) {
+        entry_count_++;
+    }
+    nodes_[node].expiry_time = std::max(nodes_[node].expiry_time, expiry_time);
+    return true;
+}
+
+bool PrefixTrie::remove(const IPKey& key, uint8_t prefix_len) {
+    prefix_len = std::min<uint8_t>(prefix_len, 128);
+
+    uint32_t node = 0;
+    for (size_t depth = 0; depth < prefix_len; ++depth) {
+        node = nodes_[node].child[key.bit(depth) ? 1 : 0];
+        if (node == NO_CHILD) {
+            return false;
+        }
+    }
+
+    if (nodes_[node].expiry_time == 0) {
+        return false;
+    }
+    nodes_[node].expiry_time = 0;
+    entry_count_--;
+    return true;
+}
+
+std::optional<uint64_t> PrefixTrie::match(const IPKey& key, uint64_t now) const {
+    uint32_t node = 0;
+    for (size_t depth = 0; ; ++depth) {
+        if (nodes_[node].expiry_time > now) {
+            return nodes_[node].expiry_time;
+        }
+        if (depth == 128) {
+            break;
+        }
+        node = nodes_[node].child[key.bit(depth) ? 1 : 0];
+        if (node == NO_CHILD) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+size_t PrefixTrie::prune(uint64_t now) {
+    size_t removed = 0;
+    prune_node(0, now, removed);
+    return removed;
+}
+
+bool PrefixTrie::prune_node(uint32_t index, uint64_t now, size_t& removed) {
+    for (int b = 0; b < 2; ++b) {
+        uint32_t child = nodes_[index].child[b];
+        if (child != NO_CHILD && prune_node(child, now, removed)) {
+            nodes_[index].child[b] = NO_CHILD;
+            free_list_.push_back(child);
+        }
+    }
+
+    Node& node = nodes_[index];
+    if (node.expiry_time != 0 && node.expiry_time <= now) {
+        node.expiry_time = 0;
+        entry_count_--;
+        removed++;
+    }
+
+    return node.expiry_time == 0 && node.child[0] == NO_CHILD && node.child[1] == NO_CHILD;
+}
+
+// SlidingWindowSketch methods
+
+SlidingWindowSketch::SlidingWindowSketch(
+    size_t width,
+    size_t depth,
+    uint64_t window_seconds,
+    size_t bucket_count
+)
+    : width_mask_(round_up_pow2(std::max<size_t>(width, 1)) - 1),
+      depth_(std::max<size_t>(depth, 1)),
+      bucket_count_(std::max<size_t>(bucket_count, 1)),
+      bucket_seconds_(std::max<uint64_t>(window_seconds / std::max<size_t>(bucket_count, 1), 1)),
+      counters_(bucket_count_ * depth_ * (width_mask_ + 1), 0),
+      bucket_epochs_(bucket_count_, EMPTY_BUCKET),
+      bucket_totals_(bucket_count_, 0)
+{
+}
+
+size_t SlidingWindowSketch::column(const IPKey& key, size_t row) const {
+    uint64_t h = mix64(key.hi ^ ((row + 1) * 0x9E3779B97F4A7C15ULL));
+    h = mix64(h ^ key.lo);
+    return static_cast<size_t>(h) & width_mask_;
+}
+
+uint32_t* SlidingWindowSketch::bucket_row(size_t bucket, size_t row) {
+    return counters_.data() + (bucket * depth_ + row) * (width_mask_ + 1);
+}
+
+const uint32_t* SlidingWindowSketch::bucket_row(size_t bucket, size_t row) const {
+    return counters_.data() + (bucket * depth_ + row) * (width_mask_ + 1);
+}
+
+bool SlidingWindowSketch::bucket_live(size_t bucket, uint64_t slot) const {
+    const uint64_t epoch = bucket_epochs_[bucket];
+    return epoch != EMPTY_BUCKET && epoch <= slot && slot - epoch < bucket_count_;
+}
+
+uint32_t SlidingWindowSketch::add(const IPKey& key, uint64_t now, uint32_t count) {
+    const uint64_t slot = now / bucket_seconds_;
+    const size_t bucket = static_cast<size_t>(slot % bucket_count_);
+
+    if (bucket_epochs_[bucket] != slot) {
+        // Bucket rotated out of the window: recycle it for the current slot
+        std::fill_n(bucket_row(bucket, 0), depth_ * (width_mask_ + 1), 0u);
+        bucket_epochs_[bucket] = slot;
+        bucket_totals_[bucket] = 0;
+    }
+
+    // Conservative update: only raise counters that hold the current minimum
+    uint32_t current = std::numeric_limits<uint32_t>::max();
+    for (size_t row = 0; row < depth_; ++row) {
+        current = std::min(current, bucket_row(bucket, row)[column(key, row)]);
+    }
+    const uint64_t raised = static_cast<uint64_t>(current) + count;
+    const uint32_t target = static_cast<uint32_t>(
+        std::min<uint64_t>(raised, std::numeric_limits<uint32_t>::max()));
+    for (size_t row = 0; row < depth_; ++row) {
+        uint32_t& counter = bucket_row(bucket, row)[column(key, row)];
+        counter = std::max(counter, target);
+    }
+    bucket_totals_[bucket] += count;
+
+    return estimate(key, now);
+}
+
+uint32_t SlidingWindowSketch::estimate(const IPKey& key, uint64_t now) const {
+    const uint64_t slot = now / bucket_seconds_;
+    uint64_t sum = 0;
+
+    for (size_t bucket = 0; bucket < bucket_count_; ++bucket) {
+        if (!bucket_live(bucket, slot)) {
+            continue;
+        }
+        uint32_t bucket_min = std::numeric_limits<uint32_t>::max();
+        for (size_t row = 0; row < depth_; ++row) {
+            bucket_min = std::min(bucket_min, bucket_row(bucket, row)[column(key, row)]);
+        }
+        sum += bucket_min;
+    }
+
+    return static_cast<uint32_t>(std::min<uint64_t>(sum, std::numeric_limits<uint32_t>::max()));
+}
+
+uint64_t SlidingWindowSketch::total(uint64_t now) const {
+    const uint64_t slot = now / bucket_seconds_;
+    uint64_t sum = 0;
+    for (size_t bucket = 0; bucket < bucket_count_; ++bucket) {
+        if (bucket_live(bucket, slot)) {
+            sum += bucket_totals_[bucket];
+        }
+    }
+    return sum;
+}
+
+// IPAdmissionEngine methods
+
+std::string admission_decision_to_string(AdmissionDecision decision) {
+    switch (decision) {
+        case AdmissionDecision::ALLOW: return "allow";
+        case AdmissionDecision::BLOCKED: return "blocked";
+        case AdmissionDecision::IP_RATE_LIMITED: return "ip_rate_limited";
+        case AdmissionDecision::SUBNET_RATE_LIMITED: return "subnet_rate_limited";
+        case AdmissionDecision::CONNECTION_LIMITED: return "connection_limited";
+        default: return "unknown";
+    }
+}
+
+IPAdmissionEngine::IPAdmissionEngine(const AdmissionPolicy& policy)
+    : policy_(policy),
+      blocks_(std::make_shared<BlockTable>(policy.max_trie_nodes)),
+      ip_minute_(policy.sketch_width, policy.sketch_depth, 60, 6),
+      ip_hour_(policy.sketch_width, policy.sketch_depth, 3600, 12),
+      subnet_minute_(policy.sketch_width, policy.sketch_depth, 60, 6),
+      active_width_(round_up_pow2(std::max<size_t>(policy.sketch_width, 1))),
+      active_depth_(std::max<size_t>(policy.sketch_depth, 1)),
+      active_counters_(active_width_ * active_depth_, 0),
+      stats_{}
+{
+    CASHEW_LOG_INFO("IPAdmissionEngine initialized ({}/min per IP, {}/min per subnet, {} KB)",
+                   policy_.max_per_ip_per_minute,
+                   policy_.max_per_subnet_per_minute,
+                   get_statistics().memory_bytes / 1024);
+}
+
+IPKey IPAdmissionEngine::key_for(const std::string& ip_address) const {
+    if (auto parsed = IPKey::parse(ip_address)) {
+        return *parsed;
+    }
+    return IPKey::from_opaque(ip_address);
+}
+
+IPKey IPAdmissionEngine::subnet_of(const IPKey& key) const {
+    switch (key.family) {
+        case IPFamily::IPv4:
+            return key.masked(static_cast<uint8_t>(IPV4_MAPPED_OFFSET + std::min<uint8_t>(policy_.ipv4_subnet_prefix, 32)));
+        case IPFamily::IPv6:
+            return key.masked(std::min<uint8_t>(policy_.ipv6_subnet_prefix, 128));
+        default:
+            return key;
+    }
+}
+
+AdmissionDecision IPAdmissionEngine::admit_request(const std::string& ip_address) {
+    return admit_request(ip_address, current_timestamp());
+}
+
+AdmissionDecision IPAdmissionEngine::admit_request(const std::string& ip_address, uint64_t now) {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return check_locked(key, now);
+}
+
+AdmissionDecision IPAdmissionEngine::admit_connection(const std::string& ip_address) {
+    return admit_connection(ip_address, current_timestamp());
+}
+
+AdmissionDecision IPAdmissionEngine::admit_connection(const std::string& ip_address, uint64_t now) {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (policy_.max_active_per_ip > 0 &&
+        !blocked_locked(key, now) &&
+        active_estimate_locked(key) >= policy_.max_active_per_ip) {
+        stats_.total_checks++;
+        stats_.connection_limited++;
+        if (policy_.connection_block_seconds > 0) {
+            block_locked(key, 128, now + policy_.connection_block_seconds, now);
+        }
+        return AdmissionDecision::CONNECTION_LIMITED;
+    }
+
+    return check_locked(key, now);
+}
+
+AdmissionDecision IPAdmissionEngine::check_locked(const IPKey& key, uint64_t now) {
+    stats_.total_checks++;
+
+    if (blocked_locked(key, now)) {
+        stats_.blocked++;
+        return AdmissionDecision::BLOCKED;
+    }
+
+    const IPKey subnet = subnet_of(key);
+    const uint32_t per_minute = ip_minute_.add(key, now);
+    const uint32_t per_hour = ip_hour_.add(key, now);
+    const uint32_t per_subnet = subnet_minute_.add(subnet, now);
+
+    if (per_minute > policy_.max_per_ip_per_minute || per_hour > policy_.max_per_ip_per_hour) {
+        stats_.ip_rate_limited++;
+        if (policy_.rate_block_seconds > 0) {
+            block_locked(key, 128, now + policy_.rate_block_seconds, now);
+        }
+        return AdmissionDecision::IP_RATE_LIMITED;
+    }
+
+    if (policy_.max_per_subnet_per_minute > 0 && per_subnet > policy_.max_per_subnet_per_minute) {
+        stats_.subnet_rate_limited++;
+        if (policy_.rate_block_seconds > 0 && key.family != IPFamily::OPAQUE) {
+            const uint8_t prefix_len = key.family == IPFamily::IPv4
+                ? static_cast<uint8_t>(IPV4_MAPPED_OFFSET + std::min<uint8_t>(policy_.ipv4_subnet_prefix, 32))
+                : std::min<uint8_t>(policy_.ipv6_subnet_prefix, 128);
+            block_locked(subnet, prefix_len, now + policy_.rate_block_seconds, now);
+        }
+        return AdmissionDecision::SUBNET_RATE_LIMITED;
+    }
+
+    stats_.allowed++;
+    return AdmissionDecision::ALLOW;
+}
+
+bool IPAdmissionEngine::blocked_locked(const IPKey& key, uint64_t now) const {
+    std::lock_guard<std::mutex> lock(blocks_->mutex);
+    return blocks_->trie.match(key, now).has_value();
+}
+
+void IPAdmissionEngine::on_connection_opened(const std::string& ip_address) {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t row = 0; row < active_depth_; ++row) {
+        uint32_t& counter = active_counters_[active_index(key, row)];
+        if (counter < std::numeric_limits<uint32_t>::max()) {
+            counter++;
+        }
+    }
+}
+
+void IPAdmissionEngine::on_connection_closed(const std::string& ip_address) {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (size_t row = 0; row < active_depth_; ++row) {
+        uint32_t& counter = active_counters_[active_index(key, row)];
+        if (counter > 0) {
+            counter--;
+        }
+    }
+}
+
+uint32_t IPAdmissionEngine::active_connections(const std::string& ip_address) const {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_estimate_locked(key);
+}
+
+uint32_t IPAdmissionEngine::active_estimate_locked(const IPKey& key) const {
+    uint32_t estimate = std::numeric_limits<uint32_t>::max();
+    for (size_t row = 0; row < active_depth_; ++row) {
+        estimate = std::min(estimate, active_counters_[active_index(key, row)]);
+    }
+    return estimate;
+}
+
+size_t IPAdmissionEngine::active_index(const IPKey& key, size_t row) const {
+    const uint64_t h = mix64(key.hi ^ mix64(key.lo + row));
+    return row * active_width_ + static_cast<size_t>(h & (active_width_ - 1));
+}
+
+void IPAdmissionEngine::block(const std::string& ip_address, uint64_t duration_seconds) {
+    block(ip_address, duration_seconds, current_timestamp());
+}
+
+void IPAdmissionEngine::block(const std::string& ip_address, uint64_t duration_seconds, uint64_t now) {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+    block_locked(key, 128, now + duration_seconds, now);
+}
+
+bool IPAdmissionEngine::block_prefix(const std::string& cidr, uint64_t duration_seconds) {
+    auto parsed = IPKey::parse_cidr(cidr);
+    if (!parsed) {
+        CASHEW_LOG_WARN("Invalid CIDR prefix: {}", cidr);
+        return false;
+    }
+
+    const uint64_t now = current_timestamp();
+    std::lock_guard<std::mutex> lock(mutex_);
+    block_locked(parsed->first, parsed->second, now + duration_seconds, now);
+    return true;
+}
+
+bool IPAdmissionEngine::unblock(const std::string& ip_address) {
+    if (auto parsed = IPKey::parse_cidr(ip_address)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::lock_guard<std::mutex> blocks_lock(blocks_->mutex);
+        return blocks_->trie.remove(parsed->first, parsed->second);
+    }
+
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> blocks_lock(blocks_->mutex);
+    return blocks_->trie.remove(key, 128);
+}
+
+void IPAdmissionEngine::block_locked(const IPKey& key, uint8_t prefix_len, uint64_t expiry_time, uint64_t now) {
+    std::lock_guard<std::mutex> lock(blocks_->mutex);
+    PrefixTrie& trie = blocks_->trie;
+    if (trie.insert(key, prefix_len, expiry_time)) {
+        return;
+    }
+
+    // Pool exhausted: reclaim expired entries and retry once
+    trie.prune(now);
+    if (!trie.insert(key, prefix_len, expiry_time)) {
+        if (stats_.blocks_dropped++ == 0) {
+            CASHEW_LOG_WARN("Admission block table full ({} nodes), dropping new blocks", trie.capacity());
+        }
+    }
+}
+
+bool IPAdmissionEngine::is_blocked(const std::string& ip_address) const {
+    return is_blocked(ip_address, current_timestamp());
+}
+
+bool IPAdmissionEngine::is_blocked(const std::string& ip_address, uint64_t now) const {
+    const IPKey key = key_for(ip_address);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return blocked_locked(key, now);
+}
+
+void IPAdmissionEngine::share_blocks_with(const IPAdmissionEngine& other) {
+    // One engine mutex at a time, so two engines sharing with each other
+    // cannot deadlock
+    std::shared_ptr<BlockTable> table;
+    {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        table = other.blocks_;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocks_ = std::move(table);
+}
+
+uint64_t IPAdmissionEngine::recent_admissions() const {
+    return recent_admissions(current_timestamp());
+}
+
+uint64_t IPAdmissionEngine::recent_admissions(uint64_t now) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ip_minute_.total(now);
+}
+
+void IPAdmissionEngine::cleanup() {
+    const uint64_t now = current_timestamp();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> blocks_lock(blocks_->mutex);
+    size_t removed = blocks_->trie.prune(now);
+    if (removed > 0) {
+        CASHEW_LOG_DEBUG("Admission engine released {} expired blocks", removed);
+    }
+}
+
+IPAdmissionEngine::Statistics IPAdmissionEngine::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> blocks_lock(blocks_->mutex);
+    Statistics stats = stats_;
+    stats.blocked_prefixes = blocks_->trie.entry_count();
+    stats.memory_bytes = blocks_->trie.memory_bytes() +
+                         ip_minute_.memory_bytes() +
+                         ip_hour_.memory_bytes() +
+                         subnet_minute_.memory_bytes() +
+                         active_counters_.size() * sizeof(uint32_t);
+    return stats;
+}
+
+size_t IPAdmissionEngine::blocked_prefix_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> blocks_lock(blocks_->mutex);
+    return blocks_->trie.entry_count();
+}
+
+uint64_t IPAdmissionEngine::current_timestamp() const {
+    auto now = std::chrono::system_clock::now();
+    auto now_time_t = std::chrono::system_clock::to_time_t(now);
+    return static_cast<uint64_t>(now_time_t);
+}
+
+} // namespace cashew::security
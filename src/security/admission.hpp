@@ -0,0 +1,325 @@
+#pragma once
+
+#include "cashew/common.hpp"
+#include <vector>
+#include <string>
+#include <optional>
+#include <memory>
+#include <mutex>
+
+namespace cashew::security {
+
+/**
+ * IPFamily - Origin of an IPKey
+ */
+enum class IPFamily {
+    IPv4,
+    IPv6,
+    OPAQUE  // Not an IP literal; hashed identifier
+};
+
+/**
+ * IPKey - IPv4/IPv6 address as a 128-bit key
+ *
+ * IPv4 addresses are stored IPv4-mapped (::ffff:a.b.c.d) so both families
+ * share one key space and one prefix trie.
+ */
+struct IPKey {
+    uint64_t hi;
+    uint64_t lo;
+    IPFamily family;
+
+    IPKey() : hi(0), lo(0), family(IPFamily::OPAQUE) {}
+
+    /**
+     * Parse textual IPv4/IPv6 address (optional [brackets] are stripped)
+     */
+    static std::optional<IPKey> parse(const std::string& address);
+
+    /**
+     * Parse CIDR notation ("10.0.0.0/8", "2001:db8::/32")
+     * @return key and prefix length in the 128-bit key space
+     */
+    static std::optional<std::pair<IPKey, uint8_t>> parse_cidr(const std::string& cidr);
+
+    /**
+     * Key for identifiers that are not IP literals (hashed into the key space)
+     */
+    static IPKey from_opaque(const std::string& identifier);
+
+    /**
+     * Keep the first prefix_len bits (128-bit key space), zero the rest
+     */
+    IPKey masked(uint8_t prefix_len) const;
+
+    bool bit(size_t index) const;
+
+    bool operator==(const IPKey& other) const { return hi == other.hi && lo == other.lo; }
+};
+
+/**
+ * PrefixTrie - Binary trie of blocked IPv4/IPv6 prefixes
+ *
+ * Nodes live in a fixed-capacity pool, so memory is bounded no matter how
+ * many addresses are blocked. A lookup walks at most 128 levels.
+ */
+class PrefixTrie {
+public:
+    explicit PrefixTrie(size_t max_nodes);
+
+    /**
+     * Insert prefix with expiry time
+     * @return false if the node pool is exhausted
+     */
+    bool insert(const IPKey& key, uint8_t prefix_len, uint64_t expiry_time);
+
+    /**
+     * Remove exact prefix entry
+     */
+    bool remove(const IPKey& key, uint8_t prefix_len);
+
+    /**
+     * Find unexpired entry covering key
+     * @return expiry time of the covering entry
+     */
+    std::optional<uint64_t> match(const IPKey& key, uint64_t now) const;
+
+    /**
+     * Drop expired entries and release empty branches
+     * @return number of entries removed
+     */
+    size_t prune(uint64_t now);
+
+    size_t entry_count() const { return entry_count_; }
+    size_t node_count() const { return nodes_.size() - free_list_.size(); }
+    size_t capacity() const { return max_nodes_; }
+    size_t memory_bytes() const { return nodes_.capacity() * sizeof(Node); }
+
+private:
+    static constexpr uint32_t NO_CHILD = 0;  // Node 0 is the root
+
+    struct Node {
+        uint32_t child[2];
+        uint64_t expiry_time;  // 0 = no entry at this prefix
+
+        Node() : child{NO_CHILD, NO_CHILD}, expiry_time(0) {}
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_list_;
+    size_t max_nodes_;
+    size_t entry_count_;
+
+    std::optional<uint32_t> allocate_node();
+    bool prune_node(uint32_t index, uint64_t now, size_t& removed);
+};
+
+/**
+ * SlidingWindowSketch - Count-min sketch over rotating time buckets
+ *
+ * Estimates per-key event counts over the last window_seconds using
+ * width x depth counters per bucket. Estimates never undercount; memory is
+ * fixed at construction.
+ */
+class SlidingWindowSketch {
+public:
+    SlidingWindowSketch(size_t width, size_t depth, uint64_t window_seconds, size_t bucket_count);
+
+    /**
+     * Record events for key
+     * @return estimated count in window including this addition
+     */
+    uint32_t add(const IPKey& key, uint64_t now, uint32_t count = 1);
+
+    /**
+     * Estimated count for key in window
+     */
+    uint32_t estimate(const IPKey& key, uint64_t now) const;
+
+    /**
+     * Exact total of all events in window
+     */
+    uint64_t total(uint64_t now) const;
+
+    uint64_t window_seconds() const { return bucket_seconds_ * bucket_count_; }
+    size_t memory_bytes() const { return counters_.size() * sizeof(uint32_t); }
+
+private:
+    size_t width_mask_;
+    size_t depth_;
+    size_t bucket_count_;
+    uint64_t bucket_seconds_;
+
+    std::vector<uint32_t> counters_;       // [bucket][row][column]
+    std::vector<uint64_t> bucket_epochs_;  // Time slot each bucket currently holds
+    std::vector<uint64_t> bucket_totals_;
+
+    size_t column(const IPKey& key, size_t row) const;
+    uint32_t* bucket_row(size_t bucket, size_t row);
+    const uint32_t* bucket_row(size_t bucket, size_t row) const;
+    bool bucket_live(size_t bucket, uint64_t slot) const;
+};
+
+/**
+ * AdmissionPolicy - Limits applied by IPAdmissionEngine
+ */
+struct AdmissionPolicy {
+    uint32_t max_per_ip_per_minute;
+    uint32_t max_per_ip_per_hour;
+    uint32_t max_per_subnet_per_minute;   // 0 = no subnet limit
+    uint32_t max_active_per_ip;           // 0 = no concurrent limit
+
+    uint8_t ipv4_subnet_prefix;           // Aggregate IPv4 clients by /24
+    uint8_t ipv6_subnet_prefix;           // Aggregate IPv6 clients by /64
+
+    uint64_t rate_block_seconds;          // Auto-block after rate violation (0 = off)
+    uint64_t connection_block_seconds;    // Auto-block after concurrency violation (0 = off)
+
+    size_t sketch_width;
+    size_t sketch_depth;
+    size_t max_trie_nodes;
+
+    AdmissionPolicy()
+        : max_per_ip_per_minute(60),
+          max_per_ip_per_hour(1000),
+          max_per_subnet_per_minute(1200),
+          max_active_per_ip(0),
+          ipv4_subnet_prefix(24),
+          ipv6_subnet_prefix(64),
+          rate_block_seconds(0),
+          connection_block_seconds(0),
+          sketch_width(1024),
+          sketch_depth(4),
+          max_trie_nodes(1 << 16) {}
+};
+
+/**
+ * AdmissionDecision - Outcome of an admission check
+ */
+enum class AdmissionDecision {
+    ALLOW,
+    BLOCKED,
+    IP_RATE_LIMITED,
+    SUBNET_RATE_LIMITED,
+    CONNECTION_LIMITED
+};
+
+std::string admission_decision_to_string(AdmissionDecision decision);
+
+/**
+ * IPAdmissionEngine - Fixed-memory admission control for inbound traffic
+ *
+ * Used by the gateway (per HTTP request) and the P2P accept path (per
+ * connection), one engine each so that neither's traffic counts against
+ * the other's limits; the two can share one block list. Every decision
+ * costs a bounded trie walk plus a few sketch probes, and memory does not
+ * grow with the number of source IPs.
+ *
+ * Thread-safe.
+ */
+class IPAdmissionEngine {
+public:
+    explicit IPAdmissionEngine(const AdmissionPolicy& policy = AdmissionPolicy());
+    ~IPAdmissionEngine() = default;
+
+    /**
+     * Admit a request: block check, then per-IP and per-subnet rate windows
+     */
+    AdmissionDecision admit_request(const std::string& ip_address);
+    AdmissionDecision admit_request(const std::string& ip_address, uint64_t now);
+
+    /**
+     * Admit a new connection: request checks plus concurrent-connection limit
+     */
+    AdmissionDecision admit_connection(const std::string& ip_address);
+    AdmissionDecision admit_connection(const std::string& ip_address, uint64_t now);
+
+    /**
+     * Track concurrent connections per IP
+     */
+    void on_connection_opened(const std::string& ip_address);
+    void on_connection_closed(const std::string& ip_address);
+    uint32_t active_connections(const std::string& ip_address) const;
+
+    /**
+     * Block a single address or a CIDR prefix
+     */
+    void block(const std::string& ip_address, uint64_t duration_seconds);
+    void block(const std::string& ip_address, uint64_t duration_seconds, uint64_t now);
+    bool block_prefix(const std::string& cidr, uint64_t duration_seconds);
+    bool unblock(const std::string& ip_address);
+
+    bool is_blocked(const std::string& ip_address) const;
+    bool is_blocked(const std::string& ip_address, uint64_t now) const;
+
+    /**
+     * Use other's block list from now on (blocks set here so far are dropped)
+     *
+     * Only blocks are shared; policy, rate windows and connection counts
+     * stay with each engine.
+     */
+    void share_blocks_with(const IPAdmissionEngine& other);
+
+    /**
+     * Admissions recorded across all sources in the last minute
+     */
+    uint64_t recent_admissions() const;
+    uint64_t recent_admissions(uint64_t now) const;
+
+    /**
+     * Drop expired blocks
+     */
+    void cleanup();
+
+    // Statistics
+    struct Statistics {
+        uint64_t total_checks;
+        uint64_t allowed;
+        uint64_t blocked;
+        uint64_t ip_rate_limited;
+        uint64_t subnet_rate_limited;
+        uint64_t connection_limited;
+        uint64_t blocks_dropped;  // Blocks refused because the trie pool was full
+        size_t blocked_prefixes;
+        size_t memory_bytes;
+    };
+
+    Statistics get_statistics() const;
+    size_t blocked_prefix_count() const;
+    const AdmissionPolicy& get_policy() const { return policy_; }
+
+private:
+    AdmissionPolicy policy_;
+
+    // Block list, possibly shared with other engines; its mutex nests
+    // inside the owning engine's mutex_
+    struct BlockTable {
+        explicit BlockTable(size_t max_nodes) : trie(max_nodes) {}
+        mutable std::mutex mutex;
+        PrefixTrie trie;
+    };
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<BlockTable> blocks_;
+    SlidingWindowSketch ip_minute_;
+    SlidingWindowSketch ip_hour_;
+    SlidingWindowSketch subnet_minute_;
+    size_t active_width_;
+    size_t active_depth_;
+    std::vector<uint32_t> active_counters_;  // Counting sketch, no time decay
+
+    Statistics stats_;
+
+    IPKey key_for(const std::string& ip_address) const;
+    IPKey subnet_of(const IPKey& key) const;
+
+    AdmissionDecision check_locked(const IPKey& key, uint64_t now);
+    bool blocked_locked(const IPKey& key, uint64_t now) const;
+    void block_locked(const IPKey& key, uint8_t prefix_len, uint64_t expiry_time, uint64_t now);
+    uint32_t active_estimate_locked(const IPKey& key) const;
+    size_t active_index(const IPKey& key, size_t row) const;
+
+    uint64_t current_timestamp() const;
+};
+
+} // namespace cashew::security
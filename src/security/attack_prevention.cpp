@@ -268,131 +268,74 @@ bool SybilDefense::verify_pow_difficulty(const Hash256& pow_proof, uint32_t diff
 // DDoSMitigation methods
 
 DDoSMitigation::DDoSMitigation()
-    : total_connections_(0), blocked_connections_(0)
+    : DDoSMitigation(std::make_shared<IPAdmissionEngine>(default_policy()))
 {
-    CASHEW_LOG_INFO("DDoSMitigation initialized (max {}/IP)", MAX_CONNECTIONS_PER_IP);
+}
+
+DDoSMitigation::DDoSMitigation(std::shared_ptr<IPAdmissionEngine> engine)
+    : engine_(std::move(engine)), total_connections_(0), blocked_connections_(0)
+{
+    CASHEW_LOG_INFO("DDoSMitigation initialized (max {}/IP)",
+                   engine_->get_policy().max_active_per_ip);
+}
+
+AdmissionPolicy DDoSMitigation::default_policy() {
+    AdmissionPolicy policy;
+    policy.max_active_per_ip = MAX_CONNECTIONS_PER_IP;
+    policy.connection_block_seconds = CONNECTION_LIMIT_BLOCK_SECONDS;
+    return policy;
 }
 
 bool DDoSMitigation::allow_connection(const std::string& ip_address) {
-    // Check if IP is blocked
-    if (is_blocked(ip_address)) {
-        blocked_connections_++;
-        return false;
+    AdmissionDecision decision = engine_->admit_connection(ip_address);
+    if (decision == AdmissionDecision::ALLOW) {
+        return true;
     }
     
-    auto& info = ip_connections_[ip_address];
-    
-    // Check connection limit
-    if (exceeds_connection_limit(info)) {
+    if (decision == AdmissionDecision::CONNECTION_LIMITED) {
         CASHEW_LOG_WARN("Connection limit exceeded for IP: {}", ip_address);
-        block_ip(ip_address, 3600);  // Block for 1 hour
-        blocked_connections_++;
-        return false;
+    } else if (decision != AdmissionDecision::BLOCKED) {
+        CASHEW_LOG_DEBUG("Connection from {} refused: {}",
+                        ip_address, admission_decision_to_string(decision));
     }
     
-    return true;
+    blocked_connections_++;
+    return false;
 }
 
 void DDoSMitigation::record_connection(const std::string& ip_address) {
-    auto& info = ip_connections_[ip_address];
-    info.active_connections++;
-    info.total_connections++;
-    
-    uint64_t current = current_timestamp();
-    info.last_connection_time = current;
-    info.connection_timestamps.push_back(current);
-    
-    // Keep only last 100 timestamps
-    if (info.connection_timestamps.size() > 100) {
-        info.connection_timestamps.erase(info.connection_timestamps.begin());
-    }
-    
+    engine_->on_connection_opened(ip_address);
     total_connections_++;
 }
 
 void DDoSMitigation::close_connection(const std::string& ip_address) {
-    auto it = ip_connections_.find(ip_address);
-    if (it != ip_connections_.end() && it->second.active_connections > 0) {
-        it->second.active_connections--;
-    }
+    engine_->on_connection_closed(ip_address);
 }
 
 void DDoSMitigation::block_ip(const std::string& ip_address, uint64_t duration_seconds) {
-    uint64_t current = current_timestamp();
-    
-    BlockEntry entry;
-    entry.block_time = current;
-    entry.expiry_time = current + duration_seconds;
-    entry.reason = "Rate limit exceeded";
-    
-    blocked_ips_[ip_address] = entry;
-    
+    engine_->block(ip_address, duration_seconds);
     CASHEW_LOG_WARN("Blocked IP {} for {}s", ip_address, duration_seconds);
 }
 
 bool DDoSMitigation::is_blocked(const std::string& ip_address) const {
-    auto it = blocked_ips_.find(ip_address);
-    if (it == blocked_ips_.end()) {
-        return false;
-    }
-    
-    uint64_t current = current_timestamp();
-    return current < it->second.expiry_time;
+    return engine_->is_blocked(ip_address);
 }
 
 bool DDoSMitigation::detect_attack_pattern() const {
-    uint64_t current = current_timestamp();
-    
-    // Count connections in last minute
-    size_t recent_connections = 0;
-    
-    for (const auto& [ip, info] : ip_connections_) {
-        for (const auto& timestamp : info.connection_timestamps) {
-            if (current - timestamp <= 60) {
-                recent_connections++;
-            }
-        }
-    }
-    
-    return recent_connections >= ATTACK_THRESHOLD_CONNECTIONS_PER_MINUTE;
+    // Connections in the last minute, read from the engine's window totals
+    return engine_->recent_admissions() >= ATTACK_THRESHOLD_CONNECTIONS_PER_MINUTE;
 }
 
 float DDoSMitigation::get_threat_level() const {
-    if (ip_connections_.empty()) {
-        return 0.0f;
-    }
-    
-    // Calculate based on blocked IPs ratio and connection rates
-    float blocked_ratio = static_cast<float>(blocked_ips_.size()) / 
-                         static_cast<float>(ip_connections_.size());
+    // Scale by how far the last minute's admission rate exceeds the attack threshold
+    float rate_pressure = static_cast<float>(engine_->recent_admissions()) /
+                         static_cast<float>(2 * ATTACK_THRESHOLD_CONNECTIONS_PER_MINUTE);
     
-    return std::min(blocked_ratio * 2.0f, 1.0f);
+    return std::min(rate_pressure, 1.0f);
 }
 
 void DDoSMitigation::cleanup_expired_blocks() {
-    uint64_t current = current_timestamp();
-    std::vector<std::string> to_unblock;
-    
-    for (const auto& [ip, entry] : blocked_ips_) {
-        if (current >= entry.expiry_time) {
-            to_unblock.push_back(ip);
-        }
-    }
-    
-    for (const auto& ip : to_unblock) {
-        blocked_ips_.erase(ip);
-        CASHEW_LOG_DEBUG("Unblocked IP: {}", ip);
-    }
-}
-
-uint64_t DDoSMitigation::current_timestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    return static_cast<uint64_t>(now_time_t);
-}
-
-bool DDoSMitigation::exceeds_connection_limit(const IPConnectionInfo& info) const {
-    return info.active_connections >= MAX_CONNECTIONS_PER_IP;
+    engine_->cleanup();
 }
 
 // ForkDetector methods
@@ -651,6 +594,14 @@ void AttackPreventionCoordinator::set_rate_limit_policy(const RateLimitPolicy& p
     rate_limiter_ = RateLimiter(policy);
 }
 
+void AttackPreventionCoordinator::set_admission_engine(std::shared_ptr<IPAdmissionEngine> engine) {
+    // Only the block list is shared: another component's traffic must not
+    // count toward the attack threshold, nor its policy replace the per-IP cap
+    if (engine) {
+        ddos_mitigation_.get_admission_engine()->share_blocks_with(*engine);
+    }
+}
+
 uint64_t AttackPreventionCoordinator::current_timestamp() const {
     auto now = std::chrono::system_clock::now();
     auto now_time_t = std::chrono::system_clock::to_time_t(now);
@@ -3,6 +3,7 @@
 #include "cashew/common.hpp"
 #include "core/ledger/ledger.hpp"
 #include "core/reputation/reputation.hpp"
+#include "security/admission.hpp"
 #include <vector>
 #include <map>
 #include <set>
@@ -154,10 +155,15 @@ private:
  * - Connection limiting per IP
  * - Challenge-response for suspicious traffic
  * - Adaptive throttling
+ * 
+ * Per-IP state lives in an IPAdmissionEngine (prefix trie + sketches), so
+ * memory stays fixed under floods. Its block list can be shared with the
+ * gateway's engine; connection counts and the per-IP cap stay its own.
  */
 class DDoSMitigation {
 public:
     DDoSMitigation();
+    explicit DDoSMitigation(std::shared_ptr<IPAdmissionEngine> engine);
     ~DDoSMitigation() = default;
     
     /**
@@ -204,38 +210,26 @@ public:
      */
     void cleanup_expired_blocks();
     
+    /**
+     * Admission engine backing this mitigation (its blocks can be shared)
+     */
+    std::shared_ptr<IPAdmissionEngine> get_admission_engine() const { return engine_; }
+    
     // Statistics
     uint64_t get_total_connections() const { return total_connections_; }
     uint64_t get_blocked_connections() const { return blocked_connections_; }
-    size_t get_blocked_ips_count() const { return blocked_ips_.size(); }
+    size_t get_blocked_ips_count() const { return engine_->blocked_prefix_count(); }
     
-private:
-    struct IPConnectionInfo {
-        size_t active_connections;
-        uint64_t total_connections;
-        uint64_t last_connection_time;
-        std::vector<uint64_t> connection_timestamps;  // Last 100 connections
-        
-        IPConnectionInfo() 
-            : active_connections(0), total_connections(0), last_connection_time(0) {}
-    };
-    
-    struct BlockEntry {
-        uint64_t block_time;
-        uint64_t expiry_time;
-        std::string reason;
-    };
+    static AdmissionPolicy default_policy();
     
-    std::map<std::string, IPConnectionInfo> ip_connections_;
-    std::map<std::string, BlockEntry> blocked_ips_;
+private:
+    std::shared_ptr<IPAdmissionEngine> engine_;
     uint64_t total_connections_;
     uint64_t blocked_connections_;
     
     static constexpr size_t MAX_CONNECTIONS_PER_IP = 10;
     static constexpr size_t ATTACK_THRESHOLD_CONNECTIONS_PER_MINUTE = 50;
-    
-    uint64_t current_timestamp() const;
-    bool exceeds_connection_limit(const IPConnectionInfo& info) const;
+    static constexpr uint64_t CONNECTION_LIMIT_BLOCK_SECONDS = 3600;
 };
 
 /**
@@ -368,6 +362,11 @@ public:
     void enable_sybil_defense(bool enable) { sybil_defense_enabled_ = enable; }
     void enable_ddos_mitigation(bool enable) { ddos_mitigation_enabled_ = enable; }
     void enable_fork_detection(bool enable) { fork_detection_enabled_ = enable; }
+    // Share engine's block list; connection limits stay the mitigation's own
+    void set_admission_engine(std::shared_ptr<IPAdmissionEngine> engine);
+    std::shared_ptr<IPAdmissionEngine> get_admission_engine() const {
+        return ddos_mitigation_.get_admission_engine();
+    }
     
 private:
     ledger::Ledger& ledger_;
@@ -1,4 +1,5 @@
 #include "security/ip_protection.hpp"
+#include "cashew/time_utils.hpp"
 #include "crypto/random.hpp"
 #include "crypto/blake3.hpp"
 #include "utils/logger.hpp"
@@ -19,11 +20,9 @@ uint64_t ConnectionInfo::connection_duration() const {
 }
 
 bool ConnectionInfo::is_stale(uint64_t stale_threshold_seconds) const {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    uint64_t current = static_cast<uint64_t>(now_time_t);
+    const uint64_t current = time::CoarseClock::now_seconds();
     
-    return (current - last_activity_time) > stale_threshold_seconds;
+    return current > last_activity_time && (current - last_activity_time) > stale_threshold_seconds;
 }
 
 // EphemeralAddress methods
@@ -151,6 +151,13 @@ std::vector<uint8_t> RevocationListUpdate::to_bytes() const {
     // Source node (32 bytes)
     data.insert(data.end(), source_node.id.begin(), source_node.id.end());
     
+    // Versions (3 x 8 bytes)
+    for (uint64_t v : {since_version, version, head_version}) {
+        for (int i = 0; i < 8; i++) {
+            data.push_back(static_cast<uint8_t>(v >> (i * 8)));
+        }
+    }
+    
     // Number of revocations (4 bytes)
     uint32_t count = static_cast<uint32_t>(revocations.size());
     for (int i = 0; i < 4; i++) {
@@ -174,7 +181,7 @@ std::vector<uint8_t> RevocationListUpdate::to_bytes() const {
 }
 
 std::optional<RevocationListUpdate> RevocationListUpdate::from_bytes(const std::vector<uint8_t>& data) {
-    if (data.size() < 8 + 32 + 4 + 64) {
+    if (data.size() < 8 + 32 + 24 + 4 + 64) {
         return std::nullopt;
     }
     
@@ -191,6 +198,14 @@ std::optional<RevocationListUpdate> RevocationListUpdate::from_bytes(const std::
     std::copy(data.begin() + offset, data.begin() + offset + 32, update.source_node.id.begin());
     offset += 32;
     
+    // Versions
+    for (uint64_t* v : {&update.since_version, &update.version, &update.head_version}) {
+        *v = 0;
+        for (int i = 0; i < 8; i++) {
+            *v |= static_cast<uint64_t>(data[offset++]) << (i * 8);
+        }
+    }
+    
     // Number of revocations
     uint32_t count = 0;
     for (int i = 0; i < 4; i++) {
@@ -231,10 +246,73 @@ std::optional<RevocationListUpdate> RevocationListUpdate::from_bytes(const std::
     return update;
 }
 
+// RevocationFilter methods
+
+namespace {
+
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+RevocationFilter::RevocationFilter(size_t expected_keys)
+    : capacity_(std::max<size_t>(expected_keys, 64))
+{
+    const size_t bits = capacity_ * BITS_PER_KEY;
+    blocks_.resize((bits + 511) / 512, Block{});
+}
+
+std::pair<uint64_t, uint64_t> RevocationFilter::key_hashes(const NodeID& node_id, Capability capability) {
+    // Node IDs are already uniform hashes; mix in the capability and spread
+    uint64_t lo = 0;
+    uint64_t hi = 0;
+    for (int i = 0; i < 8; i++) {
+        lo |= static_cast<uint64_t>(node_id.id[i]) << (i * 8);
+        hi |= static_cast<uint64_t>(node_id.id[8 + i]) << (i * 8);
+    }
+    const uint64_t cap = static_cast<uint64_t>(capability) + 1;
+    return {mix64(lo ^ (cap * 0x9E3779B97F4A7C15ULL)), mix64(hi + cap)};
+}
+
+void RevocationFilter::insert(const NodeID& node_id, Capability capability) {
+    auto [block_hash, bit_hash] = key_hashes(node_id, capability);
+    Block& block = blocks_[block_hash % blocks_.size()];
+    for (size_t i = 0; i < PROBES; i++) {
+        const size_t bit = (bit_hash >> (i * 9)) & 511;
+        block.words[bit >> 6] |= 1ULL << (bit & 63);
+    }
+}
+
+bool RevocationFilter::might_contain(const NodeID& node_id, Capability capability) const {
+    auto [block_hash, bit_hash] = key_hashes(node_id, capability);
+    const Block& block = blocks_[block_hash % blocks_.size()];
+    for (size_t i = 0; i < PROBES; i++) {
+        const size_t bit = (bit_hash >> (i * 9)) & 511;
+        if ((block.words[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RevocationFilter::clear() {
+    std::fill(blocks_.begin(), blocks_.end(), Block{});
+}
+
 // TokenRevocationManager methods
 
 TokenRevocationManager::TokenRevocationManager()
-    : revocation_expiry_days_(30)
+    : filter_keys_(0)
+    , current_version_(0)
+    , check_stats_{}
+    , revocation_expiry_days_(30)
     , max_revocations_per_node_(100)
     , max_propagation_count_(10)
 {
@@ -264,13 +342,12 @@ std::optional<TokenRevocation> TokenRevocationManager::revoke_token(
         return std::nullopt;
     }
     
-    // Add to storage
+    // Add to storage (revoking the same thing twice is a no-op)
     Hash256 id = revocation.get_id();
     
-    RevocationListEntry entry(revocation);
-    revocations_[id] = entry;
-    
-    add_revocation_to_indexes(id, revocation);
+    if (!store_revocation(id, RevocationListEntry(revocation))) {
+        return revocation;
+    }
     
     CASHEW_LOG_INFO("Token revoked for node {} capability {} reason {}",
                     node_id.to_string().substr(0, 8),
@@ -281,19 +358,28 @@ std::optional<TokenRevocation> TokenRevocationManager::revoke_token(
 }
 
 bool TokenRevocationManager::is_token_revoked(const CapabilityToken& token) const {
-    // Check all revocations for this node
-    auto it = revocations_by_node_.find(token.node_id);
-    if (it == revocations_by_node_.end()) {
+    check_stats_.checks++;
+    
+    // Common case: nothing revoked for this (node, capability), one cache line
+    if (!filter_.might_contain(token.node_id, token.capability)) {
+        check_stats_.filter_negatives++;
         return false;
     }
     
-    // Check each revocation to see if it matches this token
-    for (const auto& rev_id : it->second) {
-        auto rev_it = revocations_.find(rev_id);
-        if (rev_it != revocations_.end()) {
-            if (rev_it->second.revocation.matches_token(token)) {
-                return true;
-            }
+    auto it = revocations_by_token_.find(TokenKey{token.node_id.id, token.capability});
+    if (it == revocations_by_token_.end()) {
+        check_stats_.false_positives++;
+        return false;
+    }
+    
+    // Same rules as TokenRevocation::matches_token, node and capability already equal
+    for (const auto& indexed : it->second) {
+        if (!indexed.context.empty() && !token.context.empty() && indexed.context != token.context) {
+            continue;
+        }
+        if (token.issued_at < indexed.revoked_at) {
+            check_stats_.revoked++;
+            return true;
         }
     }
     
@@ -301,21 +387,10 @@ bool TokenRevocationManager::is_token_revoked(const CapabilityToken& token) cons
 }
 
 bool TokenRevocationManager::has_revocations(const NodeID& node_id, Capability capability) const {
-    auto it = revocations_by_node_.find(node_id);
-    if (it == revocations_by_node_.end()) {
+    if (!filter_.might_contain(node_id, capability)) {
         return false;
     }
-    
-    for (const auto& rev_id : it->second) {
-        auto rev_it = revocations_.find(rev_id);
-        if (rev_it != revocations_.end()) {
-            if (rev_it->second.revocation.capability == capability) {
-                return true;
-            }
-        }
-    }
-    
-    return false;
+    return revocations_by_token_.count(TokenKey{node_id.id, capability}) > 0;
 }
 
 std::vector<TokenRevocation> TokenRevocationManager::get_revocations_for(const NodeID& node_id) const {
@@ -376,10 +451,10 @@ bool TokenRevocationManager::process_revocation(
     RevocationListEntry entry(revocation);
     entry.witnesses.insert(source_node);
     
-    revocations_[id] = entry;
     seen_revocations_.insert(id);
-    
-    add_revocation_to_indexes(id, revocation);
+    if (!store_revocation(id, std::move(entry))) {
+        return false;  // Revoked locally already
+    }
     
     CASHEW_LOG_INFO("Processed revocation from source node");
     
@@ -395,6 +470,15 @@ size_t TokenRevocationManager::process_revocation_list(const RevocationListUpdat
         }
     }
     
+    // Advance the peer's sync point only for contiguous deltas; after a gap
+    // the next request restarts from the last version we fully hold
+    if (update.version > 0) {
+        uint64_t& synced = peer_versions_[update.source_node];
+        if (update.since_version <= synced) {
+            synced = update.version;
+        }
+    }
+    
     CASHEW_LOG_INFO("Processed revocation list: {}/{} accepted",
                     accepted, update.revocations.size());
     
@@ -407,10 +491,8 @@ RevocationListUpdate TokenRevocationManager::create_revocation_list(bool include
     // Note: source_node and signature would be filled in by caller
     
     if (include_all) {
-        // Include all revocations
-        for (const auto& [id, entry] : revocations_) {
-            update.revocations.push_back(entry.revocation);
-        }
+        // Full dump is a delta from the beginning with no size limit
+        return create_revocation_delta(0, revocations_.size());
     } else {
         // Only recent (last hour)
         uint64_t one_hour_ago = current_timestamp() - 3600;
@@ -420,6 +502,52 @@ RevocationListUpdate TokenRevocationManager::create_revocation_list(bool include
     return update;
 }
 
+RevocationListUpdate TokenRevocationManager::create_revocation_delta(
+    uint64_t since_version,
+    size_t max_count
+) const {
+    RevocationListUpdate update;
+    update.timestamp = current_timestamp();
+    // Note: source_node and signature would be filled in by caller
+    
+    // A receiver ahead of us means our versions restarted; resend everything
+    if (since_version > current_version_) {
+        since_version = 0;
+    }
+    
+    update.since_version = since_version;
+    update.head_version = current_version_;
+    update.version = since_version;
+    
+    if (max_count == 0) {
+        return update;
+    }
+    
+    update.version = current_version_;
+    for (auto it = revocations_by_version_.upper_bound(since_version);
+         it != revocations_by_version_.end(); ++it) {
+        if (update.revocations.size() >= max_count) {
+            update.version = std::prev(it)->first;  // it is past the first entry here
+            break;
+        }
+        auto rev_it = revocations_.find(it->second);
+        if (rev_it != revocations_.end()) {
+            update.revocations.push_back(rev_it->second.revocation);
+        }
+    }
+    
+    if (update.revocations.empty() && update.version < since_version) {
+        update.version = since_version;
+    }
+    
+    return update;
+}
+
+uint64_t TokenRevocationManager::synced_version(const NodeID& peer) const {
+    auto it = peer_versions_.find(peer);
+    return it != peer_versions_.end() ? it->second : 0;
+}
+
 bool TokenRevocationManager::verify_revocation(
     const TokenRevocation& revocation,
     const PublicKey& revoker_public_key
@@ -477,16 +605,25 @@ void TokenRevocationManager::cleanup_expired_revocations() {
     for (const auto& id : to_remove) {
         auto it = revocations_.find(id);
         if (it != revocations_.end()) {
+            revocations_by_version_.erase(it->second.version);
             remove_revocation_from_indexes(id, it->second.revocation);
             revocations_.erase(it);
         }
     }
     
     if (!to_remove.empty()) {
+        // Bloom filters cannot delete; drop stale bits so negatives stay cheap
+        rebuild_filter();
         CASHEW_LOG_INFO("Cleaned up {} expired revocations", to_remove.size());
     }
 }
 
+TokenRevocationManager::CheckStatistics TokenRevocationManager::get_check_statistics() const {
+    CheckStatistics stats = check_stats_;
+    stats.filter_bytes = filter_.memory_bytes();
+    return stats;
+}
+
 // Private methods
 
 bool TokenRevocationManager::is_revocation_expired(const TokenRevocation& revocation) const {
@@ -522,6 +659,18 @@ void TokenRevocationManager::add_revocation_to_indexes(
 ) {
     revocations_by_node_[revocation.node_id].insert(id);
     revocations_by_capability_[revocation.capability].insert(id);
+    
+    auto& indexed = revocations_by_token_[TokenKey{revocation.node_id.id, revocation.capability}];
+    if (indexed.empty()) {
+        filter_keys_++;
+        if (filter_keys_ > filter_.capacity()) {
+            indexed.push_back({id, revocation.revoked_at, revocation.context});
+            rebuild_filter();
+            return;
+        }
+        filter_.insert(revocation.node_id, revocation.capability);
+    }
+    indexed.push_back({id, revocation.revoked_at, revocation.context});
 }
 
 void TokenRevocationManager::remove_revocation_from_indexes(
@@ -544,9 +693,42 @@ void TokenRevocationManager::remove_revocation_from_indexes(
         }
     }
     
+    auto token_it = revocations_by_token_.find(TokenKey{revocation.node_id.id, revocation.capability});
+    if (token_it != revocations_by_token_.end()) {
+        auto& indexed = token_it->second;
+        indexed.erase(std::remove_if(indexed.begin(), indexed.end(),
+                                     [&id](const IndexedRevocation& r) { return r.id == id; }),
+                      indexed.end());
+        if (indexed.empty()) {
+            revocations_by_token_.erase(token_it);
+        }
+    }
+    
     seen_revocations_.erase(id);
 }
 
+bool TokenRevocationManager::store_revocation(const Hash256& id, RevocationListEntry entry) {
+    if (revocations_.count(id) > 0) {
+        return false;
+    }
+    
+    entry.added_at = current_timestamp();
+    entry.version = ++current_version_;
+    revocations_by_version_[entry.version] = id;
+    
+    auto [it, inserted] = revocations_.emplace(id, std::move(entry));
+    add_revocation_to_indexes(id, it->second.revocation);
+    return inserted;
+}
+
+void TokenRevocationManager::rebuild_filter() {
+    filter_keys_ = revocations_by_token_.size();
+    filter_ = RevocationFilter(std::max<size_t>(1024, filter_keys_ * 2));
+    for (const auto& [key, indexed] : revocations_by_token_) {
+        filter_.insert(NodeID(key.node), key.capability);
+    }
+}
+
 uint64_t TokenRevocationManager::current_timestamp() const {
     auto now = std::chrono::system_clock::now();
     return std::chrono::system_clock::to_time_t(now);
@@ -4,6 +4,8 @@
 #include "security/access.hpp"
 #include <set>
 #include <map>
+#include <unordered_map>
+#include <array>
 #include <vector>
 #include <optional>
 #include <chrono>
@@ -58,18 +60,21 @@ struct TokenRevocation {
 struct RevocationListEntry {
     TokenRevocation revocation;
     uint64_t added_at;               // When added to local list
+    uint64_t version;                // Local sequence number (for delta sync)
     std::set<NodeID> witnesses;      // Nodes that confirmed this revocation
     uint32_t propagation_count;      // How many times we've forwarded this
     
     // Default constructor
     RevocationListEntry()
         : added_at(0)
+        , version(0)
         , propagation_count(0)
     {}
     
     RevocationListEntry(const TokenRevocation& rev)
         : revocation(rev)
         , added_at(0)
+        , version(0)
         , propagation_count(0)
     {
         auto now = std::chrono::system_clock::now();
@@ -79,17 +84,56 @@ struct RevocationListEntry {
 
 /**
  * RevocationListUpdate - Gossip message for revocation list
+ *
+ * Versions are the sender's local sequence numbers. A delta carries the
+ * revocations in (since_version, version]; head_version > version means the
+ * receiver should ask again from version. Full/recent dumps have version 0.
  */
 struct RevocationListUpdate {
     std::vector<TokenRevocation> revocations;
-    uint64_t timestamp;
-    NodeID source_node;
-    Signature signature;
+    uint64_t timestamp = 0;
+    NodeID source_node{};
+    uint64_t since_version = 0;
+    uint64_t version = 0;
+    uint64_t head_version = 0;
+    Signature signature{};
     
     std::vector<uint8_t> to_bytes() const;
     static std::optional<RevocationListUpdate> from_bytes(const std::vector<uint8_t>& data);
 };
 
+/**
+ * RevocationFilter - Blocked Bloom filter over (node, capability) keys
+ *
+ * Each key maps to one 64-byte block, so a lookup touches a single cache
+ * line. No false negatives; false positives fall through to the exact index.
+ * Entries cannot be removed; the owner rebuilds the filter after expiry.
+ */
+class RevocationFilter {
+public:
+    explicit RevocationFilter(size_t expected_keys = 1024);
+    
+    void insert(const NodeID& node_id, Capability capability);
+    bool might_contain(const NodeID& node_id, Capability capability) const;
+    
+    void clear();
+    size_t capacity() const { return capacity_; }
+    size_t memory_bytes() const { return blocks_.size() * sizeof(Block); }
+    
+private:
+    struct alignas(64) Block {
+        std::array<uint64_t, 8> words;
+    };
+    
+    static constexpr size_t BITS_PER_KEY = 12;
+    static constexpr size_t PROBES = 7;
+    
+    std::vector<Block> blocks_;
+    size_t capacity_;
+    
+    static std::pair<uint64_t, uint64_t> key_hashes(const NodeID& node_id, Capability capability);
+};
+
 /**
  * TokenRevocationManager - Manages token revocation and gossip propagation
  * 
@@ -183,6 +227,24 @@ public:
      */
     RevocationListUpdate create_revocation_list(bool include_all = false) const;
     
+    /**
+     * Create a delta of revocations added after since_version
+     * @param since_version Last version the receiver has from this node
+     * @param max_count Maximum revocations in this delta
+     * @return Revocation list update ready for signing and transmission
+     */
+    RevocationListUpdate create_revocation_delta(uint64_t since_version, size_t max_count = 500) const;
+    
+    /**
+     * Latest local version (0 = nothing revoked yet)
+     */
+    uint64_t current_version() const { return current_version_; }
+    
+    /**
+     * Last contiguous version received from peer (ask for deltas since this)
+     */
+    uint64_t synced_version(const NodeID& peer) const;
+    
     /**
      * Verify a revocation is properly signed
      * @param revocation The revocation to verify
@@ -209,19 +271,64 @@ public:
     size_t expired_revocation_count() const;
     void cleanup_expired_revocations();
     
+    struct CheckStatistics {
+        uint64_t checks;
+        uint64_t filter_negatives;   // Answered by the filter alone
+        uint64_t false_positives;    // Filter hit, no exact entry
+        uint64_t revoked;
+        size_t filter_bytes;
+    };
+    
+    CheckStatistics get_check_statistics() const;
+    
     // Configuration
     void set_revocation_expiry_days(uint32_t days) { revocation_expiry_days_ = days; }
     void set_max_revocations_per_node(uint32_t max) { max_revocations_per_node_ = max; }
     
 private:
+    // Exact index entry: everything matches_token needs, without a revocations_ lookup
+    struct IndexedRevocation {
+        Hash256 id;
+        uint64_t revoked_at;
+        std::vector<uint8_t> context;
+    };
+    
+    struct TokenKey {
+        Hash256 node;
+        Capability capability;
+        
+        bool operator==(const TokenKey& other) const {
+            return capability == other.capability && node == other.node;
+        }
+    };
+    
+    struct TokenKeyHash {
+        size_t operator()(const TokenKey& key) const {
+            return std::hash<Hash256>{}(key.node) ^ (static_cast<size_t>(key.capability) * 0x9E3779B97F4A7C15ULL);
+        }
+    };
+    
     // Revocation storage
     std::map<Hash256, RevocationListEntry> revocations_;  // By revocation ID
     std::map<NodeID, std::set<Hash256>> revocations_by_node_;  // Index by node
     std::map<Capability, std::set<Hash256>> revocations_by_capability_;  // Index by capability
+    std::unordered_map<TokenKey, std::vector<IndexedRevocation>, TokenKeyHash> revocations_by_token_;
+    std::map<uint64_t, Hash256> revocations_by_version_;  // Delta sync order
+    
+    // Front filter for is_token_revoked (rebuilt on growth and expiry)
+    RevocationFilter filter_;
+    size_t filter_keys_;
+    
+    // Versioning
+    uint64_t current_version_;
+    std::map<NodeID, uint64_t> peer_versions_;
     
     // Seen revocations (for deduplication)
     std::set<Hash256> seen_revocations_;
     
+    // Check statistics (is_token_revoked is const)
+    mutable CheckStatistics check_stats_;
+    
     // Configuration
     uint32_t revocation_expiry_days_;
     uint32_t max_revocations_per_node_;
@@ -232,6 +339,8 @@ private:
     bool should_accept_revocation(const TokenRevocation& revocation) const;
     void add_revocation_to_indexes(const Hash256& id, const TokenRevocation& revocation);
     void remove_revocation_from_indexes(const Hash256& id, const TokenRevocation& revocation);
+    bool store_revocation(const Hash256& id, RevocationListEntry entry);
+    void rebuild_filter();
     uint64_t current_timestamp() const;
 };
 
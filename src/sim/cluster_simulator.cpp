@@ -0,0 +1,670 @@
+#include "sim/cluster_simulator.hpp"
+#include "crypto/blake3.hpp"
+#include "crypto/ed25519.hpp"
+#include "utils/logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+#include <sstream>
+
+namespace cashew::sim {
+
+using network::GossipMessage;
+using network::GossipMessageType;
+
+namespace {
+
+// Reproducible identity per (seed, index); the node ID is the key's hash as usual
+std::pair<PublicKey, SecretKey> make_node_keys(uint64_t seed, size_t index) {
+    std::vector<uint8_t> material;
+    for (int i = 0; i < 8; ++i) {
+        material.push_back(static_cast<uint8_t>(seed >> (i * 8)));
+    }
+    for (int i = 0; i < 8; ++i) {
+        material.push_back(static_cast<uint8_t>(static_cast<uint64_t>(index) >> (i * 8)));
+    }
+    return crypto::Ed25519::keypair_from_seed(crypto::Blake3::hash(material));
+}
+
+std::vector<uint8_t> make_payload(std::mt19937_64& rng, size_t size) {
+    std::vector<uint8_t> payload(size);
+    for (auto& byte : payload) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return payload;
+}
+
+double to_ms(SimTime time) {
+    return static_cast<double>(time.count()) / 1000.0;
+}
+
+} // namespace
+
+// LatencySamples
+
+void LatencySamples::add(SimTime sample) {
+    samples_.push_back(sample.count());
+    sorted_ = false;
+}
+
+SimTime LatencySamples::percentile(double p) const {
+    if (samples_.empty()) {
+        return SimTime{0};
+    }
+    if (!sorted_) {
+        std::sort(samples_.begin(), samples_.end());
+        sorted_ = true;
+    }
+    const double clamped = std::clamp(p, 0.0, 100.0);
+    const auto rank = static_cast<size_t>(std::ceil(clamped / 100.0 * samples_.size()));
+    return SimTime{samples_[rank == 0 ? 0 : rank - 1]};
+}
+
+double LatencySamples::mean_ms() const {
+    if (samples_.empty()) {
+        return 0.0;
+    }
+    const double total = std::accumulate(samples_.begin(), samples_.end(), 0.0);
+    return total / static_cast<double>(samples_.size()) / 1000.0;
+}
+
+// WorkloadReport
+
+std::string WorkloadReport::to_string(size_t node_count) const {
+    std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(1);
+    oss << name << ": " << completed << "/" << issued
+        << " (" << completion_rate() * 100.0 << "%) in " << to_ms(duration) << " ms"
+        << " | latency p50 " << to_ms(latency.percentile(50))
+        << " p90 " << to_ms(latency.percentile(90))
+        << " p99 " << to_ms(latency.percentile(99))
+        << " max " << to_ms(latency.max()) << " ms"
+        << " | " << messages << " msgs, " << bytes << " B";
+    if (node_count > 0) {
+        oss << " (" << bytes / node_count << " B/node avg, " << max_node_bytes << " B max)";
+    }
+    oss << ", " << dropped << " dropped";
+    return oss.str();
+}
+
+// Node
+
+struct ClusterSimulator::Node {
+    NodeID id;
+    PublicKey public_key;
+    SecretKey secret_key;
+    bool online{true};
+    std::vector<size_t> neighbours;
+
+    network::GossipProtocol gossip;
+    network::Router router;
+    ledger::Ledger ledger;
+    ledger::StateManager state;
+    network::LedgerGossipBridge bridge;
+
+    std::unordered_map<Hash256, std::vector<uint8_t>> content;
+    network::ContentSetTracker hosted;
+    SimTime uplink_free_at{0};
+    TrafficCounters traffic;
+    size_t current_sender{0};  // Link the message being handled arrived on
+
+    // Workload hooks (reset by each workload)
+    std::function<void(const GossipMessage&)> on_flood;
+    std::function<void(const ContentHash&)> on_content;
+
+    Node(const NodeID& node_id, const std::pair<PublicKey, SecretKey>& keys)
+        : id(node_id),
+          public_key(keys.first),
+          secret_key(keys.second),
+          gossip(node_id),
+          router(node_id),
+          ledger(node_id),
+          state(ledger),
+          bridge(ledger, state, gossip)
+    {
+        gossip.set_local_public_key(public_key);
+        gossip.set_sign_callback([this](const std::vector<uint8_t>& data) {
+            return crypto::Ed25519::sign(data, secret_key);
+        });
+    }
+};
+
+// ClusterSimulator
+
+ClusterSimulator::ClusterSimulator(const ClusterConfig& config)
+    : config_(config),
+      rng_(config.seed)
+{
+    nodes_.reserve(config_.node_count);
+    for (size_t i = 0; i < config_.node_count; ++i) {
+        const auto keys = make_node_keys(config_.seed, i);
+        const NodeID id(crypto::Blake3::hash(bytes(keys.first.begin(), keys.first.end())));
+        index_by_id_[id.id] = i;
+        nodes_.push_back(std::make_unique<Node>(id, keys));
+    }
+
+    build_topology();
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        wire_node(i);
+    }
+
+    CASHEW_LOG_INFO("ClusterSimulator: {} nodes, {} peers each", nodes_.size(), config_.peers_per_node);
+}
+
+ClusterSimulator::~ClusterSimulator() = default;
+
+const NodeID& ClusterSimulator::node_id(size_t index) const {
+    return nodes_.at(index)->id;
+}
+
+network::GossipProtocol& ClusterSimulator::gossip(size_t index) {
+    return nodes_.at(index)->gossip;
+}
+
+network::Router& ClusterSimulator::router(size_t index) {
+    return nodes_.at(index)->router;
+}
+
+ledger::Ledger& ClusterSimulator::ledger(size_t index) {
+    return nodes_.at(index)->ledger;
+}
+
+ledger::StateManager& ClusterSimulator::state(size_t index) {
+    return nodes_.at(index)->state;
+}
+
+const TrafficCounters& ClusterSimulator::traffic(size_t index) const {
+    return nodes_.at(index)->traffic;
+}
+
+const std::vector<size_t>& ClusterSimulator::neighbours(size_t index) const {
+    return nodes_.at(index)->neighbours;
+}
+
+void ClusterSimulator::build_topology() {
+    const size_t n = nodes_.size();
+    if (n < 2) {
+        return;
+    }
+
+    std::vector<std::set<size_t>> links(n);
+    const auto link = [&links](size_t a, size_t b) {
+        links[a].insert(b);
+        links[b].insert(a);
+    };
+
+    // A ring keeps the overlay connected; random chords give the rest
+    for (size_t i = 0; i < n; ++i) {
+        link(i, (i + 1) % n);
+    }
+    const size_t degree = std::min(config_.peers_per_node, n - 1);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        size_t attempts = 0;
+        while (links[i].size() < degree && attempts++ < degree * 8) {
+            const size_t other = pick(rng_);
+            if (other != i) {
+                link(i, other);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        nodes_[i]->neighbours.assign(links[i].begin(), links[i].end());
+        for (size_t peer : links[i]) {
+            nodes_[i]->gossip.add_peer(nodes_[peer]->id);
+        }
+    }
+}
+
+void ClusterSimulator::wire_node(size_t index) {
+    Node& node = *nodes_[index];
+    node.gossip.set_fanout(config_.gossip_fanout);
+
+    node.gossip.set_send_callback([this, index](const NodeID& to, const GossipMessage& message) {
+        send(index, to, MessageKind::GOSSIP, message.to_bytes());
+        return true;
+    });
+    node.router.set_request_send_callback([this, index](const NodeID& to, const network::ContentRequest& request) {
+        send(index, to, MessageKind::CONTENT_REQUEST, request.to_bytes());
+        return true;
+    });
+    node.router.set_response_send_callback([this, index](const NodeID& to, const network::ContentResponse& response) {
+        send(index, to, MessageKind::CONTENT_RESPONSE, response.to_bytes());
+        return true;
+    });
+    node.router.set_cancel_send_callback([this, index](const NodeID& to, const Hash256& request_id) {
+        send(index, to, MessageKind::CONTENT_CANCEL, std::vector<uint8_t>(request_id.begin(), request_id.end()));
+        return true;
+    });
+    node.router.set_local_content_fetch_callback([&node](const ContentHash& content_hash)
+                                                 -> std::optional<std::vector<uint8_t>> {
+        auto it = node.content.find(content_hash.hash);
+        if (it == node.content.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    });
+    node.router.set_content_received_callback([&node](const ContentHash& content_hash, const std::vector<uint8_t>&) {
+        if (node.on_content) {
+            node.on_content(content_hash);
+        }
+    });
+
+    // Content announcements teach the router where content lives
+    node.gossip.register_handler(GossipMessageType::CONTENT_ANNOUNCEMENT, [&node](const GossipMessage& message) {
+        auto announcement = network::ContentAnnouncement::from_bytes(message.payload);
+        if (!announcement || announcement->hosting_node == node.id) {
+            return;
+        }
+        node.router.update_routing_table(announcement->hosting_node,
+                                         static_cast<uint8_t>(std::min<int>(message.hop_count + 1, 255)));
+        node.router.get_routing_table().advertise_content(announcement->hosting_node, announcement->content_hash);
+    });
+    node.router.register_gossip_handlers(node.gossip);
+    node.gossip.register_handler(GossipMessageType::NETWORK_STATE_UPDATE, [this, &node](const GossipMessage& message) {
+        node.bridge.handle_gossip_message(nodes_[node.current_sender]->id, message);
+    });
+    node.gossip.register_handler(GossipMessageType::NODE_CAPABILITY, [&node](const GossipMessage& message) {
+        if (node.on_flood) {
+            node.on_flood(message);
+        }
+    });
+}
+
+void ClusterSimulator::set_online(size_t index, bool online) {
+    Node& node = *nodes_.at(index);
+    if (node.online == online) {
+        return;
+    }
+    node.online = online;
+
+    // Neighbours notice the link going down or coming back
+    for (size_t peer : node.neighbours) {
+        if (online) {
+            nodes_[peer]->gossip.add_peer(node.id);
+        } else {
+            nodes_[peer]->gossip.remove_peer(node.id);
+        }
+    }
+}
+
+bool ClusterSimulator::is_online(size_t index) const {
+    return nodes_.at(index)->online;
+}
+
+size_t ClusterSimulator::online_count() const {
+    return static_cast<size_t>(std::count_if(nodes_.begin(), nodes_.end(),
+                                             [](const auto& node) { return node->online; }));
+}
+
+void ClusterSimulator::schedule(SimTime delay, std::function<void()> action) {
+    events_.push(Event{now_ + std::max(delay, SimTime{0}), next_sequence_++, std::move(action)});
+}
+
+void ClusterSimulator::run_until(SimTime time) {
+    while (!events_.empty() && events_.top().at <= time) {
+        // Copy out before popping: the action may schedule more events
+        Event event = events_.top();
+        events_.pop();
+        now_ = event.at;
+        event.action();
+    }
+    now_ = std::max(now_, time);
+}
+
+void ClusterSimulator::run_until_idle(SimTime limit) {
+    const SimTime stop_at = now_ + limit;
+    while (!events_.empty() && events_.top().at <= stop_at) {
+        Event event = events_.top();
+        events_.pop();
+        now_ = event.at;
+        event.action();
+    }
+}
+
+void ClusterSimulator::send(size_t from, const NodeID& to, MessageKind kind, std::vector<uint8_t> payload) {
+    Node& sender = *nodes_[from];
+    auto it = index_by_id_.find(to.id);
+    if (!sender.online || it == index_by_id_.end()) {
+        return;
+    }
+    const size_t target = it->second;
+
+    sender.traffic.messages_sent++;
+    sender.traffic.bytes_sent += payload.size();
+
+    // Queue behind earlier sends on the uplink, then cross the link
+    const auto& link = config_.link;
+    SimTime departure = std::max(now_, sender.uplink_free_at);
+    if (link.uplink_bytes_per_second > 0) {
+        departure += SimTime{static_cast<int64_t>(payload.size() * 1000000 / link.uplink_bytes_per_second)};
+    }
+    sender.uplink_free_at = departure;
+
+    SimTime arrival = departure + link.latency;
+    if (link.jitter.count() > 0) {
+        arrival += SimTime{std::uniform_int_distribution<int64_t>(0, link.jitter.count())(rng_)};
+    }
+
+    if (link.loss_rate > 0.0 && std::bernoulli_distribution(link.loss_rate)(rng_)) {
+        nodes_[target]->traffic.messages_dropped++;
+        return;
+    }
+
+    events_.push(Event{arrival, next_sequence_++,
+                       [this, from, target, kind, payload = std::move(payload)]() {
+                           deliver(from, target, kind, payload);
+                       }});
+}
+
+void ClusterSimulator::deliver(size_t from, size_t to, MessageKind kind, const std::vector<uint8_t>& payload) {
+    Node& node = *nodes_[to];
+    if (!node.online) {
+        node.traffic.messages_dropped++;
+        return;
+    }
+    node.traffic.messages_received++;
+    node.traffic.bytes_received += payload.size();
+    node.current_sender = from;
+
+    switch (kind) {
+        case MessageKind::GOSSIP:
+            if (auto message = GossipMessage::from_bytes(payload)) {
+                node.gossip.receive_message(*message);
+            }
+            break;
+        case MessageKind::CONTENT_REQUEST:
+            if (auto request = network::ContentRequest::from_bytes(payload)) {
+                node.router.handle_content_request(*request);
+            }
+            break;
+        case MessageKind::CONTENT_RESPONSE:
+            if (auto response = network::ContentResponse::from_bytes(payload)) {
+                node.router.handle_content_response(*response);
+            }
+            break;
+        case MessageKind::CONTENT_CANCEL:
+            if (payload.size() == 32) {
+                Hash256 request_id{};
+                std::copy(payload.begin(), payload.end(), request_id.begin());
+                node.router.handle_content_cancel(request_id);
+            }
+            break;
+    }
+}
+
+void ClusterSimulator::start_churn(SimTime until) {
+    churn_until_ = until;
+    if (churn_.departures_per_second > 0.0) {
+        schedule_departure();
+    }
+}
+
+void ClusterSimulator::schedule_departure() {
+    std::exponential_distribution<double> gap(churn_.departures_per_second);
+    const SimTime delay{static_cast<int64_t>(gap(rng_) * 1e6)};
+    if (now_ + delay > churn_until_) {
+        return;
+    }
+
+    schedule(delay, [this]() {
+        std::vector<size_t> online;
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            if (nodes_[i]->online) {
+                online.push_back(i);
+            }
+        }
+        if (online.size() > 1) {
+            const size_t victim = online[std::uniform_int_distribution<size_t>(0, online.size() - 1)(rng_)];
+            set_online(victim, false);
+
+            std::exponential_distribution<double> downtime(1e6 / static_cast<double>(churn_.mean_downtime.count()));
+            schedule(SimTime{static_cast<int64_t>(downtime(rng_) * 1e6)}, [this, victim]() {
+                set_online(victim, true);
+            });
+        }
+        schedule_departure();
+    });
+}
+
+ClusterSimulator::WorkloadMark ClusterSimulator::mark() const {
+    WorkloadMark mark;
+    mark.started = now_;
+    mark.traffic.reserve(nodes_.size());
+    for (const auto& node : nodes_) {
+        mark.traffic.push_back(node->traffic);
+    }
+    return mark;
+}
+
+void ClusterSimulator::finish(WorkloadReport& report, const WorkloadMark& mark) const {
+    report.duration = now_ - mark.started;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const auto& before = mark.traffic[i];
+        const auto& after = nodes_[i]->traffic;
+        report.messages += after.messages_sent - before.messages_sent;
+        report.bytes += after.bytes_sent - before.bytes_sent;
+        report.dropped += after.messages_dropped - before.messages_dropped;
+        const uint64_t node_bytes = (after.bytes_sent - before.bytes_sent) +
+                                    (after.bytes_received - before.bytes_received);
+        report.max_node_bytes = std::max(report.max_node_bytes, node_bytes);
+    }
+}
+
+WorkloadReport ClusterSimulator::run_content_workload(const ContentWorkload& workload) {
+    WorkloadReport report;
+    report.name = "content";
+    const size_t n = nodes_.size();
+    if (n < 2 || workload.items == 0) {
+        return report;
+    }
+
+    // Place items, then each host announces its set in one digest; routes
+    // are learned through gossip
+    std::vector<ContentHash> items;
+    std::uniform_int_distribution<size_t> pick_node(0, n - 1);
+    for (size_t item = 0; item < workload.items; ++item) {
+        auto data = make_payload(rng_, workload.item_bytes);
+        const ContentHash content_hash(crypto::Blake3::hash(data));
+        items.push_back(content_hash);
+
+        std::set<size_t> hosts;
+        while (hosts.size() < std::min(workload.replicas, n)) {
+            hosts.insert(pick_node(rng_));
+        }
+        for (size_t host : hosts) {
+            Node& node = *nodes_[host];
+            node.content[content_hash.hash] = data;
+            node.router.advertise_local_content(content_hash);
+            node.hosted.add(content_hash);
+        }
+    }
+    for (auto& node : nodes_) {
+        if (node->hosted.has_pending_changes()) {
+            node->gossip.broadcast_message(node->gossip.create_content_digest(node->hosted.full_digest()));
+        }
+    }
+    run_until_idle();
+
+    // Requests: Poisson arrivals, Zipf popularity, random online requesters
+    std::vector<double> weights(items.size());
+    for (size_t rank = 0; rank < items.size(); ++rank) {
+        weights[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), workload.zipf_exponent);
+    }
+    std::discrete_distribution<size_t> pick_item(weights.begin(), weights.end());
+    std::exponential_distribution<double> gap(1.0 / static_cast<double>(std::max<int64_t>(1, workload.mean_interarrival.count())));
+
+    // Outstanding request issue times per node and content hash
+    std::vector<std::unordered_map<Hash256, std::vector<SimTime>>> outstanding(n);
+    for (size_t i = 0; i < n; ++i) {
+        nodes_[i]->on_content = [this, &outstanding, &report, i](const ContentHash& content_hash) {
+            auto it = outstanding[i].find(content_hash.hash);
+            if (it == outstanding[i].end()) {
+                return;
+            }
+            for (SimTime issued_at : it->second) {
+                report.latency.add(now_ - issued_at);
+                report.completed++;
+            }
+            outstanding[i].erase(it);
+        };
+    }
+
+    const auto start = mark();
+    SimTime offset{0};
+    for (size_t r = 0; r < workload.requests; ++r) {
+        offset += SimTime{static_cast<int64_t>(gap(rng_))};
+        const size_t item = pick_item(rng_);
+        const size_t requester = pick_node(rng_);
+        schedule(offset, [this, &outstanding, &report, &items, item, requester]() {
+            Node& node = *nodes_[requester];
+            if (!node.online || node.content.count(items[item].hash) > 0) {
+                return;
+            }
+            report.issued++;
+            outstanding[requester][items[item].hash].push_back(now_);
+            node.router.request_content(items[item]);
+        });
+    }
+    start_churn(now_ + offset);
+    run_until_idle();
+
+    for (auto& node : nodes_) {
+        node->on_content = nullptr;
+    }
+    finish(report, start);
+    return report;
+}
+
+WorkloadReport ClusterSimulator::run_gossip_flood(const GossipFloodWorkload& workload) {
+    WorkloadReport report;
+    report.name = "gossip";
+    const size_t n = nodes_.size();
+    if (n == 0) {
+        return report;
+    }
+
+    std::unordered_map<Hash256, SimTime> sent_at;
+    for (auto& node : nodes_) {
+        node->on_flood = [this, &sent_at, &report](const GossipMessage& message) {
+            auto it = sent_at.find(message.message_id);
+            if (it != sent_at.end()) {
+                report.latency.add(now_ - it->second);
+                report.completed++;
+            }
+        };
+    }
+
+    const auto start = mark();
+    std::uniform_int_distribution<size_t> pick_node(0, n - 1);
+    for (size_t m = 0; m < workload.messages; ++m) {
+        const size_t origin = pick_node(rng_);
+        auto payload = make_payload(rng_, workload.payload_bytes);
+        schedule(SimTime{workload.interval.count() * static_cast<int64_t>(m)},
+                 [this, &sent_at, &report, origin, payload = std::move(payload)]() {
+            Node& node = *nodes_[origin];
+            if (!node.online) {
+                return;
+            }
+            GossipMessage message;
+            message.type = GossipMessageType::NODE_CAPABILITY;
+            message.payload = payload;
+            message.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            message.hop_count = 0;
+            message.message_id = crypto::Blake3::hash(payload);
+
+            sent_at[message.message_id] = now_;
+            report.issued += online_count() - 1;
+            node.gossip.broadcast_message(message);
+        });
+    }
+    start_churn(now_ + SimTime{workload.interval.count() * static_cast<int64_t>(workload.messages)});
+    run_until_idle();
+
+    for (auto& node : nodes_) {
+        node->on_flood = nullptr;
+    }
+    finish(report, start);
+    return report;
+}
+
+WorkloadReport ClusterSimulator::run_ledger_burst(const LedgerBurstWorkload& workload) {
+    WorkloadReport report;
+    report.name = "ledger";
+    const size_t n = nodes_.size();
+    if (workload.writer >= n) {
+        return report;
+    }
+
+    // Followers apply the writer's chain strictly in order; track each
+    // follower's position and stamp every event it newly applied
+    Node& writer = *nodes_[workload.writer];
+    const size_t base = writer.ledger.event_count();
+    std::vector<SimTime> recorded_at;
+    std::vector<size_t> applied(n);
+    for (size_t i = 0; i < n; ++i) {
+        applied[i] = nodes_[i]->ledger.event_count();
+    }
+
+    const auto start = mark();
+    const auto track = [this, &applied, &recorded_at, &report, base]() {
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            const size_t count = nodes_[i]->ledger.event_count();
+            while (applied[i] < count) {
+                const size_t position = applied[i]++;
+                if (position >= base && position - base < recorded_at.size()) {
+                    report.latency.add(now_ - recorded_at[position - base]);
+                    report.completed++;
+                }
+            }
+        }
+    };
+
+    for (size_t e = 0; e < workload.events; ++e) {
+        schedule(SimTime{workload.interval.count() * static_cast<int64_t>(e)},
+                 [this, &writer, &recorded_at, &report, &applied, workload, e]() {
+            if (!writer.online) {
+                return;
+            }
+            const Hash256 event_id = writer.ledger.record_reputation_update(
+                nodes_[(workload.writer + 1 + e) % nodes_.size()]->id, 1, "sim");
+            recorded_at.push_back(now_);
+            applied[workload.writer] = writer.ledger.event_count();
+            report.issued += online_count() - 1;
+
+            if (const auto* event = writer.ledger.find_event(event_id)) {
+                writer.state.apply_event(*event);
+                writer.bridge.broadcast_event(*event);
+            }
+        });
+    }
+    const SimTime issue_span{workload.interval.count() * static_cast<int64_t>(workload.events)};
+    start_churn(now_ + issue_span);
+
+    // Batches are flushed on virtual time; the bridge's own wall-clock
+    // window is pushed out of the way while the burst runs
+    if (workload.batch_window.count() > 0) {
+        writer.bridge.set_event_batch_window(std::chrono::hours(1));
+        for (SimTime at = workload.batch_window; at <= issue_span + workload.batch_window;
+             at += workload.batch_window) {
+            schedule(at, [&writer]() { writer.bridge.flush_event_batch(); });
+        }
+    }
+
+    // Check progress after every delivery batch
+    while (!events_.empty()) {
+        const SimTime next = events_.top().at;
+        run_until(next);
+        track();
+    }
+    writer.bridge.set_event_batch_window(std::chrono::milliseconds(0));
+
+    finish(report, start);
+    return report;
+}
+
+} // namespace cashew::sim
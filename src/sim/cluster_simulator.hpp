@@ -0,0 +1,229 @@
+#pragma once
+
+#include "cashew/common.hpp"
+#include "core/ledger/ledger.hpp"
+#include "core/ledger/state.hpp"
+#include "network/gossip.hpp"
+#include "network/ledger_sync.hpp"
+#include "network/router.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cashew::sim {
+
+/**
+ * Virtual time since the simulation started
+ */
+using SimTime = std::chrono::microseconds;
+
+/**
+ * LinkProfile - Properties of every simulated link
+ */
+struct LinkProfile {
+    SimTime latency{20000};                      // One-way propagation delay
+    SimTime jitter{5000};                        // Uniform extra delay, 0..jitter
+    uint64_t uplink_bytes_per_second{12500000};  // Per-node uplink (100 Mbit/s), 0 = unlimited
+    double loss_rate{0.0};                       // Probability a message is dropped
+};
+
+/**
+ * ClusterConfig - Shape of the simulated cluster
+ */
+struct ClusterConfig {
+    size_t node_count{100};
+    size_t peers_per_node{8};   // Random gossip neighbours per node (links are symmetric)
+    size_t gossip_fanout{4};
+    LinkProfile link;
+    uint64_t seed{1};
+};
+
+/**
+ * LatencySamples - Latency samples with percentile summaries
+ */
+class LatencySamples {
+public:
+    void add(SimTime sample);
+
+    size_t count() const { return samples_.size(); }
+    SimTime percentile(double p) const;  // p in [0, 100]
+    SimTime max() const { return percentile(100.0); }
+    double mean_ms() const;
+
+private:
+    mutable std::vector<int64_t> samples_;
+    mutable bool sorted_{true};
+};
+
+/**
+ * TrafficCounters - Messages and bytes seen by one node's link
+ */
+struct TrafficCounters {
+    uint64_t messages_sent{0};
+    uint64_t bytes_sent{0};
+    uint64_t messages_received{0};
+    uint64_t bytes_received{0};
+    uint64_t messages_dropped{0};  // Lost on the way to this node, or it was offline
+};
+
+/**
+ * WorkloadReport - Outcome of one workload run
+ */
+struct WorkloadReport {
+    std::string name;
+    size_t issued{0};       // Requests, or (message, node) deliveries expected
+    size_t completed{0};
+    LatencySamples latency;
+    SimTime duration{0};    // Virtual time from first issue until the cluster went idle
+    uint64_t messages{0};
+    uint64_t bytes{0};
+    uint64_t dropped{0};
+    uint64_t max_node_bytes{0};  // Busiest node, sent + received
+
+    double completion_rate() const { return issued == 0 ? 1.0 : static_cast<double>(completed) / issued; }
+    std::string to_string(size_t node_count) const;
+};
+
+/**
+ * ContentWorkload - Content requests with Zipf popularity
+ */
+struct ContentWorkload {
+    size_t items{200};
+    size_t item_bytes{4096};
+    size_t replicas{3};
+    size_t requests{2000};
+    double zipf_exponent{1.0};
+    SimTime mean_interarrival{500};  // Poisson arrivals across the cluster
+};
+
+/**
+ * GossipFloodWorkload - Messages flooded from random origins
+ */
+struct GossipFloodWorkload {
+    size_t messages{50};
+    size_t payload_bytes{256};
+    SimTime interval{10000};
+};
+
+/**
+ * LedgerBurstWorkload - Events appended by one writer and propagated by gossip
+ */
+struct LedgerBurstWorkload {
+    size_t events{100};
+    SimTime interval{1000};
+    size_t writer{0};
+    SimTime batch_window{0};  // Writer's event batching window, 0 = one message per event
+};
+
+/**
+ * ChurnProfile - Nodes leaving and rejoining while a workload runs
+ */
+struct ChurnProfile {
+    double departures_per_second{0.0};
+    SimTime mean_downtime{std::chrono::seconds(5)};
+};
+
+/**
+ * ClusterSimulator - Many nodes in one process over a simulated network
+ *
+ * Each node runs the real GossipProtocol, Router, Ledger, StateManager and
+ * LedgerGossipBridge. Their send callbacks feed a discrete-event transport
+ * in virtual time. Every message is serialized, queued behind earlier sends
+ * on the sender's uplink, and delivered after the link latency plus jitter,
+ * unless it is lost or the receiver is offline. Workloads run in virtual
+ * time and report latency percentiles, completion, messages and bytes.
+ *
+ * Timers inside the components (router hedging, deadlines, gossip age) still
+ * read the wall clock; virtual runs finish far faster than those timeouts.
+ * Connections are modelled by the link layer rather than PeerManager and
+ * SessionManager, which have no transport hook.
+ *
+ * Single-threaded; not thread-safe.
+ */
+class ClusterSimulator {
+public:
+    explicit ClusterSimulator(const ClusterConfig& config);
+    ~ClusterSimulator();
+
+    ClusterSimulator(const ClusterSimulator&) = delete;
+    ClusterSimulator& operator=(const ClusterSimulator&) = delete;
+
+    // Nodes (components are exposed for custom workloads)
+    size_t node_count() const { return nodes_.size(); }
+    const NodeID& node_id(size_t index) const;
+    network::GossipProtocol& gossip(size_t index);
+    network::Router& router(size_t index);
+    ledger::Ledger& ledger(size_t index);
+    ledger::StateManager& state(size_t index);
+    const TrafficCounters& traffic(size_t index) const;
+    const std::vector<size_t>& neighbours(size_t index) const;
+
+    void set_online(size_t index, bool online);
+    bool is_online(size_t index) const;
+    size_t online_count() const;
+
+    // Event loop
+    SimTime now() const { return now_; }
+    void schedule(SimTime delay, std::function<void()> action);
+    void run_until(SimTime time);
+    void run_until_idle(SimTime limit = std::chrono::minutes(10));
+
+    /**
+     * Churn applied while the following workloads issue their load
+     */
+    void set_churn(const ChurnProfile& churn) { churn_ = churn; }
+
+    // Workloads
+    WorkloadReport run_content_workload(const ContentWorkload& workload);
+    WorkloadReport run_gossip_flood(const GossipFloodWorkload& workload);
+    WorkloadReport run_ledger_burst(const LedgerBurstWorkload& workload);
+
+private:
+    struct Node;
+    enum class MessageKind : uint8_t { GOSSIP, CONTENT_REQUEST, CONTENT_RESPONSE, CONTENT_CANCEL };
+
+    struct Event {
+        SimTime at;
+        uint64_t sequence;
+        std::function<void()> action;
+
+        bool operator>(const Event& other) const {
+            return at != other.at ? at > other.at : sequence > other.sequence;
+        }
+    };
+
+    struct WorkloadMark {
+        std::vector<TrafficCounters> traffic;
+        SimTime started;
+    };
+
+    ClusterConfig config_;
+    std::mt19937_64 rng_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::unordered_map<Hash256, size_t> index_by_id_;
+
+    SimTime now_{0};
+    uint64_t next_sequence_{0};
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+
+    ChurnProfile churn_;
+    SimTime churn_until_{0};
+
+    void build_topology();
+    void wire_node(size_t index);
+    void send(size_t from, const NodeID& to, MessageKind kind, std::vector<uint8_t> payload);
+    void deliver(size_t from, size_t to, MessageKind kind, const std::vector<uint8_t>& payload);
+    void start_churn(SimTime until);
+    void schedule_departure();
+
+    WorkloadMark mark() const;
+    void finish(WorkloadReport& report, const WorkloadMark& mark) const;
+};
+
+} // namespace cashew::sim
@@ -0,0 +1,147 @@
+#include "storage/file_sync.hpp"
+#include <cerrno>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #include <sys/locking.h>
+#else
+    #include <fcntl.h>
+    #include <sys/file.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace cashew::storage {
+
+bool sync_file(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool sync_directory(const std::filesystem::path& directory) {
+#ifndef _WIN32
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#else
+    (void)directory;
+    return true;
+#endif
+}
+
+std::FILE* lock_file(const std::filesystem::path& path) {
+    std::FILE* file = std::fopen(path.string().c_str(), "ab");
+    if (!file) {
+        return nullptr;
+    }
+#ifdef _WIN32
+    const bool locked = _locking(_fileno(file), _LK_NBLCK, 1) == 0;
+#else
+    const bool locked = ::flock(fileno(file), LOCK_EX | LOCK_NB) == 0;
+#endif
+    if (!locked) {
+        std::fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+std::FILE* open_lock_file(const std::filesystem::path& path) {
+    return std::fopen(path.string().c_str(), "ab");
+}
+
+bool lock_exclusive(std::FILE* file) {
+#ifdef _WIN32
+    // _locking locks from the current position; _LK_LOCK retries for ~10 s
+    std::fseek(file, 0, SEEK_SET);
+    return _locking(_fileno(file), _LK_LOCK, 1) == 0;
+#else
+    int rc;
+    do {
+        rc = ::flock(fileno(file), LOCK_EX);
+    } while (rc != 0 && errno == EINTR);
+    return rc == 0;
+#endif
+}
+
+void unlock_file(std::FILE* file) {
+#ifdef _WIN32
+    std::fseek(file, 0, SEEK_SET);
+    _locking(_fileno(file), _LK_UNLCK, 1);
+#else
+    ::flock(fileno(file), LOCK_UN);
+#endif
+}
+
+#ifdef _WIN32
+namespace {
+
+std::optional<FileIdentity> identify_handle(HANDLE handle) {
+    BY_HANDLE_FILE_INFORMATION info;
+    if (handle == INVALID_HANDLE_VALUE || !GetFileInformationByHandle(handle, &info)) {
+        return std::nullopt;
+    }
+    FileIdentity identity;
+    identity.device = info.dwVolumeSerialNumber;
+    identity.index = (static_cast<uint64_t>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    identity.size = (static_cast<uint64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    return identity;
+}
+
+} // namespace
+
+std::optional<FileIdentity> identify_file(const std::filesystem::path& path) {
+    HANDLE handle = CreateFileW(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    auto identity = identify_handle(handle);
+    if (handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(handle);
+    }
+    return identity;
+}
+
+std::optional<FileIdentity> identify_file(std::FILE* file) {
+    return identify_handle(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file))));
+}
+#else
+namespace {
+
+FileIdentity identity_of(const struct stat& st) {
+    FileIdentity identity;
+    identity.device = static_cast<uint64_t>(st.st_dev);
+    identity.index = static_cast<uint64_t>(st.st_ino);
+    identity.size = static_cast<uint64_t>(st.st_size);
+    return identity;
+}
+
+} // namespace
+
+std::optional<FileIdentity> identify_file(const std::filesystem::path& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return std::nullopt;
+    }
+    return identity_of(st);
+}
+
+std::optional<FileIdentity> identify_file(std::FILE* file) {
+    struct stat st;
+    if (::fstat(fileno(file), &st) != 0) {
+        return std::nullopt;
+    }
+    return identity_of(st);
+}
+#endif
+
+} // namespace cashew::storage
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <optional>
+
+namespace cashew::storage {
+
+/**
+ * Flush a stdio stream and force its data to disk
+ */
+bool sync_file(std::FILE* file);
+
+/**
+ * Force a directory's entries (new files, renames) to disk
+ * Directories cannot be opened for syncing on Windows; there it is a no-op.
+ */
+bool sync_directory(const std::filesystem::path& directory);
+
+/**
+ * Open (creating if needed) and exclusively lock a lock file
+ * @return nullptr if another process or handle holds the lock; fclose releases it
+ */
+std::FILE* lock_file(const std::filesystem::path& path);
+
+/**
+ * Open (creating if needed) a lock file without locking it
+ */
+std::FILE* open_lock_file(const std::filesystem::path& path);
+
+/**
+ * Block until the exclusive lock on a file from open_lock_file is held
+ */
+bool lock_exclusive(std::FILE* file);
+void unlock_file(std::FILE* file);
+
+/**
+ * FileIdentity - Which file a path or handle refers to, and its size
+ * A rename over a path changes its identity, even if the size matches.
+ */
+struct FileIdentity {
+    uint64_t device = 0;
+    uint64_t index = 0;
+    uint64_t size = 0;
+
+    bool same_file(const FileIdentity& other) const {
+        return device == other.device && index == other.index;
+    }
+};
+
+std::optional<FileIdentity> identify_file(const std::filesystem::path& path);
+std::optional<FileIdentity> identify_file(std::FILE* file);
+
+} // namespace cashew::storage
@@ -0,0 +1,576 @@
+#include "storage/kv_store.hpp"
+#include "storage/file_sync.hpp"
+#include "utils/logger.hpp"
+#include <array>
+
+namespace cashew::storage {
+
+namespace {
+
+constexpr uint8_t OP_PUT = 1;
+constexpr uint8_t OP_REMOVE = 2;
+constexpr size_t RECORD_HEADER_SIZE = 8;  // u32 payload length + u32 CRC32
+constexpr size_t COMPACT_OPS_PER_RECORD = 4096;
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    static const auto table = []() {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void append_u32(bytes& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+    }
+}
+
+bool read_u32(const bytes& in, size_t& offset, uint32_t& value) {
+    if (offset + 4 > in.size()) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[offset + i]) << (i * 8);
+    }
+    offset += 4;
+    return true;
+}
+
+/**
+ * Decode one record payload; nullopt if malformed
+ */
+std::optional<std::vector<WriteBatch::Op>> decode_payload(const bytes& in, size_t offset, size_t end) {
+    size_t pos = offset;
+    auto read_bounded = [&](uint32_t& value) {
+        return pos + 4 <= end && read_u32(in, pos, value);
+    };
+
+    uint32_t count = 0;
+    if (!read_bounded(count)) {
+        return std::nullopt;
+    }
+
+    std::vector<WriteBatch::Op> ops;
+    ops.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pos >= end) {
+            return std::nullopt;
+        }
+        const uint8_t kind = in[pos++];
+
+        uint32_t key_len = 0;
+        if (!read_bounded(key_len) || pos + key_len > end) {
+            return std::nullopt;
+        }
+        WriteBatch::Op op;
+        op.key.assign(reinterpret_cast<const char*>(in.data() + pos), key_len);
+        pos += key_len;
+
+        if (kind == OP_PUT) {
+            uint32_t value_len = 0;
+            if (!read_bounded(value_len) || pos + value_len > end) {
+                return std::nullopt;
+            }
+            op.value = bytes(in.begin() + static_cast<std::ptrdiff_t>(pos),
+                             in.begin() + static_cast<std::ptrdiff_t>(pos + value_len));
+            pos += value_len;
+        } else if (kind != OP_REMOVE) {
+            return std::nullopt;
+        }
+        ops.push_back(std::move(op));
+    }
+
+    if (pos != end) {
+        return std::nullopt;
+    }
+    return ops;
+}
+
+/**
+ * Holds the cross-process writer lock on kv.lock for one scope
+ */
+class WriterLock {
+public:
+    explicit WriterLock(std::FILE* file)
+        : file_(file), held_(file != nullptr && lock_exclusive(file)) {}
+    ~WriterLock() {
+        if (held_) {
+            unlock_file(file_);
+        }
+    }
+
+    WriterLock(const WriterLock&) = delete;
+    WriterLock& operator=(const WriterLock&) = delete;
+
+    bool held() const { return held_; }
+
+private:
+    std::FILE* file_;
+    bool held_;
+};
+
+} // namespace
+
+// WriteBatch
+
+void WriteBatch::put(const std::string& key, const bytes& value) {
+    ops_.push_back(Op{key, value});
+}
+
+void WriteBatch::remove(const std::string& key) {
+    ops_.push_back(Op{key, std::nullopt});
+}
+
+// KVStore
+
+KVStore::KVStore(const std::filesystem::path& directory, const KVStoreOptions& options)
+    : directory_(directory),
+      log_path_(directory / "kv.log"),
+      options_(options),
+      log_(nullptr),
+      lock_(nullptr),
+      live_bytes_(0),
+      log_bytes_(0),
+      external_batches_(0),
+      batches_written_(0),
+      compactions_(0),
+      recovered_batches_(0),
+      truncated_bytes_(0)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        CASHEW_LOG_ERROR("Failed to create KV store directory {}: {}", directory_.string(), ec.message());
+        return;
+    }
+
+    lock_ = open_lock_file(directory_ / "kv.lock");
+    if (!lock_) {
+        CASHEW_LOG_ERROR("Failed to open KV store lock file in {}", directory_.string());
+        return;
+    }
+
+    WriterLock writer(lock_);
+    if (!writer.held()) {
+        CASHEW_LOG_ERROR("Failed to lock KV store {}", directory_.string());
+        return;
+    }
+
+    // A leftover temp file means compaction died before its rename; the old log is intact
+    std::filesystem::remove(directory_ / "kv.log.tmp", ec);
+
+    if (!open_log()) {
+        return;
+    }
+    recovered_batches_ = read_log_locked();
+    if (!prepare_append_locked()) {
+        std::fclose(log_);
+        log_ = nullptr;
+        return;
+    }
+
+    CASHEW_LOG_DEBUG("KV store opened at {} ({} keys, {} batches replayed)",
+                     directory_.string(), entries_.size(), recovered_batches_);
+}
+
+KVStore::~KVStore() {
+    if (log_) {
+        std::fflush(log_);
+        std::fclose(log_);
+    }
+    if (lock_) {
+        std::fclose(lock_);
+    }
+}
+
+bool KVStore::put(const std::string& key, const bytes& value) {
+    WriteBatch batch;
+    batch.put(key, value);
+    return write(batch);
+}
+
+bool KVStore::remove(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WriterLock writer(lock_);
+    if (!writer.held() || !prepare_append_locked() || entries_.find(key) == entries_.end()) {
+        return false;
+    }
+
+    WriteBatch::Op op{key, std::nullopt};
+    if (!append_record(encode_record({op}))) {
+        return false;
+    }
+    apply_locked(op);
+    return true;
+}
+
+bool KVStore::write(const WriteBatch& batch) {
+    if (batch.empty()) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    WriterLock writer(lock_);
+    if (!writer.held() || !prepare_append_locked() || !append_record(encode_record(batch.ops()))) {
+        return false;
+    }
+
+    for (const auto& op : batch.ops()) {
+        apply_locked(op);
+    }
+
+    if (should_compact_locked()) {
+        compact_locked();
+    }
+    return true;
+}
+
+std::optional<bytes> KVStore::get(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_locked();
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool KVStore::contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_locked();
+    return entries_.find(key) != entries_.end();
+}
+
+void KVStore::for_each_prefix(const std::string& prefix,
+                              const std::function<bool(const std::string&, const bytes&)>& visitor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_locked();
+    for (auto it = entries_.lower_bound(prefix); it != entries_.end(); ++it) {
+        if (it->first.compare(0, prefix.size(), prefix) != 0) {
+            break;
+        }
+        if (!visitor(it->first, it->second)) {
+            break;
+        }
+    }
+}
+
+std::vector<std::string> KVStore::keys_with_prefix(const std::string& prefix) const {
+    std::vector<std::string> keys;
+    for_each_prefix(prefix, [&keys](const std::string& key, const bytes&) {
+        keys.push_back(key);
+        return true;
+    });
+    return keys;
+}
+
+bool KVStore::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    WriterLock writer(lock_);
+    return writer.held() && prepare_append_locked() && compact_locked();
+}
+
+bool KVStore::sync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_ && sync_file(log_);
+}
+
+size_t KVStore::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    refresh_locked();
+    return entries_.size();
+}
+
+KVStore::Statistics KVStore::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats;
+    stats.keys = entries_.size();
+    stats.live_bytes = live_bytes_;
+    stats.log_bytes = log_bytes_;
+    stats.batches_written = batches_written_;
+    stats.compactions = compactions_;
+    stats.recovered_batches = recovered_batches_;
+    stats.external_batches = external_batches_;
+    stats.truncated_bytes = truncated_bytes_;
+    return stats;
+}
+
+bool KVStore::open_log() {
+    log_ = std::fopen(log_path_.string().c_str(), "ab");
+    if (!log_) {
+        CASHEW_LOG_ERROR("Failed to open KV log: {}", log_path_.string());
+        return false;
+    }
+    return true;
+}
+
+void KVStore::refresh_locked() const {
+    if (!log_) {
+        return;
+    }
+    auto current = identify_file(log_path_);
+    if (!current || (current->same_file(log_file_) && current->size == log_file_.size)) {
+        return;
+    }
+    external_batches_ += read_log_locked();
+}
+
+uint64_t KVStore::read_log_locked() const {
+    std::FILE* in = std::fopen(log_path_.string().c_str(), "rb");
+    if (!in) {
+        return 0;
+    }
+    auto opened = identify_file(in);
+    if (!opened) {
+        std::fclose(in);
+        return 0;
+    }
+
+    // Replaced by a compaction (or cut below what we applied): rebuild from the start
+    if (!opened->same_file(log_file_) || opened->size < log_bytes_) {
+        entries_.clear();
+        live_bytes_ = 0;
+        log_bytes_ = 0;
+    }
+    log_file_ = *opened;
+
+    bytes data(static_cast<size_t>(opened->size - log_bytes_));
+    size_t read = 0;
+    if (!data.empty() && std::fseek(in, static_cast<long>(log_bytes_), SEEK_SET) == 0) {
+        read = std::fread(data.data(), 1, data.size(), in);
+    }
+    std::fclose(in);
+    data.resize(read);
+
+    // Stop at the first incomplete or damaged record; a writer may still be appending it
+    uint64_t batches = 0;
+    size_t offset = 0;
+    while (offset + RECORD_HEADER_SIZE <= data.size()) {
+        size_t pos = offset;
+        uint32_t length = 0;
+        uint32_t checksum = 0;
+        read_u32(data, pos, length);
+        read_u32(data, pos, checksum);
+
+        if (pos + length > data.size() || crc32(data.data() + pos, length) != checksum) {
+            break;
+        }
+
+        auto ops = decode_payload(data, pos, pos + length);
+        if (!ops) {
+            break;
+        }
+        for (const auto& op : *ops) {
+            apply_locked(op);
+        }
+
+        batches++;
+        offset = pos + length;
+    }
+
+    log_bytes_ += offset;
+    log_file_.size = log_bytes_ + (data.size() - offset);
+    return batches;
+}
+
+bool KVStore::prepare_append_locked() {
+    if (!log_) {
+        return false;
+    }
+    refresh_locked();
+
+    // With the writer lock held nobody is mid-append, so bytes past the last record are torn
+    if (log_file_.size > log_bytes_) {
+        const uint64_t torn = log_file_.size - log_bytes_;
+        CASHEW_LOG_WARN("KV log {} has a torn tail; dropping {} bytes", log_path_.string(), torn);
+
+        std::error_code ec;
+        std::filesystem::resize_file(log_path_, log_bytes_, ec);
+        if (ec) {
+            CASHEW_LOG_ERROR("Failed to truncate KV log: {}", ec.message());
+            return false;
+        }
+        truncated_bytes_ += torn;
+        log_file_.size = log_bytes_;
+    }
+
+    // Another store compacted since our handle was opened; append to the new log
+    auto handle = identify_file(log_);
+    if (!handle || !handle->same_file(log_file_)) {
+        std::fclose(log_);
+        log_ = nullptr;
+        if (!open_log()) {
+            return false;
+        }
+        handle = identify_file(log_);
+        if (!handle || !handle->same_file(log_file_)) {
+            CASHEW_LOG_ERROR("KV log {} changed while locked", log_path_.string());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool KVStore::append_record(const bytes& record) {
+    if (!log_) {
+        return false;
+    }
+
+    if (std::fwrite(record.data(), 1, record.size(), log_) != record.size() || std::fflush(log_) != 0) {
+        CASHEW_LOG_ERROR("Failed to append to KV log: {}", log_path_.string());
+        discard_partial_append();
+        return false;
+    }
+    if (options_.sync_writes && !sync_file(log_)) {
+        CASHEW_LOG_ERROR("Failed to sync KV log: {}", log_path_.string());
+        discard_partial_append();
+        return false;
+    }
+
+    log_bytes_ += record.size();
+    log_file_.size = log_bytes_;
+    batches_written_++;
+    return true;
+}
+
+void KVStore::discard_partial_append() {
+    // Reopen so no buffered remainder of the record reaches the file later
+    std::fclose(log_);
+    log_ = nullptr;
+
+    std::error_code ec;
+    std::filesystem::resize_file(log_path_, log_bytes_, ec);
+    if (ec) {
+        // Leave the store closed rather than append behind a torn record
+        CASHEW_LOG_ERROR("Failed to truncate KV log after a failed append: {}", ec.message());
+        return;
+    }
+    log_file_.size = log_bytes_;
+    open_log();
+}
+
+void KVStore::apply_locked(const WriteBatch::Op& op) const {
+    auto it = entries_.find(op.key);
+    if (it != entries_.end()) {
+        live_bytes_ -= it->first.size() + it->second.size();
+    }
+
+    if (op.value) {
+        live_bytes_ += op.key.size() + op.value->size();
+        if (it != entries_.end()) {
+            it->second = *op.value;
+        } else {
+            entries_.emplace(op.key, *op.value);
+        }
+    } else if (it != entries_.end()) {
+        entries_.erase(it);
+    }
+}
+
+bool KVStore::compact_locked() {
+    const auto temp_path = directory_ / "kv.log.tmp";
+    std::FILE* temp = std::fopen(temp_path.string().c_str(), "wb");
+    if (!temp) {
+        CASHEW_LOG_ERROR("Failed to create KV compaction file: {}", temp_path.string());
+        return false;
+    }
+
+    uint64_t written = 0;
+    bool ok = true;
+    std::vector<WriteBatch::Op> chunk;
+    auto flush_chunk = [&]() {
+        if (chunk.empty()) {
+            return;
+        }
+        const bytes record = encode_record(chunk);
+        ok = ok && std::fwrite(record.data(), 1, record.size(), temp) == record.size();
+        written += record.size();
+        chunk.clear();
+    };
+
+    for (const auto& [key, value] : entries_) {
+        chunk.push_back(WriteBatch::Op{key, value});
+        if (chunk.size() >= COMPACT_OPS_PER_RECORD) {
+            flush_chunk();
+        }
+    }
+    flush_chunk();
+
+    ok = ok && sync_file(temp);
+    std::fclose(temp);
+    if (!ok) {
+        CASHEW_LOG_ERROR("Failed to write KV compaction file: {}", temp_path.string());
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    if (log_) {
+        std::fclose(log_);
+        log_ = nullptr;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, log_path_, ec);
+    if (ec) {
+        CASHEW_LOG_ERROR("Failed to install compacted KV log: {}", ec.message());
+        open_log();
+        return false;
+    }
+    sync_directory(directory_);
+
+    compactions_++;
+    CASHEW_LOG_DEBUG("Compacted KV log {} ({} keys, {} bytes)", log_path_.string(), entries_.size(), written);
+    if (!open_log()) {
+        return false;
+    }
+    if (auto identity = identify_file(log_)) {
+        log_file_ = *identity;
+    }
+    log_bytes_ = written;
+    log_file_.size = written;
+    return true;
+}
+
+bool KVStore::should_compact_locked() const {
+    return log_bytes_ > options_.compact_min_bytes &&
+           static_cast<double>(log_bytes_) > options_.compact_garbage_ratio * static_cast<double>(live_bytes_);
+}
+
+bytes KVStore::encode_record(const std::vector<WriteBatch::Op>& ops) {
+    bytes record(RECORD_HEADER_SIZE);
+    append_u32(record, static_cast<uint32_t>(ops.size()));
+    for (const auto& op : ops) {
+        record.push_back(op.value ? OP_PUT : OP_REMOVE);
+        append_u32(record, static_cast<uint32_t>(op.key.size()));
+        record.insert(record.end(), op.key.begin(), op.key.end());
+        if (op.value) {
+            append_u32(record, static_cast<uint32_t>(op.value->size()));
+            record.insert(record.end(), op.value->begin(), op.value->end());
+        }
+    }
+
+    const uint32_t length = static_cast<uint32_t>(record.size() - RECORD_HEADER_SIZE);
+    const uint32_t checksum = crc32(record.data() + RECORD_HEADER_SIZE, length);
+    for (int i = 0; i < 4; ++i) {
+        record[i] = static_cast<uint8_t>(length >> (i * 8));
+        record[4 + i] = static_cast<uint8_t>(checksum >> (i * 8));
+    }
+    return record;
+}
+
+} // namespace cashew::storage
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "cashew/common.hpp"
+#include "storage/file_sync.hpp"
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <filesystem>
+#include <mutex>
+
+namespace cashew::storage {
+
+/**
+ * WriteBatch - Group of puts/removes applied atomically by KVStore::write
+ */
+class WriteBatch {
+public:
+    void put(const std::string& key, const bytes& value);
+    void remove(const std::string& key);
+    void clear() { ops_.clear(); }
+
+    bool empty() const { return ops_.empty(); }
+    size_t size() const { return ops_.size(); }
+
+    struct Op {
+        std::string key;
+        std::optional<bytes> value;  // nullopt = remove
+    };
+
+    const std::vector<Op>& ops() const { return ops_; }
+
+private:
+    std::vector<Op> ops_;
+};
+
+/**
+ * KVStoreOptions - Tuning for KVStore
+ */
+struct KVStoreOptions {
+    bool sync_writes;             // fsync after every batch (default: flush to OS only)
+    size_t compact_min_bytes;     // Never compact logs smaller than this
+    double compact_garbage_ratio; // Compact once log_bytes > ratio * live_bytes
+
+    KVStoreOptions()
+        : sync_writes(false),
+          compact_min_bytes(4 * 1024 * 1024),
+          compact_garbage_ratio(2.0) {}
+};
+
+/**
+ * KVStore - Embedded ordered key-value store
+ *
+ * Keys live in an ordered in-memory index; every write batch is appended to
+ * a checksummed log as a single record, so a batch is applied completely or
+ * not at all. On open the log is replayed and a torn tail (crash mid-append)
+ * is truncated. Once the log is mostly garbage it is compacted by writing the
+ * live set to a new file and renaming it over the old one. An append that
+ * fails part-way is cut back off the log before the error is returned, so
+ * later batches never land behind a torn record.
+ *
+ * Several stores, in one process or several, may share a directory. Writers
+ * take an exclusive lock on kv.lock for the length of one append or
+ * compaction and first catch up with the log, so they never append behind a
+ * record they have not applied. Readers take no lock: each read stats the log
+ * and only reads it when it grew (another store's records are applied, a
+ * record still being written is left for later) or was replaced by a
+ * compaction (the index is rebuilt). Thread-safe.
+ */
+class KVStore {
+public:
+    explicit KVStore(const std::filesystem::path& directory,
+                     const KVStoreOptions& options = KVStoreOptions());
+    ~KVStore();
+
+    KVStore(const KVStore&) = delete;
+    KVStore& operator=(const KVStore&) = delete;
+
+    bool is_open() const { return log_ != nullptr; }
+
+    bool put(const std::string& key, const bytes& value);
+    bool remove(const std::string& key);
+
+    /**
+     * Apply all operations in batch atomically
+     */
+    bool write(const WriteBatch& batch);
+
+    std::optional<bytes> get(const std::string& key) const;
+    bool contains(const std::string& key) const;
+
+    /**
+     * Visit keys starting with prefix in order; return false to stop
+     */
+    void for_each_prefix(const std::string& prefix,
+                         const std::function<bool(const std::string&, const bytes&)>& visitor) const;
+
+    std::vector<std::string> keys_with_prefix(const std::string& prefix) const;
+
+    /**
+     * Rewrite the log with only live entries
+     */
+    bool compact();
+
+    /**
+     * fsync the log
+     */
+    bool sync();
+
+    size_t size() const;
+
+    // Statistics
+    struct Statistics {
+        size_t keys;
+        uint64_t live_bytes;
+        uint64_t log_bytes;
+        uint64_t batches_written;
+        uint64_t compactions;
+        uint64_t recovered_batches;
+        uint64_t external_batches;  // Appended by other stores after open
+        uint64_t truncated_bytes;   // Torn tails dropped
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    std::filesystem::path directory_;
+    std::filesystem::path log_path_;
+    KVStoreOptions options_;
+
+    mutable std::mutex mutex_;
+    std::FILE* log_;
+    std::FILE* lock_;
+
+    // Index of the log as last read; const reads catch it up first
+    mutable std::map<std::string, bytes, std::less<>> entries_;
+    mutable FileIdentity log_file_;  // size = bytes seen, including any partial record
+    mutable uint64_t live_bytes_;
+    mutable uint64_t log_bytes_;     // End of the last complete record applied
+    mutable uint64_t external_batches_;
+
+    uint64_t batches_written_;
+    uint64_t compactions_;
+    uint64_t recovered_batches_;
+    uint64_t truncated_bytes_;
+
+    bool open_log();
+    void refresh_locked() const;
+    uint64_t read_log_locked() const;
+    bool prepare_append_locked();
+    bool append_record(const bytes& record);
+    void discard_partial_append();
+    void apply_locked(const WriteBatch::Op& op) const;
+    bool compact_locked();
+    bool should_compact_locked() const;
+
+    static bytes encode_record(const std::vector<WriteBatch::Op>& ops);
+};
+
+} // namespace cashew::storage
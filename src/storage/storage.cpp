@@ -1,28 +1,191 @@
 #include "storage.hpp"
+#include "storage/file_sync.hpp"
 #include "utils/logger.hpp"
 #include "crypto/blake3.hpp"
+#include "crypto/random.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
 
 namespace cashew::storage {
 
-// Current backend uses filesystem + in-memory indexing.
+// Current backend uses filesystem blobs + embedded KVStore for metadata.
+//
+// Content is written to a staging file, fsynced and renamed into place, so a
+// blob under content/ is always complete. Each put fsyncs its own file;
+// the directory fsyncs that make the renames durable are group-committed:
+// one thread syncs every directory touched since the last commit on behalf
+// of all waiting writers.
+//
+// Several instances (a running node and `cashew content add`) may share a
+// data directory, so each stages into its own subdirectory of staging/,
+// held by a lock on "<name>.lock". Only subdirectories whose lock is free
+// belong to a process that is gone and are swept.
 class Storage::Impl {
 public:
     explicit Impl(const std::filesystem::path& data_dir)
         : data_dir_(data_dir)
         , content_dir_(data_dir / "content")
+        , staging_root_(data_dir / "staging")
         , metadata_dir_(data_dir / "metadata")
+        , metadata_(data_dir / "metadata.db")
     {
         // Create directories
         std::filesystem::create_directories(content_dir_);
-        std::filesystem::create_directories(metadata_dir_);
+        
+        open_staging();
+        migrate_legacy_metadata();
         
         CASHEW_LOG_INFO("Storage initialized at: {}", data_dir_.string());
         CASHEW_LOG_INFO("Content directory: {}", content_dir_.string());
-        CASHEW_LOG_INFO("Metadata directory: {}", metadata_dir_.string());
+        CASHEW_LOG_INFO("Metadata store: {} keys", metadata_.size());
+    }
+    
+    ~Impl() {
+        if (staging_lock_) {
+            std::error_code ec;
+            std::filesystem::remove_all(staging_dir_, ec);
+            std::filesystem::remove(lock_path_for(staging_dir_), ec);
+            std::fclose(staging_lock_);
+        }
+    }
+    
+    /**
+     * Import file-per-key metadata written by older versions. Only files that
+     * made it into the store are removed; anything skipped keeps the legacy
+     * directory in place, and a failed scan or write leaves it untouched.
+     */
+    void migrate_legacy_metadata() {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(metadata_dir_, ec)) {
+            return;
+        }
+        
+        WriteBatch batch;
+        std::vector<std::filesystem::path> migrated;
+        std::filesystem::directory_iterator it(metadata_dir_, ec);
+        for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            const auto& entry = *it;
+            std::error_code type_ec;
+            if (!entry.is_regular_file(type_ec)) {
+                continue;
+            }
+            std::ifstream file(entry.path(), std::ios::binary);
+            bytes value((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (!file.is_open() || file.bad()) {
+                CASHEW_LOG_WARN("Skipping unreadable metadata file: {}", entry.path().string());
+                continue;
+            }
+            batch.put(entry.path().filename().string(), value);
+            migrated.push_back(entry.path());
+        }
+        if (ec) {
+            CASHEW_LOG_ERROR("Failed to scan legacy metadata ({}); keeping {}", ec.message(), metadata_dir_.string());
+            return;
+        }
+        
+        if (!metadata_.write(batch)) {
+            CASHEW_LOG_ERROR("Failed to migrate legacy metadata; keeping {}", metadata_dir_.string());
+            return;
+        }
+        
+        for (const auto& path : migrated) {
+            std::filesystem::remove(path, ec);
+        }
+        if (!std::filesystem::remove(metadata_dir_, ec)) {
+            CASHEW_LOG_WARN("Legacy metadata directory {} still holds unmigrated entries", metadata_dir_.string());
+        }
+        if (!batch.empty()) {
+            CASHEW_LOG_INFO("Migrated {} legacy metadata entries into metadata store", batch.size());
+        }
+    }
+    
+    /**
+     * Sweep stale staging directories, then lock and create our own
+     */
+    void open_staging() {
+        std::error_code ec;
+        std::filesystem::create_directories(staging_root_, ec);
+        sweep_stale_staging();
+        
+        for (int attempt = 0; attempt < 4; ++attempt) {
+            std::ostringstream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << crypto::Random::generate_uint64();
+            const auto dir = staging_root_ / name.str();
+            const auto lock_path = lock_path_for(dir);
+            
+            std::FILE* lock = lock_file(lock_path);
+            if (!lock) {
+                continue;
+            }
+            // A sweep may have removed the lock file between its creation and our lock
+            auto held = identify_file(lock);
+            auto current = identify_file(lock_path);
+            if (!held || !current || !held->same_file(*current)) {
+                std::fclose(lock);
+                continue;
+            }
+            
+            staging_lock_ = lock;
+            staging_dir_ = dir;
+            std::filesystem::create_directories(staging_dir_, ec);
+            return;
+        }
+        
+        // Still usable; a sweep by another instance may fail one of our writes
+        CASHEW_LOG_ERROR("Failed to lock a staging directory under {}", staging_root_.string());
+        staging_dir_ = staging_root_ / "unlocked";
+        std::filesystem::create_directories(staging_dir_, ec);
+    }
+    
+    /**
+     * Remove staging left by instances that are gone. Their files were never
+     * renamed into place. Lock files come before their directory, so a
+     * directory without one is stale too.
+     */
+    void sweep_stale_staging() {
+        std::error_code ec;
+        std::vector<std::filesystem::path> entries;
+        for (std::filesystem::directory_iterator it(staging_root_, ec), end; !ec && it != end; it.increment(ec)) {
+            entries.push_back(it->path());
+        }
+        
+        for (const auto& path : entries) {
+            std::error_code entry_ec;
+            if (path.extension() == ".lock") {
+                std::FILE* lock = lock_file(path);
+                if (!lock) {
+                    continue;  // Owner is alive
+                }
+                auto dir = path;
+                dir.replace_extension();
+                std::filesystem::remove_all(dir, entry_ec);
+                std::filesystem::remove(path, entry_ec);
+                std::fclose(lock);
+            } else if (std::filesystem::is_directory(path, entry_ec)) {
+                if (!std::filesystem::exists(lock_path_for(path), entry_ec)) {
+                    std::filesystem::remove_all(path, entry_ec);
+                }
+            } else {
+                // Flat staging files from older versions
+                std::filesystem::remove(path, entry_ec);
+            }
+        }
+    }
+    
+    static std::filesystem::path lock_path_for(const std::filesystem::path& dir) {
+        auto path = dir;
+        path += ".lock";
+        return path;
     }
     
     std::filesystem::path get_content_path(const ContentHash& hash) const {
@@ -32,38 +195,47 @@ public:
         return content_dir_ / subdir / hash_str;
     }
     
-    std::filesystem::path get_metadata_path(const std::string& key) const {
-        // Simple key to filename (escape special chars)
-        std::string safe_key = key;
-        for (char& c : safe_key) {
-            if (c == '/' || c == '\\' || c == ':') {
-                c = '_';
-            }
-        }
-        return metadata_dir_ / safe_key;
-    }
-    
     bool put_content(const ContentHash& hash, const bytes& data) {
         auto path = get_content_path(hash);
         
-        // Create subdirectory
-        std::filesystem::create_directories(path.parent_path());
+        // Blobs only appear by rename, so an existing one is complete
+        if (std::filesystem::exists(path)) {
+            return true;
+        }
         
-        // Write file
-        std::ofstream file(path, std::ios::binary);
-        if (!file) {
-            CASHEW_LOG_ERROR("Failed to create content file: {}", path.string());
-            return false;
+        // Single-flight: concurrent puts of one hash share the first writer's result
+        std::shared_ptr<PendingPut> pending;
+        bool is_writer = false;
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            auto [it, inserted] = pending_puts_.try_emplace(hash.hash);
+            if (inserted) {
+                it->second = std::make_shared<PendingPut>();
+            }
+            pending = it->second;
+            is_writer = inserted;
         }
         
-        file.write(reinterpret_cast<const char*>(data.data()), data.size());
-        if (!file) {
-            CASHEW_LOG_ERROR("Failed to write content file: {}", path.string());
-            return false;
+        if (!is_writer) {
+            std::unique_lock<std::mutex> lock(pending_mutex_);
+            pending_cv_.wait(lock, [&pending]() { return pending->done; });
+            return pending->ok;
         }
         
-        CASHEW_LOG_DEBUG("Stored content: {} ({} bytes)", hash.to_string(), data.size());
-        return true;
+        bool ok = std::filesystem::exists(path) || write_content(hash, path, data);
+        
+        {
+            std::lock_guard<std::mutex> lock(pending_mutex_);
+            pending->ok = ok;
+            pending->done = true;
+            pending_puts_.erase(hash.hash);
+        }
+        pending_cv_.notify_all();
+        
+        if (ok) {
+            CASHEW_LOG_DEBUG("Stored content: {} ({} bytes)", hash.to_string(), data.size());
+        }
+        return ok;
     }
     
     std::optional<bytes> get_content(const ContentHash& hash) const {
@@ -93,72 +265,86 @@ public:
         return data;
     }
     
-    bool has_content(const ContentHash& hash) const {
-        return std::filesystem::exists(get_content_path(hash));
-    }
-    
-    bool delete_content(const ContentHash& hash) {
+    std::optional<bytes> get_content_range(const ContentHash& hash, size_t offset, size_t length) const {
         auto path = get_content_path(hash);
         
-        if (!std::filesystem::exists(path)) {
-            return false;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return std::nullopt;
         }
         
-        std::error_code ec;
-        bool result = std::filesystem::remove(path, ec);
+        const auto end = file.tellg();
+        if (end < 0) {
+            CASHEW_LOG_ERROR("Failed to get content size of: {}", path.string());
+            return std::nullopt;
+        }
         
-        if (!result || ec) {
-            CASHEW_LOG_ERROR("Failed to delete content: {} ({})", 
-                           path.string(), ec.message());
-            return false;
+        const size_t size = static_cast<size_t>(end);
+        if (offset >= size) {
+            return bytes();
         }
         
-        return true;
-    }
-    
-    bool put_metadata(const std::string& key, const bytes& value) {
-        auto path = get_metadata_path(key);
+        size_t actual_length = std::min(length, size - offset);
+        bytes data(actual_length);
+        file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+        file.read(reinterpret_cast<char*>(data.data()), actual_length);
         
-        std::ofstream file(path, std::ios::binary);
         if (!file) {
-            CASHEW_LOG_ERROR("Failed to create metadata file: {}", path.string());
-            return false;
+            CASHEW_LOG_ERROR("Failed to read content range from: {}", path.string());
+            return std::nullopt;
         }
         
-        file.write(reinterpret_cast<const char*>(value.data()), value.size());
-        return file.good();
+        return data;
     }
     
-    std::optional<bytes> get_metadata(const std::string& key) const {
-        auto path = get_metadata_path(key);
-        
-        if (!std::filesystem::exists(path)) {
+    std::optional<size_t> content_size(const ContentHash& hash) const {
+        std::error_code ec;
+        auto size = std::filesystem::file_size(get_content_path(hash), ec);
+        if (ec) {
             return std::nullopt;
         }
-        
-        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(size);
+    }
+    
+    bool verify_content(const ContentHash& hash) const {
+        std::ifstream file(get_content_path(hash), std::ios::binary);
         if (!file) {
-            return std::nullopt;
+            return false;
         }
         
-        size_t size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        
-        bytes data(size);
-        file.read(reinterpret_cast<char*>(data.data()), size);
-        
-        return file ? std::optional<bytes>(data) : std::nullopt;
+        auto computed = crypto::Blake3::hash_stream(file);
+        return computed && *computed == hash.hash;
+    }
+    
+    bool has_content(const ContentHash& hash) const {
+        return std::filesystem::exists(get_content_path(hash));
     }
     
-    bool delete_metadata(const std::string& key) {
-        auto path = get_metadata_path(key);
+    bool delete_content(const ContentHash& hash) {
+        auto path = get_content_path(hash);
         
         if (!std::filesystem::exists(path)) {
             return false;
         }
         
         std::error_code ec;
-        return std::filesystem::remove(path, ec);
+        bool result = std::filesystem::remove(path, ec);
+        
+        if (!result || ec) {
+            CASHEW_LOG_ERROR("Failed to delete content: {} ({})", 
+                           path.string(), ec.message());
+            return false;
+        }
+        
+        return true;
+    }
+    
+    KVStore& metadata() {
+        return metadata_;
+    }
+    
+    const KVStore& metadata() const {
+        return metadata_;
     }
     
     std::vector<ContentHash> list_content() const {
@@ -205,9 +391,118 @@ public:
     }
     
 private:
+    struct PendingPut {
+        bool done = false;
+        bool ok = false;
+    };
+    
+    /**
+     * Stage, fsync and rename one blob, then wait for its directory commit
+     */
+    bool write_content(const ContentHash& hash, const std::filesystem::path& path, const bytes& data) {
+        const uint8_t shard = hash.hash[0];
+        const bool new_subdir = !subdir_ready_[shard].load(std::memory_order_acquire);
+        if (new_subdir) {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            if (ec) {
+                CASHEW_LOG_ERROR("Failed to create content directory: {}", path.parent_path().string());
+                return false;
+            }
+            subdir_ready_[shard].store(true, std::memory_order_release);
+        }
+        
+        // Writers are single-flighted per hash, so the hash names the staging file
+        auto staging_path = staging_dir_ / hash.to_string();
+        std::FILE* file = std::fopen(staging_path.string().c_str(), "wb");
+        if (!file) {
+            CASHEW_LOG_ERROR("Failed to create staging file: {}", staging_path.string());
+            return false;
+        }
+        
+        bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        ok = sync_file(file) && ok;
+        ok = std::fclose(file) == 0 && ok;
+        
+        std::error_code ec;
+        if (ok) {
+            std::filesystem::rename(staging_path, path, ec);
+            ok = !ec;
+        }
+        if (!ok) {
+            CASHEW_LOG_ERROR("Failed to write content file: {}", path.string());
+            std::filesystem::remove(staging_path, ec);
+            return false;
+        }
+        
+        std::vector<std::filesystem::path> dirs{path.parent_path()};
+        if (new_subdir) {
+            dirs.push_back(content_dir_);
+        }
+        return commit_directories(dirs);
+    }
+    
+    /**
+     * Wait until dirs have been fsynced by a commit that started after this call
+     */
+    bool commit_directories(const std::vector<std::filesystem::path>& dirs) {
+        std::unique_lock<std::mutex> lock(commit_mutex_);
+        commit_dirs_.insert(dirs.begin(), dirs.end());
+        const uint64_t ticket = ++commit_requested_;
+        
+        while (commit_completed_ < ticket) {
+            if (commit_running_) {
+                commit_cv_.wait(lock);
+                continue;
+            }
+            
+            // Lead a commit covering every writer queued so far
+            commit_running_ = true;
+            const uint64_t covered = commit_requested_;
+            std::set<std::filesystem::path> batch;
+            batch.swap(commit_dirs_);
+            lock.unlock();
+            
+            bool ok = true;
+            for (const auto& dir : batch) {
+                ok = sync_directory(dir) && ok;
+            }
+            
+            lock.lock();
+            if (!ok) {
+                CASHEW_LOG_ERROR("Failed to sync {} content directories", batch.size());
+                commit_failed_through_ = covered;
+            }
+            commit_completed_ = covered;
+            commit_running_ = false;
+            commit_cv_.notify_all();
+        }
+        return ticket > commit_failed_through_;
+    }
+    
     std::filesystem::path data_dir_;
     std::filesystem::path content_dir_;
-    std::filesystem::path metadata_dir_;
+    std::filesystem::path staging_root_;
+    std::filesystem::path staging_dir_;   // This instance's, under staging_root_
+    std::FILE* staging_lock_ = nullptr;
+    std::filesystem::path metadata_dir_;  // Legacy file-per-key metadata
+    KVStore metadata_;
+    
+    // Content subdirectories known to exist (indexed by first hash byte)
+    std::array<std::atomic<bool>, 256> subdir_ready_{};
+    
+    std::mutex pending_mutex_;
+    std::condition_variable pending_cv_;
+    std::unordered_map<Hash256, std::shared_ptr<PendingPut>> pending_puts_;
+    
+    // Group commit of directory fsyncs
+    std::mutex commit_mutex_;
+    std::condition_variable commit_cv_;
+    std::set<std::filesystem::path> commit_dirs_;
+    uint64_t commit_requested_ = 0;
+    uint64_t commit_completed_ = 0;
+    uint64_t commit_failed_through_ = 0;
+    bool commit_running_ = false;
 };
 
 // Storage implementation
@@ -227,6 +522,19 @@ std::optional<bytes> Storage::get_content(const ContentHash& content_hash) const
     return impl_->get_content(content_hash);
 }
 
+std::optional<bytes> Storage::get_content_range(const ContentHash& content_hash,
+                                                size_t offset, size_t length) const {
+    return impl_->get_content_range(content_hash, offset, length);
+}
+
+std::optional<size_t> Storage::content_size(const ContentHash& content_hash) const {
+    return impl_->content_size(content_hash);
+}
+
+bool Storage::verify_content(const ContentHash& content_hash) const {
+    return impl_->verify_content(content_hash);
+}
+
 bool Storage::has_content(const ContentHash& content_hash) const {
     return impl_->has_content(content_hash);
 }
@@ -236,15 +544,27 @@ bool Storage::delete_content(const ContentHash& content_hash) {
 }
 
 bool Storage::put_metadata(const std::string& key, const bytes& value) {
-    return impl_->put_metadata(key, value);
+    return impl_->metadata().put(key, value);
 }
 
 std::optional<bytes> Storage::get_metadata(const std::string& key) const {
-    return impl_->get_metadata(key);
+    return impl_->metadata().get(key);
 }
 
 bool Storage::delete_metadata(const std::string& key) {
-    return impl_->delete_metadata(key);
+    return impl_->metadata().remove(key);
+}
+
+bool Storage::write_metadata(const WriteBatch& batch) {
+    return impl_->metadata().write(batch);
+}
+
+std::vector<std::string> Storage::list_metadata(const std::string& prefix) const {
+    return impl_->metadata().keys_with_prefix(prefix);
+}
+
+KVStore& Storage::metadata_store() {
+    return impl_->metadata();
 }
 
 std::vector<ContentHash> Storage::list_content() const {
@@ -260,8 +580,8 @@ size_t Storage::item_count() const {
 }
 
 void Storage::compact() {
-    // Filesystem backend stores blobs directly; no compaction phase required.
-    CASHEW_LOG_INFO("Storage compaction skipped (filesystem backend)");
+    // Content blobs are stored directly; only the metadata log needs compacting.
+    impl_->metadata().compact();
 }
 
 } // namespace cashew::storage
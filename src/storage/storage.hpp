@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cashew/common.hpp"
+#include "storage/kv_store.hpp"
 #include <optional>
 #include <string>
 #include <vector>
@@ -10,7 +11,7 @@ namespace cashew::storage {
 
 /**
  * Storage backend interface for content-addressed storage
- * Uses LevelDB for metadata and filesystem for content blobs
+ * Uses an embedded KVStore for metadata and filesystem for content blobs
  */
 class Storage {
 public:
@@ -42,6 +43,30 @@ public:
      */
     std::optional<bytes> get_content(const ContentHash& content_hash) const;
     
+    /**
+     * Read part of stored content without loading the rest
+     * @param content_hash Content hash
+     * @param offset Start offset
+     * @param length Maximum bytes to read (clamped to the content end)
+     * @return Bytes read (empty past the end) or nullopt if not found
+     */
+    std::optional<bytes> get_content_range(const ContentHash& content_hash,
+                                           size_t offset, size_t length) const;
+    
+    /**
+     * Size of stored content, without reading it
+     * @param content_hash Content hash
+     * @return Size in bytes or nullopt if not found
+     */
+    std::optional<size_t> content_size(const ContentHash& content_hash) const;
+    
+    /**
+     * Stream stored content through BLAKE3 and compare with its hash
+     * @param content_hash Content hash
+     * @return True if present and intact
+     */
+    bool verify_content(const ContentHash& content_hash) const;
+    
     /**
      * Check if content exists
      * @param content_hash Content hash
@@ -78,6 +103,26 @@ public:
      */
     bool delete_metadata(const std::string& key);
     
+    /**
+     * Apply several metadata puts/removes atomically
+     * @param batch Operations to apply
+     * @return True if successful
+     */
+    bool write_metadata(const WriteBatch& batch);
+    
+    /**
+     * List metadata keys starting with prefix (in key order)
+     * @param prefix Key prefix
+     * @return Matching keys
+     */
+    std::vector<std::string> list_metadata(const std::string& prefix) const;
+    
+    /**
+     * Underlying metadata store, shared with other persisted registries
+     * @return Metadata store
+     */
+    KVStore& metadata_store();
+    
     /**
      * List all content hashes
      * @return Vector of content hashes
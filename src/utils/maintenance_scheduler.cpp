@@ -0,0 +1,324 @@
+#include "utils/maintenance_scheduler.hpp"
+#include "utils/logger.hpp"
+#include "cashew/time_utils.hpp"
+#include <algorithm>
+
+namespace cashew::utils {
+
+namespace {
+
+uint64_t steady_now_ms() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+MaintenanceScheduler::MaintenanceScheduler(std::chrono::milliseconds tick, size_t wheel_slots)
+    : tick_ms_(std::max<uint64_t>(1, static_cast<uint64_t>(tick.count()))),
+      origin_ms_(steady_now_ms()),
+      wheel_(std::max<size_t>(1, wheel_slots)),
+      current_tick_(0),
+      next_task_id_(1),
+      running_task_(INVALID_TASK),
+      jitter_rng_(std::random_device{}()),
+      stats_{}
+{
+}
+
+MaintenanceScheduler::~MaintenanceScheduler() {
+    stop();
+}
+
+void MaintenanceScheduler::start() {
+    if (running_) {
+        return;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MaintenanceScheduler::run_loop, this);
+    CASHEW_LOG_INFO("Maintenance scheduler started ({} ms tick, {} slots)", tick_ms_, wheel_.size());
+}
+
+void MaintenanceScheduler::stop() {
+    if (!running_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_cv_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    CASHEW_LOG_INFO("Maintenance scheduler stopped");
+}
+
+MaintenanceScheduler::TaskId MaintenanceScheduler::schedule_periodic(
+    const std::string& name,
+    std::chrono::milliseconds interval,
+    TaskCallback callback,
+    double jitter,
+    std::optional<std::chrono::milliseconds> initial_delay)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Task task;
+    task.id = next_task_id_++;
+    task.name = name;
+    task.callback = std::move(callback);
+    task.interval_ms = std::max<uint64_t>(tick_ms_, static_cast<uint64_t>(interval.count()));
+    task.jitter = std::clamp(jitter, 0.0, 0.5);
+    task.due_ms = clock_ms() + (initial_delay
+        ? static_cast<uint64_t>(std::max<int64_t>(0, initial_delay->count()))
+        : jittered_interval_locked(task.interval_ms, task.jitter));
+    task.stats = TaskStats{name, 0, 0, 0, 0, 0};
+
+    const TaskId id = task.id;
+    auto& stored = tasks_.emplace(id, std::move(task)).first->second;
+    place_locked(stored);
+    return id;
+}
+
+MaintenanceScheduler::TaskId MaintenanceScheduler::schedule_once(
+    const std::string& name,
+    std::chrono::milliseconds delay,
+    TaskCallback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Task task;
+    task.id = next_task_id_++;
+    task.name = name;
+    task.callback = std::move(callback);
+    task.interval_ms = 0;
+    task.jitter = 0.0;
+    task.due_ms = clock_ms() + static_cast<uint64_t>(std::max<int64_t>(0, delay.count()));
+    task.stats = TaskStats{name, 0, 0, 0, 0, 0};
+
+    const TaskId id = task.id;
+    auto& stored = tasks_.emplace(id, std::move(task)).first->second;
+    place_locked(stored);
+    return id;
+}
+
+bool MaintenanceScheduler::cancel(TaskId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Wheel entries for the task are dropped lazily when their slot comes up
+    const bool removed = tasks_.erase(id) > 0;
+    
+    // Wait out an in-flight run so the caller can safely tear down its state
+    idle_cv_.wait(lock, [this, id]() {
+        return running_task_ != id || running_thread_ == std::this_thread::get_id();
+    });
+    return removed;
+}
+
+bool MaintenanceScheduler::trigger(TaskId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) {
+        return false;
+    }
+
+    it->second.due_ms = origin_ms_ + (current_tick_ + 1) * tick_ms_;
+    place_locked(it->second);
+    return true;
+}
+
+size_t MaintenanceScheduler::run_pending(uint64_t now_ms) {
+    struct DueRun {
+        TaskId id;
+        uint64_t due_tick;
+        uint64_t due_ms;
+        TaskCallback callback;
+    };
+
+    std::vector<DueRun> runs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        const uint64_t target_tick = now_ms > origin_ms_ ? (now_ms - origin_ms_) / tick_ms_ : 0;
+        if (target_tick <= current_tick_) {
+            return 0;
+        }
+
+        std::vector<SlotEntry> due;
+        const uint64_t span = target_tick - current_tick_;
+        if (span >= wheel_.size()) {
+            // Fell behind by a full rotation: sweep every slot once
+            for (size_t slot = 0; slot < wheel_.size(); ++slot) {
+                collect_slot_locked(slot, target_tick, due);
+            }
+        } else {
+            for (uint64_t tick = current_tick_ + 1; tick <= target_tick; ++tick) {
+                collect_slot_locked(static_cast<size_t>(tick % wheel_.size()), target_tick, due);
+            }
+        }
+
+        stats_.ticks += span;
+        current_tick_ = target_tick;
+
+        for (const auto& entry : due) {
+            auto it = tasks_.find(entry.id);
+            if (it == tasks_.end() || it->second.due_tick != entry.due_tick) {
+                continue;  // Cancelled or rescheduled
+            }
+            runs.push_back(DueRun{entry.id, entry.due_tick, it->second.due_ms, it->second.callback});
+        }
+    }
+
+    std::sort(runs.begin(), runs.end(), [](const DueRun& a, const DueRun& b) {
+        return a.due_ms < b.due_ms;
+    });
+
+    size_t executed = 0;
+    for (auto& run : runs) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = tasks_.find(run.id);
+            if (it == tasks_.end() || it->second.due_tick != run.due_tick) {
+                continue;  // Cancelled or rescheduled by an earlier task
+            }
+            running_task_ = run.id;
+            running_thread_ = std::this_thread::get_id();
+        }
+        ++executed;
+        
+        const uint64_t started_ms = std::max(now_ms, clock_ms());
+        const uint64_t lag_ms = started_ms > run.due_ms ? started_ms - run.due_ms : 0;
+
+        bool failed = false;
+        const auto begin = std::chrono::steady_clock::now();
+        try {
+            run.callback();
+        } catch (const std::exception& e) {
+            failed = true;
+            CASHEW_LOG_ERROR("Maintenance task {} failed: {}", run.id, e.what());
+        }
+        const auto runtime_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_task_ = INVALID_TASK;
+        idle_cv_.notify_all();
+        stats_.total_runs++;
+        stats_.max_lag_ms = std::max(stats_.max_lag_ms, lag_ms);
+        if (failed) {
+            stats_.total_failures++;
+        }
+
+        auto it = tasks_.find(run.id);
+        if (it == tasks_.end()) {
+            continue;  // Cancelled while running
+        }
+
+        Task& task = it->second;
+        task.stats.runs++;
+        task.stats.last_lag_ms = lag_ms;
+        task.stats.max_lag_ms = std::max(task.stats.max_lag_ms, lag_ms);
+        task.stats.total_runtime_us += runtime_us;
+        if (failed) {
+            task.stats.failures++;
+        }
+
+        if (task.due_tick != run.due_tick) {
+            continue;  // Triggered again while running
+        }
+
+        if (task.interval_ms == 0) {
+            tasks_.erase(it);
+            continue;
+        }
+
+        // Next period counts from now, so a stalled scheduler does not burst
+        task.due_ms = now_ms + jittered_interval_locked(task.interval_ms, task.jitter);
+        place_locked(task);
+    }
+
+    return executed;
+}
+
+uint64_t MaintenanceScheduler::clock_ms() const {
+    return steady_now_ms();
+}
+
+MaintenanceScheduler::Statistics MaintenanceScheduler::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Statistics stats = stats_;
+    stats.active_tasks = tasks_.size();
+    return stats;
+}
+
+std::optional<MaintenanceScheduler::TaskStats> MaintenanceScheduler::get_task_stats(TaskId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) {
+        return std::nullopt;
+    }
+    return it->second.stats;
+}
+
+void MaintenanceScheduler::run_loop() {
+    time::CoarseClock::attach();
+
+    while (running_) {
+        time::CoarseClock::refresh();
+        run_pending(clock_ms());
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(tick_ms_), [this]() { return !running_; });
+    }
+
+    time::CoarseClock::detach();
+}
+
+void MaintenanceScheduler::place_locked(Task& task) {
+    uint64_t due_tick = tick_for(task.due_ms);
+    if (due_tick <= current_tick_) {
+        due_tick = current_tick_ + 1;
+    }
+    task.due_tick = due_tick;
+    wheel_[static_cast<size_t>(due_tick % wheel_.size())].push_back(SlotEntry{task.id, due_tick});
+}
+
+uint64_t MaintenanceScheduler::tick_for(uint64_t time_ms) const {
+    if (time_ms <= origin_ms_) {
+        return 0;
+    }
+    return (time_ms - origin_ms_ + tick_ms_ - 1) / tick_ms_;  // Round up: never run early
+}
+
+uint64_t MaintenanceScheduler::jittered_interval_locked(uint64_t interval_ms, double jitter) {
+    if (jitter <= 0.0) {
+        return interval_ms;
+    }
+    std::uniform_real_distribution<double> dist(-jitter, jitter);
+    const double scaled = static_cast<double>(interval_ms) * (1.0 + dist(jitter_rng_));
+    return std::max<uint64_t>(tick_ms_, static_cast<uint64_t>(scaled));
+}
+
+void MaintenanceScheduler::collect_slot_locked(size_t slot, uint64_t up_to_tick,
+                                               std::vector<SlotEntry>& due) {
+    auto& entries = wheel_[slot];
+    for (size_t i = 0; i < entries.size();) {
+        const SlotEntry entry = entries[i];
+        auto it = tasks_.find(entry.id);
+        const bool stale = (it == tasks_.end() || it->second.due_tick != entry.due_tick);
+
+        if (stale || entry.due_tick <= up_to_tick) {
+            if (!stale) {
+                due.push_back(entry);
+            }
+            entries[i] = entries.back();
+            entries.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+} // namespace cashew::utils
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <optional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+
+namespace cashew::utils {
+
+/**
+ * MaintenanceScheduler - Single-threaded timer wheel for periodic upkeep
+ *
+ * Replaces per-component sleep loops (session cleanup, gossip announcements,
+ * decay checks, WebSocket keepalive) with one thread. Tasks are hashed into
+ * wheel slots by due tick, so each tick only touches the tasks in its slot.
+ * Periodic tasks get optional jitter so components started together do not
+ * fire in lockstep, and each run records how late it started (lag).
+ *
+ * While running, the scheduler refreshes time::CoarseClock every tick.
+ * Task callbacks run on the scheduler thread and must not block for long.
+ *
+ * Thread-safe.
+ */
+class MaintenanceScheduler {
+public:
+    using TaskId = uint64_t;
+    using TaskCallback = std::function<void()>;
+
+    static constexpr TaskId INVALID_TASK = 0;
+
+    explicit MaintenanceScheduler(std::chrono::milliseconds tick = std::chrono::milliseconds(100),
+                                  size_t wheel_slots = 512);
+    ~MaintenanceScheduler();
+
+    MaintenanceScheduler(const MaintenanceScheduler&) = delete;
+    MaintenanceScheduler& operator=(const MaintenanceScheduler&) = delete;
+
+    // Start/stop the scheduler thread
+    void start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    /**
+     * Run callback every interval
+     * @param jitter Fraction of interval to randomize each period by (+/-)
+     * @param initial_delay Delay before first run (default: one interval)
+     */
+    TaskId schedule_periodic(const std::string& name,
+                             std::chrono::milliseconds interval,
+                             TaskCallback callback,
+                             double jitter = 0.1,
+                             std::optional<std::chrono::milliseconds> initial_delay = std::nullopt);
+
+    /**
+     * Run callback once after delay
+     */
+    TaskId schedule_once(const std::string& name,
+                         std::chrono::milliseconds delay,
+                         TaskCallback callback);
+
+    /**
+     * Remove a task; waits for an in-flight run of it to finish unless
+     * called from that run
+     */
+    bool cancel(TaskId id);
+
+    /**
+     * Move a task's next run to the next tick
+     */
+    bool trigger(TaskId id);
+
+    /**
+     * Run every task due at or before now_ms (scheduler clock)
+     * @return number of task runs
+     *
+     * Called by the scheduler thread; tests may drive it directly.
+     */
+    size_t run_pending(uint64_t now_ms);
+
+    /**
+     * Scheduler clock (monotonic milliseconds)
+     */
+    uint64_t clock_ms() const;
+
+    // Statistics
+    struct TaskStats {
+        std::string name;
+        uint64_t runs;
+        uint64_t failures;
+        uint64_t last_lag_ms;
+        uint64_t max_lag_ms;
+        uint64_t total_runtime_us;
+    };
+
+    struct Statistics {
+        size_t active_tasks;
+        uint64_t ticks;
+        uint64_t total_runs;
+        uint64_t total_failures;
+        uint64_t max_lag_ms;
+    };
+
+    Statistics get_statistics() const;
+    std::optional<TaskStats> get_task_stats(TaskId id) const;
+
+private:
+    struct Task {
+        TaskId id;
+        std::string name;
+        TaskCallback callback;
+        uint64_t interval_ms;  // 0 = one-shot
+        double jitter;
+        uint64_t due_ms;
+        uint64_t due_tick;
+        TaskStats stats;
+    };
+
+    struct SlotEntry {
+        TaskId id;
+        uint64_t due_tick;
+    };
+
+    const uint64_t tick_ms_;
+    const uint64_t origin_ms_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+    std::vector<std::vector<SlotEntry>> wheel_;
+    std::unordered_map<TaskId, Task> tasks_;
+    uint64_t current_tick_;
+    TaskId next_task_id_;
+    TaskId running_task_;
+    std::thread::id running_thread_;
+    std::mt19937_64 jitter_rng_;
+    Statistics stats_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    void run_loop();
+    void place_locked(Task& task);
+    uint64_t tick_for(uint64_t time_ms) const;
+    uint64_t jittered_interval_locked(uint64_t interval_ms, double jitter);
+    void collect_slot_locked(size_t slot, uint64_t up_to_tick, std::vector<SlotEntry>& due);
+};
+
+} // namespace cashew::utils
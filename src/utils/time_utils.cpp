@@ -104,6 +104,30 @@ TimePoint from_string(const std::string& str) {
     return tp;
 }
 
+// CoarseClock implementation
+std::atomic<uint64_t> CoarseClock::cached_ms_{0};
+std::atomic<uint32_t> CoarseClock::drivers_{0};
+
+uint64_t CoarseClock::now_milliseconds() {
+    if (drivers_.load(std::memory_order_acquire) == 0) {
+        return timestamp_milliseconds();
+    }
+    return cached_ms_.load(std::memory_order_relaxed);
+}
+
+void CoarseClock::refresh() {
+    cached_ms_.store(timestamp_milliseconds(), std::memory_order_relaxed);
+}
+
+void CoarseClock::attach() {
+    refresh();
+    drivers_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void CoarseClock::detach() {
+    drivers_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
 // EpochManager implementation
 uint64_t EpochManager::current_epoch() const {
     return epoch_for_timestamp(timestamp_seconds());
@@ -3,7 +3,24 @@
 #include "cashew/gateway/content_renderer.hpp"
 #include "cashew/common.hpp"
 #include "crypto/blake3.hpp"
+#include "crypto/ed25519.hpp"
+#include "storage/kv_store.hpp"
+#include "runtime/executor.hpp"
+#include "gateway/native_http_server.hpp"
 #include <gtest/gtest.h>
+#include <cctype>
+#include <filesystem>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#ifdef CASHEW_PLATFORM_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using namespace cashew;
 using namespace cashew::gateway;
@@ -14,6 +31,76 @@ Hash256 hash_of(const std::vector<uint8_t>& data) {
     return crypto::Blake3::hash(data);
 }
 
+std::string hex_of(const Hash256& hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    for (uint8_t byte : hash) {
+        out.push_back(digits[byte >> 4]);
+        out.push_back(digits[byte & 0x0F]);
+    }
+    return out;
+}
+
+std::vector<uint8_t> to_bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+#ifdef CASHEW_PLATFORM_LINUX
+int connect_local(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    timeval timeout{5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+struct RawResponse {
+    std::string head;
+    std::string body;
+};
+
+// Read count Content-Length framed responses from fd
+std::vector<RawResponse> read_responses(int fd, size_t count) {
+    std::vector<RawResponse> responses;
+    std::string buffer;
+    char chunk[4096];
+    while (responses.size() < count) {
+        const size_t head_end = buffer.find("\r\n\r\n");
+        if (head_end != std::string::npos) {
+            RawResponse response;
+            response.head = buffer.substr(0, head_end);
+            size_t length = 0;
+            if (auto pos = response.head.find("Content-Length: "); pos != std::string::npos) {
+                length = std::stoul(response.head.substr(pos + 16));
+            }
+            if (buffer.size() >= head_end + 4 + length) {
+                response.body = buffer.substr(head_end + 4, length);
+                buffer.erase(0, head_end + 4 + length);
+                responses.push_back(std::move(response));
+                continue;
+            }
+        }
+        const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return responses;
+}
+
+void send_all(int fd, const std::string& data) {
+    ASSERT_EQ(send(fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+}
+#endif
+
 } // namespace
 
 TEST(GatewayTest, ContentTypeDetectionByMagicAndExtension) {
@@ -132,6 +219,521 @@ TEST(GatewayTest, GatewayServerConstructsAndRegistersHandlers) {
     EXPECT_EQ(stats.total_requests, 0u);
 }
 
+TEST(GatewayTest, RendererPrefetchesPageAssetsAndWarmsFromPopularityLog) {
+    std::map<Hash256, std::vector<uint8_t>> things;
+    auto add_thing = [&things](const std::string& text) {
+        auto data = to_bytes(text);
+        Hash256 hash = hash_of(data);
+        things[hash] = data;
+        return hash;
+    };
+
+    const Hash256 style = add_thing("body { color: red; }");
+    const Hash256 script = add_thing("console.log('hi');");
+    const Hash256 other = add_thing("plain text thing");
+    std::string upper = hex_of(script);
+    for (auto& c : upper) c = static_cast<char>(std::toupper(c));
+    const Hash256 page = add_thing(
+        "<!DOCTYPE html><html><head>"
+        "<link rel=\"stylesheet\" href=\"/api/thing/" + hex_of(style) + "\">"
+        "<script src='" + upper + "'></script></head>"
+        "<body><a href=\"/api/thing/" + hex_of(style) + "\">again</a>"
+        "<p>" + hex_of(other) + "</p></body></html>");
+
+    auto refs = ContentRenderer::extract_content_references(things[page]);
+    ASSERT_EQ(refs.size(), 2u);
+    EXPECT_EQ(refs[0], style);
+    EXPECT_EQ(refs[1], script);
+    EXPECT_EQ(ContentRenderer::extract_content_references(things[page], 1).size(), 1u);
+
+    ContentRendererConfig cfg;
+    cfg.sanitize_html = false;
+    auto fetcher = [&things](const Hash256& requested) -> std::optional<std::vector<uint8_t>> {
+        auto it = things.find(requested);
+        if (it == things.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    };
+
+    const auto dir = std::filesystem::temp_directory_path() / "cashew_test_popularity";
+    std::filesystem::remove_all(dir);
+
+    {
+        auto executor = std::make_shared<runtime::Executor>(2);
+        executor->start();
+
+        ContentRenderer renderer(cfg);
+        renderer.set_fetch_callback(fetcher);
+        renderer.set_prefetch_executor(executor);
+
+        ASSERT_TRUE(renderer.render_content(page).has_value());
+        for (int i = 0; i < 200 && !(renderer.is_cached(style) && renderer.is_cached(script)); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_TRUE(renderer.is_cached(style));
+        EXPECT_TRUE(renderer.is_cached(script));
+        EXPECT_FALSE(renderer.is_cached(other));
+        EXPECT_EQ(renderer.get_cache_stats().prefetch_count, 2u);
+
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_TRUE(renderer.render_content(style).has_value());
+        }
+        ASSERT_TRUE(renderer.render_content(other).has_value());
+
+        auto popular = renderer.get_popular_content(2);
+        ASSERT_EQ(popular.size(), 2u);
+        EXPECT_EQ(popular[0].content_hash, style);
+        EXPECT_EQ(popular[0].access_count, 5u);
+        EXPECT_EQ(popular[0].size_bytes, things[style].size());
+
+        storage::KVStore store(dir);
+        ASSERT_TRUE(store.is_open());
+        EXPECT_TRUE(renderer.save_popularity(store));
+        EXPECT_EQ(store.keys_with_prefix("popularity/").size(), 3u);
+
+        executor->stop();
+    }
+
+    {
+        storage::KVStore store(dir);
+        ContentRenderer renderer(cfg);
+        renderer.set_fetch_callback(fetcher);
+        ASSERT_TRUE(renderer.load_popularity(store));
+
+        auto popular = renderer.get_popular_content(10);
+        ASSERT_EQ(popular.size(), 3u);
+        EXPECT_EQ(popular[0].content_hash, style);
+        EXPECT_EQ(popular[0].access_count, 2u);  // Halved on load
+
+        // Budget fits the stylesheet but not the page
+        EXPECT_EQ(renderer.warm_cache(things[style].size() + things[other].size()), 2u);
+        EXPECT_TRUE(renderer.is_cached(style));
+        EXPECT_TRUE(renderer.is_cached(other));
+        EXPECT_FALSE(renderer.is_cached(page));
+    }
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(GatewayTest, RendererCoalescesConcurrentFetchesAndBoundsConcurrency) {
+    ContentRendererConfig cfg;
+    cfg.sanitize_html = false;
+    cfg.max_concurrent_fetches = 2;
+    ContentRenderer renderer(cfg);
+
+    std::map<Hash256, std::vector<uint8_t>> things;
+    std::vector<Hash256> hashes;
+    for (uint8_t i = 0; i < 6; ++i) {
+        std::vector<uint8_t> data(1024, i);
+        hashes.push_back(hash_of(data));
+        things[hashes.back()] = data;
+    }
+
+    std::mutex fetch_mutex;
+    std::map<Hash256, int> fetch_calls;
+    std::atomic<int> active{0};
+    std::atomic<int> peak{0};
+    renderer.set_fetch_callback([&](const Hash256& requested) -> std::optional<std::vector<uint8_t>> {
+        int now = ++active;
+        int seen = peak.load();
+        while (now > seen && !peak.compare_exchange_weak(seen, now)) {}
+        {
+            std::lock_guard<std::mutex> lock(fetch_mutex);
+            fetch_calls[requested]++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        --active;
+        return things.at(requested);
+    });
+
+    // A herd on one uncached hash costs one fetch
+    std::vector<std::thread> herd;
+    std::atomic<int> served{0};
+    for (int i = 0; i < 8; ++i) {
+        herd.emplace_back([&]() {
+            auto result = renderer.render_content(hashes[0]);
+            if (result && result->data == things[hashes[0]]) {
+                served++;
+            }
+        });
+    }
+    for (auto& thread : herd) {
+        thread.join();
+    }
+    EXPECT_EQ(served, 8);
+    EXPECT_EQ(fetch_calls[hashes[0]], 1);
+    EXPECT_EQ(renderer.get_cache_stats().miss_count + renderer.get_cache_stats().hit_count, 8u);
+
+    // Distinct hashes are fetched at most max_concurrent_fetches at a time
+    std::vector<std::thread> spread;
+    for (size_t i = 1; i < hashes.size(); ++i) {
+        spread.emplace_back([&, i]() { EXPECT_TRUE(renderer.render_content(hashes[i]).has_value()); });
+    }
+    for (auto& thread : spread) {
+        thread.join();
+    }
+    EXPECT_LE(peak.load(), 2);
+    for (size_t i = 1; i < hashes.size(); ++i) {
+        EXPECT_EQ(fetch_calls[hashes[i]], 1);
+    }
+}
+
+TEST(GatewayTest, AdmissionControllerQueuesBurstsAndShedsStandingQueues) {
+    AdmissionConfig config;
+    config.max_concurrent = {0, 2, 16, 4};
+    config.target_queue_delay = std::chrono::milliseconds(5);
+    config.interval = std::chrono::milliseconds(50);
+    config.max_queue_delay = std::chrono::milliseconds(2000);
+    AdmissionController control(config);
+
+    auto first = control.acquire(EndpointClass::CONTENT);
+    auto second = control.acquire(EndpointClass::CONTENT);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+
+    // A burst waits for a slot rather than failing
+    std::atomic<bool> burst_admitted{false};
+    std::thread burst([&]() {
+        auto permit = control.acquire(EndpointClass::CONTENT);
+        burst_admitted = static_cast<bool>(permit);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    first = AdmissionController::Permit();
+    burst.join();
+    EXPECT_TRUE(burst_admitted);
+
+    // Once waiters have been queued for a whole interval, newcomers are shed fast
+    first = control.acquire(EndpointClass::CONTENT);
+    ASSERT_TRUE(first);
+    std::atomic<bool> waiter_admitted{false};
+    std::thread waiter([&]() { waiter_admitted = static_cast<bool>(control.acquire(EndpointClass::CONTENT)); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+
+    const auto shed_started = std::chrono::steady_clock::now();
+    auto shed = control.acquire(EndpointClass::CONTENT);
+    EXPECT_FALSE(shed);
+    EXPECT_LT(std::chrono::steady_clock::now() - shed_started, std::chrono::milliseconds(1000));
+
+    auto stats = control.get_statistics();
+    const auto& content = stats.classes[static_cast<size_t>(EndpointClass::CONTENT)];
+    EXPECT_TRUE(content.standing_queue);
+    EXPECT_EQ(content.in_flight, 2u);
+    EXPECT_EQ(content.waiting, 1u);
+
+    // try_acquire sheds instead of waiting when the class is full
+    const auto try_started = std::chrono::steady_clock::now();
+    EXPECT_FALSE(control.try_acquire(EndpointClass::CONTENT));
+    EXPECT_LT(std::chrono::steady_clock::now() - try_started, std::chrono::milliseconds(5));
+
+    second = AdmissionController::Permit();
+    waiter.join();
+    EXPECT_TRUE(waiter_admitted);
+
+    // Unlimited classes never queue
+    std::vector<AdmissionController::Permit> statics;
+    for (int i = 0; i < 32; ++i) {
+        statics.push_back(control.acquire(EndpointClass::STATIC));
+        EXPECT_TRUE(statics.back());
+    }
+
+    stats = control.get_statistics();
+    EXPECT_EQ(stats.classes[static_cast<size_t>(EndpointClass::CONTENT)].queued, 2u);
+    EXPECT_EQ(stats.classes[static_cast<size_t>(EndpointClass::CONTENT)].shed, 2u);
+    EXPECT_EQ(stats.classes[static_cast<size_t>(EndpointClass::CONTENT)].peak_in_flight, 2u);
+    EXPECT_EQ(stats.shed, 2u);
+    EXPECT_EQ(stats.admitted, 5u + 32u);
+
+    GatewayConfig gateway_config;
+    gateway_config.max_concurrent_content = 3;
+    GatewayServer server(gateway_config);
+    const auto server_stats = server.get_statistics();
+    EXPECT_EQ(server_stats.admission.classes[static_cast<size_t>(EndpointClass::CONTENT)].limit, 3u);
+    EXPECT_EQ(server_stats.requests_shed, 0u);
+}
+
+TEST(GatewayTest, AdmissionControllerHandsSlotsToWaitersInArrivalOrder) {
+    AdmissionConfig config;
+    config.max_concurrent = {1, 1, 1, 1, 1};
+    config.max_queue_delay = std::chrono::milliseconds(5000);
+    AdmissionController control(config);
+
+    const auto waiting = [&control]() {
+        return control.get_statistics().classes[static_cast<size_t>(EndpointClass::API)].waiting;
+    };
+    const auto wait_for_waiters = [&waiting](size_t count) {
+        while (waiting() < count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    auto holder = control.acquire(EndpointClass::API);
+    ASSERT_TRUE(holder);
+
+    std::mutex order_mutex;
+    std::vector<int> order;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.emplace_back([&, i]() {
+            auto permit = control.acquire(EndpointClass::API);
+            ASSERT_TRUE(permit);
+            std::lock_guard<std::mutex> lock(order_mutex);
+            order.push_back(i);
+        });
+        wait_for_waiters(static_cast<size_t>(i) + 1);
+    }
+
+    // Each freed slot goes to the oldest waiter
+    holder = AdmissionController::Permit();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+
+    // Only callers that actually waited count as queued
+    const auto stats = control.get_statistics().classes[static_cast<size_t>(EndpointClass::API)];
+    EXPECT_EQ(stats.queued, 3u);
+    EXPECT_EQ(stats.in_flight, 0u);
+}
+
+#ifdef CASHEW_PLATFORM_LINUX
+TEST(GatewayTest, NativeHttpEnginePipelinesInOrderAndServesGatewayRoutes) {
+    auto executor = std::make_shared<runtime::Executor>(2);
+    executor->start();
+
+    NativeHttpOptions options;
+    options.bind_address = "127.0.0.1";
+    options.port = 0;
+    NativeHttpServer server(options, [](const HttpRequest& request) {
+        if (request.path == "/slow") {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        std::string text = request.path;
+        if (auto it = request.query_params.find("q"); it != request.query_params.end()) {
+            text += "?" + it->second;
+        }
+        text += "|" + std::string(request.body.begin(), request.body.end());
+        HttpResponse response;
+        response.set_binary_body(to_bytes(text), "text/plain");
+        return response;
+    }, executor, [](const HttpRequest& request) { return request.path == "/fast"; });
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(server.port(), 0);
+
+    // Pipelined requests are answered in order even when the first is slow
+    int fd = connect_local(server.port());
+    ASSERT_GE(fd, 0);
+    send_all(fd, "GET /slow HTTP/1.1\r\nHost: test\r\n\r\n"
+                 "GET /fast?q=a%20b HTTP/1.1\r\nHost: test\r\n\r\n"
+                 "POST /echo HTTP/1.1\r\nContent-Length: 5\r\n\r\nhello");
+    auto responses = read_responses(fd, 3);
+    ASSERT_EQ(responses.size(), 3u);
+    EXPECT_EQ(responses[0].body, "/slow|");
+    EXPECT_EQ(responses[1].body, "/fast?a b|");
+    EXPECT_EQ(responses[2].body, "/echo|hello");
+    EXPECT_NE(responses[0].head.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_NE(responses[0].head.find("Connection: keep-alive"), std::string::npos);
+
+    // Same connection stays usable; Connection: close ends it after the response
+    send_all(fd, "GET /bye HTTP/1.1\r\nConnection: close\r\n\r\n");
+    responses = read_responses(fd, 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0].body, "/bye|");
+    char byte;
+    EXPECT_EQ(recv(fd, &byte, 1, 0), 0);
+    close(fd);
+
+    fd = connect_local(server.port());
+    send_all(fd, "NONSENSE\r\n\r\n");
+    responses = read_responses(fd, 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_NE(responses[0].head.find("400 Bad Request"), std::string::npos);
+    close(fd);
+
+    auto stats = server.get_statistics();
+    EXPECT_EQ(stats.requests, 4u);
+    EXPECT_EQ(stats.inline_requests, 1u);
+    EXPECT_EQ(stats.pipelined_requests, 2u);
+    EXPECT_EQ(stats.bad_requests, 1u);
+    server.stop();
+    executor->stop();
+
+    // Gateway routes through the native engine
+    GatewayConfig config;
+    config.bind_address = "127.0.0.1";
+    config.http_port = 0;
+    config.use_native_http_engine = true;
+    config.http_worker_threads = 2;
+    GatewayServer gateway(config);
+    ASSERT_TRUE(gateway.start());
+    fd = connect_local(gateway.bound_port());
+    ASSERT_GE(fd, 0);
+    send_all(fd, "GET /api/health HTTP/1.1\r\n\r\nGET /api/status HTTP/1.1\r\n\r\n");
+    responses = read_responses(fd, 2);
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_NE(responses[0].body.find("healthy"), std::string::npos);
+    EXPECT_NE(responses[1].body.find("total_requests"), std::string::npos);
+    close(fd);
+    gateway.stop();
+    EXPECT_EQ(gateway.get_statistics().priority_requests, 1u);
+}
+
+TEST(GatewayTest, GatewayRevalidatesOnlyExistingContentAndKeepsSessionUpgrades) {
+    const std::vector<uint8_t> payload = to_bytes("revalidated thing");
+    const Hash256 stored = hash_of(payload);
+    auto renderer = std::make_shared<ContentRenderer>(ContentRendererConfig());
+    renderer->set_fetch_callback([&](const Hash256& requested) -> std::optional<std::vector<uint8_t>> {
+        if (requested == stored) {
+            return payload;
+        }
+        return std::nullopt;
+    });
+
+    GatewayConfig config;
+    config.bind_address = "127.0.0.1";
+    config.http_port = 0;
+    config.use_native_http_engine = true;
+    config.http_worker_threads = 2;
+    GatewayServer gateway(config);
+    gateway.set_content_renderer(renderer);
+    ASSERT_TRUE(gateway.start());
+
+    // "*" is answered with 304 only for content that exists; bogus hashes are rejected first
+    const std::string missing(64, 'a');
+    const std::string bogus(64, 'z');
+    int fd = connect_local(gateway.bound_port());
+    ASSERT_GE(fd, 0);
+    send_all(fd, "GET /api/thing/" + hex_of(stored) + " HTTP/1.1\r\nIf-None-Match: *\r\n\r\n"
+                 "GET /api/thing/" + missing + " HTTP/1.1\r\nIf-None-Match: *\r\n\r\n"
+                 "GET /api/thing/" + bogus + " HTTP/1.1\r\nIf-None-Match: \"" + bogus + "\"\r\n\r\n"
+                 "GET /api/thing/" + hex_of(stored) + " HTTP/1.1\r\nIf-None-Match: \"" + hex_of(stored) + "\"\r\n\r\n");
+    auto responses = read_responses(fd, 4);
+    ASSERT_EQ(responses.size(), 4u);
+    EXPECT_NE(responses[0].head.find("304 Not Modified"), std::string::npos);
+    EXPECT_NE(responses[1].head.find("404 Not Found"), std::string::npos);
+    EXPECT_NE(responses[2].head.find("400 Bad Request"), std::string::npos);
+    EXPECT_NE(responses[3].head.find("304 Not Modified"), std::string::npos);
+
+    // Authentication upgrades the stored session, not a copy of it
+    const auto [public_key, secret_key] = crypto::Ed25519::generate_keypair();
+    const std::string challenge = "login-challenge";
+    const auto signature = crypto::Ed25519::sign(to_bytes(challenge), secret_key);
+    const std::string body = "{\"public_key\": \"" + crypto::Ed25519::public_key_to_hex(public_key) +
+                             "\", \"message\": \"" + challenge +
+                             "\", \"signature\": \"" + crypto::Ed25519::signature_to_hex(signature) + "\"}";
+    send_all(fd, "POST /api/auth HTTP/1.1\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body);
+    responses = read_responses(fd, 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_NE(responses[0].body.find("\"authenticated\": true"), std::string::npos);
+    close(fd);
+
+    const auto stats = gateway.get_statistics();
+    gateway.stop();
+    EXPECT_EQ(stats.authenticated_sessions, 1u);
+
+    // Only the hash-matching revalidation counted as cheap, and it went through admission
+    EXPECT_EQ(stats.priority_requests, 1u);
+    EXPECT_EQ(stats.admission.classes[static_cast<size_t>(EndpointClass::PRIORITY)].admitted, 1u);
+    EXPECT_EQ(stats.admission.classes[static_cast<size_t>(EndpointClass::CONTENT)].admitted, 3u);
+}
+
+TEST(GatewayTest, NativeHttpEngineBoundsPipelinedOutputAndRejectsConflictingLengths) {
+    NativeHttpOptions options;
+    options.bind_address = "127.0.0.1";
+    options.port = 0;
+    options.event_loops = 1;
+    options.max_pending_output = 64 * 1024;
+    std::atomic<int> handled{0};
+    NativeHttpServer server(options, [&](const HttpRequest& request) {
+        handled++;
+        HttpResponse response;
+        response.set_binary_body(std::vector<uint8_t>(256 * 1024, static_cast<uint8_t>(request.path.back())),
+                                 "application/octet-stream");
+        return response;
+    }, nullptr);
+    ASSERT_TRUE(server.start());
+
+    // A client that pipelines without reading stalls the parser at the high-water mark
+    constexpr int PIPELINED = 32;
+    int fd = connect_local(server.port());
+    ASSERT_GE(fd, 0);
+    std::string burst;
+    for (int i = 0; i < PIPELINED; ++i) {
+        burst += "GET /" + std::to_string(i % 10) + " HTTP/1.1\r\n\r\n";
+    }
+    send_all(fd, burst);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LT(handled.load(), PIPELINED);
+
+    // Reading drains the queue and the rest of the pipeline is answered in order
+    auto responses = read_responses(fd, PIPELINED);
+    ASSERT_EQ(responses.size(), static_cast<size_t>(PIPELINED));
+    for (int i = 0; i < PIPELINED; ++i) {
+        ASSERT_EQ(responses[i].body.size(), 256u * 1024);
+        EXPECT_EQ(responses[i].body[0], static_cast<char>('0' + i % 10));
+    }
+    EXPECT_EQ(handled.load(), PIPELINED);
+    close(fd);
+
+    // Repeated identical lengths are fine, conflicting ones are rejected
+    fd = connect_local(server.port());
+    send_all(fd, "POST /1 HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 2\r\n\r\nok"
+                 "POST /2 HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 7\r\n\r\nok");
+    responses = read_responses(fd, 2);
+    ASSERT_EQ(responses.size(), 2u);
+    EXPECT_NE(responses[0].head.find("200 OK"), std::string::npos);
+    EXPECT_NE(responses[1].head.find("400 Bad Request"), std::string::npos);
+    close(fd);
+
+    EXPECT_EQ(server.get_statistics().bad_requests, 1u);
+    server.stop();
+}
+
+TEST(GatewayTest, NativeHttpEngineAnswersHalfClosedClientsAndDropsStalledReaders) {
+    NativeHttpOptions options;
+    options.bind_address = "127.0.0.1";
+    options.port = 0;
+    options.event_loops = 1;
+    options.max_pending_output = 64 * 1024;
+    options.keep_alive_timeout = std::chrono::seconds(1);
+    NativeHttpServer server(options, [](const HttpRequest& request) {
+        HttpResponse response;
+        const size_t size = request.path == "/large" ? 256 * 1024 : 16;
+        response.set_binary_body(std::vector<uint8_t>(size, 'x'), "application/octet-stream");
+        return response;
+    }, nullptr);
+    ASSERT_TRUE(server.start());
+
+    // Requests sent before a half-close are still answered, then the server closes
+    int fd = connect_local(server.port());
+    ASSERT_GE(fd, 0);
+    send_all(fd, "GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\nGET /c HTTP/1.1\r\n\r\n");
+    shutdown(fd, SHUT_WR);
+    auto responses = read_responses(fd, 3);
+    EXPECT_EQ(responses.size(), 3u);
+    char byte = 0;
+    EXPECT_EQ(recv(fd, &byte, 1, 0), 0);
+    close(fd);
+
+    // A client that never reads its responses is dropped after keep_alive_timeout
+    constexpr size_t PIPELINED = 128;
+    fd = connect_local(server.port());
+    ASSERT_GE(fd, 0);
+    std::string burst;
+    for (size_t i = 0; i < PIPELINED; ++i) {
+        burst += "GET /large HTTP/1.1\r\n\r\n";
+    }
+    send_all(fd, burst);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3000));
+    responses = read_responses(fd, PIPELINED);
+    EXPECT_LT(responses.size(), PIPELINED);
+    close(fd);
+
+    server.stop();
+}
+#endif
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,8 +1,11 @@
 #include "core/ledger/ledger.hpp"
 #include "core/ledger/state.hpp"
 #include "core/reputation/reputation.hpp"
+#include "core/reputation/attestation.hpp"
+#include "core/postake/hybrid_coordinator.hpp"
 #include "cashew/common.hpp"
 #include <gtest/gtest.h>
+#include <random>
 
 using namespace cashew;
 using namespace cashew::ledger;
@@ -41,6 +44,43 @@ TEST(LedgerReputationTest, LedgerEventRecordingAndChainValidation) {
     EXPECT_EQ(key_events.size(), 1u);
 }
 
+TEST(LedgerReputationTest, LedgerRangeQueriesViewStoredEvents) {
+    const NodeID local = make_node(3);
+    const Hash256 network_id = make_hash(20);
+    const ContentHash thing(make_hash(21));
+    Ledger ledger(local);
+
+    ledger.record_node_joined(local);
+    const Hash256 key_event = ledger.record_key_issued(core::KeyType::NETWORK, 1, IssuanceMethod::POW, make_hash(4));
+    ledger.record_network_created(network_id);
+    ledger.record_network_member_added(network_id, make_node(5), "FULL");
+    ledger.record_thing_replicated(thing, network_id, local, 512);
+    ledger.record_key_issued(core::KeyType::SERVICE, 2, IssuanceMethod::POSTAKE, make_hash(6));
+
+    const auto key_events = ledger.events_of_type(EventType::KEY_ISSUED);
+    ASSERT_EQ(key_events.size(), 2u);
+    EXPECT_EQ(&key_events.front(), ledger.find_event(key_event));  // No copy
+    EXPECT_EQ(key_events.position(1), 5u);
+
+    EXPECT_EQ(ledger.events_for_network(network_id).size(), 2u);
+    EXPECT_EQ(ledger.events_for_thing(thing).size(), 1u);
+    EXPECT_EQ(ledger.events_from_node(local).size(), 6u);
+    EXPECT_TRUE(ledger.events_from_node(make_node(99)).empty());
+
+    const uint64_t epoch = ledger.events().front().epoch;
+    EXPECT_EQ(ledger.events_in_epochs(epoch, epoch + 1).size(), 6u);
+    EXPECT_TRUE(ledger.events_in_epochs(epoch + 2, epoch + 10).empty());
+
+    // Views keep their extent while the ledger grows, and page cleanly
+    const auto all = ledger.events();
+    ledger.record_node_left(local);
+    EXPECT_EQ(all.size(), 6u);
+    EXPECT_EQ(ledger.recent_events(2).front().event_type, EventType::KEY_ISSUED);
+    EXPECT_EQ(all.subrange(4, 10).size(), 2u);
+    EXPECT_TRUE(all.subrange(8, 1).empty());
+    EXPECT_TRUE(ledger.contains_event(key_event));
+}
+
 TEST(LedgerReputationTest, StateManagerBuildsCapabilitiesFromLedger) {
     const NodeID local = make_node(2);
     const Hash256 network_id = make_hash(12);
@@ -97,6 +137,243 @@ TEST(LedgerReputationTest, ReputationManagerTracksActionsAndScores) {
     EXPECT_EQ(reputation.get_reputation(local), after_hosting + 25);
 }
 
+TEST(LedgerReputationTest, TrustPathFinderFindsWidestPathWithinHopLimit) {
+    const NodeID a = make_node(30);
+    const NodeID b = make_node(31);
+    const NodeID c = make_node(32);
+    const NodeID d = make_node(33);
+
+    TrustGraph graph;
+    graph.add_edge(a, c, 0.5f);
+    graph.add_edge(a, b, 0.9f);
+    graph.add_edge(b, c, 0.9f);
+    graph.add_edge(c, d, 0.2f);  // Too weak to follow
+
+    TrustPathFinder finder(graph);
+    auto direct = finder.find_widest_path(a, c, 1);
+    ASSERT_TRUE(direct.has_value());
+    EXPECT_EQ(direct->nodes, (std::vector<NodeID>{a, c}));
+    EXPECT_NEAR(direct->strength, 0.5f, 1e-5f);
+
+    auto widest = finder.find_strongest_path(a, c, 2);
+    ASSERT_TRUE(widest.has_value());
+    EXPECT_EQ(*widest, (std::vector<NodeID>{a, b, c}));
+    EXPECT_FALSE(finder.find_widest_path(a, d, 5).has_value());
+    EXPECT_EQ(finder.calculate_trust_distance(a, c), 1u);
+
+    // Cross-check against exhaustive enumeration on a random dense graph
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> weight(0.2f, 1.0f);
+    std::vector<NodeID> nodes;
+    for (uint8_t i = 0; i < 40; ++i) {
+        nodes.push_back(make_node(static_cast<uint8_t>(100 + i)));
+    }
+    TrustGraph random_graph;
+    for (int i = 0; i < 160; ++i) {
+        random_graph.add_edge(nodes[rng() % nodes.size()], nodes[rng() % nodes.size()], weight(rng));
+    }
+
+    TrustPathFinder random_finder(random_graph);
+    for (int query = 0; query < 200; ++query) {
+        const NodeID& from = nodes[rng() % nodes.size()];
+        const NodeID& to = nodes[rng() % nodes.size()];
+        const uint32_t hops = 1 + static_cast<uint32_t>(query % 4);
+        if (from == to) {
+            continue;
+        }
+
+        // find_all_paths bounds path length in nodes, plus one
+        float expected = 0.0f;
+        for (const auto& path : random_finder.find_all_paths(from, to, hops + 2)) {
+            expected = std::max(expected, random_finder.calculate_path_strength(path));
+        }
+
+        auto found = random_finder.find_widest_path(from, to, hops);
+        if (expected == 0.0f) {
+            EXPECT_FALSE(found.has_value());
+            continue;
+        }
+        ASSERT_TRUE(found.has_value());
+        EXPECT_LE(found->nodes.size(), hops + 1);
+        EXPECT_NEAR(found->strength, expected, 1e-5f);
+        EXPECT_NEAR(random_finder.calculate_path_strength(found->nodes), expected, 1e-5f);
+    }
+}
+
+TEST(LedgerReputationTest, HybridCoordinatorBoundsIssuanceStatePerNode) {
+    Ledger ledger(make_node(1));
+    StateManager state(ledger);
+    core::ProofOfWork pow;
+    postake::PoStakeEngine postake_engine(state);
+    postake::HybridCoordinator coordinator(state, pow, postake_engine);
+
+    postake::HybridPolicy policy;
+    policy.max_keys_per_epoch = 10;
+    policy.min_seconds_between_issuance = 0;
+    coordinator.set_policy(policy);
+
+    core::PowSolution solution{};
+    solution.difficulty = 0;
+
+    // Epoch limit holds while the per-node ring keeps only recent records
+    const NodeID node = make_node(7);
+    size_t issued = 0;
+    for (int i = 0; i < 12; ++i) {
+        if (coordinator.request_keys_via_pow(node, solution, core::KeyType::IDENTITY, 1)) {
+            issued++;
+        }
+    }
+    EXPECT_EQ(issued, 10u);
+
+    auto history = coordinator.get_issuance_history(node);
+    ASSERT_EQ(history.size(), postake::HybridCoordinator::RECENT_RECORDS);
+    const uint64_t epoch = history.back().epoch;
+    EXPECT_EQ(coordinator.get_keys_issued_in_epoch(node, epoch), 10u);
+    EXPECT_EQ(coordinator.get_keys_issued_in_epoch(node, epoch + postake::HybridCoordinator::EPOCH_WINDOW), 0u);
+    for (size_t i = 1; i < history.size(); ++i) {
+        EXPECT_LE(history[i - 1].issued_at, history[i].issued_at);
+    }
+    EXPECT_EQ(coordinator.get_last_issuance_time(node), history.back().issued_at);
+
+    // Rate limit is in seconds
+    policy.min_seconds_between_issuance = 60;
+    coordinator.set_policy(policy);
+    const NodeID other = make_node(8);
+    EXPECT_TRUE(coordinator.request_keys_via_pow(other, solution, core::KeyType::IDENTITY, 1).has_value());
+    EXPECT_FALSE(coordinator.request_keys_via_pow(other, solution, core::KeyType::IDENTITY, 1).has_value());
+
+    EXPECT_EQ(coordinator.tracked_nodes(), 2u);
+    EXPECT_EQ(coordinator.total_keys_issued(), 11u);
+    EXPECT_TRUE(coordinator.get_issuance_history(make_node(9)).empty());
+}
+
+TEST(LedgerReputationTest, ContributionTrackerCapsTrackedNodes) {
+    using postake::ContributionTracker;
+    ContributionTracker tracker;
+
+    const NodeID online = make_node(200);
+    tracker.record_node_online(online);
+    for (size_t i = 0; i < ContributionTracker::MAX_TRACKED_NODES + 100; ++i) {
+        Hash256 id{};
+        id[0] = 1;
+        for (int b = 0; b < 4; ++b) {
+            id[b + 1] = static_cast<uint8_t>(i >> (b * 8));
+        }
+        tracker.record_bytes_routed(NodeID(id), 1);
+    }
+    EXPECT_LE(tracker.tracked_nodes(), ContributionTracker::MAX_TRACKED_NODES);
+
+    // Newly recorded nodes are never the ones evicted
+    const NodeID latest = make_node(201);
+    tracker.record_bytes_routed(latest, 42);
+    EXPECT_EQ(tracker.get_metrics(latest).bytes_routed, 42u);
+    EXPECT_LE(tracker.tracked_nodes(), ContributionTracker::MAX_TRACKED_NODES);
+}
+
+TEST(LedgerReputationTest, PoStakeColumnarEpochScoringMatchesPerNodeScoring) {
+    Ledger ledger(make_node(1));
+    StateManager state(ledger);
+    postake::PoStakeEngine engine(state);
+    for (auto key_type : {core::KeyType::SERVICE, core::KeyType::ROUTING, core::KeyType::NETWORK}) {
+        engine.set_earning_rate(key_type, postake::KeyEarningRate{key_type, 20, 4, 10});
+    }
+
+    // Enough nodes for a four-way split
+    constexpr uint64_t GB = 1024ull * 1024 * 1024;
+    std::mt19937_64 rng(7);
+    postake::ContributionColumns columns;
+    columns.taken_at = 2000000000;
+    std::vector<postake::ContributionMetrics> all_metrics;
+    const size_t node_count = 4 * postake::PoStakeEngine::MIN_NODES_PER_CHUNK + 123;
+    for (size_t i = 0; i < node_count; ++i) {
+        postake::ContributionMetrics metrics;
+        Hash256 id{};
+        for (int b = 0; b < 4; ++b) {
+            id[b] = static_cast<uint8_t>(i >> (b * 8));
+        }
+        metrics.node_id = NodeID(id);
+        metrics.total_uptime = rng() % 5000000;
+        metrics.bytes_routed = rng() % (300 * GB);
+        metrics.things_hosted = static_cast<uint32_t>(rng() % 30);
+        metrics.storage_bytes_provided = rng() % (50 * GB);
+        metrics.successful_routes = static_cast<uint32_t>(rng() % 150);
+        metrics.failed_routes = static_cast<uint32_t>(rng() % 20);
+        metrics.routing_reliability = static_cast<float>(metrics.successful_routes) /
+            static_cast<float>(std::max(1u, metrics.successful_routes + metrics.failed_routes));
+        metrics.epochs_witnessed = static_cast<uint32_t>(rng() % 20);
+        metrics.epochs_missed = static_cast<uint32_t>(rng() % 5);
+        all_metrics.push_back(metrics);
+        columns.push_back(metrics);
+    }
+    // Half an hour online out of the last hour: 50% -> 50 * 0.3
+    columns.first_seen[0] = columns.taken_at - 3600;
+    columns.total_uptime[0] = 1800;
+
+    const auto serial = engine.score_epoch(columns, 9);
+    auto executor = std::make_shared<runtime::Executor>(4);
+    executor->start();
+    engine.set_executor(executor);
+    const auto parallel = engine.score_epoch(columns, 9);
+    EXPECT_GT(executor->get_statistics().submitted, 0u);
+    ASSERT_EQ(serial.size(), node_count);
+    EXPECT_EQ(parallel.total_score, serial.total_score);
+    EXPECT_EQ(parallel.uptime_score, serial.uptime_score);
+    EXPECT_EQ(parallel.rank, serial.rank);
+    ASSERT_EQ(parallel.rewards.size(), serial.rewards.size());
+    EXPECT_FALSE(serial.rewards.empty());
+
+    // Columns score exactly as the per-node path (first_seen 0: uptime is clock-free)
+    EXPECT_EQ(serial.uptime_score[0], 15u);
+    for (size_t i = 1; i < node_count; i += 97) {
+        const auto expected = engine.calculate_score(all_metrics[i]);
+        const auto actual = serial.score(columns, i);
+        EXPECT_EQ(actual.node_id, expected.node_id);
+        EXPECT_EQ(actual.uptime_score, expected.uptime_score);
+        EXPECT_EQ(actual.bandwidth_score, expected.bandwidth_score);
+        EXPECT_EQ(actual.storage_score, expected.storage_score);
+        EXPECT_EQ(actual.routing_score, expected.routing_score);
+        EXPECT_EQ(actual.witness_score, expected.witness_score);
+        EXPECT_EQ(actual.total_score, expected.total_score);
+    }
+
+    // Ranks order by total score; rewards follow the earning rates
+    std::vector<uint32_t> by_rank(node_count);
+    for (size_t i = 0; i < node_count; ++i) {
+        by_rank[serial.rank[i]] = static_cast<uint32_t>(i);
+    }
+    for (size_t r = 1; r < node_count; ++r) {
+        EXPECT_GE(serial.total_score[by_rank[r - 1]], serial.total_score[by_rank[r]]);
+    }
+    size_t reward_index = 0;
+    for (size_t i = 0; i < node_count; ++i) {
+        const uint32_t expected_keys = serial.total_score[i] < 10 ? 0 : std::min(serial.total_score[i] / 20, 4u);
+        if (expected_keys == 0) {
+            continue;
+        }
+        ASSERT_LT(reward_index, serial.rewards.size());
+        EXPECT_EQ(serial.rewards[reward_index].node_id, columns.node_ids[i]);
+        EXPECT_EQ(serial.rewards[reward_index].key_count, expected_keys);
+        EXPECT_EQ(serial.rewards[reward_index].epoch, 9u);
+        reward_index++;
+    }
+    EXPECT_EQ(reward_index, serial.rewards.size());
+
+    // Tracker-backed queries run on the same snapshot
+    auto& tracker = engine.get_tracker();
+    for (uint8_t i = 0; i < 5; ++i) {
+        tracker.record_node_online(make_node(10 + i));
+        tracker.record_bytes_routed(make_node(10 + i), (i + 1) * 40 * GB);
+        tracker.record_thing_hosted(make_node(10 + i), GB);
+    }
+    EXPECT_EQ(tracker.snapshot_active().size(), 5u);
+    const auto top = engine.get_top_contributors(postake::ContributionType::BANDWIDTH, 2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0], make_node(14));
+    EXPECT_EQ(top[1], make_node(13));
+    EXPECT_EQ(engine.calculate_epoch_rewards(10).size(), 5u);
+    EXPECT_GT(engine.get_average_contribution_score(), 0u);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,9 +1,30 @@
 #include "network/network.hpp"
+#include "network/router.hpp"
+#include "network/activity_monitor.hpp"
+#include "network/ledger_sync.hpp"
+#include "network/nat_traversal.hpp"
+#include "runtime/executor.hpp"
+#include "sim/cluster_simulator.hpp"
+#include "utils/logger.hpp"
+#include "utils/maintenance_scheduler.hpp"
+#include "cashew/time_utils.hpp"
 #include "core/node/node_identity.hpp"
 #include "crypto/blake3.hpp"
 #include "crypto/ed25519.hpp"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <filesystem>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+#ifndef CASHEW_PLATFORM_WINDOWS
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using namespace cashew;
 using namespace cashew::network;
@@ -27,6 +48,113 @@ Network make_test_network() {
     return Network(cashew::network::NetworkID(network_seed), content_hash_from_text("network-test-content"));
 }
 
+// In-memory gossip transport: sends queue up as envelopes and are delivered
+// one at a time, so a test can inspect, alter or drop each in turn
+class GossipWire {
+public:
+    struct Envelope {
+        NodeID from;
+        NodeID to;
+        GossipMessage message;
+    };
+
+    void attach(GossipProtocol& gossip, const NodeID& self) {
+        gossip.set_send_callback([this, self](const NodeID& to, const GossipMessage& message) {
+            in_flight_.push_back({self, to, message});
+            return true;
+        });
+    }
+
+    bool empty() const { return in_flight_.empty(); }
+
+    Envelope pop() {
+        Envelope envelope = std::move(in_flight_.front());
+        in_flight_.pop_front();
+        return envelope;
+    }
+
+    // Hand every envelope to route, including ones sent while delivering
+    template <typename Route>
+    void pump(Route&& route) {
+        while (!empty()) {
+            route(pop());
+        }
+    }
+
+private:
+    std::deque<Envelope> in_flight_;
+};
+
+#ifndef CASHEW_PLATFORM_WINDOWS
+// Loopback STUN server answering with the sender's address, optionally
+// ignoring the first few requests or reporting a shifted port
+class FakeStunResponder {
+public:
+    explicit FakeStunResponder(int drop_first = 0, uint16_t port_shift = 0)
+        : drop_first_(drop_first), port_shift_(port_shift) {
+        sock_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        socklen_t len = sizeof(addr);
+        getsockname(sock_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~FakeStunResponder() {
+        running_ = false;
+        thread_.join();
+        close(sock_);
+    }
+
+    STUNServer server() const { return STUNServer("127.0.0.1", port_); }
+    int requests() const { return requests_.load(); }
+
+private:
+    void run() {
+        std::vector<uint8_t> buffer(512);
+        while (running_) {
+            pollfd pfd{sock_, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) {
+                continue;
+            }
+            sockaddr_in from{};
+            socklen_t from_len = sizeof(from);
+            auto n = recvfrom(sock_, buffer.data(), buffer.size(), 0,
+                              reinterpret_cast<sockaddr*>(&from), &from_len);
+            auto request = STUNMessage::from_bytes(
+                std::vector<uint8_t>(buffer.begin(), buffer.begin() + std::max<ssize_t>(n, 0)));
+            if (!request || ++requests_ <= drop_first_) {
+                continue;
+            }
+
+            STUNMessage response = *request;
+            response.message_type = STUNMessage::BINDING_RESPONSE;
+            uint16_t port = static_cast<uint16_t>(ntohs(from.sin_port) + port_shift_) ^
+                            static_cast<uint16_t>(STUNMessage::MAGIC_COOKIE >> 16);
+            uint32_t ip = ntohl(from.sin_addr.s_addr) ^ STUNMessage::MAGIC_COOKIE;
+            response.attributes = {
+                0x00, 0x20, 0x00, 0x08, 0x00, 0x01,
+                static_cast<uint8_t>(port >> 8), static_cast<uint8_t>(port),
+                static_cast<uint8_t>(ip >> 24), static_cast<uint8_t>(ip >> 16),
+                static_cast<uint8_t>(ip >> 8), static_cast<uint8_t>(ip)};
+            auto out = response.to_bytes();
+            sendto(sock_, out.data(), out.size(), 0, reinterpret_cast<sockaddr*>(&from), from_len);
+        }
+    }
+
+    int sock_ = -1;
+    uint16_t port_ = 0;
+    int drop_first_;
+    uint16_t port_shift_;
+    std::atomic<bool> running_{true};
+    std::atomic<int> requests_{0};
+    std::thread thread_;
+};
+#endif
+
 } // namespace
 
 class NetworkTest : public ::testing::Test {
@@ -133,6 +261,1076 @@ TEST_F(NetworkTest, RegistrySaveLoadRoundTrip) {
     std::filesystem::remove_all(base);
 }
 
+TEST(RuntimeTest, ExecutorRunsCoroutinesAcrossPriorities) {
+    runtime::Executor executor(2);
+    executor.start();
+
+    auto pipeline = [](runtime::Executor& ex) -> runtime::Task<int> {
+        co_await ex.schedule(runtime::Priority::LATENCY);
+        EXPECT_EQ(runtime::Executor::current(), &ex);
+
+        int hashed = co_await ex.run([]() { return 21; }, runtime::Priority::BULK);
+        co_await ex.sleep_for(std::chrono::milliseconds(5));
+        co_return hashed * 2;
+    };
+    EXPECT_EQ(runtime::sync_wait(pipeline(executor)), 42);
+
+    // Jobs fanned out from one worker are finished by the whole pool
+    std::atomic<int> done{0};
+    runtime::Completion<bool> all_done;
+    executor.submit([&]() {
+        for (int i = 0; i < 64; ++i) {
+            executor.submit([&]() {
+                if (++done == 64) {
+                    all_done.set(true);
+                }
+            });
+        }
+    });
+    auto wait_all = [](runtime::Completion<bool> completion) -> runtime::Task<bool> {
+        co_return co_await completion;
+    };
+    EXPECT_TRUE(runtime::sync_wait(wait_all(all_done)));
+    EXPECT_EQ(done.load(), 64);
+
+    executor.stop();
+    EXPECT_GE(executor.get_statistics().executed, 66u);
+}
+
+TEST(RuntimeTest, RouterFetchContentResolvesFromPeerResponse) {
+    NodeID requester_id(crypto::Blake3::hash(bytes{'a'}));
+    NodeID host_id(crypto::Blake3::hash(bytes{'b'}));
+    Router requester(requester_id);
+    Router host(host_id);
+
+    const bytes payload = {'c', 'a', 's', 'h', 'e', 'w'};
+    const ContentHash hash(crypto::Blake3::hash(payload));
+    host.advertise_local_content(hash);
+    host.set_local_content_fetch_callback([&](const ContentHash&) { return std::optional<bytes>(payload); });
+
+    // In-process transport: both directions deliver synchronously
+    requester.set_request_send_callback([&](const NodeID&, const ContentRequest& request) {
+        host.handle_content_request(request);
+        return true;
+    });
+    host.set_response_send_callback([&](const NodeID&, const ContentResponse& response) {
+        requester.handle_content_response(response);
+        return true;
+    });
+
+    requester.update_routing_table(host_id, 1);
+    requester.get_routing_table().advertise_content(host_id, hash);
+
+    auto content = runtime::sync_wait(requester.fetch_content(hash));
+    ASSERT_TRUE(content.has_value());
+    EXPECT_EQ(*content, payload);
+    EXPECT_EQ(requester.pending_request_count(), 0u);
+
+    // No route resolves immediately instead of hanging
+    auto missing = runtime::sync_wait(requester.fetch_content(content_hash_from_text("nowhere")));
+    EXPECT_FALSE(missing.has_value());
+}
+
+TEST_F(NetworkTest, PeerMetricsSteerHostAndReplicationSourceSelection) {
+    const NodeID fast = founder_id;
+    const NodeID slow = invitee_id;
+    const ContentHash hash = content_hash_from_text("replicated");
+
+    PeerMetrics metrics;
+    EXPECT_FLOAT_EQ(metrics.speed_factor(fast), 1.0f);  // Unmeasured peers are neutral
+
+    RoutingTable table;
+    table.set_peer_metrics(&metrics);
+    table.add_node(slow, 1);
+    table.add_node(fast, 2);
+    table.advertise_content(slow, hash);
+    table.advertise_content(fast, hash);
+
+    // Without measurements the closer host wins
+    EXPECT_EQ(table.select_best_host(hash), slow);
+
+    for (int i = 0; i < 8; ++i) {
+        metrics.record_rtt(fast, std::chrono::milliseconds(10));
+        metrics.record_transfer(fast, 512 * 1024, std::chrono::milliseconds(60));
+        metrics.record_rtt(slow, std::chrono::milliseconds(400));
+    }
+    metrics.record_failure(slow);
+    EXPECT_GT(metrics.speed_factor(fast), 1.0f);
+    EXPECT_LT(metrics.speed_factor(slow), 1.0f);
+    EXPECT_LT(metrics.expected_fetch_ms(fast), metrics.expected_fetch_ms(slow));
+
+    EXPECT_EQ(table.select_best_host(hash), fast);
+    auto ranked = table.select_multiple_hosts(hash, 2);
+    ASSERT_EQ(ranked.size(), 2u);
+    EXPECT_EQ(ranked[0], fast);
+    EXPECT_EQ(table.select_multiple_hosts(hash, 1).size(), 1u);
+
+    auto network = make_test_network();
+    NetworkMember fast_member(fast, founder_kp.first, MemberRole::FULL);
+    NetworkMember slow_member(slow, invitee_kp.first, MemberRole::FULL);
+    fast_member.reliability_score = 0.8f;
+    ASSERT_TRUE(network.add_member(slow_member));
+    ASSERT_TRUE(network.add_member(fast_member));
+    for (const auto& id : {fast, slow}) {
+        network.mark_member_active(id);
+        network.mark_replica_complete(id, true);
+    }
+
+    EXPECT_EQ(network.select_best_source_for_replication(), slow);
+    EXPECT_EQ(network.select_best_source_for_replication(&metrics), fast);
+}
+
+TEST(RuntimeTest, RouterHedgesSlowHostAndEnforcesDeadlines) {
+    NodeID requester_id(crypto::Blake3::hash(bytes{'r'}));
+    NodeID slow_id(crypto::Blake3::hash(bytes{'s'}));
+    NodeID fast_id(crypto::Blake3::hash(bytes{'f'}));
+    Router requester(requester_id);
+    Router fast(fast_id);
+
+    const bytes payload = {'h', 'e', 'd', 'g', 'e'};
+    const ContentHash hash(crypto::Blake3::hash(payload));
+    fast.advertise_local_content(hash);
+    fast.set_local_content_fetch_callback([&](const ContentHash&) { return std::optional<bytes>(payload); });
+    fast.set_response_send_callback([&](const NodeID&, const ContentResponse& response) {
+        requester.handle_content_response(response);
+        return true;
+    });
+
+    // The slow host is closer, so it is asked first, but it never answers
+    std::vector<NodeID> asked;
+    std::vector<NodeID> cancelled;
+    requester.set_request_send_callback([&](const NodeID& peer, const ContentRequest& request) {
+        asked.push_back(peer);
+        if (peer == fast_id) {
+            fast.handle_content_request(request);
+        }
+        return true;
+    });
+    requester.set_cancel_send_callback([&](const NodeID& peer, const Hash256&) {
+        cancelled.push_back(peer);
+        return true;
+    });
+
+    requester.update_routing_table(slow_id, 1);
+    requester.update_routing_table(fast_id, 2);
+    requester.get_routing_table().advertise_content(slow_id, hash);
+    requester.get_routing_table().advertise_content(fast_id, hash);
+
+    bool received = false;
+    requester.set_content_received_callback([&](const ContentHash&, const bytes&) { received = true; });
+
+    requester.request_content(hash);
+    ASSERT_EQ(asked.size(), 1u);
+    EXPECT_EQ(asked[0], slow_id);
+
+    // Not due yet: nothing is duplicated
+    requester.process_hedges();
+    EXPECT_EQ(requester.hedges_sent(), 0u);
+
+    std::this_thread::sleep_for(requester.hedge_delay() + std::chrono::milliseconds(10));
+    requester.process_hedges();
+    EXPECT_TRUE(received);
+    EXPECT_EQ(requester.hedges_sent(), 1u);
+    EXPECT_EQ(requester.hedge_wins(), 1u);
+    EXPECT_EQ(requester.pending_request_count(), 0u);
+    ASSERT_EQ(cancelled.size(), 1u);
+    EXPECT_EQ(cancelled[0], slow_id);
+
+    // Deadlines cross the wire as the remaining budget, so peers' clocks need not agree
+    ContentRequest late;
+    late.content_hash = hash;
+    late.requester_id = requester_id;
+    late.request_id = crypto::Blake3::hash(bytes{'l'});
+    late.hop_limit = 4;
+    late.timestamp = 0;
+    late.deadline_ms = time::CoarseClock::now_milliseconds() + 5000;
+    auto decoded = ContentRequest::from_bytes(late.to_bytes());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_LE(decoded->deadline_ms, time::CoarseClock::now_milliseconds() + 5000);
+    EXPECT_GE(decoded->deadline_ms + 100, late.deadline_ms);
+
+    // Late requests are dropped by the host
+    late.deadline_ms = 1;
+    const uint64_t served = fast.responses_sent();
+    fast.handle_content_request(late);
+    EXPECT_EQ(fast.responses_sent(), served);
+    EXPECT_EQ(fast.deadline_drops(), 1u);
+
+    // A request whose deadline passes locally fails instead of waiting 30s,
+    // with the maintenance scheduler driving process_hedges
+    auto scheduler = std::make_shared<utils::MaintenanceScheduler>(std::chrono::milliseconds(10), 16);
+    requester.set_maintenance_scheduler(scheduler);
+    requester.get_routing_table().advertise_content(slow_id, content_hash_from_text("only-slow"));
+    requester.request_content(content_hash_from_text("only-slow"), ContentRequest::DEFAULT_HOP_LIMIT,
+                              std::chrono::milliseconds(1));
+    EXPECT_EQ(requester.pending_request_count(), 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    scheduler->run_pending(scheduler->clock_ms() + 2 * Router::MIN_HEDGE_DELAY.count());
+    EXPECT_EQ(requester.pending_request_count(), 0u);
+    requester.set_maintenance_scheduler(nullptr);
+    EXPECT_EQ(scheduler->get_statistics().active_tasks, 0u);
+}
+
+TEST(RuntimeTest, RouterCoalescesRequestsForSameContent) {
+    NodeID requester_id(crypto::Blake3::hash(bytes{'q'}));
+    NodeID host_id(crypto::Blake3::hash(bytes{'h'}));
+    Router requester(requester_id);
+    Router host(host_id);
+
+    const bytes payload = {'h', 'e', 'r', 'd'};
+    const ContentHash hash(crypto::Blake3::hash(payload));
+    host.advertise_local_content(hash);
+    host.set_local_content_fetch_callback([&](const ContentHash&) { return std::optional<bytes>(payload); });
+    host.set_response_send_callback([&](const NodeID&, const ContentResponse& response) {
+        requester.handle_content_response(response);
+        return true;
+    });
+
+    // Hold requests on the wire so several callers overlap
+    std::vector<ContentRequest> sent;
+    requester.set_request_send_callback([&](const NodeID&, const ContentRequest& request) {
+        sent.push_back(request);
+        return true;
+    });
+    int received = 0;
+    requester.set_content_received_callback([&](const ContentHash&, const bytes&) { received++; });
+
+    requester.update_routing_table(host_id, 1);
+    requester.get_routing_table().advertise_content(host_id, hash);
+
+    const Hash256 first = requester.request_content(hash);
+    EXPECT_EQ(requester.request_content(hash), first);
+    EXPECT_EQ(requester.request_content(hash), first);
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(requester.pending_request_count(), 1u);
+    EXPECT_EQ(requester.coalesced_requests(), 2u);
+
+    host.handle_content_request(sent[0]);
+    EXPECT_EQ(received, 1);
+    EXPECT_EQ(requester.pending_request_count(), 0u);
+
+    // Once answered, the next request goes out again
+    const Hash256 again = requester.request_content(hash);
+    EXPECT_NE(again, first);
+    EXPECT_EQ(sent.size(), 2u);
+    requester.cancel_request(again);
+
+    // A joining caller keeps the deadline the hosts were sent, and one
+    // caller giving up leaves the request to the others
+    const Hash256 second = requester.request_content(hash, ContentRequest::DEFAULT_HOP_LIMIT,
+                                                     std::chrono::milliseconds(1000));
+    const uint64_t sent_deadline = requester.get_pending_request(second)->deadline_ms;
+    EXPECT_EQ(requester.request_content(hash, ContentRequest::DEFAULT_HOP_LIMIT,
+                                        std::chrono::milliseconds(60000)), second);
+    EXPECT_EQ(requester.get_pending_request(second)->deadline_ms, sent_deadline);
+    requester.cancel_request(second);
+    EXPECT_TRUE(requester.get_pending_request(second).has_value());
+    requester.cancel_request(second);
+    EXPECT_FALSE(requester.get_pending_request(second).has_value());
+    EXPECT_EQ(requester.pending_request_count(), 0u);
+
+    // Unroutable requests are never shared
+    const ContentHash nowhere = content_hash_from_text("nowhere");
+    const Hash256 lost = requester.request_content(nowhere);
+    EXPECT_NE(requester.request_content(nowhere), lost);
+    EXPECT_EQ(requester.coalesced_requests(), 3u);
+}
+
+TEST_F(NetworkTest, ActivityMonitorBatchesTrafficPerThreadAndFlushesExactTotals) {
+    postake::ContributionTracker tracker;
+    ActivityMonitor monitor(tracker);
+
+    Hash256 local_seed{};
+    local_seed[0] = 0x01;
+    const NodeID local(local_seed);
+    monitor.start_monitoring_local_node(local);
+
+    std::vector<NodeID> peers;
+    std::vector<uint32_t> indices;
+    for (uint8_t i = 0; i < 8; ++i) {
+        Hash256 seed{};
+        seed[0] = 0x10;
+        seed[1] = i;
+        peers.emplace_back(seed);
+        indices.push_back(monitor.peer_index(peers.back()));
+    }
+    EXPECT_EQ(monitor.peer_index(peers[3]), indices[3]);
+
+    // Stays below FLUSH_BATCH per thread, so nothing reaches the tracker yet
+    constexpr size_t kThreads = 4;
+    constexpr size_t kRounds = 100;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t round = 0; round < kRounds; ++round) {
+                for (uint32_t index : indices) {
+                    monitor.on_bytes_sent(index, 10);
+                    monitor.on_bytes_received(index, 3);
+                }
+                monitor.on_bytes_routed_for(peers[0], 7);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(tracker.get_metrics(peers[0]).bytes_routed, 0u);
+    EXPECT_EQ(monitor.total_bytes_routed(), kThreads * kRounds * 7);
+
+    monitor.flush_traffic();
+    for (const auto& peer : peers) {
+        const auto metrics = tracker.get_metrics(peer);
+        EXPECT_EQ(metrics.bytes_received, kThreads * kRounds * 10);
+        EXPECT_EQ(metrics.bytes_sent, kThreads * kRounds * 3);
+    }
+    EXPECT_EQ(tracker.get_metrics(peers[0]).bytes_routed, kThreads * kRounds * 7);
+    const auto local_metrics = tracker.get_metrics(local);
+    EXPECT_EQ(local_metrics.bytes_sent, kThreads * kRounds * peers.size() * 10);
+    EXPECT_EQ(local_metrics.bytes_received, kThreads * kRounds * peers.size() * 3);
+
+    // Batches flush on their own once a thread reaches FLUSH_BATCH events
+    for (uint32_t i = 0; i < ActivityMonitor::FLUSH_BATCH; ++i) {
+        monitor.on_bytes_sent(indices[1], 1);
+    }
+    EXPECT_EQ(tracker.get_metrics(peers[1]).bytes_received,
+              kThreads * kRounds * 10 + ActivityMonitor::FLUSH_BATCH);
+
+    // Epoch boundaries flush too
+    monitor.on_bytes_sent(indices[2], 5);
+    monitor.on_epoch_witnessed(local, 1);
+    EXPECT_EQ(tracker.get_metrics(peers[2]).bytes_received, kThreads * kRounds * 10 + 5);
+
+    // So does the maintenance scheduler, for traffic that never fills a batch
+    auto scheduler = std::make_shared<utils::MaintenanceScheduler>(std::chrono::milliseconds(10), 16);
+    monitor.set_maintenance_scheduler(scheduler);
+    ASSERT_TRUE(monitor.start_periodic_flush(std::chrono::milliseconds(100)));
+    EXPECT_FALSE(monitor.start_periodic_flush());
+    monitor.on_bytes_sent(indices[3], 9);
+    scheduler->run_pending(scheduler->clock_ms() + 200);
+    EXPECT_EQ(tracker.get_metrics(peers[3]).bytes_received, kThreads * kRounds * 10 + 9);
+    monitor.stop_periodic_flush();
+
+    // A departed peer's slot is reused two flushes later; a held one is kept
+    const uint32_t held = monitor.hold_peer(peers[5]);
+    monitor.on_peer_disconnected(peers[4]);
+    monitor.on_peer_disconnected(peers[5]);
+    monitor.on_bytes_sent(indices[4], 4);  // Through an index cached before the disconnect
+    monitor.flush_traffic();
+    EXPECT_EQ(monitor.tracked_peer_count(), peers.size() - 1);
+    monitor.on_bytes_sent(indices[4], 2);  // Still the old peer's until the next flush
+    monitor.flush_traffic();
+    EXPECT_EQ(tracker.get_metrics(peers[4]).bytes_received, kThreads * kRounds * 10 + 6);
+
+    Hash256 newcomer_seed{};
+    newcomer_seed[0] = 0x20;
+    const NodeID newcomer(newcomer_seed);
+    EXPECT_EQ(monitor.peer_index(newcomer), indices[4]);
+    EXPECT_EQ(monitor.peer_slot_count(), peers.size());
+    EXPECT_EQ(monitor.peer_index(peers[5]), held);
+    monitor.release_peer(held);
+}
+
+TEST_F(NetworkTest, LedgerBridgeBootstrapsFromCoSignedStateSnapshot) {
+    const auto other_kp = crypto::Ed25519::generate_keypair();
+    const NodeID other_id = node_id_from_public_key(other_kp.first);
+    Hash256 joiner_seed{};
+    joiner_seed[0] = 0x77;
+    const NodeID joiner_id(joiner_seed);
+
+    // Founder and a second server build independent ledgers from the same events
+    ledger::Ledger founder_ledger(founder_id);
+    founder_ledger.record_node_joined(founder_id);
+    founder_ledger.record_key_issued(KeyType::SERVICE, 3, ledger::IssuanceMethod::POW, Hash256{});
+    Hash256 network_id{};
+    network_id[0] = 0x42;
+    founder_ledger.record_network_created(network_id);
+    founder_ledger.record_network_member_added(network_id, founder_id, "FOUNDER");
+    for (uint8_t i = 0; i < 40; ++i) {
+        founder_ledger.record_thing_replicated(content_hash_from_text("thing-" + std::to_string(i)),
+                                               network_id, founder_id, 1000 + i);
+    }
+    ledger::Ledger other_ledger(other_id);
+    for (const auto& event : founder_ledger.events()) {
+        ASSERT_TRUE(other_ledger.add_external_event(event));
+    }
+
+    // Both read the same injected clock, two weeks after the last event, so
+    // activity decays identically on each
+    const uint64_t frozen_now = founder_ledger.events().back().timestamp + 15 * 24 * 60 * 60;
+    ledger::StateManager founder_state(founder_ledger);
+    ledger::StateManager other_state(other_ledger);
+    founder_state.set_time_source([frozen_now]() { return frozen_now; });
+    other_state.set_time_source([frozen_now]() { return frozen_now; });
+    founder_state.update_node_activity();
+    other_state.update_node_activity();
+
+    GossipProtocol founder_gossip(founder_id);
+    GossipProtocol other_gossip(other_id);
+    LedgerGossipBridge founder_bridge(founder_ledger, founder_state, founder_gossip);
+    LedgerGossipBridge other_bridge(other_ledger, other_state, other_gossip);
+
+    GossipWire wire;
+    wire.attach(founder_gossip, founder_id);
+    wire.attach(other_gossip, other_id);
+    founder_gossip.add_peer(other_id);
+    other_gossip.add_peer(founder_id);
+
+    // Both servers snapshot the same checkpoint and co-sign it
+    founder_bridge.set_snapshot_signer(founder_id, founder_kp.first, founder_kp.second);
+    other_bridge.set_snapshot_signer(other_id, other_kp.first, other_kp.second);
+    founder_bridge.set_snapshot_chunk_size(256);
+    other_bridge.set_snapshot_chunk_size(256);
+
+    const auto deliver_to_servers = [&](const GossipWire::Envelope& envelope) {
+        if (envelope.to == founder_id) {
+            founder_bridge.handle_gossip_message(envelope.from, envelope.message);
+        } else if (envelope.to == other_id) {
+            other_bridge.handle_gossip_message(envelope.from, envelope.message);
+        }
+    };
+    const auto pump_servers = [&]() { wire.pump(deliver_to_servers); };
+
+    // A forged co-signature claiming the second server's ID is ignored and
+    // does not block its real one
+    {
+        auto forged = founder_state.create_state_snapshot(256).manifest;
+        ledger::SnapshotSignature fake;
+        fake.signer = other_id;
+        fake.public_key = other_kp.first;
+        forged.signatures.push_back(fake);
+        LedgerSyncMessage checkpoint;
+        checkpoint.type = LedgerSyncMessage::Type::CHECKPOINT;
+        checkpoint.start_epoch = forged.epoch;
+        checkpoint.end_epoch = forged.epoch;
+        checkpoint.ledger_hash = forged.ledger_hash;
+        checkpoint.payload = forged.to_bytes();
+        GossipMessage message;
+        message.type = GossipMessageType::NETWORK_STATE_UPDATE;
+        message.payload = checkpoint.serialize();
+        founder_bridge.handle_gossip_message(invitee_id, message);
+        ASSERT_TRUE(founder_bridge.latest_peer_manifest().has_value());
+        EXPECT_TRUE(founder_bridge.latest_peer_manifest()->signatures.empty());
+    }
+
+    founder_bridge.broadcast_checkpoint(founder_ledger.current_epoch());
+    pump_servers();
+    other_bridge.broadcast_checkpoint(other_ledger.current_epoch());
+    pump_servers();
+
+    ASSERT_TRUE(founder_bridge.latest_snapshot().has_value());
+    ASSERT_TRUE(other_bridge.latest_snapshot().has_value());
+    const auto manifest = founder_bridge.latest_snapshot()->manifest;
+    EXPECT_EQ(manifest.snapshot_id(), other_bridge.latest_snapshot()->manifest.snapshot_id());
+    EXPECT_EQ(founder_bridge.latest_snapshot()->chunks, other_bridge.latest_snapshot()->chunks);
+    EXPECT_GT(manifest.chunk_hashes.size(), 4u);
+    EXPECT_EQ(manifest.ledger_hash, founder_ledger.get_latest_hash());
+    EXPECT_EQ(manifest.epoch, founder_ledger.tip_epoch());
+    EXPECT_EQ(manifest.signatures.size(), 2u);
+
+    const std::map<NodeID, PublicKey> trusted{{founder_id, founder_kp.first}, {other_id, other_kp.first}};
+    EXPECT_EQ(manifest.count_valid_signatures(trusted), 2u);
+
+    auto round_trip = ledger::StateSnapshotManifest::from_bytes(manifest.to_bytes());
+    ASSERT_TRUE(round_trip.has_value());
+    EXPECT_EQ(round_trip->snapshot_id(), manifest.snapshot_id());
+
+    // The founder keeps writing into the snapshot epoch after the snapshot
+    const Hash256 tail_id = founder_ledger.record_thing_replicated(
+        content_hash_from_text("after-snapshot"), network_id, founder_id, 7);
+    ASSERT_TRUE(other_ledger.add_external_event(*founder_ledger.find_event(tail_id)));
+    founder_state.apply_event(*founder_ledger.find_event(tail_id));
+    other_state.apply_event(*other_ledger.find_event(tail_id));
+
+    const auto bootstrap = [&](bool other_silent) {
+        ledger::Ledger joiner_ledger(joiner_id);
+        ledger::StateManager joiner_state(joiner_ledger);
+        GossipProtocol joiner_gossip(joiner_id);
+        LedgerGossipBridge joiner_bridge(joiner_ledger, joiner_state, joiner_gossip);
+        wire.attach(joiner_gossip, joiner_id);
+
+        EXPECT_FALSE(joiner_bridge.begin_snapshot_bootstrap(manifest, {founder_id, other_id}, trusted, 3));
+        EXPECT_FALSE(joiner_bridge.begin_snapshot_bootstrap(manifest, {founder_id, other_id},
+                                                            {{founder_id, other_kp.first}}, 1));
+
+        // Chunks come from both servers. The second server either damages its
+        // first chunk (rejected and refetched) or never answers (timed out).
+        size_t corrupted = 0;
+        size_t dropped = 0;
+        const auto pump = [&]() {
+            wire.pump([&](GossipWire::Envelope envelope) {
+                if (envelope.to == joiner_id) {
+                    if (envelope.from == other_id && !other_silent && corrupted == 0) {
+                        auto message = LedgerSyncMessage::deserialize(envelope.message.payload);
+                        if (message && message->type == LedgerSyncMessage::Type::SNAPSHOT_CHUNK) {
+                            message->payload[0] ^= 0xFF;
+                            envelope.message.payload = message->serialize();
+                            corrupted++;
+                        }
+                    }
+                    joiner_bridge.handle_gossip_message(envelope.from, envelope.message);
+                } else if (envelope.to == other_id && other_silent) {
+                    dropped++;
+                } else {
+                    deliver_to_servers(envelope);
+                }
+            });
+        };
+
+        joiner_bridge.set_snapshot_chunk_timeout(std::chrono::milliseconds(0));
+        ASSERT_TRUE(joiner_bridge.begin_snapshot_bootstrap(*round_trip, {founder_id, other_id}, trusted, 2));
+        EXPECT_TRUE(joiner_bridge.is_bootstrapping());
+        pump();
+        if (other_silent) {
+            EXPECT_GT(dropped, 0u);
+            EXPECT_TRUE(joiner_bridge.is_bootstrapping());
+            joiner_bridge.expire_stalled_requests();
+            pump();
+        } else {
+            EXPECT_EQ(corrupted, 1u);
+        }
+        EXPECT_FALSE(joiner_bridge.is_bootstrapping());
+        EXPECT_FALSE(joiner_bridge.is_catching_up());
+
+        // The ledger is anchored at the snapshot and the tail event chained on
+        EXPECT_TRUE(joiner_ledger.is_anchored());
+        EXPECT_EQ(joiner_ledger.event_count(), 1u);
+        EXPECT_TRUE(joiner_ledger.contains_event(tail_id));
+        EXPECT_EQ(joiner_ledger.get_latest_hash(), founder_ledger.get_latest_hash());
+        EXPECT_EQ(joiner_ledger.chain_length(), founder_ledger.chain_length());
+
+        EXPECT_EQ(joiner_state.get_node_key_balance(founder_id, KeyType::SERVICE), 3u);
+        EXPECT_TRUE(joiner_state.is_node_in_network(founder_id, network_id));
+        EXPECT_EQ(joiner_state.get_member_role(founder_id, network_id), std::optional<std::string>("FOUNDER"));
+        EXPECT_FALSE(joiner_state.is_node_active(founder_id));
+        EXPECT_EQ(joiner_state.available_thing_count(), 41u);
+        EXPECT_EQ(joiner_state.create_state_snapshot(256).chunks, founder_state.create_state_snapshot(256).chunks);
+
+        // Rebuilding replays the tail on top of the snapshot instead of wiping it
+        joiner_state.rebuild_state();
+        EXPECT_EQ(joiner_state.available_thing_count(), 41u);
+        EXPECT_EQ(joiner_state.get_node_key_balance(founder_id, KeyType::SERVICE), 3u);
+
+        // A restore over a ledger that holds events, or with a chunk that does
+        // not match its manifest, leaves state untouched
+        const auto& chunks = founder_bridge.latest_snapshot()->chunks;
+        EXPECT_FALSE(joiner_state.restore_state_snapshot(manifest, chunks));
+        auto altered = chunks;
+        altered.back().push_back(0);
+        ledger::Ledger empty_ledger(joiner_id);
+        ledger::StateManager untouched(empty_ledger);
+        EXPECT_FALSE(untouched.restore_state_snapshot(manifest, altered));
+        EXPECT_EQ(untouched.available_thing_count(), 0u);
+        EXPECT_FALSE(empty_ledger.is_anchored());
+    };
+
+    bootstrap(false);
+    bootstrap(true);
+}
+
+TEST(RuntimeTest, ClusterSimulatorRunsWorkloadsInVirtualTime) {
+    // Ledger followers log every out-of-order event they reject
+    const auto previous_level = cashew::utils::Logger::get()->level();
+    cashew::utils::Logger::get()->set_level(spdlog::level::err);
+
+    cashew::sim::ClusterConfig config;
+    config.node_count = 30;
+    config.peers_per_node = 6;
+    config.link.jitter = cashew::sim::SimTime{0};
+    cashew::sim::ClusterSimulator cluster(config);
+
+    for (size_t i = 0; i < cluster.node_count(); ++i) {
+        EXPECT_GE(cluster.neighbours(i).size(), 2u);
+    }
+
+    // Lossless links: flooding with fanout 4 over 6 neighbours reaches nearly everyone
+    auto flood = cluster.run_gossip_flood(cashew::sim::GossipFloodWorkload{10, 128, cashew::sim::SimTime{5000}});
+    EXPECT_EQ(flood.issued, 10u * (config.node_count - 1));
+    EXPECT_GE(flood.completion_rate(), 0.9);
+    EXPECT_GE(flood.latency.percentile(0), config.link.latency);
+    EXPECT_GT(flood.messages, 0u);
+    EXPECT_EQ(flood.dropped, 0u);
+
+    // Content travels requester -> host -> requester: two link latencies,
+    // less for requests coalesced onto one already in flight
+    cashew::sim::ContentWorkload content;
+    content.items = 20;
+    content.item_bytes = 1024;
+    content.requests = 200;
+    auto fetched = cluster.run_content_workload(content);
+    EXPECT_GT(fetched.issued, 0u);
+    EXPECT_EQ(fetched.completed, fetched.issued);
+    EXPECT_GE(fetched.latency.percentile(50), config.link.latency * 2);
+    EXPECT_GT(fetched.bytes, content.item_bytes * fetched.completed);
+    EXPECT_GE(fetched.max_node_bytes, fetched.bytes / config.node_count);
+
+    // Offline nodes fall out of their neighbours' peer lists and receive nothing
+    cluster.set_online(1, false);
+    EXPECT_EQ(cluster.online_count(), config.node_count - 1);
+    const auto received_before = cluster.traffic(1).messages_received;
+    auto partial = cluster.run_gossip_flood(cashew::sim::GossipFloodWorkload{5, 64, cashew::sim::SimTime{5000}});
+    EXPECT_EQ(cluster.traffic(1).messages_received, received_before);
+    EXPECT_LE(partial.issued, 5u * (config.node_count - 2));
+    cluster.set_online(1, true);
+
+    // Spaced-out ledger events reach every follower in order, and all
+    // ledgers end on the writer's chain. Followers apply strictly in order
+    // and the simulator runs no catch-up, so forward to every neighbour:
+    // a random fanout could leave a follower stuck behind one missed event
+    for (size_t i = 0; i < cluster.node_count(); ++i) {
+        cluster.gossip(i).set_fanout(cluster.neighbours(i).size());
+    }
+    const size_t events_before = cluster.ledger(0).event_count();
+    auto burst = cluster.run_ledger_burst(cashew::sim::LedgerBurstWorkload{5, std::chrono::milliseconds(500), 0});
+    EXPECT_EQ(burst.issued, 5u * (config.node_count - 1));
+    EXPECT_EQ(burst.completed, burst.issued);
+    EXPECT_EQ(cluster.ledger(0).event_count(), events_before + 5);
+    for (size_t i = 1; i < cluster.node_count(); ++i) {
+        EXPECT_EQ(cluster.ledger(i).event_count(), cluster.ledger(0).event_count()) << "node " << i;
+        EXPECT_EQ(cluster.ledger(i).get_latest_hash(), cluster.ledger(0).get_latest_hash()) << "node " << i;
+    }
+
+    cashew::utils::Logger::get()->set_level(previous_level);
+}
+
+TEST_F(NetworkTest, LedgerBridgeCoalescesEventBurstIntoOneVerifiedBatch) {
+    ledger::Ledger writer_ledger(founder_id);
+    ledger::StateManager writer_state(writer_ledger);
+    ledger::Ledger reader_ledger(invitee_id);
+    ledger::StateManager reader_state(reader_ledger);
+
+    GossipProtocol writer_gossip(founder_id);
+    GossipProtocol reader_gossip(invitee_id);
+    LedgerGossipBridge writer_bridge(writer_ledger, writer_state, writer_gossip);
+    LedgerGossipBridge reader_bridge(reader_ledger, reader_state, reader_gossip);
+
+    std::vector<GossipMessage> sent;
+    writer_gossip.set_send_callback([&sent](const NodeID&, const GossipMessage& message) {
+        sent.push_back(message);
+        return true;
+    });
+    writer_gossip.add_peer(invitee_id);
+
+    Hash256 network_id{};
+    network_id[0] = 0x51;
+    writer_bridge.set_event_batch_window(std::chrono::hours(1));
+    for (uint8_t i = 0; i < 20; ++i) {
+        const Hash256 event_id = writer_ledger.record_thing_replicated(
+            content_hash_from_text("wave-" + std::to_string(i)), network_id, founder_id, 100 + i);
+        writer_bridge.broadcast_event(*writer_ledger.find_event(event_id));
+    }
+    EXPECT_TRUE(sent.empty());
+    EXPECT_EQ(writer_bridge.pending_batch_size(), 20u);
+    EXPECT_FALSE(writer_bridge.flush_event_batch_if_due());
+
+    writer_bridge.flush_event_batch();
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(writer_bridge.pending_batch_size(), 0u);
+    EXPECT_EQ(writer_bridge.get_events_sent(), 20u);
+    EXPECT_EQ(writer_bridge.get_batches_sent(), 1u);
+    const auto batch = LedgerSyncMessage::deserialize(sent[0].payload);
+    ASSERT_TRUE(batch.has_value());
+    EXPECT_EQ(batch->events.size(), 20u);
+
+    // A batch failing verification is dropped whole
+    size_t verifier_calls = 0;
+    reader_bridge.set_event_batch_verifier([&verifier_calls](const std::vector<ledger::LedgerEvent>&) {
+        verifier_calls++;
+        return false;
+    });
+    reader_bridge.handle_gossip_message(founder_id, sent[0]);
+    EXPECT_EQ(reader_ledger.event_count(), 0u);
+    EXPECT_EQ(reader_bridge.get_batches_rejected(), 1u);
+
+    // One verifier call covers the whole batch
+    reader_bridge.set_event_batch_verifier([&verifier_calls](const std::vector<ledger::LedgerEvent>& events) {
+        verifier_calls++;
+        return events.size() == 20;
+    });
+    reader_bridge.handle_gossip_message(founder_id, sent[0]);
+    EXPECT_EQ(verifier_calls, 2u);
+    EXPECT_EQ(reader_ledger.event_count(), 20u);
+    EXPECT_EQ(reader_ledger.get_latest_hash(), writer_ledger.get_latest_hash());
+
+    // Redelivery has nothing unseen left to verify
+    reader_bridge.handle_gossip_message(founder_id, sent[0]);
+    EXPECT_EQ(verifier_calls, 2u);
+
+    // With no window every event still goes out on its own
+    writer_bridge.set_event_batch_window(std::chrono::milliseconds(0));
+    const Hash256 lone_id = writer_ledger.record_thing_replicated(
+        content_hash_from_text("lone"), network_id, founder_id, 1);
+    writer_bridge.broadcast_event(*writer_ledger.find_event(lone_id));
+    ASSERT_EQ(sent.size(), 2u);
+    EXPECT_EQ(sent[1].message_id, lone_id);
+}
+
+TEST_F(NetworkTest, LedgerCatchUpPagesDisjointRangesFromSeveralPeers) {
+    const auto other_kp = crypto::Ed25519::generate_keypair();
+    const NodeID other_id = node_id_from_public_key(other_kp.first);
+    Hash256 joiner_seed{};
+    joiner_seed[0] = 0x72;
+    const NodeID joiner_id(joiner_seed);
+
+    // 200 events, five per epoch over epochs 1..40, held by two servers
+    ledger::Ledger founder_ledger(founder_id);
+    ledger::Ledger other_ledger(other_id);
+    Hash256 previous{};
+    const uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    for (uint32_t i = 0; i < 200; ++i) {
+        ledger::LedgerEvent event;
+        event.event_type = ledger::EventType::POW_SOLUTION_SUBMITTED;
+        event.source_node = founder_id;
+        event.timestamp = now;
+        event.epoch = 1 + i / 5;
+        event.previous_hash = previous;
+        event.data.assign(100, static_cast<uint8_t>(i));
+        event.event_id = content_hash_from_text("catch-up-" + std::to_string(i)).hash;
+        ASSERT_TRUE(founder_ledger.add_external_event(event));
+        ASSERT_TRUE(other_ledger.add_external_event(event));
+        previous = event.compute_hash();
+    }
+    ledger::StateManager founder_state(founder_ledger);
+    ledger::StateManager other_state(other_ledger);
+
+    GossipProtocol founder_gossip(founder_id);
+    GossipProtocol other_gossip(other_id);
+    LedgerGossipBridge founder_bridge(founder_ledger, founder_state, founder_gossip);
+    LedgerGossipBridge other_bridge(other_ledger, other_state, other_gossip);
+
+    GossipWire wire;
+    wire.attach(founder_gossip, founder_id);
+    wire.attach(other_gossip, other_id);
+
+    // from_checkpoints: the joiner learns the peers' tips from their checkpoints
+    // and sync_with_network splits the range, with a small reorder buffer
+    const auto catch_up = [&](bool other_fails, bool from_checkpoints) {
+        ledger::Ledger joiner_ledger(joiner_id);
+        ledger::StateManager joiner_state(joiner_ledger);
+        GossipProtocol joiner_gossip(joiner_id);
+        LedgerGossipBridge joiner_bridge(joiner_ledger, joiner_state, joiner_gossip);
+        wire.attach(joiner_gossip, joiner_id);
+        joiner_bridge.set_sync_page_bytes(4096);
+        joiner_bridge.set_catch_up_timeout(std::chrono::milliseconds(20));
+
+        if (from_checkpoints) {
+            joiner_bridge.set_catch_up_buffer_limit(8);
+            for (const NodeID& server : {founder_id, other_id}) {
+                LedgerSyncMessage checkpoint;
+                checkpoint.type = LedgerSyncMessage::Type::CHECKPOINT;
+                checkpoint.start_epoch = founder_ledger.current_epoch();
+                checkpoint.end_epoch = founder_ledger.tip_epoch();
+                checkpoint.ledger_hash = founder_ledger.get_latest_hash();
+                GossipMessage message;
+                message.type = GossipMessageType::NETWORK_STATE_UPDATE;
+                message.payload = checkpoint.serialize();
+                joiner_bridge.handle_gossip_message(server, message);
+            }
+            joiner_bridge.sync_with_network();
+        } else {
+            EXPECT_TRUE(joiner_bridge.begin_catch_up(1, 40, {founder_id, other_id}));
+        }
+        EXPECT_TRUE(joiner_bridge.is_catching_up());
+
+        std::map<NodeID, std::set<uint64_t>> epochs_served;
+        size_t pages = 0;
+        size_t most_buffered = 0;
+        int timeouts = 0;
+        bool failed = false;
+        while (!wire.empty() || (joiner_bridge.is_catching_up() && timeouts < 5)) {
+            if (wire.empty()) {
+                // The silent server's range is handed over once its page times out
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                joiner_bridge.expire_stalled_requests();
+                timeouts++;
+                continue;
+            }
+            const GossipWire::Envelope envelope = wire.pop();
+            if (envelope.to == founder_id) {
+                founder_bridge.handle_gossip_message(envelope.from, envelope.message);
+                continue;
+            }
+            if (envelope.to == other_id) {
+                if (!failed) {
+                    other_bridge.handle_gossip_message(envelope.from, envelope.message);
+                }
+                continue;
+            }
+            auto page = LedgerSyncMessage::deserialize(envelope.message.payload);
+            ASSERT_TRUE(page.has_value());
+            EXPECT_LE(envelope.message.payload.size(), 4096u);
+            pages++;
+            for (const auto& event : page->events) {
+                epochs_served[envelope.from].insert(event.epoch);
+            }
+            joiner_bridge.handle_gossip_message(envelope.from, envelope.message);
+            most_buffered = std::max(most_buffered, joiner_bridge.catch_up_buffered_events());
+
+            // The second server goes silent after its first page
+            if (other_fails && envelope.from == other_id) {
+                failed = true;
+            }
+        }
+
+        EXPECT_FALSE(joiner_bridge.is_catching_up());
+        EXPECT_EQ(timeouts > 0, other_fails);
+        EXPECT_EQ(joiner_ledger.event_count(), 200u);
+        EXPECT_EQ(joiner_ledger.get_latest_hash(), founder_ledger.get_latest_hash());
+        EXPECT_GT(pages, 10u);
+
+        // Each server paged only its own half of the range
+        ASSERT_FALSE(epochs_served[other_id].empty());
+        ASSERT_FALSE(epochs_served[founder_id].empty());
+        if (from_checkpoints) {
+            // Peer order is shuffled, and the halves are split at the advertised tip
+            const auto& low = *epochs_served[founder_id].begin() < *epochs_served[other_id].begin()
+                                  ? epochs_served[founder_id] : epochs_served[other_id];
+            const auto& high = &low == &epochs_served[founder_id] ? epochs_served[other_id] : epochs_served[founder_id];
+            EXPECT_LT(*low.rbegin(), *high.begin());
+            EXPECT_EQ(*high.rbegin(), 40u);
+            EXPECT_LE(*low.rbegin(), 21u);
+
+            // Ranges ahead stopped paging at the buffer limit instead of holding their whole half
+            EXPECT_LT(most_buffered, 8u + 40u);
+            return;
+        }
+        EXPECT_GE(*epochs_served[other_id].begin(), 21u);
+        EXPECT_LE(*epochs_served[founder_id].begin(), 20u);
+        if (!other_fails) {
+            EXPECT_LE(*epochs_served[founder_id].rbegin(), 20u);
+            EXPECT_GT(most_buffered, 50u);
+        } else {
+            // ...until the founder resumed the other half from its cursor
+            EXPECT_EQ(*epochs_served[founder_id].rbegin(), 40u);
+            EXPECT_EQ(epochs_served[founder_id].count(21), 0u);
+        }
+    };
+
+    catch_up(false, false);
+    catch_up(true, false);
+    catch_up(false, true);
+}
+
+#ifndef CASHEW_PLATFORM_WINDOWS
+TEST(RuntimeTest, NATTraversalRacesStunServersAndClassifiesByQuorum) {
+    FakeStunResponder silent(1000);  // Never answers
+    FakeStunResponder lossy(1);      // Answers only the retransmission
+    FakeStunResponder honest;
+    FakeStunResponder shifted(0, 7); // Reports a different mapping
+
+    NATTraversal nat;
+    nat.set_timeout(std::chrono::milliseconds(2000));
+    nat.set_initial_rto(std::chrono::milliseconds(50));
+
+    // A dead or unresolvable server in front no longer delays discovery
+    nat.clear_stun_servers();
+    nat.add_stun_server(STUNServer("stun.invalid", 3478));
+    nat.add_stun_server(silent.server());
+    nat.add_stun_server(honest.server());
+    auto start = std::chrono::steady_clock::now();
+    auto address = nat.discover_public_address();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_TRUE(address.has_value());
+    EXPECT_EQ(address->ip, "127.0.0.1");
+    EXPECT_NE(address->port, 0);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+    EXPECT_TRUE(nat.get_cached_address().has_value());
+
+    // Retransmission reaches the lossy server; agreeing mappings equal to
+    // our own socket mean there is no NAT
+    nat.clear_cache();
+    nat.clear_stun_servers();
+    nat.add_stun_server(lossy.server());
+    nat.add_stun_server(honest.server());
+    EXPECT_EQ(nat.detect_nat_type(), NATType::OPEN_INTERNET);
+    EXPECT_GE(lossy.requests(), 2);
+    EXPECT_EQ(nat.get_cached_address()->nat_type, NATType::OPEN_INTERNET);
+
+    // Mapping that changes per destination
+    nat.clear_cache();
+    nat.add_stun_server(shifted.server());
+    EXPECT_EQ(nat.detect_nat_type(), NATType::SYMMETRIC);
+
+    // A single answer out of two configured servers is below quorum
+    nat.clear_cache();
+    nat.clear_stun_servers();
+    nat.set_timeout(std::chrono::milliseconds(300));
+    nat.add_stun_server(silent.server());
+    nat.add_stun_server(honest.server());
+    EXPECT_EQ(nat.detect_nat_type(), NATType::UNKNOWN);
+
+    // Background refresh: the scheduler tick only hands the probe off, so it
+    // returns long before the silent server's timeout
+    auto executor = std::make_shared<runtime::Executor>(1);
+    auto scheduler = std::make_shared<utils::MaintenanceScheduler>(std::chrono::milliseconds(10), 16);
+    nat.clear_cache();
+    nat.add_stun_server(lossy.server());
+    EXPECT_FALSE(nat.start_background_refresh());  // Needs both
+    nat.set_maintenance_scheduler(scheduler);
+    nat.set_executor(executor);
+    executor->start();
+    ASSERT_TRUE(nat.start_background_refresh());
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(scheduler->run_pending(scheduler->clock_ms() + 20), 1u);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    nat.stop_background_refresh();  // Waits for the probe in flight
+    ASSERT_TRUE(nat.get_cached_address().has_value());
+    EXPECT_EQ(nat.get_cached_address()->nat_type, NATType::OPEN_INTERNET);
+    executor->stop();
+}
+#endif
+
+TEST_F(NetworkTest, ContentDigestAdvertisesHostedSetAsOneCompactFilter) {
+    GossipProtocol sender(founder_id);
+    sender.add_peer(invitee_id);
+    sender.set_local_public_key(founder_kp.first);
+    sender.set_sign_callback([this](const std::vector<uint8_t>& data) {
+        return crypto::Ed25519::sign(data, founder_kp.second);
+    });
+    std::vector<GossipMessage> sent;
+    sender.set_send_callback([&sent](const NodeID&, const GossipMessage& message) {
+        sent.push_back(message);
+        return true;
+    });
+    GossipScheduler scheduler(sender);
+
+    constexpr size_t kThings = 5000;
+    std::vector<ContentHash> hosted;
+    for (size_t i = 0; i < kThings; ++i) {
+        hosted.push_back(content_hash_from_text("thing-" + std::to_string(i)));
+        scheduler.announce_content(hosted.back(), 1024);
+    }
+    EXPECT_TRUE(sent.empty());  // Nothing goes out per Thing
+
+    // One full digest for the whole set, a fraction of per-Thing announcements
+    ASSERT_TRUE(scheduler.publish_content_digest());
+    ASSERT_EQ(sent.size(), 1u);
+    EXPECT_EQ(sent[0].type, GossipMessageType::CONTENT_DIGEST);
+    EXPECT_LT(sent[0].payload.size(), kThings * 2);
+    EXPECT_FALSE(scheduler.publish_content_digest());
+
+    auto full = ContentDigest::from_bytes(sent[0].payload);
+    ASSERT_TRUE(full.has_value());
+    ASSERT_TRUE(full->is_full());
+    EXPECT_EQ(full->hosting_node, founder_id);
+    EXPECT_EQ(full->item_count, kThings);
+
+    RoutingTable table;
+    table.add_node(founder_id, 1);
+    ASSERT_TRUE(table.apply_content_digest(*full));
+    EXPECT_EQ(table.content_index_size(), 0u);
+    EXPECT_EQ(table.content_filter_count(), 1u);
+    for (const auto& content_hash : hosted) {
+        ASSERT_EQ(table.select_best_host(content_hash), founder_id);
+    }
+    size_t false_positives = 0;
+    for (size_t i = 0; i < kThings; ++i) {
+        if (table.has_content_route(content_hash_from_text("absent-" + std::to_string(i)))) {
+            ++false_positives;
+        }
+    }
+    EXPECT_LT(false_positives, kThings / 50);
+
+    // Small changes travel as a delta on top of the held version
+    auto added = content_hash_from_text("thing-new");
+    scheduler.announce_content(added, 1024);
+    scheduler.withdraw_content(hosted[0]);
+    ASSERT_TRUE(scheduler.publish_content_digest());
+    auto delta = ContentDigest::from_bytes(sent.back().payload);
+    ASSERT_TRUE(delta.has_value());
+    EXPECT_FALSE(delta->is_full());
+    EXPECT_EQ(delta->since_version, full->version);
+    ASSERT_TRUE(table.apply_content_digest(*delta));
+    EXPECT_EQ(table.get_content_digest_version(founder_id), delta->version);
+    EXPECT_TRUE(table.find_hosts_for_content(hosted[0]).empty());
+    EXPECT_EQ(table.find_hosts_for_content(added).size(), 1u);
+
+    // A delta that skips a version is ignored until the next full digest
+    scheduler.announce_content(content_hash_from_text("thing-lost"), 1024);
+    ASSERT_TRUE(scheduler.publish_content_digest());
+    scheduler.announce_content(content_hash_from_text("thing-late"), 1024);
+    ASSERT_TRUE(scheduler.publish_content_digest());
+    auto gapped = ContentDigest::from_bytes(sent.back().payload);
+    ASSERT_TRUE(gapped.has_value());
+    EXPECT_FALSE(table.apply_content_digest(*gapped));
+    ASSERT_TRUE(scheduler.publish_content_digest(true));
+    auto resync = ContentDigest::from_bytes(sent.back().payload);
+    ASSERT_TRUE(resync.has_value());
+    ASSERT_TRUE(table.apply_content_digest(*resync));
+    EXPECT_EQ(table.find_hosts_for_content(content_hash_from_text("thing-lost")).size(), 1u);
+    EXPECT_EQ(table.find_hosts_for_content(content_hash_from_text("thing-late")).size(), 1u);
+    EXPECT_FALSE(table.apply_content_digest(*full));  // Stale
+
+    // A restarted node's versions continue above the ones it announced before
+    GossipScheduler restarted(sender);
+    restarted.announce_content(hosted[1], 1024);
+    ASSERT_TRUE(restarted.publish_content_digest());
+    auto reborn = ContentDigest::from_bytes(sent.back().payload);
+    ASSERT_TRUE(reborn.has_value());
+    EXPECT_TRUE(reborn->is_full());
+    EXPECT_GT(reborn->version, resync->version);
+    ASSERT_TRUE(table.apply_content_digest(*reborn));
+    EXPECT_EQ(table.get_content_digest_version(founder_id), reborn->version);
+    EXPECT_EQ(table.find_hosts_for_content(hosted[1]).size(), 1u);
+
+    // Only the hosting node's own key can speak for it
+    ContentDigest tampered = *reborn;
+    tampered.version += 1;
+    EXPECT_FALSE(table.apply_content_digest(tampered));
+    ContentDigest forged = tampered;
+    forged.hosting_key = invitee_kp.first;
+    forged.signature = crypto::Ed25519::sign(forged.signing_bytes(), invitee_kp.second);
+    EXPECT_FALSE(table.apply_content_digest(forged));
+    EXPECT_EQ(table.get_content_digest_version(founder_id), reborn->version);
+
+    // Received over gossip, a digest reaches the routing table through the router
+    GossipProtocol receiver_gossip(invitee_id);
+    Router receiver(invitee_id);
+    receiver.register_gossip_handlers(receiver_gossip);
+    receiver_gossip.receive_message(sent.back());
+    EXPECT_EQ(receiver.get_routing_table().get_content_digest_version(founder_id), reborn->version);
+    EXPECT_EQ(receiver.get_routing_table().select_best_host(hosted[1]), founder_id);
+
+    // Forgetting the node drops its filter
+    table.remove_node(founder_id);
+    EXPECT_EQ(table.content_filter_count(), 0u);
+}
+
+TEST_F(NetworkTest, ContentDigestReissuesFullFilterOnceDeltasWearIt) {
+    ContentSetTracker tracker(1);
+    for (size_t i = 0; i < 200; ++i) {
+        tracker.add(content_hash_from_text("base-" + std::to_string(i)));
+    }
+    ASSERT_TRUE(tracker.next_digest().is_full());
+
+    // Deltas stack up to a quarter of the set the filter was sized for
+    size_t deltas = 0;
+    for (size_t round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < 5; ++i) {
+            tracker.add(content_hash_from_text("added-" + std::to_string(round * 5 + i)));
+        }
+        if (tracker.next_digest().is_full()) {
+            break;
+        }
+        ++deltas;
+    }
+    EXPECT_EQ(deltas, 10u);
+    EXPECT_FALSE(tracker.has_pending_changes());
+
+    // Withdrawals wear the filter the same way, from a fresh full digest
+    for (size_t round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < 5; ++i) {
+            tracker.remove(content_hash_from_text("base-" + std::to_string(round * 5 + i)));
+        }
+        if (tracker.next_digest().is_full()) {
+            deltas = round;
+            break;
+        }
+    }
+    EXPECT_EQ(deltas, 12u);  // 250 hosted when the filter was rebuilt
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
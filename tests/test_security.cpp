@@ -1,10 +1,12 @@
 #include "security/access.hpp"
 #include "security/content_integrity.hpp"
 #include "security/attack_prevention.hpp"
+#include "security/token_revocation.hpp"
 #include "core/ledger/ledger.hpp"
 #include "core/ledger/state.hpp"
 #include "cashew/common.hpp"
 #include <gtest/gtest.h>
+#include <ctime>
 
 using namespace cashew;
 using namespace cashew::security;
@@ -67,6 +69,87 @@ TEST(SecurityTest, DDoSMitigationBlocksFloodingIp) {
     EXPECT_TRUE(mitigation.is_blocked(ip));
 }
 
+TEST(SecurityTest, DDoSMitigationKeepsItsLimitsWhenSharingBlocksWithGateway) {
+    // Gateway-style policy: request windows only, no concurrent cap
+    auto gateway = std::make_shared<IPAdmissionEngine>(AdmissionPolicy());
+    DDoSMitigation mitigation;
+    mitigation.get_admission_engine()->share_blocks_with(*gateway);
+
+    // HTTP requests do not count as P2P connection attempts
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(gateway->admit_request("172.16.0." + std::to_string(i)), AdmissionDecision::ALLOW);
+    }
+    EXPECT_FALSE(mitigation.detect_attack_pattern());
+
+    // The per-IP connection cap still holds, and its block reaches the gateway
+    const std::string ip = "192.168.0.42";
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(mitigation.allow_connection(ip));
+        mitigation.record_connection(ip);
+    }
+    EXPECT_FALSE(mitigation.allow_connection(ip));
+    EXPECT_EQ(gateway->admit_request(ip), AdmissionDecision::BLOCKED);
+
+    // Blocks placed through the gateway apply to connections too
+    gateway->block("10.9.9.9", 60);
+    EXPECT_FALSE(mitigation.allow_connection("10.9.9.9"));
+    EXPECT_EQ(mitigation.get_blocked_ips_count(), 2u);
+}
+
+TEST(SecurityTest, AdmissionEngineBlocksPrefixesAndSlidesRateWindow) {
+    AdmissionPolicy policy;
+    policy.max_per_ip_per_minute = 3;
+    policy.max_per_subnet_per_minute = 4;
+    policy.max_trie_nodes = 512;
+    IPAdmissionEngine engine(policy);
+
+    const uint64_t t0 = 1'000'000;
+    EXPECT_EQ(engine.admit_request("10.1.2.3", t0), AdmissionDecision::ALLOW);
+    EXPECT_EQ(engine.admit_request("10.1.2.3", t0), AdmissionDecision::ALLOW);
+    EXPECT_EQ(engine.admit_request("10.1.2.3", t0 + 1), AdmissionDecision::ALLOW);
+    EXPECT_EQ(engine.admit_request("10.1.2.3", t0 + 1), AdmissionDecision::IP_RATE_LIMITED);
+
+    // Neighbours in the same /24 share the subnet budget (refused requests count too)
+    EXPECT_EQ(engine.admit_request("10.1.2.4", t0 + 2), AdmissionDecision::SUBNET_RATE_LIMITED);
+    EXPECT_EQ(engine.admit_request("10.1.3.4", t0 + 2), AdmissionDecision::ALLOW);
+
+    // Window slides: a minute later the address is admitted again
+    EXPECT_EQ(engine.admit_request("10.1.2.3", t0 + 120), AdmissionDecision::ALLOW);
+
+    // Prefix blocks cover IPv4 and IPv6 subnets
+    ASSERT_TRUE(engine.block_prefix("192.168.0.0/16", 60));
+    ASSERT_TRUE(engine.block_prefix("2001:db8::/32", 60));
+    EXPECT_TRUE(engine.is_blocked("192.168.44.7"));
+    EXPECT_TRUE(engine.is_blocked("2001:db8:1::5"));
+    EXPECT_FALSE(engine.is_blocked("192.169.0.1"));
+    EXPECT_FALSE(engine.is_blocked("2001:db9::1"));
+    EXPECT_EQ(engine.admit_request("192.168.1.1"), AdmissionDecision::BLOCKED);
+    EXPECT_EQ(engine.blocked_prefix_count(), 2u);
+}
+
+TEST(SecurityTest, AdmissionEngineMemoryStaysFixedUnderFlood) {
+    AdmissionPolicy policy;
+    policy.max_trie_nodes = 256;
+    policy.rate_block_seconds = 30;
+    policy.max_per_ip_per_minute = 1;
+    IPAdmissionEngine engine(policy);
+
+    const size_t memory_before = engine.get_statistics().memory_bytes;
+    const uint64_t t0 = 2'000'000;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        const std::string ip = "fd00::" + std::to_string(i % 9999) + ":" + std::to_string(i);
+        engine.admit_request(ip, t0);
+        engine.admit_request(ip, t0);  // Second hit trips the per-IP limit and auto-blocks
+    }
+
+    const auto stats = engine.get_statistics();
+    EXPECT_GT(stats.ip_rate_limited, 0u);
+    EXPECT_GT(stats.blocks_dropped, 0u);
+    EXPECT_LE(stats.blocked_prefixes, 256u);
+    EXPECT_LE(stats.memory_bytes, memory_before + 256 * 24);
+    EXPECT_EQ(stats.total_checks, 40000u);
+}
+
 TEST(SecurityTest, SybilDefenseCanValidateWithLowDifficultySetting) {
     SybilDefense sybil;
     sybil.set_min_pow_difficulty(0);
@@ -100,6 +183,122 @@ TEST(SecurityTest, AccessControlRespectsKeysReputationAndFounderRole) {
     EXPECT_EQ(access.get_access_level_in_network(local, network_id), AccessLevel::FOUNDER);
 }
 
+TEST(SecurityTest, AccessControlMemoizesDecisionsUntilLedgerChanges) {
+    const NodeID local = make_node(12);
+    const Hash256 network_id = make_hash(56);
+
+    Ledger ledger(local);
+    ledger.record_node_joined(local);
+    ledger.record_network_created(network_id);
+
+    StateManager state(ledger);
+    AccessControl access(state);
+
+    AccessRequest request;
+    request.requester = local;
+    request.capability = Capability::HOST_THINGS;
+
+    EXPECT_FALSE(access.check_access(request).granted);
+    EXPECT_FALSE(access.check_access(request).granted);
+    auto stats = access.get_cache_statistics();
+    EXPECT_EQ(stats.decision_misses, 1u);
+    EXPECT_EQ(stats.decision_hits, 1u);
+
+    // Thing events do not touch the node, so the entry stays warm
+    ledger.record_thing_replicated(ContentHash(make_hash(70)), network_id, make_node(13), 128);
+    state.apply_event(ledger.get_all_events().back());
+    EXPECT_FALSE(access.check_access(request).granted);
+    EXPECT_EQ(access.get_cache_statistics().decision_hits, 2u);
+
+    // A key issuance for the node invalidates the cached denial
+    ledger.record_key_issued(core::KeyType::SERVICE, 1, IssuanceMethod::POW, make_hash(23));
+    state.apply_event(ledger.get_all_events().back());
+    EXPECT_TRUE(access.check_access(request).granted);
+    EXPECT_EQ(access.get_cache_statistics().decision_misses, 2u);
+
+    // Tokens verify once, then come from the cache; tampering still fails
+    auto token = access.issue_token(local, Capability::HOST_THINGS);
+    ASSERT_TRUE(token.has_value());
+    EXPECT_TRUE(access.verify_token(*token));
+    EXPECT_TRUE(access.verify_token(*token));
+    stats = access.get_cache_statistics();
+    EXPECT_EQ(stats.token_misses, 1u);
+    EXPECT_EQ(stats.token_hits, 1u);
+
+    CapabilityToken forged = *token;
+    forged.capability = Capability::REVOKE_KEYS;
+    EXPECT_FALSE(access.verify_token(forged));
+}
+
+TEST(SecurityTest, TokenRevocationFiltersChecksAndSyncsDeltas) {
+    const NodeID admin = make_node(90);
+    const uint64_t now = static_cast<uint64_t>(std::time(nullptr));
+
+    TokenRevocationManager source;
+    for (uint8_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(source.revoke_token(make_node(i), Capability::HOST_THINGS,
+                                        RevocationReason::ABUSE_DETECTED, admin).has_value());
+    }
+    EXPECT_EQ(source.current_version(), 3u);
+
+    CapabilityToken token;
+    token.node_id = make_node(1);
+    token.capability = Capability::HOST_THINGS;
+    token.issued_at = now - 60;
+    EXPECT_TRUE(source.is_token_revoked(token));
+
+    // Tokens issued after the revocation, or for another capability, stay valid
+    token.issued_at = now + 60;
+    EXPECT_FALSE(source.is_token_revoked(token));
+    token.issued_at = now - 60;
+    token.capability = Capability::POST_CONTENT;
+    EXPECT_FALSE(source.is_token_revoked(token));
+
+    // Unrevoked nodes are answered by the front filter
+    for (uint8_t i = 100; i < 200; ++i) {
+        token.node_id = make_node(i);
+        EXPECT_FALSE(source.is_token_revoked(token));
+    }
+    auto stats = source.get_check_statistics();
+    EXPECT_EQ(stats.revoked, 1u);
+    EXPECT_GE(stats.filter_negatives, 95u);
+    EXPECT_GT(stats.filter_bytes, 0u);
+
+    // First sync ships everything, the next only what is new
+    TokenRevocationManager replica;
+    auto delta = source.create_revocation_delta(replica.synced_version(admin));
+    delta.source_node = admin;
+    auto decoded = RevocationListUpdate::from_bytes(delta.to_bytes());
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(replica.process_revocation_list(*decoded), 3u);
+    EXPECT_EQ(replica.synced_version(admin), 3u);
+
+    source.revoke_token(make_node(7), Capability::POST_CONTENT, RevocationReason::POLICY_VIOLATION, admin);
+    source.revoke_token(make_node(8), Capability::POST_CONTENT, RevocationReason::POLICY_VIOLATION, admin);
+
+    // An empty batch carries nothing and does not move the peer's version
+    delta = source.create_revocation_delta(replica.synced_version(admin), 0);
+    EXPECT_TRUE(delta.revocations.empty());
+    EXPECT_EQ(delta.version, replica.synced_version(admin));
+    EXPECT_EQ(delta.head_version, source.current_version());
+
+    delta = source.create_revocation_delta(replica.synced_version(admin), 1);
+    delta.source_node = admin;
+    ASSERT_EQ(delta.revocations.size(), 1u);
+    EXPECT_LT(delta.version, delta.head_version);
+    EXPECT_EQ(replica.process_revocation_list(delta), 1u);
+
+    delta = source.create_revocation_delta(replica.synced_version(admin), 1);
+    delta.source_node = admin;
+    EXPECT_EQ(replica.process_revocation_list(delta), 1u);
+    EXPECT_EQ(replica.synced_version(admin), source.current_version());
+    EXPECT_EQ(replica.revocation_count(), 5u);
+
+    token.node_id = make_node(8);
+    token.capability = Capability::POST_CONTENT;
+    EXPECT_TRUE(replica.is_token_revoked(token));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -6,6 +6,7 @@
 #include <nlohmann/json.hpp>
 #include <filesystem>
 #include <fstream>
+#include <thread>
 
 using namespace cashew;
 using namespace cashew::storage;
@@ -255,6 +256,187 @@ TEST_F(StorageTest, ConcurrentAccess) {
     EXPECT_EQ(success_count, 10);
 }
 
+TEST_F(StorageTest, MetadataStoreBatchesPrefixScanAndRecovery) {
+    const fs::path store_dir = fs::path(test_dir) / "kv";
+    {
+        KVStore store(store_dir);
+        ASSERT_TRUE(store.is_open());
+        
+        WriteBatch batch;
+        batch.put("mime_aa", bytes{'t', 'x', 't'});
+        batch.put("name_aa", bytes{'a'});
+        batch.put("mime_bb", bytes{'h', 't', 'm', 'l'});
+        ASSERT_TRUE(store.write(batch));
+        ASSERT_TRUE(store.remove("mime_bb"));
+        
+        EXPECT_EQ(store.keys_with_prefix("mime_"), std::vector<std::string>{"mime_aa"});
+        EXPECT_EQ(store.size(), 2u);
+    }
+    
+    // Simulate a crash mid-append: a torn record at the tail is dropped on reopen
+    {
+        std::ofstream log(store_dir / "kv.log", std::ios::binary | std::ios::app);
+        const char torn[] = {0x40, 0x00, 0x00, 0x00, 0x01, 0x02};
+        log.write(torn, sizeof(torn));
+    }
+    {
+        KVStore store(store_dir);
+        EXPECT_EQ(store.size(), 2u);
+        EXPECT_EQ(store.get_statistics().truncated_bytes, 6u);
+        EXPECT_EQ(store.get("mime_aa"), (bytes{'t', 'x', 't'}));
+        EXPECT_FALSE(store.contains("mime_bb"));
+        
+        for (int i = 0; i < 50; ++i) {
+            ASSERT_TRUE(store.put("name_aa", bytes(64, static_cast<uint8_t>(i))));
+        }
+        const auto before = store.get_statistics().log_bytes;
+        ASSERT_TRUE(store.compact());
+        EXPECT_LT(store.get_statistics().log_bytes, before);
+    }
+    {
+        KVStore store(store_dir);
+        EXPECT_EQ(store.get("name_aa"), bytes(64, 49));
+        
+        // A second store on the directory sees the first one's appends and compactions
+        KVStore second(store_dir);
+        ASSERT_TRUE(second.is_open());
+        ASSERT_TRUE(second.put("name_bb", bytes{'b'}));
+        EXPECT_EQ(store.get("name_bb"), bytes{'b'});
+        
+        ASSERT_TRUE(store.remove("name_bb"));
+        ASSERT_TRUE(store.put("name_cc", bytes{'c'}));
+        ASSERT_TRUE(store.compact());
+        EXPECT_FALSE(second.contains("name_bb"));
+        EXPECT_EQ(second.get("name_cc"), bytes{'c'});
+        EXPECT_EQ(second.size(), store.size());
+        
+        // Writers catch up before appending, so neither store's batch lands on a stale log
+        ASSERT_TRUE(second.put("name_dd", bytes{'d'}));
+        ASSERT_TRUE(store.put("name_ee", bytes{'e'}));
+        EXPECT_EQ(second.keys_with_prefix("name_"),
+                  (std::vector<std::string>{"name_aa", "name_cc", "name_dd", "name_ee"}));
+        EXPECT_GT(second.get_statistics().external_batches, 0u);
+    }
+    {
+        KVStore store(store_dir);
+        EXPECT_EQ(store.size(), 5u);
+        EXPECT_EQ(store.get_statistics().truncated_bytes, 0u);
+    }
+    
+    // Storage imports file-per-key metadata from older versions
+    const fs::path legacy_dir = fs::path(test_dir) / "node" / "metadata";
+    fs::create_directories(legacy_dir / "nested");
+    std::ofstream(legacy_dir / "mime_cc") << "image/png";
+    
+    {
+        Storage storage(fs::path(test_dir) / "node");
+        auto mime = storage.get_metadata("mime_cc");
+        ASSERT_TRUE(mime.has_value());
+        EXPECT_EQ(std::string(mime->begin(), mime->end()), "image/png");
+        
+        // What was not migrated stays behind
+        EXPECT_FALSE(fs::exists(legacy_dir / "mime_cc"));
+        EXPECT_TRUE(fs::exists(legacy_dir / "nested"));
+    }
+    
+    fs::remove(legacy_dir / "nested");
+    Storage storage(fs::path(test_dir) / "node");
+    EXPECT_FALSE(fs::exists(legacy_dir));
+}
+
+TEST_F(StorageTest, TwoStoragesShareOneDirectory) {
+    // A running node and `cashew content add` open the same data directory
+    Storage node(test_dir);
+    Storage cli(test_dir);
+    
+    bytes data = {7, 7, 7};
+    ContentHash hash(crypto::Blake3::hash(data));
+    ASSERT_TRUE(cli.put_content(hash, data));
+    ASSERT_TRUE(cli.put_metadata("mime_" + hash.to_string(), bytes{'t', 'x', 't'}));
+    
+    EXPECT_TRUE(node.has_content(hash));
+    EXPECT_EQ(node.get_metadata("mime_" + hash.to_string()), (bytes{'t', 'x', 't'}));
+    
+    ASSERT_TRUE(node.put_metadata("name_" + hash.to_string(), bytes{'n'}));
+    EXPECT_EQ(cli.get_metadata("name_" + hash.to_string()), bytes{'n'});
+    
+    // Opening another instance leaves the live instances' in-flight staging alone
+    const fs::path staging = fs::path(test_dir) / "staging";
+    std::vector<fs::path> inflight;
+    for (const auto& entry : fs::directory_iterator(staging)) {
+        if (entry.is_directory()) {
+            inflight.push_back(entry.path() / "inflight");
+            std::ofstream(inflight.back()).put('x');
+        }
+    }
+    ASSERT_EQ(inflight.size(), 2u);
+    {
+        Storage third(test_dir);
+    }
+    for (const auto& path : inflight) {
+        EXPECT_TRUE(fs::exists(path));
+    }
+}
+
+TEST_F(StorageTest, ConcurrentPutsStageRenameAndDeduplicate) {
+    // A crashed writer's staging is discarded on open, whether flat or in an unlocked directory
+    const fs::path staging = fs::path(test_dir) / "staging";
+    fs::create_directories(staging / "0123456789abcdef");
+    std::ofstream(staging / "partial").put('x');
+    std::ofstream(staging / "0123456789abcdef" / "partial").put('x');
+    std::ofstream(staging / "0123456789abcdef.lock").put('x');
+    
+    Storage storage(test_dir);
+    auto staged_files = [&staging]() {
+        size_t count = 0;
+        for (const auto& entry : fs::recursive_directory_iterator(staging)) {
+            count += entry.is_regular_file() && entry.path().extension() != ".lock";
+        }
+        return count;
+    };
+    EXPECT_FALSE(fs::exists(staging / "0123456789abcdef"));
+    EXPECT_FALSE(fs::exists(staging / "0123456789abcdef.lock"));
+    EXPECT_EQ(staged_files(), 0u);
+    
+    std::vector<bytes> blobs;
+    std::vector<ContentHash> hashes;
+    for (int i = 0; i < 32; ++i) {
+        blobs.emplace_back(4096 + i, static_cast<uint8_t>(i));
+        hashes.emplace_back(crypto::Blake3::hash(blobs.back()));
+    }
+    
+    // Every blob is put by several threads at once
+    std::vector<std::thread> threads;
+    std::atomic<int> failures{0};
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < blobs.size(); ++i) {
+                size_t index = (i + t * 4) % blobs.size();
+                if (!storage.put_content(hashes[index], blobs[index])) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(storage.item_count(), blobs.size());
+    for (size_t i = 0; i < blobs.size(); ++i) {
+        EXPECT_EQ(storage.get_content(hashes[i]), blobs[i]);
+    }
+    EXPECT_EQ(staged_files(), 0u);
+    
+    // Existing content is not rewritten
+    const auto hex = hashes[0].to_string();
+    const auto blob_path = fs::path(test_dir) / "content" / hex.substr(0, 2) / hex;
+    const auto written_at = fs::last_write_time(blob_path);
+    EXPECT_TRUE(storage.put_content(hashes[0], blobs[0]));
+    EXPECT_EQ(fs::last_write_time(blob_path), written_at);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();